@@ -0,0 +1,7 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/build-gtest/googletest-src/googlemock
+# Build directory: /root/repo/build-gtest/googletest-build/googlemock
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("../googletest")
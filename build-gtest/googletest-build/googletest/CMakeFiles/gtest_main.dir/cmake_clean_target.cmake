@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "/root/repo/_gate_build/lib/libgtest_main.a"
+)
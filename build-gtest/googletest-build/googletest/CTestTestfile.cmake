@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/build-gtest/googletest-src/googletest
+# Build directory: /root/repo/build-gtest/googletest-build/googletest
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
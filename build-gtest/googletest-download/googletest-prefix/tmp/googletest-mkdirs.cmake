@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/build-gtest/googletest-src"
+  "/root/repo/build-gtest/googletest-build"
+  "/root/repo/build-gtest/googletest-download/googletest-prefix"
+  "/root/repo/build-gtest/googletest-download/googletest-prefix/tmp"
+  "/root/repo/build-gtest/googletest-download/googletest-prefix/src/googletest-stamp"
+  "/root/repo/build-gtest/googletest-download/googletest-prefix/src"
+  "/root/repo/build-gtest/googletest-download/googletest-prefix/src/googletest-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/build-gtest/googletest-download/googletest-prefix/src/googletest-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/build-gtest/googletest-download/googletest-prefix/src/googletest-stamp${cfgdir}") # cfgdir has leading slash
+endif()
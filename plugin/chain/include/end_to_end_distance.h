@@ -44,6 +44,8 @@ class EndToEndDistance : public Analyze {
   /// Return the end to end distance
   const Accumulator& end_to_end_distance() const { return accumulator(); }
 
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("EndToEndDistance"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
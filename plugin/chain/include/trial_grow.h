@@ -36,6 +36,7 @@ typedef std::map<std::string, std::string> argtype;
   - default_num_steps: optional default number of steps for all stages.
   - default_reference_index: optional default reference index for all stages.
   - default_new_only: optional default new only for all stages.
+  - default_num_threads: optional default number of threads for all stages.
 
   The following options may be used in any argtype.
   If used in the first, then it is a partial regrowth move.
@@ -61,7 +62,8 @@ typedef std::map<std::string, std::string> argtype;
     Requires arguments described in TrialSelectBond.
   - rigid_body_angle: if true, add TrialSelectAngle and PerturbDistanceAngleConnector.
     Requires arguments described in TrialSelectAngle.
-  - TrialStage arguments: num_steps, reference_index, new_only, etc.
+  - TrialStage arguments: num_steps, reference_index, new_only, num_threads,
+    etc.
 
   Note that only one of bond, angle or branch may be true for a given stage.
 
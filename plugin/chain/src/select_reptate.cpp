@@ -74,17 +74,20 @@ void SelectReptate::update_anchor(const bool is_endpoint_beginning,
     site_bonded_to = 1;
   }
   // for the old configuration, set the anchor to the old bond.
-  get_anchor()->set_site(0, 0, anchor_index);
+  // bonded_to_ is the other end, which is bonded after reptation.
+  get_anchor()->set_site(0, 0, site_bonded_to);
   get_anchor()->set_particle(0, particle_index);
-  ASSERT(bonded_to_.replace_indices(particle_index, {site_bonded_to}),
+  ASSERT(bonded_to_.replace_indices(particle_index, {anchor_index}),
     "bonded_to_ wasn't initialized to proper size on precompute");
 }
 
 void SelectReptate::mid_stage() {
-  // exclude the anchor from interactions.
-  // include interactions with site that use to be bonded
-  get_mobile()->set_new_bond(anchor());
-  get_mobile()->set_old_bond(bonded_to_);
+  // exclude the old bond from the bond energy and include it in interactions.
+  // include the new bond in the bond energy and exclude it from interactions.
+  get_mobile()->set_old_bond(anchor());
+  get_mobile()->set_new_bond(bonded_to_);
+  // for the new configuration, set the anchor to the new bond.
+  get_anchor()->set_site(0, 0, bonded_to_.site_indices()[0][0]);
 }
 
 }  // namespace feasst
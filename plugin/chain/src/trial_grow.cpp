@@ -67,6 +67,7 @@ void TrialGrow::build_(std::vector<argtype> * args) {
   const std::string default_num_steps = str("default_num_steps", &(*args)[0], "1");
   const std::string default_reference_index = str("default_reference_index", &(*args)[0], "-1");
   const std::string default_new_only = str("default_new_only", &(*args)[0], "false");
+  const std::string default_num_threads = str("default_num_threads", &(*args)[0], "1");
   // First, determine all trial types from args[0]
   std::vector<std::string> trial_types;
   std::vector<bool> trial_half_weight;
@@ -357,6 +358,7 @@ void TrialGrow::build_(std::vector<argtype> * args) {
       argtype stage_args = {{"num_steps", num_steps},
         {"reference_index", str("reference_index", &iargs, default_reference_index)},
         {"new_only", str("new_only", &iargs, default_new_only)},
+        {"num_threads", str("num_threads", &iargs, default_num_threads)},
       };
       feasst_check_all_used(iargs);
       trial->add_stage(select, perturb, &stage_args);
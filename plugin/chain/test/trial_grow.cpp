@@ -10,6 +10,7 @@
 #include "monte_carlo/include/trial_stage.h"
 #include "steppers/include/movie.h"
 #include "steppers/include/energy.h"
+#include "steppers/include/check_energy.h"
 #include "system/include/dont_visit_model.h"
 #include "chain/include/trial_grow.h"
 #include "charge/include/utils.h"
@@ -60,6 +61,59 @@ TEST(TrialGrow, bond_harmonic) {
   }
 }
 
+// The energies of the steps of the stages are computed with threads, but the
+// trajectory is the same as without threads.
+TEST(TrialGrow, num_threads) {
+  std::vector<std::shared_ptr<MonteCarlo> > mcs;
+  for (const std::string num_threads : {"1", "4"}) {
+    auto mc = std::make_shared<MonteCarlo>();
+    mc->set(MakeRandomMT19937({{"seed", "123"}}));
+    mc->set(spce({{"physical_constants", "CODATA2010"},
+      {"cubic_side_length", "20"}, {"alpha", str(5.6/20)},
+      {"kmax_squared", "38"}, {"dual_cut", "3.2"}}));
+    mc->set(MakeThermoParams({{"beta", "0.2"}, {"chemical_potential", "50"}}));
+    mc->set(MakeMetropolis());
+    for (const std::string trial : {"transfer", "regrow"}) {
+      mc->add(MakeTrialGrow({
+        {{trial, "true"}, {"particle_type", "0"}, {"site", "0"},
+         {"default_num_steps", "6"}, {"default_reference_index", "0"},
+         {"default_num_threads", num_threads}},
+        {{"bond", "true"}, {"mobile_site", "1"}, {"anchor_site", "0"}},
+        {{"angle", "true"}, {"mobile_site", "2"}, {"anchor_site", "0"},
+         {"anchor_site2", "1"}}}));
+    }
+    EXPECT_EQ(num_threads, str(mc->trial(0).stage(1).num_threads()));
+    mc->add(MakeCheckEnergy({{"trials_per_update", "1"}, {"tolerance", "1e-8"}}));
+    mcs.push_back(mc);
+  }
+  for (int attempt = 0; attempt < 400; ++attempt) {
+    if (attempt == 200) {
+      EXPECT_GT(mcs[1]->configuration().num_particles(), 5);
+      for (std::shared_ptr<MonteCarlo> mc : mcs) {
+        mc->set(MakeThermoParams({{"beta", "0.2"},
+                                  {"chemical_potential", "-50"}}));
+      }
+    }
+    for (std::shared_ptr<MonteCarlo> mc : mcs) {
+      mc->attempt(1);
+    }
+    const Configuration& config = mcs[0]->configuration();
+    const Configuration& config2 = mcs[1]->configuration();
+    ASSERT_EQ(config.num_particles(), config2.num_particles());
+    EXPECT_EQ(mcs[0]->criteria().current_energy(),
+              mcs[1]->criteria().current_energy());
+    for (const int part : config.selection_of_all().particle_indices()) {
+      for (int site = 0; site < config.select_particle(part).num_sites();
+           ++site) {
+        EXPECT_EQ(config.select_particle(part).site(site).position().coord(),
+                  config2.select_particle(part).site(site).position().coord());
+      }
+    }
+  }
+  EXPECT_GT(mcs[1]->trial(2).num_success(), 0);
+  EXPECT_GT(mcs[1]->trial(1).num_success(), 0);
+}
+
 TEST(TrialGrow, file) {
   auto trial = MakeTrialGrowFile({
     {"grow_file", "../plugin/chain/test/data/dimer_grow_file.txt"}});
@@ -1,5 +1,16 @@
 #include "utils/test/utils.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/particle.h"
+#include "configuration/include/configuration.h"
+#include "system/include/potential.h"
+#include "system/include/system.h"
+#include "system/include/thermo_params.h"
+#include "monte_carlo/include/monte_carlo.h"
+#include "monte_carlo/include/metropolis.h"
+#include "monte_carlo/include/trial_stage.h"
+#include "steppers/include/check_energy.h"
 #include "chain/include/trial_reptate.h"
+#include "chain/test/system_chain.h"
 
 namespace feasst {
 
@@ -8,4 +19,37 @@ TEST(TrialReptate, serialize) {
   Trial trial2 = test_serialize(*trial);
 }
 
+// As for TrialGrow, the trajectory with threads is the same as without.
+TEST(TrialReptate, num_threads) {
+  std::vector<std::shared_ptr<MonteCarlo> > mcs;
+  for (const std::string num_threads : {"1", "4"}) {
+    auto mc = std::make_shared<MonteCarlo>();
+    mc->set(MakeRandomMT19937({{"seed", "123"}}));
+    mc->add(std::make_shared<Configuration>(config()));
+    mc->add(MakePotential(MakeLennardJones(),
+                          MakeVisitModelIntra({{"intra_cut", "1"}})));
+    mc->set(MakeThermoParams({{"beta", "1"}}));
+    mc->set(MakeMetropolis());
+    mc->add(MakeTrialReptate({{"particle_type", "0"}, {"max_length", "1"},
+      {"num_steps", "4"}, {"num_threads", num_threads}}));
+    EXPECT_EQ(num_threads, str(mc->trial(0).stage(0).num_threads()));
+    mc->add(MakeCheckEnergy({{"trials_per_update", "1"}, {"tolerance", "1e-8"}}));
+    mcs.push_back(mc);
+  }
+  for (int attempt = 0; attempt < 100; ++attempt) {
+    for (std::shared_ptr<MonteCarlo> mc : mcs) {
+      mc->attempt(1);
+    }
+    EXPECT_EQ(mcs[0]->criteria().current_energy(),
+              mcs[1]->criteria().current_energy());
+    const Particle& chain = mcs[0]->configuration().particle(0);
+    const Particle& chain2 = mcs[1]->configuration().particle(0);
+    for (int site = 0; site < chain.num_sites(); ++site) {
+      EXPECT_EQ(chain.site(site).position().coord(),
+                chain2.site(site).position().coord());
+    }
+  }
+  EXPECT_GT(mcs[1]->trial(0).num_success(), 0);
+}
+
 }  // namespace feasst
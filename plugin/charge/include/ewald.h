@@ -32,6 +32,13 @@ namespace feasst {
   \f$\vec{v} = 2\pi\vec{b}\times\vec{c}/V\f$
 
   \f$\vec{w} = 2\pi\vec{b}\times\vec{c}/V\f$
+
+  The eik of each site are stored contiguously, and the eik of the sites of
+  a particle are stored one after another.
+  The wave vectors are grouped into runs with the same x and y components
+  and consecutive z components, so that the update of the structure factor
+  for a site is a contiguous loop over each run.
+  Perturbations update the structure factor with only the selected sites.
  */
 class Ewald : public VisitModel {
  public:
@@ -53,6 +60,9 @@ class Ewald : public VisitModel {
     - kzmax: same as above, but in the third dimension.
     - kmax_squared: optionally set the squared maximum integer wave vector for
       cubic domains only, which also sets kxmax, etc.
+    - VisitModel arguments.
+      If num_threads > 1, each thread computes the structure factor of a
+      contiguous range of particles for the entire Configuration.
    */
   explicit Ewald(argtype args = argtype());
   explicit Ewald(argtype * args);
@@ -96,6 +106,8 @@ class Ewald : public VisitModel {
   void resize_struct_fact_new_(const int num_vectors);
 
   /// Compute new eiks and update the given structure factor.
+  /// The new eiks of the selected sites are stored contiguously in eik_new,
+  /// in the order of the selection.
   void update_struct_fact_eik(const Select& selection,
     const Configuration& config,
     const std::vector<double>& wave_prefactor,
@@ -104,7 +116,7 @@ class Ewald : public VisitModel {
     const double vy, const double vz, const double wz,
     std::vector<double> * struct_fact_real,
     std::vector<double> * struct_fact_imag,
-    std::vector<std::vector<std::vector<double> > > * eik_new) const;
+    std::vector<double> * eik_new) const;
 
   /// Process tolerance arguments and initialize wave vectors.
   void precompute(Configuration * config) override;
@@ -193,9 +205,13 @@ class Ewald : public VisitModel {
 //  double eik(const int part_index, const int site_index,
 //    const int vector_index, const int dim, const bool real = true) const;
 
-  /// Same as above, but for all particles, sites and wave vectors.
-  const std::vector<std::vector<std::vector<double> > >& eik() const {
-    return manual_data_.dble_3D(); }
+  /// Return the number of eik for each site.
+  int num_eik() const { return 2*(num_kx_ + num_ky_ + num_kz_); }
+
+  /// Return the eik of all particles, sites and wave vectors.
+  /// The eik of a site begin at the site index multiplied by num_eik.
+  const std::vector<std::vector<double> >& eik() const {
+    return manual_data_.dble_2D(); }
 
   /// Return the real part of the structure factor for a given vector index
   /// corresponding with wave_prefactor and wave_num.
@@ -243,6 +259,10 @@ class Ewald : public VisitModel {
   std::vector<double> wave_prefactor_new_;
   std::vector<int> wave_num_;
   std::vector<int> wave_num_new_;
+  // For each run of wave vectors with constant kx and ky, and consecutive kz:
+  // the first vector, the vector after the last, kx, ky and the first kz.
+  std::vector<int> runs_;
+  std::vector<int> runs_new_;
   const int dimension_ = 3;
   //double stored_energy_ = 0.;
   double ux_, uy_, uz_, vy_, vz_, wz_;
@@ -255,10 +275,10 @@ class Ewald : public VisitModel {
   std::vector<double> * struct_fact_imag_();
 
   // new eik implementation, Ewald contains all eik information.
-  // eik_[particle_index][site_index][eik_index]
-  std::vector<std::vector<std::vector<double> > > * eik_();
+  // eik_[particle_index][site_index*num_eik + eik_index]
+  std::vector<std::vector<double> > * eik_();
   // temporary
-  std::vector<std::vector<std::vector<double> > > eik_new_;
+  std::vector<double> eik_new_;
 
   // not temporary (for sizing)
   std::vector<double> struct_fact_real_new_;
@@ -268,6 +288,7 @@ class Ewald : public VisitModel {
 
   // temporary
   bool finalizable_ = false;
+  int num_sites_new_ = 0;  // number of sites with eik in eik_new_
 
   /// Return the sum of the squared charge.
   double sum_squared_charge_(const Configuration& config);
@@ -294,7 +315,37 @@ class Ewald : public VisitModel {
   double sign_(const Select& select, const int pindex) const;
 
   void resize_eik_(const Configuration& config);
-  void resize_eik_(const std::vector<std::vector<std::vector<double> > >& eik2);
+  void resize_eik_(const std::vector<std::vector<double> >& eik2);
+  void update_runs_(const std::vector<int>& wave_num,
+                    std::vector<int> * runs) const;
+  void update_struct_fact_eik_(const Select& selection,
+    const Configuration& config,
+    const std::vector<int>& runs,
+    const double ux, const double uy, const double uz,
+    const double vy, const double vz, const double wz,
+    std::vector<double> * struct_fact_real,
+    std::vector<double> * struct_fact_imag,
+    std::vector<double> * eik_new) const;
+
+  // Same as above, but only for a range of particles in the selection, and
+  // without resizing eik_new.
+  void update_struct_fact_eik_(const Select& selection,
+    const Configuration& config,
+    const std::vector<int>& runs,
+    const double ux, const double uy, const double uz,
+    const double vy, const double vz, const double wz,
+    const int first_select_index,
+    const int last_select_index,
+    const int first_select_site,
+    std::vector<double> * struct_fact_real,
+    std::vector<double> * struct_fact_imag,
+    std::vector<double> * eik_new) const;
+  bool is_new_(const Select& selection) const;
+
+  // temporary and not serialized
+  std::vector<std::vector<double> > thread_sf_real_, thread_sf_imag_;
+  void update_struct_fact_threads_(const Select& selection,
+    const Configuration& config, const int num_threads);
 };
 
 inline std::shared_ptr<Ewald> MakeEwald(argtype args = argtype()) {
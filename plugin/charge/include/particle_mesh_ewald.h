@@ -0,0 +1,166 @@
+#ifndef FEASST_CHARGE_PARTICLE_MESH_EWALD_H_
+#define FEASST_CHARGE_PARTICLE_MESH_EWALD_H_
+
+#include <vector>
+#include <complex>
+#include "system/include/visit_model.h"
+
+namespace feasst {
+
+class Domain;
+
+/**
+  The smooth particle-mesh Ewald (PME) method computes the Fourier-space
+  component of the Ewald summation by spreading the charges onto a grid with
+  cardinal B-splines, computing the structure factor by a fast Fourier
+  transform and then convoluting with the influence function.
+  See https://doi.org/10.1063/1.470117 .
+
+  This is used in place of Ewald, along with ChargeScreened,
+  ChargeScreenedIntra and ChargeSelf.
+  The energy is
+
+  \f$U = \sum_{\vec{m}\neq 0} G(\vec{m}) |\hat{Q}(\vec{m})|^2\f$
+
+  where \f$\hat{Q}\f$ is the discrete Fourier transform of the charge grid
+  and the influence function is
+
+  \f$G(\vec{m}) = \frac{2\pi}{V k^2} e^{-k^2/4\alpha^2} B(\vec{m})\f$
+
+  with the B-spline moduli, \f$B\f$.
+
+  Equivalently, \f$U = \sum_{r,r'} Q(r) \phi(r - r') Q(r')\f$, where
+  \f$\phi\f$ is the inverse transform of the influence function.
+  The potential on the grid, \f$\Phi = \phi * Q\f$, is stored.
+  Perturbations of a few sites change the charge grid only locally, by
+  \f$\Delta Q\f$, so that the change in energy,
+
+  \f$\Delta U = 2\sum_r \Delta Q(r) \Phi(r) +
+    \sum_{r,r'} \Delta Q(r) \phi(r - r') \Delta Q(r')\f$,
+
+  does not require a Fourier transform.
+  Once the perturbation is finalized, the potential on the grid is updated
+  with a fast Fourier transform.
+
+  Selections follow the same trial states as described in Ewald::compute.
+
+  Only orthorhombic domains in three dimensions are supported.
+ */
+class ParticleMeshEwald : public VisitModel {
+ public:
+  //@{
+  /** @name Arguments
+    - alpha: the alpha parameter in units of inverse length.
+    - num_mesh: number of grid points in each dimension.
+      If -1 (default), use mesh_spacing.
+    - mesh_spacing: the maximum spacing between grid points, for which the
+      number of grid points in each dimension is the smallest power of two
+      (default: 1).
+    - order: order of the B-splines (default: 4).
+   */
+  explicit ParticleMeshEwald(argtype args = argtype());
+  explicit ParticleMeshEwald(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Return the number of grid points in a dimension.
+  int num_mesh(const int dimension) const { return num_mesh_[dimension]; }
+
+  /// Return the order of the B-splines.
+  int order() const { return order_; }
+
+  /// Return the charge on the grid.
+  const std::vector<double>& charge_grid() const { return data_.dble_2D()[0]; }
+
+  /// Return the potential on the grid.
+  const std::vector<double>& potential_grid() const {
+    return data_.dble_2D()[1]; }
+
+  /// Set the alpha parameter and the number of grid points.
+  void precompute(Configuration * config) override;
+
+  /// Compute the energy from scratch.
+  void compute(
+      ModelOneBody * model,
+      const ModelParams& model_params,
+      Configuration * config,
+      const int group_index = 0) override;
+
+  /// Compute the energy of a perturbation from the change in the charge
+  /// grid.
+  void compute(
+      ModelOneBody * model,
+      const ModelParams& model_params,
+      const Select& selection,
+      Configuration * config,
+      const int group_index) override;
+
+  void finalize(const Select& select, Configuration * config) override;
+
+  void check(const Configuration& config) const override;
+  void synchronize_(const VisitModel& visit, const Select& perturbed) override;
+
+  std::shared_ptr<VisitModel> create(std::istream& istr) const override {
+    return std::make_shared<ParticleMeshEwald>(istr); }
+  std::shared_ptr<VisitModel> create(argtype * args) const override {
+    return std::make_shared<ParticleMeshEwald>(args); }
+  explicit ParticleMeshEwald(std::istream& istr);
+  void serialize(std::ostream& ostr) const override;
+
+  //@}
+ private:
+  double alpha_;
+  int num_mesh_arg_;
+  double mesh_spacing_;
+  int order_;
+  std::vector<int> num_mesh_;
+  std::vector<double> side_lengths_;
+  std::vector<double> influence_, kernel_;
+
+  // synchronization data
+  double stored_energy_() const { return data_.dble_1D()[0]; }
+  std::vector<double> * charge_grid_() { return &(*data_.get_dble_2D())[0]; }
+  std::vector<double> * potential_grid_() {
+    return &(*data_.get_dble_2D())[1]; }
+
+  // temporary
+  std::vector<int> delta_index_;
+  std::vector<double> delta_charge_;
+  std::vector<std::pair<int, double> > delta_sorted_;
+  std::vector<double> charge_grid_new_, potential_grid_new_;
+  std::vector<double> side_lengths_new_, influence_new_, kernel_new_;
+  std::vector<int> delta_grid_;
+  std::vector<double> delta_merged_;
+  std::vector<std::complex<double> > fourier_;
+  double stored_energy_new_ = 0.;
+  bool finalizable_ = false;
+  bool is_full_new_ = false;
+  bool is_influence_new_ = false;
+
+  int num_points_() const;
+  void update_influence_(const Domain& domain,
+    std::vector<double> * influence,
+    std::vector<double> * kernel,
+    std::vector<std::complex<double> > * fourier) const;
+  void spread_(const Select& selection, const Configuration& config,
+    const double sign,
+    std::vector<int> * index,
+    std::vector<double> * charge) const;
+  double potential_(const std::vector<double>& charge_grid,
+    const std::vector<double>& influence,
+    std::vector<double> * potential_grid,
+    std::vector<std::complex<double> > * fourier) const;
+  double delta_energy_();
+};
+
+inline std::shared_ptr<ParticleMeshEwald> MakeParticleMeshEwald(
+    argtype args = argtype()) {
+  return std::make_shared<ParticleMeshEwald>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_CHARGE_PARTICLE_MESH_EWALD_H_
@@ -14,7 +14,7 @@
 namespace feasst {
 
 Ewald::Ewald(argtype args) : Ewald(&args) { feasst_check_all_used(args); }
-Ewald::Ewald(argtype * args) {
+Ewald::Ewald(argtype * args) : VisitModel(args) {
   class_name_ = "Ewald";
   if (used("tolerance", *args)) {
     tolerance_ = std::make_shared<double>(dble("tolerance", args));
@@ -178,6 +178,7 @@ void Ewald::precompute(Configuration * config) {
   update_kmax_squared_(*config, &kmax_squared_);
   update_wave_vectors(*config, kmax_squared_, &wave_prefactor_, &wave_num_,
                       &ux_, &uy_, &uz_, &vy_, &vz_, &wz_);
+  update_runs_(wave_num_, &runs_);
   struct_fact_real_()->resize(wave_prefactor_.size());
   struct_fact_imag_()->resize(wave_prefactor_.size());
   resize_struct_fact_new_(wave_prefactor_.size());
@@ -186,33 +187,69 @@ void Ewald::precompute(Configuration * config) {
 }
 
 void Ewald::resize_eik_(const Configuration& config) {
-  int num_p = config.particles().num();
-  int extra = num_p - eik().size();
-  if (extra > 0) {
-    eik_()->resize(eik_()->size() + extra);
-    for (int lastp = num_p - extra; lastp < num_p; ++lastp) {
-      const int num_sites = config.particles().particle(lastp).num_sites();
-      (*eik_())[lastp].resize(num_sites);
-      for (int site = 0; site < num_sites; ++site) {
-        (*eik_())[lastp][site].resize(2*(num_kx_ + num_ky_ + num_kz_));
-      }
+  const int num_p = config.particles().num();
+  const int old_num_p = static_cast<int>(eik().size());
+  if (num_p > old_num_p) {
+    eik_()->resize(num_p);
+    for (int part = old_num_p; part < num_p; ++part) {
+      const int num_sites = config.particles().particle(part).num_sites();
+      (*eik_())[part].resize(num_sites*num_eik());
+    }
+  }
+}
+
+void Ewald::resize_eik_(const std::vector<std::vector<double> >& eik2) {
+  const int num_p = static_cast<int>(eik2.size());
+  const int old_num_p = static_cast<int>(eik().size());
+  if (num_p > old_num_p) {
+    eik_()->resize(num_p);
+    for (int part = old_num_p; part < num_p; ++part) {
+      (*eik_())[part].resize(eik2[part].size());
     }
   }
 }
 
-void Ewald::resize_eik_(
-  const std::vector<std::vector<std::vector<double> > >& eik2) {
-  int num_p = static_cast<int>(eik2.size());
-  int extra = num_p - eik().size();
-  if (extra > 0) {
-    eik_()->resize(eik_()->size() + extra);
-    for (int lastp = num_p - extra; lastp < num_p; ++lastp) {
-      const int num_sites = static_cast<int>(eik2[lastp].size());
-      (*eik_())[lastp].resize(num_sites);
-      for (int site = 0; site < num_sites; ++site) {
-        (*eik_())[lastp][site].resize(2*(num_kx_ + num_ky_ + num_kz_));
+void Ewald::update_runs_(const std::vector<int>& wave_num,
+                         std::vector<int> * runs) const {
+  runs->clear();
+  const int num_vectors = static_cast<int>(wave_num.size())/dimension_;
+  for (int k_index = 0; k_index < num_vectors; ++k_index) {
+    const int kdim = dimension_*k_index;
+    const int kx = wave_num[kdim];
+    const int ky = wave_num[kdim + 1];
+    const int kz = wave_num[kdim + 2];
+    const int num_runs = static_cast<int>(runs->size())/5;
+    if (num_runs > 0) {
+      int * last = &(*runs)[5*(num_runs - 1)];
+      if (last[1] == k_index && last[2] == kx && last[3] == ky &&
+          last[4] + k_index - last[0] == kz) {
+        ++last[1];
+        continue;
       }
     }
+    runs->insert(runs->end(), {k_index, k_index + 1, kx, ky, kz});
+  }
+}
+
+// Fill e^{ikr} for k = 0, ..., kmax by recursion of the complex product.
+// If mirror, also fill e^{-ikr} at negative offsets.
+static void eik_multiples(const double kr, const int kmax, const bool mirror,
+    double * real, double * imag) {
+  real[0] = 1.;
+  imag[0] = 0.;
+  if (kmax > 0) {
+    real[1] = std::cos(kr);
+    imag[1] = std::sin(kr);
+  }
+  for (int k = 2; k <= kmax; ++k) {
+    real[k] = real[k - 1]*real[1] - imag[k - 1]*imag[1];
+    imag[k] = real[k - 1]*imag[1] + imag[k - 1]*real[1];
+  }
+  if (mirror) {
+    for (int k = 1; k <= kmax; ++k) {
+      real[-k] = real[k];
+      imag[-k] = -imag[k];
+    }
   }
 }
 
@@ -224,174 +261,173 @@ void Ewald::update_struct_fact_eik(const Select& selection,
     const double vy, const double vz, const double wz,
     std::vector<double> * sf_real,
     std::vector<double> * sf_imag,
-    std::vector<std::vector<std::vector<double> > > * eik_new) const {
-  ASSERT(charge_index() != -1,
-    "The particle does not have charge as a Site Property");
-  DEBUG("select " << selection.str());
-//  ASSERT(sf_real->size() == struct_fact_real().size(),
-//    "While struct_fact_real_ is of size: " << struct_fact_real().size() <<
-//    " struct_fact_real is of size: " << sf_real->size());
-  std::stringstream ss;
-//  const Domain& domain = config.domain();
-//  const double lx = domain.side_length(0);
-//  const double ly = domain.side_length(1);
-//  const double lz = domain.side_length(2);
-//  const double xy = domain.xy();
-//  const double xz = domain.xz();
-//  const double yz = domain.yz();
-//  const double twopilx = 2.*PI/lx,
-//               twopily = 2.*PI/ly,
-//               twopilz = 2.*PI/lz;
-  const int state = selection.trial_state();
-
-  // resize eik_new
-  {
-    int num_p = selection.num_particles();
-    int extra = num_p - eik_new->size();
-    if (extra > 0) {
-      eik_new->resize(eik_new->size() + extra);
-      for (int lastp = num_p - extra; lastp < num_p; ++lastp) {
-        const int num_sites = selection.num_sites(lastp);
-        (*eik_new)[lastp].resize(num_sites);
-        for (int site = 0; site < num_sites; ++site) {
-          (*eik_new)[lastp][site].resize(2*(num_kx_ + num_ky_ + num_kz_));
-        }
-      }
-    }
+    std::vector<double> * eik_new) const {
+  ASSERT(dimension_*wave_prefactor.size() == wave_num.size(),
+    "wave_prefactor and wave_num are inconsistent");
+  std::vector<int> runs;
+  update_runs_(wave_num, &runs);
+  update_struct_fact_eik_(selection, config, runs, ux, uy, uz, vy, vz, wz,
+                          sf_real, sf_imag, eik_new);
+}
 
-    // check size of sites in each particle
-    for (int p = 0; p < num_p; ++p) {
-      int num_sites = selection.num_sites(p);
-      int extra_s = num_sites - static_cast<int>((*eik_new)[p].size());
-      if (extra_s > 0) {
-        (*eik_new)[p].resize(num_sites);
-        for (int lasts = num_sites - extra_s; lasts < num_sites; ++lasts) {
-          (*eik_new)[p][lasts].resize(2*(num_kx_ + num_ky_ + num_kz_));
-        }
-      }
+void Ewald::update_struct_fact_eik_(const Select& selection,
+    const Configuration&  config,
+    const std::vector<int>& runs,
+    const double ux, const double uy, const double uz,
+    const double vy, const double vz, const double wz,
+    std::vector<double> * sf_real,
+    std::vector<double> * sf_imag,
+    std::vector<double> * eik_new) const {
+  // the eik of the selection are stored contiguously, in order of the sites
+  if (is_new_(selection)) {
+    const int num_sites = selection.num_sites();
+    if (static_cast<int>(eik_new->size()) < num_sites*num_eik()) {
+      eik_new->resize(num_sites*num_eik());
     }
   }
+  update_struct_fact_eik_(selection, config, runs, ux, uy, uz, vy, vz, wz,
+    0, selection.num_particles(), 0, sf_real, sf_imag, eik_new);
+}
+
+bool Ewald::is_new_(const Select& selection) const {
+  const int state = selection.trial_state();
+  return state != 0 && state != 2;
+}
 
-  for (int select_index = 0;
-       select_index < selection.num_particles();
+void Ewald::update_struct_fact_eik_(const Select& selection,
+    const Configuration&  config,
+    const std::vector<int>& runs,
+    const double ux, const double uy, const double uz,
+    const double vy, const double vz, const double wz,
+    const int first_select_index,
+    const int last_select_index,
+    const int first_select_site,
+    std::vector<double> * sf_real,
+    std::vector<double> * sf_imag,
+    std::vector<double> * eik_new) const {
+  ASSERT(charge_index() != -1,
+    "The particle does not have charge as a Site Property");
+  DEBUG("select " << selection.str());
+  const bool is_new = is_new_(selection);
+  const int neik = num_eik();
+  const int eikrx0_index = 0;
+  const int eikry0_index = eikrx0_index + kxmax_ + kymax_ + 1;
+  const int eikrz0_index = eikry0_index + kymax_ + kzmax_ + 1;
+  const int eikix0_index = eikrz0_index + kzmax_ + 1;
+  const int eikiy0_index = eikix0_index + kxmax_ + kymax_ + 1;
+  const int eikiz0_index = eikiy0_index + kymax_ + kzmax_ + 1;
+  TRACE(eikrx0_index << " " << eikry0_index << " " << eikrz0_index << " "
+    << eikix0_index << " " << eikiy0_index << " " << eikiz0_index);
+  const int num_runs = static_cast<int>(runs.size())/5;
+  double * sfr = sf_real->data();
+  double * sfi = sf_imag->data();
+  int select_site = first_select_site;
+  for (int select_index = first_select_index;
+       select_index < last_select_index;
        ++select_index) {
     const int part_index = selection.particle_index(select_index);
     const double struct_sign = sign_(selection, select_index);
-    for (int ss_index = 0; ss_index < selection.num_sites(select_index); ++ss_index) {
+    const Particle& part = config.select_particle(part_index);
+    for (int ss_index = 0; ss_index < selection.num_sites(select_index);
+         ++ss_index, ++select_site) {
       const int site_index = selection.site_index(select_index, ss_index);
-      const Site& site = config.select_particle(part_index).site(site_index);
+      const Site& site = part.site(site_index);
       if (site.is_physical()) {
-        const int eikrx0_index = 0.;
-        const int eikry0_index = eikrx0_index + kxmax_ + kymax_ + 1;//num_kx_ + kmax_;
-        const int eikrz0_index = eikry0_index + kymax_ + kzmax_ + 1;//num_ky_;
-        const int eikix0_index = eikrz0_index + kzmax_ + 1;//num_kx_ + num_ky_ + num_kz_;
-        const int eikiy0_index = eikix0_index + kxmax_ + kymax_ + 1;//num_kx_ + kmax_;
-        const int eikiz0_index = eikiy0_index + kymax_ + kzmax_ + 1;//num_ky_;
-        TRACE(eikrx0_index << " " << eikry0_index << " " << eikrz0_index << " "
-          << eikix0_index << " " << eikiy0_index << " " << eikiz0_index);
-        const std::vector<double> * const_eikn;
-
-        // update the eik of the selection
-        if (state == 0 || state == 2) {
-          const_eikn = const_cast<const std::vector<double>*>(
-            &(eik()[part_index][site_index]));
-        } else {
-          std::vector<double> * eikn = &(*eik_new)[select_index][ss_index];
-          const_eikn = const_cast<std::vector<double>*>(eikn);
-          (*eikn)[eikrx0_index] = 1.;
-          (*eikn)[eikix0_index] = 0.;
-          (*eikn)[eikry0_index] = 1.;
-          (*eikn)[eikiy0_index] = 0.;
-          (*eikn)[eikrz0_index] = 1.;
-          (*eikn)[eikiz0_index] = 0.;
-
-          // calculate eik of kx = +/-1 explicitly
-          const std::vector<double>& pos = config.select_particle(part_index).site(site_index).position().coord();
+        const double * site_eik;
+        if (is_new) {
+          double * eikn = eik_new->data() + select_site*neik;
+          const std::vector<double>& pos = site.position().coord();
           const double x = pos[0];
           const double y = pos[1];
           const double z = pos[2];
-          //const double udotr = 2.*PI*(x/lx - y*xy/lx/ly + z*(xy*yz/lx/ly/lz - xz/lx/lz));
-          const double udotr = ux*x + uy*y + uz*z;
-          //const double vdotr = 2.*PI*(y/ly - z*yz/ly/lz);
-          const double vdotr = vy*y + vz*z;
-          //const double wdotr = 2.*PI*z/lz;
-          const double wdotr = wz*z;
-          (*eikn)[eikrx0_index + 1] = std::cos(udotr);
-          (*eikn)[eikix0_index + 1] = std::sin(udotr);
-          (*eikn)[eikry0_index + 1] = std::cos(vdotr);
-          (*eikn)[eikiy0_index + 1] = std::sin(vdotr);
-          (*eikn)[eikrz0_index + 1] = std::cos(wdotr);
-          (*eikn)[eikiz0_index + 1] = std::sin(wdotr);
-          (*eikn)[eikry0_index - 1] = (*eikn)[eikry0_index + 1];
-          (*eikn)[eikiy0_index - 1] = -(*eikn)[eikiy0_index + 1];
-          (*eikn)[eikrz0_index - 1] = (*eikn)[eikrz0_index + 1];
-          (*eikn)[eikiz0_index - 1] = -(*eikn)[eikiz0_index + 1];
-
-          // compute remaining eik by recursion
-          for (int kx = 2; kx <= kxmax_; ++kx) {
-            const double eikr2 = (*eikn)[eikrx0_index + kx - 1]*(*eikn)[eikrx0_index + 1] -
-              (*eikn)[eikix0_index + kx - 1]*(*eikn)[eikix0_index + 1];
-            (*eikn)[eikrx0_index + kx] = eikr2;
-            const double eiki2 = (*eikn)[eikrx0_index + kx - 1]*(*eikn)[eikix0_index + 1] +
-              (*eikn)[eikix0_index + kx - 1]*(*eikn)[eikrx0_index + 1];
-            (*eikn)[eikix0_index + kx] = eiki2;
-          }
-          for (int ky = 2; ky <= kymax_; ++ky) {
-            const double eikr2 = (*eikn)[eikry0_index + ky - 1]*(*eikn)[eikry0_index + 1] -
-              (*eikn)[eikiy0_index + ky - 1]*(*eikn)[eikiy0_index + 1];
-            (*eikn)[eikry0_index + ky] = eikr2;
-            const double eiki2 = (*eikn)[eikry0_index + ky - 1]*(*eikn)[eikiy0_index + 1] +
-              (*eikn)[eikiy0_index + ky - 1]*(*eikn)[eikry0_index + 1];
-            (*eikn)[eikiy0_index + ky] = eiki2;
-            (*eikn)[eikry0_index - ky] = eikr2;
-            (*eikn)[eikiy0_index - ky] = -eiki2;
-          }
-          for (int kz = 2; kz <= kzmax_; ++kz) {
-            const double eikr2 = (*eikn)[eikrz0_index + kz - 1]*(*eikn)[eikrz0_index + 1] -
-              (*eikn)[eikiz0_index + kz - 1]*(*eikn)[eikiz0_index + 1];
-            (*eikn)[eikrz0_index + kz] = eikr2;
-            const double eiki2 = (*eikn)[eikrz0_index + kz - 1]*(*eikn)[eikiz0_index + 1] +
-              (*eikn)[eikiz0_index + kz - 1]*(*eikn)[eikrz0_index + 1];
-            (*eikn)[eikiz0_index + kz] = eiki2;
-            (*eikn)[eikrz0_index - kz] = eikr2;
-            (*eikn)[eikiz0_index - kz] = -eiki2;
-          }
+          eik_multiples(ux*x + uy*y + uz*z, kxmax_, false,
+                        eikn + eikrx0_index, eikn + eikix0_index);
+          eik_multiples(vy*y + vz*z, kymax_, true,
+                        eikn + eikry0_index, eikn + eikiy0_index);
+          eik_multiples(wz*z, kzmax_, true,
+                        eikn + eikrz0_index, eikn + eikiz0_index);
+          site_eik = eikn;
+        } else {
+          site_eik = eik()[part_index].data() + site_index*neik;
         }
 
         // compute structure factor
+        // For each run of wave vectors with the same kx and ky, and
+        // consecutive kz, the product of the x and y terms is constant.
         const int type = site.type();
-        const double charge = config.model_params().select(charge_index()).value(type);
-        for (int k_index = 0; k_index < static_cast<int>(wave_prefactor.size()); ++k_index) {
-          const int kdim = dimension_*k_index;
-          const double kx = wave_num[kdim];
-          const double ky = wave_num[kdim + 1];
-          const double kz = wave_num[kdim + 2];
-          TRACE("k " << k_index << " kx " << kx << " ky " << ky << " kz " << kz << " size " << wave_prefactor.size() << " kdim " << kdim);
-          const double eikrx = (*const_eikn)[eikrx0_index + kx];
-          const double eikix = (*const_eikn)[eikix0_index + kx];
-          const double eikry = (*const_eikn)[eikry0_index + ky];
-          const double eikiy = (*const_eikn)[eikiy0_index + ky];
-          const double eikrz = (*const_eikn)[eikrz0_index + kz];
-          const double eikiz = (*const_eikn)[eikiz0_index + kz];
-          TRACE("eik[r,i]x " << eikrx << " " << eikix << " y " << eikry << " " << eikiy << " z " << eikrz << " " << eikiz << " sz " << const_eikn->size());
-          const double eikr = eikrx*eikry*eikrz
-                     - eikix*eikiy*eikrz
-                     - eikix*eikry*eikiz
-                     - eikrx*eikiy*eikiz;
-          const double eiki = -eikix*eikiy*eikiz
-                     + eikrx*eikry*eikiz
-                     + eikrx*eikiy*eikrz
-                     + eikix*eikry*eikrz;
-          TRACE("charge " << charge << " eikr " << eikr << " eiki " << eiki << " sign " << struct_sign);
-          TRACE(sf_real->size());
-          (*sf_real)[k_index] += struct_sign*charge*eikr;
-          (*sf_imag)[k_index] += struct_sign*charge*eiki;
+        const double charge =
+          config.model_params().select(charge_index()).value(type);
+        const double qsign = struct_sign*charge;
+        const double * eikrz = site_eik + eikrz0_index;
+        const double * eikiz = site_eik + eikiz0_index;
+        for (int run = 0; run < num_runs; ++run) {
+          const int * r = &runs[5*run];
+          const int kbegin = r[0];
+          const int kend = r[1];
+          const double eikrx = site_eik[eikrx0_index + r[2]];
+          const double eikix = site_eik[eikix0_index + r[2]];
+          const double eikry = site_eik[eikry0_index + r[3]];
+          const double eikiy = site_eik[eikiy0_index + r[3]];
+          const double xyr = qsign*(eikrx*eikry - eikix*eikiy);
+          const double xyi = qsign*(eikrx*eikiy + eikix*eikry);
+          const double * zr = eikrz + r[4] - kbegin;
+          const double * zi = eikiz + r[4] - kbegin;
+          #pragma omp simd
+          for (int k = kbegin; k < kend; ++k) {
+            sfr[k] += xyr*zr[k] - xyi*zi[k];
+            sfi[k] += xyr*zi[k] + xyi*zr[k];
+          }
         }
       }
     }
   }
 }
 
+void Ewald::update_struct_fact_threads_(const Select& selection,
+    const Configuration& config,
+    const int num_threads) {
+  const int num_particles = selection.num_particles();
+  const int num_vectors = static_cast<int>(struct_fact_real_new_.size());
+  if (is_new_(selection)) {
+    const int num_sites = selection.num_sites();
+    if (static_cast<int>(eik_new_.size()) < num_sites*num_eik()) {
+      eik_new_.resize(num_sites*num_eik());
+    }
+  }
+
+  // each thread computes a contiguous range of particles, beginning with the
+  // site index of the first particle in its range.
+  std::vector<int> first_site(num_particles + 1, 0);
+  for (int select_index = 0; select_index < num_particles; ++select_index) {
+    first_site[select_index + 1] = first_site[select_index] +
+      selection.num_sites(select_index);
+  }
+  thread_sf_real_.resize(num_threads);
+  thread_sf_imag_.resize(num_threads);
+  #pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+  for (int thread = 0; thread < num_threads; ++thread) {
+    std::vector<double> * sf_real = &thread_sf_real_[thread];
+    std::vector<double> * sf_imag = &thread_sf_imag_[thread];
+    sf_real->assign(num_vectors, 0.);
+    sf_imag->assign(num_vectors, 0.);
+    const int first = num_particles*thread/num_threads;
+    const int last = num_particles*(thread + 1)/num_threads;
+    update_struct_fact_eik_(selection, config, runs_new_,
+      ux_new_, uy_new_, uz_new_, vy_new_, vz_new_, wz_new_,
+      first, last, first_site[first], sf_real, sf_imag, &eik_new_);
+  }
+
+  // sum in order of the threads for reproducibility
+  for (int thread = 0; thread < num_threads; ++thread) {
+    const std::vector<double>& sf_real = thread_sf_real_[thread];
+    const std::vector<double>& sf_imag = thread_sf_imag_[thread];
+    for (int k = 0; k < num_vectors; ++k) {
+      struct_fact_real_new_[k] += sf_real[k];
+      struct_fact_imag_new_[k] += sf_imag[k];
+    }
+  }
+}
+
 class MapEwald {
  public:
   MapEwald() {
@@ -404,7 +440,7 @@ static MapEwald mapper_ = MapEwald();
 void Ewald::serialize(std::ostream& ostr) const {
   ostr << class_name_ << " ";
   serialize_visit_model_(ostr);
-  feasst_serialize_version(319, ostr);
+  feasst_serialize_version(320, ostr);
   feasst_serialize_sp(tolerance_, ostr);
   feasst_serialize_sp(tolerance_num_sites_, ostr);
   feasst_serialize_sp(alpha_arg_, ostr);
@@ -434,7 +470,7 @@ void Ewald::serialize(std::ostream& ostr) const {
 
 Ewald::Ewald(std::istream& istr) : VisitModel(istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(319 == version, version);
+  ASSERT(version >= 319 && version <= 320, version);
 //  feasst_deserialize(tolerance_, istr);
 //  feasst_deserialize(alpha_arg_, istr);
   double value;
@@ -496,6 +532,20 @@ Ewald::Ewald(std::istream& istr) : VisitModel(istr) {
   feasst_deserialize(&wz_, istr);
   feasst_deserialize(&struct_fact_real_new_, istr);
   feasst_deserialize(&struct_fact_imag_new_, istr);
+  if (version < 320) {
+    // convert eik[particle][site][eik_index] to eik[particle][eik_index]
+    std::vector<std::vector<std::vector<double> > > * eik3 =
+      manual_data_.get_dble_3D();
+    eik_()->resize(eik3->size());
+    for (int part = 0; part < static_cast<int>(eik3->size()); ++part) {
+      for (const std::vector<double>& site_eik : (*eik3)[part]) {
+        (*eik_())[part].insert((*eik_())[part].end(), site_eik.begin(),
+                               site_eik.end());
+      }
+    }
+    eik3->clear();
+  }
+  update_runs_(wave_num_, &runs_);
 }
 
 class SumCharge : public LoopConfigOneBody {
@@ -532,21 +582,28 @@ void Ewald::compute(
   update_wave_vectors(*config, kmax_squared_new_, &wave_prefactor_new_,
                       &wave_num_new_, &ux_new_, &uy_new_, &uz_new_,
                       &vy_new_, &vz_new_, &wz_new_);
+  update_runs_(wave_num_new_, &runs_new_);
   resize_struct_fact_new_(wave_prefactor_new_.size());
-  update_struct_fact_eik(config->group_select(group_index), *config,
-                         wave_prefactor_new_,
-                         wave_num_new_,
-                         ux_new_, uy_new_, uz_new_,
-                         vy_new_, vz_new_, wz_new_,
-                         &struct_fact_real_new_,
-                         &struct_fact_imag_new_,
-                         &eik_new_);
+  const Select& selection = config->group_select(group_index);
+  const int num_threads = init_threads_(config->domain());
+  if (num_threads == 1) {
+    update_struct_fact_eik_(selection, *config,
+                           runs_new_,
+                           ux_new_, uy_new_, uz_new_,
+                           vy_new_, vz_new_, wz_new_,
+                           &struct_fact_real_new_,
+                           &struct_fact_imag_new_,
+                           &eik_new_);
+  } else {
+    update_struct_fact_threads_(selection, *config, num_threads);
+  }
   const double conversion = model_params.constants().charge_conversion();
   stored_energy_new_ = conversion*fourier_energy_(struct_fact_real_new_,
                                                   struct_fact_imag_new_,
                                                   wave_prefactor_new_);
   DEBUG("stored_energy_ " << stored_energy_new_);
   set_energy(stored_energy_new_);
+  num_sites_new_ = is_new_(selection) ? selection.num_sites() : 0;
   finalizable_ = true;
 }
 
@@ -581,8 +638,8 @@ void Ewald::compute(
   }
   resize_eik_(*config);
   DEBUG("old struct fact " << struct_fact_real_new_[0]);
-  update_struct_fact_eik(selection, *config,
-    wave_prefactor_, wave_num_, ux_, uy_, uz_, vy_, vz_, wz_,
+  update_struct_fact_eik_(selection, *config,
+    runs_, ux_, uy_, uz_, vy_, vz_, wz_,
     &struct_fact_real_new_, &struct_fact_imag_new_, &eik_new_);
   DEBUG("updated struct fact " << struct_fact_real_new_[0]);
 
@@ -610,6 +667,7 @@ void Ewald::compute(
   DEBUG("stored_energy_ " << stored_energy() << " "
        "stored_energy_new_ " << stored_energy_new_);
   set_energy(enrg);
+  num_sites_new_ = is_new_(selection) ? selection.num_sites() : 0;
   finalizable_ = true;
 }
 
@@ -631,16 +689,28 @@ void Ewald::finalize(const Select& select, Configuration * config) {
 
     // update eik using eik_new
     DEBUG(select.trial_state());
-    if (select.trial_state() != 2) {
+    // A trial replayed from the cache of another copy, as in Prefetch, did
+    // not compute eik_new, and instead the eik are synchronized.
+    if (select.trial_state() != 2 && num_sites_new_ == select.num_sites()) {
+      const int neik = num_eik();
+      ASSERT(static_cast<int>(eik_new_.size()) >= num_sites_new_*neik,
+        "eik_new size: " << eik_new_.size() << " < " << num_sites_new_*neik);
+      std::vector<double>::const_iterator eik_new = eik_new_.begin();
       for (int ipart = 0; ipart < select.num_particles(); ++ipart) {
         const int part_index = select.particle_index(ipart);
+        TRACE("part_index " << part_index << " sz " << (*eik_()).size());
+        std::vector<double> * part_eik = &(*eik_())[part_index];
+        // the particle may have been resized by another copy, or its index
+        // reused by a particle of another type.
+        const int size = config->select_particle(part_index).num_sites()*neik;
+        if (static_cast<int>(part_eik->size()) != size) {
+          part_eik->resize(size);
+        }
         for (int isite = 0; isite < select.num_sites(ipart); ++isite) {
           const int site_index = select.site_index(ipart, isite);
-          const std::vector<double>& eik_new = eik_new_[ipart][isite];
-          for (int k = 0; k < static_cast<int>(eik_new.size()); ++k) {
-            TRACE("part_index " << part_index << " sz " << (*eik_()).size());
-            (*eik_())[part_index][site_index][k] = eik_new[k];
-          }
+          std::copy(eik_new, eik_new + neik,
+                    part_eik->begin() + site_index*neik);
+          eik_new += neik;
         }
       }
     }
@@ -648,6 +718,7 @@ void Ewald::finalize(const Select& select, Configuration * config) {
     if (select.trial_state() == 4) {
       wave_prefactor_ = wave_prefactor_new_;
       wave_num_ = wave_num_new_;
+      runs_ = runs_new_;
       kmax_squared_ = kmax_squared_new_;
       ux_ = ux_new_;
       uy_ = uy_new_;
@@ -693,7 +764,9 @@ double Ewald::fourier_energy_(const std::vector<double>& struct_fact_real,
                               const std::vector<double>& struct_fact_imag,
                               const std::vector<double>& wave_prefactor) {
   double en = 0;
-  for (int k = 0; k < static_cast<int>(wave_prefactor.size()); ++k) {
+  const int num_vectors = static_cast<int>(wave_prefactor.size());
+  #pragma omp simd reduction(+:en)
+  for (int k = 0; k < num_vectors; ++k) {
     en += wave_prefactor[k]*(struct_fact_real[k]*struct_fact_real[k]
                             + struct_fact_imag[k]*struct_fact_imag[k]);
   }
@@ -718,8 +791,8 @@ std::vector<double> * Ewald::struct_fact_imag_() {
   return &((*data_.get_dble_2D())[1]);
 }
 
-std::vector<std::vector<std::vector<double> > > * Ewald::eik_() {
-  return &(*manual_data_.get_dble_3D());
+std::vector<std::vector<double> > * Ewald::eik_() {
+  return manual_data_.get_dble_2D();
 }
 
 void Ewald::change_volume(const double delta_volume, const int dimension,
@@ -735,19 +808,22 @@ void Ewald::change_volume(const double delta_volume, const int dimension,
 void Ewald::synchronize_(const VisitModel& visit, const Select& select) {
   VisitModel::synchronize_(visit, select);
   DEBUG("select " << select.str());
-  resize_eik_(visit.manual_data().dble_3D());
+  const std::vector<std::vector<double> >& eik2 = visit.manual_data().dble_2D();
+  resize_eik_(eik2);
+  const int neik = num_eik();
   for (int ipart = 0; ipart < select.num_particles(); ++ipart) {
     const int part_index = select.particle_index(ipart);
+    ASSERT(part_index < static_cast<int>((*eik_()).size()),
+      "part_index: " << part_index << " >= size: " << (*eik_()).size());
+    const std::vector<double>& part_eik2 = eik2[part_index];
+    std::vector<double> * part_eik = &(*eik_())[part_index];
+    if (part_eik->size() < part_eik2.size()) {
+      part_eik->resize(part_eik2.size());
+    }
     for (int isite = 0; isite < select.num_sites(ipart); ++isite) {
-      const int site_index = select.site_index(ipart, isite);
-      const std::vector<double>& eik_new =
-        visit.manual_data().dble_3D()[part_index][site_index];
-      for (int k = 0; k < static_cast<int>(eik_new.size()); ++k) {
-        //DEBUG(part_index << " " << site_index << " " << k << " " << eik_new[k]);
-        ASSERT(part_index < static_cast<int>((*eik_()).size()),
-          "part_index: " << part_index << " >= size: " << (*eik_()).size());
-        (*eik_())[part_index][site_index][k] = eik_new[k];
-      }
+      const int begin = neik*select.site_index(ipart, isite);
+      std::copy(part_eik2.begin() + begin, part_eik2.begin() + begin + neik,
+                part_eik->begin() + begin);
     }
   }
 }
@@ -762,7 +838,7 @@ void Ewald::check(const Configuration& config) const {
   update_wave_vectors(config, kmax_squared, &wavep, &waven, &ux, &uy, &uz, &vy, &vz, &wz);
   std::vector<double> sf_real(wavep.size());
   std::vector<double> sf_imag(wavep.size());
-  std::vector<std::vector<std::vector<double> > > eikn;
+  std::vector<double> eikn;
   const Select& sel = config.selection_of_all();
   DEBUG("sel " << sel.str());
   update_struct_fact_eik(sel, config, wavep, waven, ux, uy, uz, vy, vz, wz,
@@ -829,13 +905,26 @@ void Ewald::check(const Configuration& config) const {
       }
     }
   }
+  const int neik = num_eik();
+  int select_site = 0;
   for (int sp = 0; sp < sel.num_particles(); ++sp) {
     const int part = sel.particle_index(sp);
-    if (!is_equal(eikn[sp], eik()[part], tolerance)) {
-      ss << "part " << part << " sp " << sp
-         << " eikn " << feasst_str(eikn[sp])
-         << " eik " << feasst_str(eik()[part])
-         << std::endl;
+    for (int ss_index = 0; ss_index < sel.num_sites(sp); ++ss_index) {
+      const int site = sel.site_index(sp, ss_index);
+      const std::vector<double> site_eikn(
+        eikn.begin() + neik*select_site,
+        eikn.begin() + neik*(select_site + 1));
+      const std::vector<double> site_eik(
+        eik()[part].begin() + neik*site,
+        eik()[part].begin() + neik*(site + 1));
+      if (config.select_particle(part).site(site).is_physical() &&
+          !is_equal(site_eikn, site_eik, tolerance)) {
+        ss << "part " << part << " site " << site
+           << " eikn " << feasst_str(site_eikn)
+           << " eik " << feasst_str(site_eik)
+           << std::endl;
+      }
+      ++select_site;
     }
   }
   if (!ss.str().empty()) {
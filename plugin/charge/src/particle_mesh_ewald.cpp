@@ -0,0 +1,447 @@
+#include <cmath>
+#include <algorithm>
+#include "utils/include/arguments.h"
+#include "utils/include/serialize.h"
+#include "math/include/constants.h"
+#include "math/include/fourier_transform.h"
+#include "configuration/include/select.h"
+#include "configuration/include/particle_factory.h"
+#include "configuration/include/physical_constants.h"
+#include "configuration/include/model_params.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/configuration.h"
+#include "charge/include/particle_mesh_ewald.h"
+
+namespace feasst {
+
+ParticleMeshEwald::ParticleMeshEwald(argtype args) : ParticleMeshEwald(&args) {
+  feasst_check_all_used(args);
+}
+ParticleMeshEwald::ParticleMeshEwald(argtype * args) {
+  class_name_ = "ParticleMeshEwald";
+  alpha_ = dble("alpha", args);
+  num_mesh_arg_ = integer("num_mesh", args, -1);
+  mesh_spacing_ = dble("mesh_spacing", args, 1.);
+  order_ = integer("order", args, 4);
+  ASSERT(order_ >= 2, "order: " << order_ << " must be >= 2");
+  data_.get_dble_1D()->resize(1);
+  data_.get_dble_2D()->resize(2);
+}
+
+class MapParticleMeshEwald {
+ public:
+  MapParticleMeshEwald() {
+    auto obj = MakeParticleMeshEwald({{"alpha", "1"}});
+    obj->deserialize_map()["ParticleMeshEwald"] = obj;
+  }
+};
+
+static MapParticleMeshEwald mapper_ = MapParticleMeshEwald();
+
+void ParticleMeshEwald::serialize(std::ostream& ostr) const {
+  ostr << class_name_ << " ";
+  serialize_visit_model_(ostr);
+  feasst_serialize_version(6914, ostr);
+  feasst_serialize(alpha_, ostr);
+  feasst_serialize(num_mesh_arg_, ostr);
+  feasst_serialize(mesh_spacing_, ostr);
+  feasst_serialize(order_, ostr);
+  feasst_serialize(num_mesh_, ostr);
+  feasst_serialize(side_lengths_, ostr);
+  feasst_serialize(influence_, ostr);
+  feasst_serialize(kernel_, ostr);
+}
+
+ParticleMeshEwald::ParticleMeshEwald(std::istream& istr) : VisitModel(istr) {
+  const int version = feasst_deserialize_version(istr);
+  ASSERT(version == 6914, "mismatch version: " << version);
+  feasst_deserialize(&alpha_, istr);
+  feasst_deserialize(&num_mesh_arg_, istr);
+  feasst_deserialize(&mesh_spacing_, istr);
+  feasst_deserialize(&order_, istr);
+  feasst_deserialize(&num_mesh_, istr);
+  feasst_deserialize(&side_lengths_, istr);
+  feasst_deserialize(&influence_, istr);
+  feasst_deserialize(&kernel_, istr);
+}
+
+// Fill spline[j] = M_order(w + j), j = 0, ..., order - 1, for w in [0, 1),
+// where M_order is the cardinal B-spline.
+static void fill_bspline(const double w, const int order, double * spline) {
+  spline[0] = w;
+  spline[1] = 1. - w;
+  for (int j = 2; j < order; ++j) {
+    spline[j] = 0.;
+  }
+  for (int n = 3; n <= order; ++n) {
+    for (int j = n - 1; j >= 0; --j) {
+      const double previous = j > 0 ? spline[j - 1] : 0.;
+      spline[j] = ((w + j)*spline[j] + (n - w - j)*previous)/(n - 1);
+    }
+  }
+}
+
+int ParticleMeshEwald::num_points_() const {
+  return num_mesh_[0]*num_mesh_[1]*num_mesh_[2];
+}
+
+void ParticleMeshEwald::precompute(Configuration * config) {
+  VisitModel::precompute(config);
+  const Domain& domain = config->domain();
+  ASSERT(domain.dimension() == 3, "only implemented in 3D");
+  ASSERT(!domain.is_tilted(), "only implemented for orthorhombic domains");
+  ASSERT(charge_index() != -1,
+    "The particle does not have charge as a Site Property");
+  config->add_or_set_model_param("alpha", alpha_);
+  num_mesh_.resize(3);
+  side_lengths_.resize(3);
+  for (int dim = 0; dim < 3; ++dim) {
+    side_lengths_[dim] = domain.side_length(dim);
+    if (num_mesh_arg_ != -1) {
+      num_mesh_[dim] = num_mesh_arg_;
+    } else {
+      num_mesh_[dim] = 1;
+      while (side_lengths_[dim]/num_mesh_[dim] > mesh_spacing_) {
+        num_mesh_[dim] *= 2;
+      }
+    }
+    ASSERT(num_mesh_[dim] >= order_, "num_mesh: " << num_mesh_[dim] <<
+      " must be >= order: " << order_);
+  }
+  update_influence_(domain, &influence_, &kernel_, &fourier_);
+  charge_grid_()->assign(num_points_(), 0.);
+  potential_grid_()->assign(num_points_(), 0.);
+  INFO("num_mesh " << num_mesh_[0] << " " << num_mesh_[1] << " "
+    << num_mesh_[2]);
+}
+
+void ParticleMeshEwald::update_influence_(const Domain& domain,
+    std::vector<double> * influence,
+    std::vector<double> * kernel,
+    std::vector<std::complex<double> > * fourier) const {
+  // B-spline moduli
+  std::vector<double> spline(order_);
+  fill_bspline(0., order_, spline.data());
+  std::vector<std::vector<double> > moduli(3);
+  for (int dim = 0; dim < 3; ++dim) {
+    const int num = num_mesh_[dim];
+    moduli[dim].resize(num);
+    for (int m = 0; m < num; ++m) {
+      std::complex<double> sum;
+      for (int k = 0; k <= order_ - 2; ++k) {
+        sum += spline[k + 1]*std::exp(std::complex<double>(0.,
+          2.*PI*static_cast<double>(m*k)/static_cast<double>(num)));
+      }
+      moduli[dim][m] = 1./std::norm(sum);
+    }
+    // odd orders have zero moduli at the Nyquist frequency
+    for (int m = 0; m < num; ++m) {
+      if (std::isinf(moduli[dim][m]) || moduli[dim][m] > 1e10) {
+        moduli[dim][m] = 0.5*(moduli[dim][(m + num - 1) % num] +
+                              moduli[dim][(m + 1) % num]);
+      }
+    }
+  }
+
+  // influence function
+  const double volume = domain.volume();
+  const double alpha = alpha_;
+  influence->resize(num_points_());
+  int index = 0;
+  for (int m2 = 0; m2 < num_mesh_[2]; ++m2) {
+    const int s2 = m2 <= num_mesh_[2]/2 ? m2 : m2 - num_mesh_[2];
+    const double k2 = 2.*PI*s2/domain.side_length(2);
+    for (int m1 = 0; m1 < num_mesh_[1]; ++m1) {
+      const int s1 = m1 <= num_mesh_[1]/2 ? m1 : m1 - num_mesh_[1];
+      const double k1 = 2.*PI*s1/domain.side_length(1);
+      for (int m0 = 0; m0 < num_mesh_[0]; ++m0, ++index) {
+        const int s0 = m0 <= num_mesh_[0]/2 ? m0 : m0 - num_mesh_[0];
+        const double k0 = 2.*PI*s0/domain.side_length(0);
+        const double k_sq = k0*k0 + k1*k1 + k2*k2;
+        if (index == 0) {
+          (*influence)[index] = 0.;
+        } else {
+          (*influence)[index] = 2.*PI*std::exp(-k_sq/4./alpha/alpha)/k_sq/
+            volume*moduli[0][m0]*moduli[1][m1]*moduli[2][m2];
+        }
+      }
+    }
+  }
+
+  // kernel in real space
+  fourier->assign(influence->begin(), influence->end());
+  fourier_transform(num_mesh_, fourier, true);
+  kernel->resize(num_points_());
+  for (int point = 0; point < num_points_(); ++point) {
+    (*kernel)[point] = (*fourier)[point].real();
+  }
+}
+
+void ParticleMeshEwald::spread_(const Select& selection,
+    const Configuration& config,
+    const double sign,
+    std::vector<int> * index,
+    std::vector<double> * charge) const {
+  const int order = order_;
+  const Domain& domain = config.domain();
+  std::vector<double> spline(3*order);
+  std::vector<int> grid(3*order);
+  for (int select_index = 0;
+       select_index < selection.num_particles();
+       ++select_index) {
+    const Particle& part =
+      config.select_particle(selection.particle_index(select_index));
+    for (const int site_index : selection.site_indices(select_index)) {
+      const Site& site = part.site(site_index);
+      if (site.is_physical()) {
+        const double q = sign*config.model_params().select(
+          charge_index()).value(site.type());
+        const std::vector<double>& pos = site.position().coord();
+        for (int dim = 0; dim < 3; ++dim) {
+          const int num = num_mesh_[dim];
+          const double u = num*(pos[dim]/domain.side_length(dim) + 0.5);
+          const double floor_u = std::floor(u);
+          fill_bspline(u - floor_u, order, &spline[dim*order]);
+          const int first = static_cast<int>(floor_u);
+          for (int j = 0; j < order; ++j) {
+            grid[dim*order + j] = ((first - j) % num + num) % num;
+          }
+        }
+        for (int j2 = 0; j2 < order; ++j2) {
+          for (int j1 = 0; j1 < order; ++j1) {
+            const double q12 = q*spline[order + j1]*spline[2*order + j2];
+            const int offset = num_mesh_[0]*(grid[order + j1] +
+              num_mesh_[1]*grid[2*order + j2]);
+            for (int j0 = 0; j0 < order; ++j0) {
+              index->push_back(grid[j0] + offset);
+              charge->push_back(q12*spline[j0]);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+double ParticleMeshEwald::potential_(const std::vector<double>& charge_grid,
+    const std::vector<double>& influence,
+    std::vector<double> * potential_grid,
+    std::vector<std::complex<double> > * fourier) const {
+  fourier->assign(charge_grid.begin(), charge_grid.end());
+  fourier_transform(num_mesh_, fourier);
+  double energy = 0.;
+  for (int point = 0; point < num_points_(); ++point) {
+    energy += influence[point]*std::norm((*fourier)[point]);
+    (*fourier)[point] *= influence[point];
+  }
+  fourier_transform(num_mesh_, fourier, true);
+  potential_grid->resize(num_points_());
+  for (int point = 0; point < num_points_(); ++point) {
+    (*potential_grid)[point] = (*fourier)[point].real();
+  }
+  return energy;
+}
+
+double ParticleMeshEwald::delta_energy_() {
+  // merge the changes to the same grid points
+  delta_sorted_.resize(delta_index_.size());
+  for (int delta = 0; delta < static_cast<int>(delta_index_.size()); ++delta) {
+    delta_sorted_[delta] = std::make_pair(delta_index_[delta],
+                                          delta_charge_[delta]);
+  }
+  std::sort(delta_sorted_.begin(), delta_sorted_.end());
+  delta_grid_.clear();
+  delta_merged_.clear();
+  int last = -1;
+  for (const std::pair<int, double>& delta : delta_sorted_) {
+    if (delta.first == last) {
+      delta_merged_.back() += delta.second;
+    } else {
+      last = delta.first;
+      delta_grid_.push_back(last % num_mesh_[0]);
+      delta_grid_.push_back((last/num_mesh_[0]) % num_mesh_[1]);
+      delta_grid_.push_back(last/num_mesh_[0]/num_mesh_[1]);
+      delta_merged_.push_back(delta.second);
+    }
+  }
+
+  // interaction of the change with the potential and with itself
+  const std::vector<double>& potential = potential_grid();
+  const int num0 = num_mesh_[0], num1 = num_mesh_[1], num2 = num_mesh_[2];
+  const int num_delta = static_cast<int>(delta_merged_.size());
+  double linear = 0., quadratic = 0.;
+  for (int delta1 = 0; delta1 < num_delta; ++delta1) {
+    const int * grid1 = &delta_grid_[3*delta1];
+    linear += delta_merged_[delta1]*potential[grid1[0] + num0*(grid1[1] +
+      num1*grid1[2])];
+    double sum = 0.;
+    for (int delta2 = 0; delta2 < num_delta; ++delta2) {
+      const int * grid2 = &delta_grid_[3*delta2];
+      int diff0 = grid1[0] - grid2[0];
+      int diff1 = grid1[1] - grid2[1];
+      int diff2 = grid1[2] - grid2[2];
+      if (diff0 < 0) diff0 += num0;
+      if (diff1 < 0) diff1 += num1;
+      if (diff2 < 0) diff2 += num2;
+      sum += delta_merged_[delta2]*kernel_[diff0 + num0*(diff1 + num1*diff2)];
+    }
+    quadratic += delta_merged_[delta1]*sum;
+  }
+  return 2.*linear + quadratic;
+}
+
+void ParticleMeshEwald::compute(
+    ModelOneBody * model,
+    const ModelParams& model_params,
+    Configuration * config,
+    const int group_index) {
+  const Domain& domain = config->domain();
+  is_influence_new_ = false;
+  for (int dim = 0; dim < 3; ++dim) {
+    if (domain.side_length(dim) != side_lengths_[dim]) {
+      is_influence_new_ = true;
+    }
+  }
+  if (is_influence_new_) {
+    side_lengths_new_ = domain.side_lengths().coord();
+    update_influence_(domain, &influence_new_, &kernel_new_, &fourier_);
+  }
+  const std::vector<double>& influence =
+    is_influence_new_ ? influence_new_ : influence_;
+  delta_index_.clear();
+  delta_charge_.clear();
+  spread_(config->group_select(group_index), *config, 1., &delta_index_,
+          &delta_charge_);
+  charge_grid_new_.assign(num_points_(), 0.);
+  for (int delta = 0; delta < static_cast<int>(delta_index_.size()); ++delta) {
+    charge_grid_new_[delta_index_[delta]] += delta_charge_[delta];
+  }
+  delta_index_.clear();
+  delta_charge_.clear();
+  const double conversion = model_params.constants().charge_conversion();
+  stored_energy_new_ = conversion*potential_(charge_grid_new_, influence,
+    &potential_grid_new_, &fourier_);
+  DEBUG("stored_energy_new_ " << stored_energy_new_);
+  set_energy(stored_energy_new_);
+  finalizable_ = true;
+  is_full_new_ = true;
+}
+
+void ParticleMeshEwald::compute(
+    ModelOneBody * model,
+    const ModelParams& model_params,
+    const Select& selection,
+    Configuration * config,
+    const int group_index) {
+  ASSERT(group_index == 0, "group index cannot be varied because redundant." <<
+    "otherwise implement filtering of selection based on group.");
+  const int state = selection.trial_state();
+  DEBUG("state " << state);
+  if (state == 4) {
+    compute(model, model_params, config, group_index);
+    return;
+  }
+  ASSERT(state == 0 ||
+         state == 1 ||
+         state == 2 ||
+         state == 3,
+    "unrecognized trial_state: " << state);
+
+  // the change in the charge grid accumulates from old to new
+  if (state != 1) {
+    delta_index_.clear();
+    delta_charge_.clear();
+  }
+  const double sign = (state == 0 || state == 2) ? -1. : 1.;
+  spread_(selection, *config, sign, &delta_index_, &delta_charge_);
+  if (state != 0) {
+    const double conversion = model_params.constants().charge_conversion();
+    stored_energy_new_ = stored_energy_() + conversion*delta_energy_();
+  }
+  double enrg = 0.;
+  if (state == 0) {
+    enrg = stored_energy_();
+  } else if (state == 1) {
+    enrg = stored_energy_new_;
+  } else if (state == 2) {
+    enrg = stored_energy_() - stored_energy_new_;
+  } else if (state == 3) {
+    enrg = stored_energy_new_ - stored_energy_();
+  }
+  DEBUG("enrg: " << enrg);
+  set_energy(enrg);
+  finalizable_ = true;
+  is_full_new_ = false;
+}
+
+void ParticleMeshEwald::finalize(const Select& select, Configuration * config) {
+  VisitModel::finalize(select, config);
+  if (finalizable_) {
+    if (is_full_new_) {
+      if (is_influence_new_) {
+        side_lengths_.swap(side_lengths_new_);
+        influence_.swap(influence_new_);
+        kernel_.swap(kernel_new_);
+        is_influence_new_ = false;
+      }
+      charge_grid_()->swap(charge_grid_new_);
+      potential_grid_()->swap(potential_grid_new_);
+      (*data_.get_dble_1D())[0] = stored_energy_new_;
+    } else {
+      std::vector<double> * charge_grid = charge_grid_();
+      for (int delta = 0; delta < static_cast<int>(delta_index_.size());
+           ++delta) {
+        (*charge_grid)[delta_index_[delta]] += delta_charge_[delta];
+      }
+      const double conversion =
+        config->model_params().constants().charge_conversion();
+      (*data_.get_dble_1D())[0] = conversion*potential_(*charge_grid,
+        influence_, potential_grid_(), &fourier_);
+    }
+    delta_index_.clear();
+    delta_charge_.clear();
+    finalizable_ = false;
+  }
+}
+
+void ParticleMeshEwald::synchronize_(const VisitModel& visit,
+    const Select& perturbed) {
+  VisitModel::synchronize_(visit, perturbed);
+  const ParticleMeshEwald& pme = dynamic_cast<const ParticleMeshEwald&>(visit);
+  if (side_lengths_ != pme.side_lengths_) {
+    side_lengths_ = pme.side_lengths_;
+    influence_ = pme.influence_;
+    kernel_ = pme.kernel_;
+  }
+}
+
+void ParticleMeshEwald::check(const Configuration& config) const {
+  std::vector<int> index;
+  std::vector<double> charge;
+  spread_(config.selection_of_all(), config, 1., &index, &charge);
+  std::vector<double> grid(num_points_(), 0.), potential_grid;
+  for (int delta = 0; delta < static_cast<int>(index.size()); ++delta) {
+    grid[index[delta]] += charge[delta];
+  }
+  std::vector<std::complex<double> > fourier;
+  const double energy = config.model_params().constants().charge_conversion()*
+    potential_(grid, influence_, &potential_grid, &fourier);
+  const double tolerance = 1e-6;
+  std::stringstream ss;
+  for (int point = 0; point < num_points_(); ++point) {
+    if (std::abs(grid[point] - charge_grid()[point]) > tolerance) {
+      ss << "charge_grid(" << point << "): " << grid[point]
+         << " stored: " << charge_grid()[point] << std::endl;
+    }
+  }
+  if (std::abs(energy - stored_energy_()) >
+      tolerance*std::max(1., std::abs(energy))) {
+    ss << MAX_PRECISION << "energy: " << energy << " stored: "
+       << stored_energy_() << std::endl;
+  }
+  if (!ss.str().empty()) {
+    FATAL(ss.str());
+  }
+}
+
+}  // namespace feasst
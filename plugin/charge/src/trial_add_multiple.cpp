@@ -46,11 +46,13 @@ TrialAddMultiple::TrialAddMultiple(argtype * args) : Trial(args) {
   set(std::make_shared<ComputeAddMultiple>(args));
   const std::string reference_index = feasst::str("reference_index", args, "-1");
   const std::string num_steps = feasst::str("num_steps", args, "1");
+  const std::string num_threads = feasst::str("num_threads", args, "1");
   for (int p : pt) {
     argtype nag = *args;
     nag.insert({"particle_type", str(p)});
     nag.insert({"num_steps", num_steps});
     nag.insert({"reference_index", reference_index});
+    nag.insert({"num_threads", num_threads});
     nag.insert({"exclude_perturbed", "true"});
     new_args.push_back(nag);
   }
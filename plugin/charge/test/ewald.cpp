@@ -28,7 +28,7 @@ TEST(Ewald, ewald) {
   // ewald.update_eik(config.selection_of_all(), &config);
 
   //const std::vector<double> eik = config.particle(0).site(0).properties().values();
-  const std::vector<double>& eik = ewald->eik()[0][0];
+  const std::vector<double>& eik = ewald->eik()[0];
   EXPECT_NEAR(eik[0], 1, NEAR_ZERO);
   EXPECT_NEAR(eik[1], -0.069470287276879206, NEAR_ZERO);
   EXPECT_NEAR(eik[2], -0.99034775837133582, NEAR_ZERO);
@@ -60,6 +60,75 @@ TEST(Ewald, ewald) {
   EXPECT_NEAR(ewald2->energy(), en, 1e-12);
 }
 
+TEST(Ewald, num_threads) {
+  Configuration config = spce_sample1();
+  const std::string alpha = str(5.6/config.domain().inscribed_sphere_diameter());
+  ModelEmpty model;
+  auto ewald = MakeEwald({{"alpha", alpha}, {"kmax_squared", "27"}});
+  ewald->precompute(&config);
+  model.compute(&config, ewald.get());
+  ewald->finalize(config.selection_of_all(), &config);
+  for (const std::string num_threads : {"2", "3", "-1"}) {
+    Configuration config2 = spce_sample1();
+    auto ewald2 = MakeEwald({{"alpha", alpha}, {"kmax_squared", "27"},
+                             {"num_threads", num_threads}});
+    ewald2->precompute(&config2);
+    model.compute(&config2, ewald2.get());
+    EXPECT_NEAR(ewald->energy(), ewald2->energy(), 1e-10);
+    ewald2->finalize(config2.selection_of_all(), &config2);
+    for (int k = 0; k < static_cast<int>(ewald->struct_fact_real().size());
+         ++k) {
+      EXPECT_NEAR(ewald->struct_fact_real()[k],
+                  ewald2->struct_fact_real()[k], 1e-12);
+      EXPECT_NEAR(ewald->struct_fact_imag()[k],
+                  ewald2->struct_fact_imag()[k], 1e-12);
+    }
+    for (int part = 0; part < config.num_particles(); ++part) {
+      for (int index = 0; index < static_cast<int>(ewald->eik()[part].size());
+           ++index) {
+        EXPECT_EQ(ewald->eik()[part][index], ewald2->eik()[part][index]);
+      }
+    }
+    auto ewald3 = test_serialize<Ewald, VisitModel>(*ewald2);
+    EXPECT_EQ(ewald2->num_threads(), ewald3->num_threads());
+  }
+}
+
+// Compare the energy of single-particle moves with the full computation.
+TEST(Ewald, incremental) {
+  Configuration config = spce_sample1();
+  const argtype args = {
+    {"alpha", str(5.6/config.domain().inscribed_sphere_diameter())},
+    {"kmax_squared", "27"}};
+  Ewald ewald(args);
+  ewald.precompute(&config);
+  ModelEmpty model;
+  model.compute(&config, &ewald);
+  ewald.finalize(config.selection_of_all(), &config);
+  EXPECT_EQ(3*ewald.num_eik(), static_cast<int>(ewald.eik()[0].size()));
+  RandomMT19937 random(argtype({{"seed", "123"}}));
+  for (int trial = 0; trial < 20; ++trial) {
+    const int part = random.uniform(0, config.num_particles() - 1);
+    Select select(part, config.select_particle(part));
+    select.set_trial_state(0);
+    model.compute(select, &config, &ewald);
+    Position disp(config.dimension());
+    for (int dim = 0; dim < config.dimension(); ++dim) {
+      disp.set_coord(dim, random.uniform() - 0.5);
+    }
+    config.displace_particle(select, disp);
+    select.set_trial_state(1);
+    model.compute(select, &config, &ewald);
+    const double en = ewald.energy();
+    ewald.finalize(select, &config);
+    ewald.check(config);
+    Ewald ewald2(args);
+    ewald2.precompute(&config);
+    model.compute(&config, &ewald2);
+    EXPECT_NEAR(en, ewald2.energy(), 1e-10);
+  }
+}
+
 TEST(Ewald, system) {
   const double en_lrc = -6.84874714555147;
   {
@@ -137,14 +206,14 @@ TEST(Ewald, synchronize) {
 
   EXPECT_NEAR(s1.configuration().particle(0).site(0).position().coord(0), 0.5, NEAR_ZERO);
 //  INFO(ewald1.eik().size());
-  EXPECT_NEAR(ewald1.eik()[0][0][2], 0.95105651629515364, NEAR_ZERO);
-  EXPECT_NEAR(s1.potential(0).visit_model().manual_data().dble_3D()[0][0][2], 0.95105651629515364, NEAR_ZERO);
+  EXPECT_NEAR(ewald1.eik()[0][2], 0.95105651629515364, NEAR_ZERO);
+  EXPECT_NEAR(s1.potential(0).visit_model().manual_data().dble_2D()[0][2], 0.95105651629515364, NEAR_ZERO);
   EXPECT_NEAR(s2.configuration().particle(0).site(0).position().coord(0), 0., NEAR_ZERO);
-  EXPECT_NEAR(s2.potential(0).visit_model().manual_data().dble_3D()[0][0][2], 1, NEAR_ZERO);
+  EXPECT_NEAR(s2.potential(0).visit_model().manual_data().dble_2D()[0][2], 1, NEAR_ZERO);
   s2.synchronize_(s1, part);
   EXPECT_NEAR(s2.configuration().particle(0).site(0).position().coord(0), 0.5, NEAR_ZERO);
-  EXPECT_NEAR(s1.potential(0).visit_model().manual_data().dble_3D()[0][0][2], 0.95105651629515364, NEAR_ZERO);
-  EXPECT_NEAR(s2.potential(0).visit_model().manual_data().dble_3D()[0][0][2], 0.95105651629515364, NEAR_ZERO);
+  EXPECT_NEAR(s1.potential(0).visit_model().manual_data().dble_2D()[0][2], 0.95105651629515364, NEAR_ZERO);
+  EXPECT_NEAR(s2.potential(0).visit_model().manual_data().dble_2D()[0][2], 0.95105651629515364, NEAR_ZERO);
 }
 
 TEST(Ewald, triclinic) {
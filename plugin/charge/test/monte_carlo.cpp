@@ -1,12 +1,17 @@
 #include "utils/test/utils.h"
+#include "utils/include/checkpoint.h"
+#include "utils/include/timer.h"
 #include "math/include/random_mt19937.h"
 #include "configuration/include/domain.h"
+#include "configuration/include/select.h"
 #include "system/include/hard_sphere.h"
 #include "system/include/ideal_gas.h"
 #include "system/include/dont_visit_model.h"
 #include "system/include/visit_model_cell.h"
 #include "system/include/lennard_jones.h"
 #include "system/include/model_two_body_factory.h"
+#include "system/include/potential.h"
+#include "system/include/visit_model.h"
 #include "monte_carlo/include/monte_carlo.h"
 #include "monte_carlo/include/metropolis.h"
 #include "monte_carlo/include/trial_transfer.h"
@@ -135,6 +140,41 @@ TEST(MonteCarlo, spce) {
   //EXPECT_GT(mc.configuration().num_particles(), 0);
 }
 
+TEST(MonteCarlo, spce_binary_checkpoint) {
+  auto mc = std::make_unique<MonteCarlo>();
+  mc->set(MakeRandomMT19937({{"seed", "123"}}));
+  mc->set(spce({{"alpha", str(5.6/20)}, {"kmax_squared", "38"}}));
+  const double beta = 1/kelvin2kJpermol(525);
+  mc->set(MakeThermoParams({
+    {"beta", str(beta)},
+    {"chemical_potential", str(-8.14/beta)}}));
+  mc->set(MakeMetropolis());
+  mc->add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "0.275"}}));
+  mc->add(MakeTrialTransfer({{"weight", "4."}, {"particle_type", "0"}}));
+  mc->add(MakeEnergy({{"trials_per_write", str(1e3)}}));
+  mc->attempt(1e3);
+  std::stringstream text;
+  mc->serialize(text);
+  MakeCheckpoint({{"checkpoint_file", "tmp/spce_text.fst"}})->write(*mc);
+  MakeCheckpoint({{"checkpoint_file", "tmp/spce_binary.fst"},
+                  {"binary", "true"}})->write(*mc);
+  std::unique_ptr<MonteCarlo> mc_text, mc_binary;
+  MakeCheckpoint({{"checkpoint_file", "tmp/spce_text.fst"}})->read_unique(
+    mc_text);
+  MakeCheckpoint({{"checkpoint_file", "tmp/spce_binary.fst"}})->read_unique(
+    mc_binary);
+  // the binary restart is equivalent to the text restart
+  std::stringstream text2, text3;
+  mc_text->serialize(text2);
+  mc_binary->serialize(text3);
+  EXPECT_EQ(text.str(), text2.str());
+  EXPECT_EQ(text.str(), text3.str());
+  mc->attempt(1e2);
+  mc_binary->attempt(1e2);
+  EXPECT_EQ(mc->criteria().current_energy(),
+            mc_binary->criteria().current_energy());
+}
+
 TEST(MonteCarlo, spce_NVT_BENCHMARK_LONG) {
   MonteCarlo mc;
   mc.set(MakeRandomMT19937({{"seed", "123"}}));
@@ -153,6 +193,50 @@ TEST(MonteCarlo, spce_NVT_BENCHMARK_LONG) {
   mc.attempt(2e5);
 }
 
+// Compare the cpu time of the Fourier and real-space energies of single
+// molecule translations among 512 SPC/E molecules.
+TEST(MonteCarlo, spce_fourier_BENCHMARK_LONG) {
+  System system = spce({
+    {"physical_constants", "CODATA2010"},
+    {"cubic_side_length", "24.8586887"},
+    {"alpha", str(5.6/24.8586887)},
+    {"kmax_squared", "38"},
+    {"xyz_file", install_dir() + "/plugin/charge/test/data/spce_sample_config_hummer_eq.xyz"}});
+  system.energy();
+  Configuration * config = system.get_configuration();
+  EXPECT_EQ(512, config->num_particles());
+  Potential * fourier = system.get_potential(0);
+  Potential * real = system.get_potential(1);
+  RandomMT19937 random(argtype({{"seed", "123"}}));
+  double fourier_hours = 0., real_hours = 0.;
+  for (int move = 0; move < 1e4; ++move) {
+    const int part = random.uniform(0, config->num_particles() - 1);
+    Select select(part, config->select_particle(part));
+    Position disp(config->dimension());
+    for (int dim = 0; dim < config->dimension(); ++dim) {
+      disp.set_coord(dim, 0.5*(random.uniform() - 0.5));
+    }
+    for (const int state : {0, 1}) {
+      if (state == 1) {
+        config->displace_particle(select, disp);
+      }
+      select.set_trial_state(state);
+      double begin = cpu_hours();
+      fourier->select_energy(select, config);
+      if (state == 1) {
+        fourier->finalize(select, config);
+      }
+      fourier_hours += cpu_hours() - begin;
+      begin = cpu_hours();
+      real->select_energy(select, config);
+      real_hours += cpu_hours() - begin;
+    }
+  }
+  fourier->visit_model().check(*config);
+  INFO("Fourier seconds: " << 3600.*fourier_hours << " real-space seconds: "
+    << 3600.*real_hours << " ratio: " << fourier_hours/real_hours);
+}
+
 TEST(MonteCarlo, rpm) {
   MonteCarlo mc;
   mc.set(MakeRandomMT19937({{"seed", "time"}}));
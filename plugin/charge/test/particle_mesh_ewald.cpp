@@ -0,0 +1,140 @@
+#include <cmath>
+#include "utils/test/utils.h"
+#include "configuration/test/config_utils.h"
+#include "configuration/include/domain.h"
+#include "math/include/random_mt19937.h"
+#include "system/include/model_empty.h"
+#include "system/include/lennard_jones.h"
+#include "system/include/long_range_corrections.h"
+#include "system/include/model_two_body_factory.h"
+#include "system/include/visit_model_bond.h"
+#include "system/include/potential.h"
+#include "system/include/system.h"
+#include "monte_carlo/include/monte_carlo.h"
+#include "monte_carlo/include/metropolis.h"
+#include "monte_carlo/include/trial_rotate.h"
+#include "monte_carlo/include/trial_transfer.h"
+#include "monte_carlo/include/trial_translate.h"
+#include "steppers/include/check_energy.h"
+#include "steppers/include/tune.h"
+#include "charge/include/ewald.h"
+#include "charge/include/particle_mesh_ewald.h"
+#include "charge/include/charge_screened.h"
+#include "charge/include/charge_screened_intra.h"
+#include "charge/include/charge_self.h"
+#include "charge/test/charge_utils.h"
+
+namespace feasst {
+
+TEST(ParticleMeshEwald, spce) {
+  Configuration config = spce_sample1();
+  const std::string alpha = str(5.6/config.domain().inscribed_sphere_diameter());
+  ModelEmpty model;
+  Ewald ewald(argtype({{"alpha", alpha}, {"kmax_squared", "100"}}));
+  ewald.precompute(&config);
+  model.compute(&config, &ewald);
+  ParticleMeshEwald pme(argtype({{"alpha", alpha}, {"num_mesh", "32"},
+                                 {"order", "6"}}));
+  pme.precompute(&config);
+  EXPECT_EQ(32, pme.num_mesh(2));
+  model.compute(&config, &pme);
+  pme.finalize(config.selection_of_all(), &config);
+  EXPECT_NEAR(ewald.energy(), pme.energy(), 1e-3);
+  pme.check(config);
+
+  // the change in energy of single particle moves agrees with a full
+  // computation.
+  RandomMT19937 random(argtype({{"seed", "123"}}));
+  for (int trial = 0; trial < 20; ++trial) {
+    const int part = random.uniform(0, config.num_particles() - 1);
+    Select select(part, config.select_particle(part));
+    select.set_trial_state(0);
+    model.compute(select, &config, &pme);
+    Position disp(config.dimension());
+    for (int dim = 0; dim < config.dimension(); ++dim) {
+      disp.set_coord(dim, random.uniform() - 0.5);
+    }
+    config.displace_particle(select, disp);
+    select.set_trial_state(1);
+    model.compute(select, &config, &pme);
+    const double en = pme.energy();
+    pme.finalize(select, &config);
+    pme.check(config);
+    ParticleMeshEwald pme2(argtype({{"alpha", alpha}, {"num_mesh", "32"},
+                                    {"order", "6"}}));
+    pme2.precompute(&config);
+    model.compute(&config, &pme2);
+    EXPECT_NEAR(en, pme2.energy(), 1e-10);
+  }
+
+  // serialize
+  auto pme3 = test_serialize<ParticleMeshEwald, VisitModel>(pme);
+  model.compute(&config, pme3.get());
+  EXPECT_NEAR(pme.energy(), pme3->energy(), 1e-10);
+
+  // synchronize the influence function after a change in volume
+  ParticleMeshEwald pme4(argtype({{"alpha", alpha}, {"num_mesh", "32"},
+                                  {"order", "6"}}));
+  pme4.precompute(&config);
+  model.compute(&config, &pme4);
+  pme4.finalize(config.selection_of_all(), &config);
+  config.change_volume(100., {{"dimension", "-1"}});
+  model.compute(&config, &pme);
+  pme.finalize(config.selection_of_all(), &config);
+  pme4.synchronize_(pme, config.selection_of_all());
+  pme4.check(config);
+}
+
+TEST(ParticleMeshEwald, rpm) {
+  const std::string alpha = str(5.6/20);
+  System system = rpm({{"alpha", alpha}, {"kmax_squared", "100"}});
+  Configuration * config = system.get_configuration();
+  RandomMT19937 random(argtype({{"seed", "123"}}));
+  std::vector<std::vector<double> > coords;
+  for (int part = 0; part < 100; ++part) {
+    config->add_particle_of_type(part % 2);
+    coords.push_back({4.*(part % 5) - 8. + random.uniform_real(-1., 1.),
+                      4.*((part/5) % 5) - 8. + random.uniform_real(-1., 1.),
+                      5.*(part/25) - 7.5 + random.uniform_real(-1., 1.)});
+  }
+  config->update_positions(coords);
+  system.energy();
+  const double ewald = system.potential(0).stored_energy();
+  ModelEmpty model;
+  ParticleMeshEwald pme(argtype({{"alpha", alpha}, {"num_mesh", "32"},
+                                 {"order", "6"}}));
+  pme.precompute(config);
+  model.compute(config, &pme);
+  EXPECT_NEAR(ewald, pme.energy(), 1e-3*std::abs(ewald));
+  pme.finalize(config->selection_of_all(), config);
+  pme.check(*config);
+}
+
+TEST(MonteCarlo, spce_pme) {
+  MonteCarlo mc;
+  mc.set(MakeRandomMT19937({{"seed", "123"}}));
+  mc.add(MakeConfiguration({{"cubic_side_length", "20"},
+    {"physical_constants", "CODATA2018"},
+    {"particle_type", install_dir() + "/particle/spce.fstprt"}}));
+  mc.add(MakePotential(MakeParticleMeshEwald({{"alpha", str(5.6/20)}})));
+  mc.add(MakePotential(MakeModelTwoBodyFactory(MakeLennardJones(),
+                                               MakeChargeScreened())));
+  mc.add(MakePotential(MakeChargeScreenedIntra(), MakeVisitModelBond()));
+  mc.add(MakePotential(MakeChargeSelf()));
+  mc.add(MakePotential(MakeLongRangeCorrections()));
+  const double beta = 1/kelvin2kJpermol(525);
+  mc.set(MakeThermoParams({
+    {"beta", str(beta)},
+    {"chemical_potential", str(-8.14/beta)}}));
+  mc.set(MakeMetropolis());
+  mc.add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "0.275"}}));
+  mc.add(MakeTrialRotate({{"weight", "1."}, {"tunable_param", "0.2"}}));
+  mc.add(MakeTrialTransfer({{"weight", "4."}, {"particle_type", "0"}}));
+  mc.add(MakeCheckEnergy({{"trials_per_update", str(1e2)},
+                          {"tolerance", str(1e-6)}}));
+  mc.add(MakeTune());
+  mc.attempt(1e3);
+  EXPECT_GT(mc.configuration().num_particles(), 0);
+}
+
+}  // namespace feasst
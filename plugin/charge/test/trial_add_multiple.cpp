@@ -1,7 +1,17 @@
 #include "utils/test/utils.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/particle.h"
+#include "configuration/include/select.h"
+#include "configuration/include/configuration.h"
+#include "system/include/thermo_params.h"
 #include "monte_carlo/include/trial_stage.h"
 #include "monte_carlo/include/trial_select.h"
+#include "monte_carlo/include/monte_carlo.h"
+#include "monte_carlo/include/metropolis.h"
+#include "steppers/include/check_energy.h"
 #include "charge/include/trial_add_multiple.h"
+#include "charge/include/trial_transfer_multiple.h"
+#include "charge/test/charge_utils.h"
 
 namespace feasst {
 
@@ -20,4 +30,46 @@ TEST(TrialAddMultiple, serialize) {
   Trial add2 = test_serialize(*add);
 }
 
+// As for TrialGrow, the trajectory with threads is the same as without.
+TEST(TrialAddMultiple, num_threads) {
+  std::vector<std::shared_ptr<MonteCarlo> > mcs;
+  for (const std::string num_threads : {"1", "4"}) {
+    auto mc = std::make_shared<MonteCarlo>();
+    mc->set(MakeRandomMT19937({{"seed", "123"}}));
+    mc->set(rpm({{"alpha", str(5.6/12)}, {"kmax_squared", "38"},
+                 {"dual_cut", "2"}}));
+    mc->set(MakeThermoParams({{"beta", "0.02"},
+      {"chemical_potential0", "-400"}, {"chemical_potential1", "-400"}}));
+    mc->set(MakeMetropolis());
+    mc->add(MakeTrialTransferMultiple({{"particle_type0", "0"},
+      {"particle_type1", "1"}, {"num_steps", "4"}, {"reference_index", "0"},
+      {"num_threads", num_threads}}));
+    EXPECT_EQ(num_threads, str(mc->trial(0).stage(1).num_threads()));
+    mc->add(MakeCheckEnergy({{"trials_per_update", "1"}, {"tolerance", "1e-8"}}));
+    mcs.push_back(mc);
+  }
+  for (int attempt = 0; attempt < 200; ++attempt) {
+    if (attempt == 100) {
+      EXPECT_GT(mcs[1]->configuration().num_particles(), 4);
+      for (std::shared_ptr<MonteCarlo> mc : mcs) {
+        mc->set(MakeThermoParams({{"beta", "0.02"},
+          {"chemical_potential0", "-600"}, {"chemical_potential1", "-600"}}));
+      }
+    }
+    for (std::shared_ptr<MonteCarlo> mc : mcs) {
+      mc->attempt(1);
+    }
+    const Configuration& config = mcs[0]->configuration();
+    const Configuration& config2 = mcs[1]->configuration();
+    ASSERT_EQ(config.num_particles(), config2.num_particles());
+    EXPECT_EQ(mcs[0]->criteria().current_energy(),
+              mcs[1]->criteria().current_energy());
+    for (const int part : config.selection_of_all().particle_indices()) {
+      EXPECT_EQ(config.select_particle(part).site(0).position().coord(),
+                config2.select_particle(part).site(0).position().coord());
+    }
+  }
+  EXPECT_GT(mcs[1]->trial(1).num_success(), 0);
+}
+
 }  // namespace feasst
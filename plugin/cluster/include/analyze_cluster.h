@@ -43,6 +43,8 @@ class AnalyzeCluster : public Analyze {
   /// Return the cluster size.
   const Accumulator& cluster_size() const { return accumulator(); }
 
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("AnalyzeCluster"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
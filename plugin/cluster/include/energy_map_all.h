@@ -1,7 +1,7 @@
-
 #ifndef FEASST_CLUSTER_ENERGY_MAP_ALL_H_
 #define FEASST_CLUSTER_ENERGY_MAP_ALL_H_
 
+#include <cstddef>
 #include <vector>
 #include "system/include/energy_map.h"
 #include "configuration/include/neighbor_criteria.h"
@@ -20,12 +20,40 @@ typedef std::map<std::string, std::string> argtype;
   Updates from perturbations change only the new map.
   If the perturbation is accepted, the updates are finalized into the current map.
   Otherwise, the new map is synchronized to the old map.
+
+  Each map is a single contiguous array.
+  The interactions between a pair of particles are stored in a block of
+  consecutive values for each pair of sites.
+  Each site pair stores the energy, squared distance and periodic boundary
+  wrap.
+  The blocks are ordered by the first particle, then the second particle.
+  The number of particles in the array grows geometrically, as needed.
+
+  The blocks changed in the new map are recorded, so that finalize and revert
+  copy only those blocks.
  */
 class EnergyMapAll : public EnergyMap {
  public:
   explicit EnergyMapAll(argtype args = argtype());
   explicit EnergyMapAll(argtype * args);
+  void clear(
+      const int part1_index,
+      const int site1_index,
+      const int part2_index,
+      const int site2_index) override;
+  double update(
+      const double energy,
+      const int part1_index,
+      const int site1_index,
+      const int site1_type,
+      const int part2_index,
+      const int site2_index,
+      const int site2_type,
+      const double squared_distance,
+      const Position * pbc,
+      const Configuration& config) override;
   double energy(const int part1_index, const int site1_index) const override;
+  double total_energy() const override;
   void revert(const Select& select) override;
   void finalize(const Select& select) override;
   void select_cluster(const NeighborCriteria& neighbor_criteria,
@@ -47,6 +75,20 @@ class EnergyMapAll : public EnergyMap {
   void check(const Configuration& config) const override;
   void synchronize_(const EnergyMap& map, const Select& perturbed) override;
 
+  /// Return the number of particles in the map.
+  int num_particles() const { return data_.int_1D()[1]; }
+
+  /// Return the number of particles for which memory is allocated.
+  int capacity() const { return data_.int_1D()[0]; }
+
+  /// Return the number of blocks that were changed in the new map since the
+  /// last finalize or revert.
+  int num_changed() const;
+
+  /// Return the number of bytes used to store both maps and the record of
+  /// changed blocks.
+  std::size_t num_bytes() const;
+
   // serialization
   std::string class_name() const override { return class_name_; }
   std::shared_ptr<EnergyMap> create(std::istream& istr) const override {
@@ -60,25 +102,29 @@ class EnergyMapAll : public EnergyMap {
  protected:
   void serialize_energy_map_all_(std::ostream& ostr) const;
   void resize_(const int part1, const int site1, const int part2, const int site2) override;
-  std::vector<double> * smap_(const int part1_index,
-                              const int site1_index,
-                              const int part2_index,
-                              const int site2_index) override {
-    return &((*map_())[part1_index][part2_index][site1_index][site2_index]); }
-  std::vector<double> * smap_new_(const int part1_index,
-                                  const int site1_index,
-                                  const int part2_index,
-                                  const int site2_index) override {
-    return &((*map_new_())[part1_index][part2_index][site1_index][site2_index]); }
-  const std::vector<std::vector<std::vector<std::vector<std::vector<double> > > > >& map() const override { return data_.dble_6D()[0]; }
-  const std::vector<std::vector<std::vector<std::vector<std::vector<double> > > > >& map_new() const { return data_.dble_6D()[1]; }
 
  private:
-  std::vector<std::vector<std::vector<std::vector<std::vector<double> > > > > * map_();
-  std::vector<std::vector<std::vector<std::vector<std::vector<double> > > > > * map_new_();
-  int part_max_() { return static_cast<int>(map().size()); }
+  // temporary and not serialized
+  std::vector<std::size_t> changed_;
+  bool is_all_changed_ = false;
+
+  int stride_() const { return 2 + dimen(); }
+  int layout_site_max_() const { return data_.int_1D()[2]; }
+  std::size_t block_size_() const;
+  std::size_t index_(const int part1_index, const int site1_index,
+                     const int part2_index, const int site2_index) const;
+  const std::vector<double>& flat_(const int new_map) const {
+    return data_.dble_2D()[new_map]; }
+  std::vector<double> * get_flat_(const int new_map) {
+    return &((*data_.get_dble_2D())[new_map]); }
+  void reserve_(const int capacity, const int site_max);
+  void record_(const int part1_index, const int part2_index);
+  void copy_changed_(const int from, const int to);
+  void set_default_(const int part1_index, const int site1_index,
+                    const int new_map);
+  void deserialize_nested_();
   bool is_cluster_(const NeighborCriteria& neighbor_criteria,
-                   const std::vector<std::vector<std::vector<double> > >& smap,
+                   const std::vector<double>& map,
                    const int particle_index0,
                    const int particle_index1,
                    const Configuration& config,
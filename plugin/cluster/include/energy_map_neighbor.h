@@ -2,6 +2,9 @@
 #ifndef FEASST_CLUSTER_ENERGY_MAP_NEIGHBOR_H_
 #define FEASST_CLUSTER_ENERGY_MAP_NEIGHBOR_H_
 
+#include <algorithm>
+#include <array>
+#include <unordered_map>
 #include <vector>
 #include "system/include/energy_map.h"
 #include "configuration/include/neighbor_criteria.h"
@@ -31,6 +34,15 @@ typedef std::vector<map3type> map4type;
   map with those in the new map.
   The new map is then emptied.
   When a perturbation is rejected, revert empties the new map.
+
+  The lists of neighboring particles and sites of the current map are sorted
+  by index, so that they are searched by bisection.
+  Updates are stored in a staging area, which is hashed by the particle and
+  site indices, in constant amortized time.
+  A repeated update of the same pair replaces the previous one.
+  Neighbors in the new map are found directly from the staging area.
+  Upon finalize, the new map is built in bulk from the sorted staging area,
+  and its lists are moved into the current map rather than copied.
  */
 class EnergyMapNeighbor : public EnergyMap {
  public:
@@ -140,7 +152,6 @@ class EnergyMapNeighbor : public EnergyMap {
                    const int site_index1,
                    const int particle_index2,
                    const Configuration& config,
-                   const bool old = true,
                    Position * frame = NULL) const;
 
   template<class T>
@@ -158,19 +169,35 @@ class EnergyMapNeighbor : public EnergyMap {
 //    return list[sindex];
 //  }
 
+  // Find the index in a list sorted by the first element of the pair, or
+  // add it while maintaining the order.
   template<class T>
   T * find_or_add_(const int sindex, std::vector<std::pair<int, T> > * list) {
-    int findex = -1;
-    //DEBUG("sindex " << sindex);
-    //DEBUG("list size " << list->size());
-    if (!find_in_list(sindex, *list, &findex)) {
-      findex = static_cast<int>(list->size());
-      list->push_back(std::pair<int, T>());
-      (*list)[findex].first = sindex;
-      (*list)[findex].second = T();
+    typename std::vector<std::pair<int, T> >::iterator iter =
+      std::lower_bound(list->begin(), list->end(), sindex,
+        [](const std::pair<int, T>& element, const int value) {
+          return element.first < value; });
+    if (iter == list->end() || iter->first != sindex) {
+      iter = list->insert(iter, std::pair<int, T>(sindex, T()));
+    }
+    return &iter->second;
+  }
+
+  // Return true if the index is found in a list sorted by the first element of
+  // the pair, and also return the position in the list.
+  template<class T>
+  bool find_sorted_(const int sindex,
+                    const std::vector<std::pair<int, T> >& list,
+                    int * position) const {
+    typename std::vector<std::pair<int, T> >::const_iterator iter =
+      std::lower_bound(list.begin(), list.end(), sindex,
+        [](const std::pair<int, T>& element, const int value) {
+          return element.first < value; });
+    if (iter == list.end() || iter->first != sindex) {
+      return false;
     }
-    //DEBUG("findex " << findex);
-    return &(*list)[findex].second;
+    *position = static_cast<int>(iter - list.begin());
+    return true;
   }
 
 //  template<class T>
@@ -184,14 +211,15 @@ class EnergyMapNeighbor : public EnergyMap {
 //    return list[findex].second;
 //  }
 
-  const map3type * find_map3_(const int part1,
-    const int site1,
-    const bool old = true) const;
+  const map3type * find_map3_(const int part1, const int site1) const;
 
   const map2type * find_map2_(const int part1,
     const int site1,
-    const int part2,
-    const bool old = true) const;
+    const int part2) const;
+
+  // Return the staged updates of part1 and site1, or NULL if none.
+  const std::vector<int> * find_staged_(const int part1,
+                                        const int site1) const;
 
   // invert pbcs
   void invert_pbcs_(map1type * map1) {
@@ -205,15 +233,38 @@ class EnergyMapNeighbor : public EnergyMap {
   std::string map_str() const;
   std::string map_str(const map3type& map3) const;
 
-  void sort_map_new_();
+  void build_map_new_();
   void size_map_();
   void remove_from_map_nvt_(const Select& select);
   void add_to_map_nvt_();
   void remove_particle_from_map_(const Select& select);
   void add_particle_to_map_();
 
+  // Hash the particle and site indices of the staging area.
+  struct IndexHash {
+    template<std::size_t N>
+    std::size_t operator()(const std::array<int, N>& indices) const {
+      std::size_t hash = 0;
+      for (const int index : indices) {
+        hash ^= std::hash<int>()(index) + 0x9e3779b9 + (hash << 6) +
+                (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
   // temporary and not serialized
   bool finalizable_ = false;
+  // part1, site1, part2 and site2 of each staged update
+  std::vector<int> staged_;
+  // map1type of each staged update
+  std::vector<double> staged_value_;
+  // the staged update of each part1, site1, part2 and site2
+  std::unordered_map<std::array<int, 4>, int, IndexHash> staged_index_;
+  // the staged updates of each part1 and site1
+  std::unordered_map<std::array<int, 2>, std::vector<int>, IndexHash>
+    staged_site_;
+  void clear_staged_();
   std::vector<std::vector<double> > energy_;
 };
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "utils/include/utils.h"  // find_in_list
 #include "utils/include/arguments.h"
 #include "utils/include/serialize.h"
@@ -23,7 +24,9 @@ static MapEnergyMapAll mapper_ = MapEnergyMapAll();
 
 EnergyMapAll::EnergyMapAll(argtype * args) : EnergyMap(args) {
   class_name_ = "EnergyMapAll";
-  data_.get_dble_6D()->resize(2);
+  data_.get_dble_2D()->resize(2);
+  // capacity, number of particles and number of sites per particle
+  *data_.get_int_1D() = {0, 0, 0};
 }
 EnergyMapAll::EnergyMapAll(argtype args) : EnergyMapAll(&args) {
   feasst_check_all_used(args);
@@ -31,48 +34,234 @@ EnergyMapAll::EnergyMapAll(argtype args) : EnergyMapAll(&args) {
 
 EnergyMapAll::EnergyMapAll(std::istream& istr) : EnergyMap(istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(version == 2810, "mismatch:" << version);
+  ASSERT(version >= 2810 && version <= 2811, "mismatch:" << version);
+  if (version < 2811) {
+    deserialize_nested_();
+  }
 }
 
 void EnergyMapAll::serialize_energy_map_all_(std::ostream& ostr) const {
   serialize_energy_map_(ostr);
-  feasst_serialize_version(2810, ostr);
+  feasst_serialize_version(2811, ostr);
 }
 
 void EnergyMapAll::serialize(std::ostream& ostr) const {
   serialize_energy_map_all_(ostr);
 }
 
-void EnergyMapAll::resize_(
-    const int part1_index,
+// Convert the nested vectors of older versions.
+void EnergyMapAll::deserialize_nested_() {
+  data_.get_dble_2D()->resize(2);
+  *data_.get_int_1D() = {0, 0, site_max()};
+  if (static_cast<int>(data_.dble_6D().size()) == 2) {
+    const int num = static_cast<int>(data_.dble_6D()[0].size());
+    if (num > 0) {
+      reserve_(num, site_max());
+      (*data_.get_int_1D())[1] = num;
+      for (int new_map = 0; new_map < 2; ++new_map) {
+        const vec5& nested = data_.dble_6D()[new_map];
+        std::vector<double> * flat = get_flat_(new_map);
+        for (int p1 = 0; p1 < num; ++p1) {
+          for (int p2 = 0; p2 < num; ++p2) {
+            for (int s1 = 0; s1 < site_max(); ++s1) {
+              for (int s2 = 0; s2 < site_max(); ++s2) {
+                std::copy(nested[p1][p2][s1][s2].begin(),
+                          nested[p1][p2][s1][s2].end(),
+                          flat->begin() + index_(p1, s1, p2, s2));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  data_.get_dble_6D()->clear();
+}
+
+std::size_t EnergyMapAll::block_size_() const {
+  return static_cast<std::size_t>(layout_site_max_()*layout_site_max_()*
+                                  stride_());
+}
+
+std::size_t EnergyMapAll::index_(const int part1_index,
     const int site1_index,
     const int part2_index,
-    const int site2_index) {
-  const int part_max_old = static_cast<int>(map().size());
-  if (part1_index >= part_max_old || part2_index >= part_max_old) {
-    const int part_max = std::max(part1_index, part2_index) + 1;
-    map_()->resize(part_max);
-    map_new_()->resize(part_max);
-    for (int i = 0; i < part_max; ++i) {
-      (*map_())[i].resize(part_max);
-      (*map_new_())[i].resize(part_max);
-      for (int j = 0; j < part_max; ++j) {
-        ASSERT(site_max() != 0, "wasn't precomputed");
-        (*map_())[i][j].resize(site_max());
-        (*map_new_())[i][j].resize(site_max());
-        for (int k = 0; k < site_max(); ++k) {
-          (*map_())[i][j][k].resize(site_max());
-          (*map_new_())[i][j][k].resize(site_max());
-          if (i >= part_max_old || j >= part_max_old) {
-            for (int l = 0; l < site_max(); ++l) {
-              ASSERT(dimen() != -1, "wasnt precomputed");
-              (*map_())[i][j][k][l] = std::vector<double>(2 + dimen(), default_value());
-              (*map_new_())[i][j][k][l] = map()[i][j][k][l];
-            }
+    const int site2_index) const {
+  const std::size_t block = static_cast<std::size_t>(part1_index)*capacity()
+                          + part2_index;
+  return block*block_size_() +
+    static_cast<std::size_t>(site1_index*layout_site_max_() + site2_index)*
+    stride_();
+}
+
+void EnergyMapAll::reserve_(const int capacity, const int site_max) {
+  const int old_capacity = this->capacity();
+  const int old_site_max = layout_site_max_();
+  const std::size_t size = static_cast<std::size_t>(capacity)*capacity*
+                           site_max*site_max*stride_();
+  const int num_sites = std::min(site_max, old_site_max);
+  for (int new_map = 0; new_map < 2; ++new_map) {
+    std::vector<double> flat(size, default_value());
+    const std::vector<double>& old_flat = flat_(new_map);
+    for (int p1 = 0; p1 < num_particles(); ++p1) {
+      for (int p2 = 0; p2 < num_particles(); ++p2) {
+        for (int s1 = 0; s1 < num_sites; ++s1) {
+          for (int s2 = 0; s2 < num_sites; ++s2) {
+            const std::size_t old_index =
+              ((static_cast<std::size_t>(p1)*old_capacity + p2)*old_site_max
+               + s1)*old_site_max*stride_() + s2*stride_();
+            const std::size_t new_index =
+              ((static_cast<std::size_t>(p1)*capacity + p2)*site_max
+               + s1)*site_max*stride_() + s2*stride_();
+            std::copy(old_flat.begin() + old_index,
+                      old_flat.begin() + old_index + stride_(),
+                      flat.begin() + new_index);
           }
         }
       }
     }
+    get_flat_(new_map)->swap(flat);
+  }
+  (*data_.get_int_1D())[0] = capacity;
+  (*data_.get_int_1D())[2] = site_max;
+  // the recorded blocks are no longer valid
+  if (changed_.size() > 0) {
+    changed_.clear();
+    is_all_changed_ = true;
+  }
+}
+
+void EnergyMapAll::resize_(
+    const int part1_index,
+    const int site1_index,
+    const int part2_index,
+    const int site2_index) {
+  ASSERT(site_max() != 0, "wasn't precomputed");
+  ASSERT(dimen() != -1, "wasnt precomputed");
+  const int num = std::max(part1_index, part2_index) + 1;
+  if (site_max() != layout_site_max_()) {
+    reserve_(std::max(num, capacity()), site_max());
+  }
+  if (num > capacity()) {
+    reserve_(std::max(num, 2*capacity()), site_max());
+  }
+  if (num > num_particles()) {
+    (*data_.get_int_1D())[1] = num;
+  }
+}
+
+void EnergyMapAll::record_(const int part1_index, const int part2_index) {
+  if (is_all_changed_) {
+    return;
+  }
+  const std::size_t block = static_cast<std::size_t>(part1_index)*capacity()
+                          + part2_index;
+  // site pairs of the same particle pair are typically updated in sequence
+  const int num = static_cast<int>(changed_.size());
+  if ((num > 0 && changed_[num - 1] == block) ||
+      (num > 1 && changed_[num - 2] == block)) {
+    return;
+  }
+  changed_.push_back(block);
+  // copy the entire map when most blocks have changed
+  if (2*changed_.size() >
+      static_cast<std::size_t>(num_particles())*num_particles()) {
+    changed_.clear();
+    is_all_changed_ = true;
+  }
+}
+
+void EnergyMapAll::copy_changed_(const int from, const int to) {
+  if (is_all_changed_) {
+    *get_flat_(to) = flat_(from);
+  } else {
+    const std::size_t size = block_size_();
+    const std::vector<double>& from_flat = flat_(from);
+    std::vector<double> * to_flat = get_flat_(to);
+    for (const std::size_t block : changed_) {
+      std::copy(from_flat.begin() + block*size,
+                from_flat.begin() + (block + 1)*size,
+                to_flat->begin() + block*size);
+    }
+  }
+  changed_.clear();
+  is_all_changed_ = false;
+}
+
+int EnergyMapAll::num_changed() const {
+  if (is_all_changed_) {
+    return num_particles()*num_particles();
+  }
+  return static_cast<int>(changed_.size());
+}
+
+std::size_t EnergyMapAll::num_bytes() const {
+  return (flat_(0).capacity() + flat_(1).capacity())*sizeof(double) +
+    changed_.capacity()*sizeof(std::size_t);
+}
+
+void EnergyMapAll::clear(
+    const int part1_index,
+    const int site1_index,
+    const int part2_index,
+    const int site2_index) {
+  resize_(part1_index, site1_index, part2_index, site2_index);
+  std::vector<double> * flat = get_flat_(1);
+  const std::size_t index1 =
+    index_(part1_index, site1_index, part2_index, site2_index);
+  const std::size_t index2 =
+    index_(part2_index, site2_index, part1_index, site1_index);
+  std::fill(flat->begin() + index1, flat->begin() + index1 + stride_(),
+            default_value());
+  std::fill(flat->begin() + index2, flat->begin() + index2 + stride_(),
+            default_value());
+  record_(part1_index, part2_index);
+  record_(part2_index, part1_index);
+}
+
+double EnergyMapAll::update(
+    const double energy,
+    const int part1_index,
+    const int site1_index,
+    const int site1_type,
+    const int part2_index,
+    const int site2_index,
+    const int site2_type,
+    const double squared_distance,
+    const Position * pbc,
+    const Configuration& config) {
+  resize_(part1_index, site1_index, part2_index, site2_index);
+  double * smap1 = &(*get_flat_(1))[
+    index_(part1_index, site1_index, part2_index, site2_index)];
+  double * smap2 = &(*get_flat_(1))[
+    index_(part2_index, site2_index, part1_index, site1_index)];
+  smap1[0] = energy;
+  smap1[1] = squared_distance;
+  smap2[0] = energy;
+  smap2[1] = squared_distance;
+  if (pbc->dimension() > 0) {
+    for (int dim = 0; dim < dimen(); ++dim) {
+      smap1[2 + dim] = pbc->coord(dim);
+      smap2[2 + dim] = -1.*pbc->coord(dim);
+    }
+  }
+  record_(part1_index, part2_index);
+  record_(part2_index, part1_index);
+  return energy;
+}
+
+void EnergyMapAll::set_default_(const int part1_index, const int site1_index,
+    const int new_map) {
+  std::vector<double> * flat = get_flat_(new_map);
+  for (int p2 = 0; p2 < num_particles(); ++p2) {
+    for (int s2 = 0; s2 < layout_site_max_(); ++s2) {
+      const std::size_t index1 = index_(part1_index, site1_index, p2, s2);
+      const std::size_t index2 = index_(p2, s2, part1_index, site1_index);
+      std::fill(flat->begin() + index1, flat->begin() + index1 + stride_(),
+                default_value());
+      std::fill(flat->begin() + index2, flat->begin() + index2 + stride_(),
+                default_value());
+    }
   }
 }
 
@@ -81,23 +270,15 @@ void EnergyMapAll::revert(const Select& select) {
     const int pmax = select.particle_indices().back();
     const int smax = select.site_indices().back().back();
     resize_(pmax, smax, pmax, smax);
+  }
+  copy_changed_(0, 1);
+  if (select.trial_state() == 3) {
+    // revert addition
     for (int sel_index = 0; sel_index < select.num_particles(); ++sel_index) {
       const int p1 = select.particle_index(sel_index);
       for (const int s1 : select.site_indices(sel_index)) {
-        for (int p2 = 0; p2 < static_cast<int>(map()[p1].size()); ++p2) {
-          for (int s2 = 0; s2 < static_cast<int>(map()[p1][p2][s1].size()); ++s2) {
-            if (select.trial_state() == 3) {
-              // revert addition
-              (*map_())[p1][p2][s1][s2] = std::vector<double>(2 + dimen(), default_value());
-              (*map_())[p2][p1][s2][s1] = std::vector<double>(2 + dimen(), default_value());
-              (*map_new_())[p1][p2][s1][s2] = std::vector<double>(2 + dimen(), default_value());
-              (*map_new_())[p2][p1][s2][s1] = std::vector<double>(2 + dimen(), default_value());
-            } else {
-              (*map_new_())[p1][p2][s1][s2] = map()[p1][p2][s1][s2];
-              (*map_new_())[p2][p1][s2][s1] = map()[p2][p1][s2][s1];
-            }
-          }
-        }
+        set_default_(p1, s1, 0);
+        set_default_(p1, s1, 1);
       }
     }
   }
@@ -109,24 +290,15 @@ void EnergyMapAll::finalize(const Select& select) {
     const int pmax = select.particle_indices().back();
     const int smax = select.site_indices().back().back();
     resize_(pmax, smax, pmax, smax);
+  }
+  copy_changed_(1, 0);
+  if (select.trial_state() == 2) {
+    // finalize removal
     for (int sel_index = 0; sel_index < select.num_particles(); ++sel_index) {
       const int p1 = select.particle_index(sel_index);
       for (const int s1 : select.site_indices(sel_index)) {
-        for (int p2 = 0; p2 < static_cast<int>(map()[p1].size()); ++p2) {
-          for (int s2 = 0; s2 < static_cast<int>(map()[p1][p2][s1].size()); ++s2) {
-            TRACE("p1s1p2s2 " << p1 << " " << s1 << " " << p2 << " " << s2);
-            if (select.trial_state() == 2) {
-              // finalize removal
-              (*map_())[p1][p2][s1][s2] = std::vector<double>(2 + dimen(), default_value());
-              (*map_())[p2][p1][s2][s1] = std::vector<double>(2 + dimen(), default_value());
-              (*map_new_())[p1][p2][s1][s2] = std::vector<double>(2 + dimen(), default_value());
-              (*map_new_())[p2][p1][s2][s1] = std::vector<double>(2 + dimen(), default_value());
-            } else {
-              (*map_())[p1][p2][s1][s2] = map_new()[p1][p2][s1][s2];
-              (*map_())[p2][p1][s2][s1] = map_new()[p2][p1][s2][s1];
-            }
-          }
-        }
+        set_default_(p1, s1, 0);
+        set_default_(p1, s1, 1);
       }
     }
   }
@@ -138,10 +310,8 @@ void EnergyMapAll::select_cluster(const NeighborCriteria& neighbor_criteria,
                                   Select * cluster,
                                   const Position& frame_of_reference) const {
   DEBUG("particle_node " << particle_node);
-  DEBUG("map size " << map().size());
-  for (int part2_index = 0;
-       part2_index < static_cast<int>(map()[particle_node].size());
-       ++part2_index) {
+  DEBUG("map size " << num_particles());
+  for (int part2_index = 0; part2_index < num_particles(); ++part2_index) {
     DEBUG("part2_index " << part2_index);
     // if part2 isn't already in the cluster
     // and part2 satistifies cluster criteria,
@@ -149,7 +319,7 @@ void EnergyMapAll::select_cluster(const NeighborCriteria& neighbor_criteria,
     if (!find_in_list(part2_index, cluster->particle_indices())) {
       Position frame;
       if (is_cluster_(neighbor_criteria,
-                      map()[particle_node][part2_index],
+                      flat_(0),
                       particle_node,
                       part2_index,
                       config,
@@ -169,19 +339,19 @@ void EnergyMapAll::select_cluster(const NeighborCriteria& neighbor_criteria,
 
 bool EnergyMapAll::is_cluster_(
     const NeighborCriteria& neighbor_criteria,
-    const std::vector<std::vector<std::vector<double> > >& smap,
+    const std::vector<double>& map,
     const int particle_index0,
     const int particle_index1,
     const Configuration& config,
     Position * frame) const {
-  for (int s0i = 0; s0i < static_cast<int>(smap.size()); ++s0i) {
+  for (int s0i = 0; s0i < layout_site_max_(); ++s0i) {
     const Site& site0 = config.select_particle(particle_index0).site(s0i);
     const int site_type0 = site0.type();
-    const std::vector<std::vector<double> >& map2 = smap[s0i];
-    for (int s1i = 0; s1i < static_cast<int>(map2.size()); ++s1i) {
+    for (int s1i = 0; s1i < layout_site_max_(); ++s1i) {
       const Site& site1 = config.select_particle(particle_index1).site(s1i);
       const int site_type1 = site1.type();
-      const std::vector<double>& map1 = smap[s0i][s1i];
+      const double * map1 =
+        &map[index_(particle_index0, s0i, particle_index1, s1i)];
       if (neighbor_criteria.is_accepted(map1[0], map1[1],
                                          site_type0, site_type1)) {
         if (frame) {
@@ -198,9 +368,7 @@ bool EnergyMapAll::is_cluster_(
 }
 
 void EnergyMapAll::check(const Configuration& config) const {
-  if (!is_equal(map(), map_new(), NEAR_ZERO)) {
-//    DEBUG(feasst_str(map()));
-//    DEBUG(feasst_str(map_new()));
+  if (!is_equal(flat_(0), flat_(1), NEAR_ZERO)) {
     ERROR("maps are not equal");
   }
 
@@ -208,10 +376,10 @@ void EnergyMapAll::check(const Configuration& config) const {
   for (const int part : config.group_select(0).particle_indices()) {
     for (const std::shared_ptr<Select>& ghost : config.ghosts()) {
       for (int ghost_part : ghost->particle_indices()) {
-        if (ghost_part < static_cast<int>(map()[part].size())) {
-          for (int n_site = 0; n_site < static_cast<int>(map()[part][ghost_part].size()); ++n_site) {
-            for (int g_site = 0; g_site < static_cast<int>(map()[part][ghost_part][n_site].size()); ++g_site) {
-              if (map()[part][ghost_part][n_site][g_site][0] != 0) {
+        if (part < num_particles() && ghost_part < num_particles()) {
+          for (int n_site = 0; n_site < layout_site_max_(); ++n_site) {
+            for (int g_site = 0; g_site < layout_site_max_(); ++g_site) {
+              if (flat_(0)[index_(part, n_site, ghost_part, g_site)] != 0) {
                 INFO("existing particles: " << config.group_select(0).str());
                 for (const std::shared_ptr<Select>& ghost2 : config.ghosts()) {
                   INFO("ghosts: " << ghost2->str());
@@ -230,9 +398,9 @@ bool EnergyMapAll::is_cluster_changed(const NeighborCriteria& neighbor_criteria,
     const Select& select,
     const Configuration& config) const {
   for (int p1 : select.particle_indices()) {
-    for (int p2 = 0; p2 < static_cast<int>(map()[p1].size()); ++p2) {
-      if (is_cluster_(neighbor_criteria, map()[p1][p2], p1, p2, config) !=
-          is_cluster_(neighbor_criteria, map_new()[p1][p2], p1, p2, config)) {
+    for (int p2 = 0; p2 < num_particles(); ++p2) {
+      if (is_cluster_(neighbor_criteria, flat_(0), p1, p2, config) !=
+          is_cluster_(neighbor_criteria, flat_(1), p1, p2, config)) {
         return true;
       }
     }
@@ -240,8 +408,6 @@ bool EnergyMapAll::is_cluster_changed(const NeighborCriteria& neighbor_criteria,
   return false;
 }
 
-typedef std::vector<std::vector<std::vector<std::vector<double> > > > vec4;
-
 void EnergyMapAll::neighbors(
     const NeighborCriteria& neighbor_criteria,
     const Configuration& config,
@@ -255,15 +421,13 @@ void EnergyMapAll::neighbors(
   const int site_type0 = site0.type();
   DEBUG("site_type0 " << site_type0);
   DEBUG("target_particle " << target_particle);
-  DEBUG("sz " << map().size());
-  const vec4 * map4 = const_cast<vec4 * const>(&map()[target_particle]);
-  if (new_map == 1) {
-    map4 = const_cast<vec4 * const>(&map_new()[target_particle]);
-  }
-  for (int ipart = 0; ipart < static_cast<int>(map4->size()); ++ipart) {
+  DEBUG("sz " << num_particles());
+  const std::vector<double>& map = flat_(new_map);
+  for (int ipart = 0; ipart < num_particles(); ++ipart) {
     const Site& site1 = config.select_particle(ipart).site(given_site_index);
     const int site_type1 = site1.type();
-    const std::vector<double> & map1 = (*map4)[ipart][target_site][given_site_index];
+    const double * map1 =
+      &map[index_(target_particle, target_site, ipart, given_site_index)];
     DEBUG("site_type1 " << site_type1);
     if (neighbor_criteria.is_accepted(map1[0], map1[1], site_type0, site_type1)) {
       neighbors->add_site(ipart, given_site_index);
@@ -271,29 +435,35 @@ void EnergyMapAll::neighbors(
   }
 }
 
-std::vector<std::vector<std::vector<std::vector<std::vector<double> > > > > * EnergyMapAll::map_() {
-  return &((*data_.get_dble_6D())[0]);
-}
-
-std::vector<std::vector<std::vector<std::vector<std::vector<double> > > > > * EnergyMapAll::map_new_() {
-  return &((*data_.get_dble_6D())[1]);
-}
-
 void EnergyMapAll::synchronize_(const EnergyMap& emap, const Select& perturbed) {
-  for (int sel_index = 0; sel_index < perturbed.num_particles(); ++sel_index) {
-    const int p1 = perturbed.particle_index(sel_index);
-    for (const int s1 : perturbed.site_indices(sel_index)) {
-      for (int p2 = 0; p2 < static_cast<int>(map()[p1].size()); ++p2) {
-        for (int s2 = 0; s2 < static_cast<int>(map()[p1][p2][s1].size()); ++s2) {
-//          ASSERT(emap.data().dble_6D().size() > 0, "err");
-//          ASSERT(emap.data().dble_6D()[0].size() > p1, "err");
-//          ASSERT(emap.data().dble_6D()[0][p1].size() > p2, "err");
-//          ASSERT(emap.data().dble_6D()[0][p1][p2].size() > s1, "err");
-//          ASSERT(emap.data().dble_6D()[0][p1][p2][s1].size() > s2, "err");
-          (*map_())[p1][p2][s1][s2] = emap.data().dble_6D()[0][p1][p2][s1][s2];
-          (*map_())[p2][p1][s2][s1] = emap.data().dble_6D()[0][p2][p1][s2][s1];
-          (*map_new_())[p1][p2][s1][s2] = emap.data().dble_6D()[1][p1][p2][s1][s2];
-          (*map_new_())[p2][p1][s2][s1] = emap.data().dble_6D()[1][p2][p1][s2][s1];
+  const std::vector<int>& layout = emap.data().int_1D();
+  const int capacity2 = layout[0];
+  const int site_max2 = layout[2];
+  ASSERT(site_max2 == layout_site_max_(), "site_max: " << site_max2 <<
+    " != " << layout_site_max_());
+  if (layout[1] > num_particles()) {
+    resize_(layout[1] - 1, 0, layout[1] - 1, 0);
+  }
+  auto index2 = [capacity2, site_max2, this](const int p1, const int s1,
+                                             const int p2, const int s2) {
+    return ((static_cast<std::size_t>(p1)*capacity2 + p2)*site_max2 + s1)*
+           site_max2*stride_() + s2*stride_();
+  };
+  for (int new_map = 0; new_map < 2; ++new_map) {
+    const std::vector<double>& flat2 = emap.data().dble_2D()[new_map];
+    std::vector<double> * flat = get_flat_(new_map);
+    for (int sel_index = 0; sel_index < perturbed.num_particles(); ++sel_index) {
+      const int p1 = perturbed.particle_index(sel_index);
+      for (const int s1 : perturbed.site_indices(sel_index)) {
+        for (int p2 = 0; p2 < layout[1]; ++p2) {
+          for (int s2 = 0; s2 < site_max2; ++s2) {
+            std::copy(flat2.begin() + index2(p1, s1, p2, s2),
+                      flat2.begin() + index2(p1, s1, p2, s2) + stride_(),
+                      flat->begin() + index_(p1, s1, p2, s2));
+            std::copy(flat2.begin() + index2(p2, s2, p1, s1),
+                      flat2.begin() + index2(p2, s2, p1, s1) + stride_(),
+                      flat->begin() + index_(p2, s2, p1, s1));
+          }
         }
       }
     }
@@ -302,12 +472,31 @@ void EnergyMapAll::synchronize_(const EnergyMap& emap, const Select& perturbed)
 
 double EnergyMapAll::energy(const int part1_index, const int site1_index) const {
   double energy = 0.;
-  for (const std::vector<std::vector<std::vector<double> > >& map3 : map()[part1_index]) {
-    for (const std::vector<double>& map : map3[site1_index]) {
-      energy += map[0];
+  if (part1_index >= num_particles()) {
+    return energy;
+  }
+  const std::vector<double>& map = flat_(0);
+  for (int p2 = 0; p2 < num_particles(); ++p2) {
+    for (int s2 = 0; s2 < layout_site_max_(); ++s2) {
+      energy += map[index_(part1_index, site1_index, p2, s2)];
     }
   }
   return energy;
 }
 
+double EnergyMapAll::total_energy() const {
+  double en = 0.;
+  const std::vector<double>& map = flat_(0);
+  for (int p1 = 0; p1 < num_particles(); ++p1) {
+    for (int p2 = 0; p2 < num_particles(); ++p2) {
+      for (int s1 = 0; s1 < layout_site_max_(); ++s1) {
+        for (int s2 = 0; s2 < layout_site_max_(); ++s2) {
+          en += map[index_(p1, s1, p2, s2)];
+        }
+      }
+    }
+  }
+  return 0.5*en;
+}
+
 }  // namespace feasst
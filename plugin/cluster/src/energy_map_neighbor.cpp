@@ -68,17 +68,23 @@ double EnergyMapNeighbor::update(
     const Configuration& config) {
   TRACE("updating p1 " << part1_index << " p2 " << part2_index);
   if (energy != 0.) {
-    std::vector<double> * mn1 =
-      find_or_add_(site2_index,
-      find_or_add_(part2_index,
-      find_or_add_(site1_index,
-      find_or_add_(part1_index, map_new_()))));
-    if (mn1->size() == 0) *mn1 = std::vector<double>(5, 0);
-    (*mn1)[0] = energy;
-    (*mn1)[1] = squared_distance;
+    const std::array<int, 4> key = {part1_index, site1_index, part2_index,
+                                    site2_index};
+    const int num = static_cast<int>(staged_.size())/4;
+    const std::pair<std::unordered_map<std::array<int, 4>, int,
+      IndexHash>::iterator, bool> found = staged_index_.insert({key, num});
+    const int row = found.first->second;
+    if (found.second) {
+      staged_.insert(staged_.end(), key.begin(), key.end());
+      staged_value_.resize(5*(row + 1), 0.);
+      staged_site_[{part1_index, site1_index}].push_back(row);
+    }
+    const int value = 5*row;
+    staged_value_[value] = energy;
+    staged_value_[value + 1] = squared_distance;
     if (pbc->dimension() > 0) {
       for (int dim = 0; dim < dimen(); ++dim) {
-        (*mn1)[2 + dim] = pbc->coord(dim);
+        staged_value_[value + 2 + dim] = pbc->coord(dim);
       }
     }
   }
@@ -86,131 +92,162 @@ double EnergyMapNeighbor::update(
   return energy;
 }
 
+void EnergyMapNeighbor::clear_staged_() {
+  staged_.clear();
+  staged_value_.clear();
+  staged_index_.clear();
+  staged_site_.clear();
+}
+
 void EnergyMapNeighbor::revert(const Select& select) {
   map_new_()->clear();
+  clear_staged_();
 }
 
-void EnergyMapNeighbor::sort_map_new_() {
-  std::sort(map_new_()->begin(), map_new_()->end());
-  for (std::pair<int, mn4type>& mn4 : *map_new_()) {
-    std::sort(mn4.second.begin(), mn4.second.end());
-    for (std::pair<int, map3type>& mn3 : mn4.second) {
-      std::sort(mn3.second.begin(), mn3.second.end());
-      for (std::pair<int, map2type>& mn2 : mn3.second) {
-        std::sort(mn2.second.begin(), mn2.second.end());
-      }
+const std::vector<int> * EnergyMapNeighbor::find_staged_(const int part1,
+    const int site1) const {
+  const auto iter = staged_site_.find({part1, site1});
+  if (iter == staged_site_.end()) {
+    return NULL;
+  }
+  return &iter->second;
+}
+
+void EnergyMapNeighbor::build_map_new_() {
+  map_new_()->clear();
+  if (staged_.size() == 0) {
+    return;
+  }
+  const std::vector<int>& staged = staged_;
+  const std::vector<double>& staged_value = staged_value_;
+
+  // Sort by indices, which are unique in the staging area.
+  const int num = static_cast<int>(staged.size())/4;
+  std::vector<int> order(num);
+  for (int index = 0; index < num; ++index) {
+    order[index] = index;
+  }
+  std::sort(order.begin(), order.end(),
+    [&staged](const int index1, const int index2) {
+      return std::lexicographical_compare(
+        staged.begin() + 4*index1, staged.begin() + 4*index1 + 4,
+        staged.begin() + 4*index2, staged.begin() + 4*index2 + 4); });
+  for (int oindex = 0; oindex < num; ++oindex) {
+    const int index = order[oindex];
+    const int part1 = staged[4*index];
+    const int site1 = staged[4*index + 1];
+    const int part2 = staged[4*index + 2];
+    const int site2 = staged[4*index + 3];
+    // append, because the indices are sorted
+    std::vector<std::pair<int, mn4type> > * map_new = map_new_();
+    if (map_new->size() == 0 || map_new->back().first != part1) {
+      map_new->push_back(std::pair<int, mn4type>(part1, mn4type()));
+    }
+    mn4type * mn4 = &map_new->back().second;
+    if (mn4->size() == 0 || mn4->back().first != site1) {
+      mn4->push_back(std::pair<int, map3type>(site1, map3type()));
+    }
+    map3type * mn3 = &mn4->back().second;
+    if (mn3->size() == 0 || mn3->back().first != part2) {
+      mn3->push_back(std::pair<int, map2type>(part2, map2type()));
     }
+    mn3->back().second.push_back(std::pair<int, map1type>(site2,
+      map1type(staged_value.begin() + 5*index,
+               staged_value.begin() + 5*index + 5)));
   }
-  DEBUG("sorted new map: " << map_new_str());
+  clear_staged_();
+  DEBUG("built new map: " << map_new_str());
 }
 
 void EnergyMapNeighbor::size_map_() {
+  // size the map once, so that pointers to the lists of a particle remain
+  // valid while the lists of other particles are updated.
+  int part_max = static_cast<int>(map_()->size()) - 1;
+  for (const std::pair<int, mn4type>& mn4 : *map_new_()) {
+    part_max = std::max(part_max, mn4.first);
+    for (const auto& mn3 : mn4.second) {
+      for (const auto& mn2 : mn3.second) {
+        part_max = std::max(part_max, mn2.first);
+      }
+    }
+  }
+  if (part_max >= 0) {
+    find_or_add_(part_max, map_());
+  }
   for (const std::pair<int, mn4type>& mn4 : *map_new_()) {
     const int part1 = mn4.first;
     DEBUG("part1 " << part1);
-    find_or_add_(part1, map_());
-    DEBUG("mapsize " << map_()->size());
     for (const auto& mn3 : mn4.second) {
       const int site1 = mn3.first;
       DEBUG("site1 " << site1);
       find_or_add_(site1, &(*map_())[part1]);
       DEBUG("map4size " << (*map_())[part1].size());
+      for (const auto& mn2 : mn3.second) {
+        for (const auto& mn1 : mn2.second) {
+          find_or_add_(mn1.first, &(*map_())[mn2.first]);
+        }
+      }
     }
   }
   DEBUG("map size after init " << map_()->size())
 }
 
 void EnergyMapNeighbor::remove_from_map_nvt_(const Select& select) {
-  // remove 1. part2 in selection not in new
-  //        2. site2 in selection not in new
+  // remove part2 in selection which are not identical in the new map
+  const map3type empty;
   for (int spindex = 0; spindex < select.num_particles(); ++spindex) {
     const int part1 = select.particle_index(spindex);
     DEBUG("part1 " << part1);
     if (part1 < static_cast<int>(map_()->size())) {
       map4type * map4 = &(*map_())[part1];
-      mn4type * mn4 = find_or_add_(part1, map_new_());
+      int findex = -1;
+      const mn4type * mn4 = NULL;
+      if (find_sorted_(part1, *map_new_(), &findex)) {
+        mn4 = &(*map_new_())[findex].second;
+      }
       for (const int site1 : select.site_indices(spindex)) {
         if (site1 < static_cast<int>(map4->size())) {
           DEBUG("site1 " << site1);
           map3type * map3 = &(*map4)[site1];
-          map3type * mn3 = find_or_add_(site1, mn4);
-
-          // remove part2 in selection not in new map
-          map3type diff3;
-          std::set_difference(map3->begin(), map3->end(),
-                              mn3->begin(), mn3->end(), back_inserter(diff3));
-          for (const auto& mn2 : diff3) {
-            const int part2 = mn2.first;
+          const map3type * mn3 = &empty;
+          if (mn4 && find_sorted_(site1, *mn4, &findex)) {
+            mn3 = &(*mn4)[findex].second;
+          }
+          int pneigh = 0;
+          while (pneigh < static_cast<int>(map3->size())) {
+            const int part2 = (*map3)[pneigh].first;
+            const map2type& map2 = (*map3)[pneigh].second;
             // skip double counted
-            DEBUG(select.trial_state());
+            bool is_removed = false;
             if (select.trial_state() == 1 || part2 > part1) {
-              DEBUG("removing part1/2: " << part1 << "/" << part2);
-              int fpindex = -1;
-              const bool found = find_in_list(part2, *map3, &fpindex);
-              if (found) {
-                map3->erase(map3->begin() + fpindex,
-                            map3->begin() + fpindex + 1);
-              } else {
-                FATAL(part2 << " not found");
+              is_removed = true;
+              if (find_sorted_(part2, *mn3, &findex)) {
+                if ((*mn3)[findex].second == map2) {
+                  is_removed = false;
+                }
               }
-
+            }
+            if (is_removed) {
+              DEBUG("removing part1/2: " << part1 << "/" << part2);
               // for removed part2, also remove perturbed indices
-              for (const auto& mn1 : mn2.second) {
-                const int site2 = mn1.first;
-                *find_or_add_(site1, find_or_add_(part1, &energy_)) -= mn1.second[0];
-                *find_or_add_(site2, find_or_add_(part2, &energy_)) -= mn1.second[0];
-                //energy_[part1][site1] -= mn1.second[0];
-                //energy_[part2][site2] -= mn1.second[0];
+              for (const auto& map1 : map2) {
+                const int site2 = map1.first;
+                *find_or_add_(site1, find_or_add_(part1, &energy_)) -= map1.second[0];
+                *find_or_add_(site2, find_or_add_(part2, &energy_)) -= map1.second[0];
                 map2type * map2inv = find_or_add_(part1,
                                      find_or_add_(site2,
-                                     find_or_add_(part2, map_())));
+                                     &(*map_())[part2]));
                 int fsindex = -1;
-                const bool found = find_in_list(site1, *map2inv, &fsindex);
+                const bool found = find_sorted_(site1, *map2inv, &fsindex);
                 if (found) {
-                  map2inv->erase(map2inv->begin() + fsindex,
-                                 map2inv->begin() + fsindex + 1);
+                  map2inv->erase(map2inv->begin() + fsindex);
                 } else {
                   FATAL(part2 << " not found");
                 }
               }
-            }
-          }
-
-          // find part2 in selection and old map in order to compare sites
-          map3type intersect3;
-          std::set_intersection(map3->begin(), map3->end(),
-                                mn3->begin(), mn3->end(),
-                                back_inserter(intersect3));
-          for (const auto& mn2 : intersect3) {
-            const int part2 = mn2.first;
-            if (select.trial_state() == 1 || part2 > part1) {
-              // find site2 in selection not in new map
-              map2type * map2 = find_or_add_(part2, map3);
-              map2type diff2;
-              std::set_difference(map2->begin(), map2->end(),
-                                  mn2.second.begin(), mn2.second.end(),
-                                  back_inserter(diff2));
-              for (const auto& missing1 : diff2) {
-                const int site2 = missing1.first;
-                *find_or_add_(site1, find_or_add_(part1, &energy_)) -= missing1.second[0];
-                *find_or_add_(site2, find_or_add_(part2, &energy_)) -= missing1.second[0];
-                //energy_[part1][site1] -= missing1.second[0];
-                //energy_[part2][site2] -= missing1.second[0];
-                int fsindex = -1;
-                bool found = find_in_list(site2, *map2, &fsindex);
-                ASSERT(found, "err");
-                map2->erase(map2->begin() + fsindex,
-                            map2->begin() + fsindex + 1);
-                // for removed site2, also remove perturbed index
-                map2type * map2inv = find_or_add_(part1,
-                                     find_or_add_(site2,
-                                     find_or_add_(part2, map_())));
-                fsindex = -1;
-                found = find_in_list(site1, *map2inv, &fsindex);
-                ASSERT(found, "err");
-                map2inv->erase(map2inv->begin() + fsindex,
-                               map2inv->begin() + fsindex + 1);
-              }
+              map3->erase(map3->begin() + pneigh);
+            } else {
+              ++pneigh;
             }
           }
         }
@@ -220,87 +257,43 @@ void EnergyMapNeighbor::remove_from_map_nvt_(const Select& select) {
 }
 
 void EnergyMapNeighbor::add_to_map_nvt_() {
-  // add 1. part2 in new map not in old map
-  //     2. site2 in new map not in old map
+  // add part2 in new map which are not identical in old map
   DEBUG("map new size: " << map_new_()->size());
   for (std::pair<int, mn4type>& mn4 : *map_new_()) {
     const int part1 = mn4.first;
     DEBUG("part1 " << part1);
-    map4type * map4 = find_or_add_(part1, map_());
     for (std::pair<int, map3type>& mn3 : mn4.second) {
       const int site1 = mn3.first;
-      map4 = &(*map_())[part1];
-      // resizing may make map4 pointer relocate, same with map3
-      map3type * map3 = find_or_add_(site1, map4);
-
-      // find part2 in new map not in old map
-      map3type diff3;
-      std::set_difference(mn3.second.begin(), mn3.second.end(),
-                          map3->begin(), map3->end(), back_inserter(diff3));
-      for (const auto& mn2 : diff3) {
+      map3type * map3 = &(*map_())[part1][site1];
+      for (std::pair<int, map2type>& mn2 : mn3.second) {
         const int part2 = mn2.first;
+        int findex = -1;
+        if (find_sorted_(part2, *map3, &findex)) {
+          if ((*map3)[findex].second == mn2.second) {
+            continue;
+          }
+        }
         DEBUG("adding part1/2: " << part1 << "/" << part2);
-        map3 = &(*map_())[part1][site1];
         map2type * map2 = find_or_add_(part2, map3);
-        *map2 = mn2.second;
-        std::sort(map3->begin(), map3->end());
+        map2->swap(mn2.second);
 
         // for newly added part2, also add perturbed indices of each site
-        for (const auto& mn1 : mn2.second) {
-          const int site2 = mn1.first;
-          *find_or_add_(site1, find_or_add_(part1, &energy_)) += mn1.second[0];
-          *find_or_add_(site2, find_or_add_(part2, &energy_)) += mn1.second[0];
-          //energy_[part1][site1] += mn1.second[0];
-          //energy_[part2][site2] += mn1.second[0];
+        for (const auto& map1 : *map2) {
+          const int site2 = map1.first;
+          *find_or_add_(site1, find_or_add_(part1, &energy_)) += map1.second[0];
+          *find_or_add_(site2, find_or_add_(part2, &energy_)) += map1.second[0];
           map2type * map2inv = find_or_add_(part1,
                                find_or_add_(site2,
-                               find_or_add_(part2, map_())));
+                               &(*map_())[part2]));
           map1type * map1inv = find_or_add_(site1, map2inv);
-          *map1inv = mn1.second;
+          *map1inv = map1.second;
           invert_pbcs_(map1inv);
-          std::sort(map2inv->begin(), map2inv->end());
-        }
-      }
-
-      // find part2 in new map and old map in order to compare the sites
-      map3type intersect3;
-      std::set_intersection(mn3.second.begin(), mn3.second.end(),
-                            map3->begin(), map3->end(),
-                            back_inserter(intersect3));
-      for (const auto& mn2 : intersect3) {
-        const int part2 = mn2.first;
-        map2type * map2 = find_or_add_(part2, map3);
-        // find site2 in new map not in old map
-        map2type diff2;
-        std::set_difference(mn2.second.begin(), mn2.second.end(),
-                            map2->begin(), map2->end(), back_inserter(diff2));
-        for (const auto& mn1 : diff2) {
-          const int site2 = mn1.first;
-          DEBUG("adding site2: " << site2);
-          map1type * map1 = find_or_add_(site2, map2);
-          *map1 = mn1.second;
-          *find_or_add_(site1, find_or_add_(part1, &energy_)) += mn1.second[0];
-          *find_or_add_(site2, find_or_add_(part2, &energy_)) += mn1.second[0];
-          //energy_[part1][site1] += mn1.second[0];
-          //energy_[part2][site2] += mn1.second[0];
-          std::sort(map2->begin(), map2->end());
-
-          // for newly added site2, also add perturbed index
-          // HWH copied from above
-          map2type * map2inv = find_or_add_(part1,
-                               find_or_add_(site2,
-                               find_or_add_(part2, map_())));
-          map1type * map1inv = find_or_add_(site1, map2inv);
-          *map1inv = mn1.second;
-          invert_pbcs_(map1inv);
-          std::sort(map2inv->begin(), map2inv->end());
         }
       }
     }
   }
 
   DEBUG("map after adding before removing: " << map_str());
-  DEBUG("new map after adding before removing: " << map_new_str());
 }
 
 void EnergyMapNeighbor::remove_particle_from_map_(const Select& select) {
@@ -322,18 +315,15 @@ void EnergyMapNeighbor::remove_particle_from_map_(const Select& select) {
               DEBUG("site2 " << site2);
               *find_or_add_(site1, find_or_add_(part1, &energy_)) -= map1.second[0];
               *find_or_add_(site2, find_or_add_(part2, &energy_)) -= map1.second[0];
-              //energy_[part1][site1] -= map1.second[0];
-              //energy_[part2][site2] -= map1.second[0];
               map2type * map2inv = find_or_add_(part1,
                                    find_or_add_(site2,
-                                   find_or_add_(part2, map_())));
+                                   &(*map_())[part2]));
               int fsindex = -1;
-              const bool found = find_in_list(site2, *map2inv, &fsindex);
+              const bool found = find_sorted_(site1, *map2inv, &fsindex);
               if (found) {
-                map2inv->erase(map2inv->begin() + fsindex,
-                               map2inv->begin() + fsindex + 1);
+                map2inv->erase(map2inv->begin() + fsindex);
               } else {
-                FATAL(site2 << " not found");
+                FATAL(site1 << " not found");
               }
             }
           }
@@ -347,39 +337,31 @@ void EnergyMapNeighbor::remove_particle_from_map_(const Select& select) {
 void EnergyMapNeighbor::add_particle_to_map_() {
   // Add "new" to map
   DEBUG("map new size: " << map_new_()->size());
-  for (const std::pair<int, mn4type>& mn4 : *map_new_()) {
+  for (std::pair<int, mn4type>& mn4 : *map_new_()) {
     const int part1 = mn4.first;
     DEBUG("part1 " << part1);
-    map4type * map4 = find_or_add_(part1, map_());
-    for (const std::pair<int, map3type>& mn3 : mn4.second) {
+    for (std::pair<int, map3type>& mn3 : mn4.second) {
       const int site1 = mn3.first;
       DEBUG("site1 " << site1);
-      map3type * map3 = find_or_add_(site1, map4);
-      for (const std::pair<int, map2type>& mn2 : mn3.second) {
+      map3type * map3 = &(*map_())[part1][site1];
+      for (std::pair<int, map2type>& mn2 : mn3.second) {
         const int part2 = mn2.first;
         DEBUG("part2 " << part2);
         map2type * map2 = find_or_add_(part2, map3);
-        for (const std::pair<int, map1type>& mn1 : mn2.second) {
+        for (std::pair<int, map1type>& mn1 : mn2.second) {
           const int site2 = mn1.first;
           DEBUG("site2 " << site2);
-          map1type * map1 = find_or_add_(site1, map2);
-          *map1 = mn1.second;
-          //DEBUG("en sz " << energy_.size());
-          //DEBUG("en sz " << energy_[part1].size());
-          //DEBUG("en sz " << energy_[part2].size());
-          *find_or_add_(site1, find_or_add_(part1, &energy_)) += mn1.second[0];
-          *find_or_add_(site2, find_or_add_(part2, &energy_)) += mn1.second[0];
-          //energy_[part1][site1] += mn1.second[0];
-          //energy_[part2][site2] += mn1.second[0];
-          // HWH copied from above.. make function
+          map1type * map1 = find_or_add_(site2, map2);
+          map1->swap(mn1.second);
+          *find_or_add_(site1, find_or_add_(part1, &energy_)) += (*map1)[0];
+          *find_or_add_(site2, find_or_add_(part2, &energy_)) += (*map1)[0];
           // perturb indices and add
           map2type * map2inv = find_or_add_(part1,
                                find_or_add_(site2,
-                               find_or_add_(part2, map_())));
+                               &(*map_())[part2]));
           map1type * map1inv = find_or_add_(site1, map2inv);
-          *map1inv = mn1.second;
+          *map1inv = *map1;
           invert_pbcs_(map1inv);
-          std::sort(map2inv->begin(), map2inv->end());
         }
       }
     }
@@ -388,6 +370,7 @@ void EnergyMapNeighbor::add_particle_to_map_() {
 
 void EnergyMapNeighbor::finalize(const Select& select) {
   if (!finalizable_) return;
+  build_map_new_();
   DEBUG("map: " << map_str());
   DEBUG("new map: " << map_new_str());
   DEBUG("perturbed: " << select.str());
@@ -395,7 +378,6 @@ void EnergyMapNeighbor::finalize(const Select& select) {
   DEBUG("map size " << map_()->size())
   DEBUG("new map size " << map_new_()->size())
 
-  sort_map_new_();
   size_map_();
 
   if (select.trial_state() == -1 || select.trial_state() == 1) {
@@ -437,7 +419,6 @@ void EnergyMapNeighbor::select_cluster(
                           site1,
                           part2_index,
                           config,
-                          true,  // old map
                           &frame)) {
             DEBUG("FOR " << frame_of_reference.str());
             frame.add(frame_of_reference);
@@ -459,22 +440,11 @@ typedef std::vector<double> map1type;
 typedef std::vector<std::pair<int, map1type> > map2type;
 typedef std::vector<std::pair<int, map2type> > map3type;
 const map3type * EnergyMapNeighbor::find_map3_(const int particle_index1,
-    const int site_index1,
-    const bool old) const {
-  if (old) {
-    if (particle_index1 < static_cast<int>(const_map_().size())) {
-      const map4type& map4 = const_map_()[particle_index1];
-      if (site_index1 < static_cast<int>(map4.size())) {
-        return const_cast<const map3type *>(&map4[site_index1]);
-      }
-    }
-  } else {
-    int findex = -1;
-    if (find_in_list(particle_index1, const_map_new_(), &findex)) {
-      const mn4type& map4 = const_map_new_()[findex].second;
-      if (find_in_list(site_index1, map4, &findex)) {
-        return const_cast<const map3type *>(&map4[findex].second);
-      }
+    const int site_index1) const {
+  if (particle_index1 < static_cast<int>(const_map_().size())) {
+    const map4type& map4 = const_map_()[particle_index1];
+    if (site_index1 < static_cast<int>(map4.size())) {
+      return const_cast<const map3type *>(&map4[site_index1]);
     }
   }
   return NULL;
@@ -482,11 +452,10 @@ const map3type * EnergyMapNeighbor::find_map3_(const int particle_index1,
 
 const map2type * EnergyMapNeighbor::find_map2_(const int part1,
     const int site1,
-    const int part2,
-    const bool old) const {
-  const map3type * map3 = find_map3_(part1, site1, old);
+    const int part2) const {
+  const map3type * map3 = find_map3_(part1, site1);
   int findex = -1;
-  if (find_in_list(part2, *map3, &findex)) {
+  if (map3 && find_sorted_(part2, *map3, &findex)) {
     return const_cast<const map2type *>(&(*map3)[findex].second);
   }
   return NULL;
@@ -497,10 +466,9 @@ bool EnergyMapNeighbor::is_cluster_(const NeighborCriteria& neighbor_criteria,
     const int site_index1,
     const int particle_index2,
     const Configuration& config,
-    const bool old,
     Position * frame) const {
   const map2type * map2 = find_map2_(particle_index1, site_index1,
-                                     particle_index2, old);
+                                     particle_index2);
   if (map2) {
     const int site_type1 =
       config.select_particle(particle_index1).site(site_index1).type();
@@ -538,27 +506,20 @@ bool EnergyMapNeighbor::is_cluster_changed(
       DEBUG("spindex " << spindex);
       DEBUG("p1 " << p1);
       DEBUG("s1 " << s1);
-      const map3type * newmap = find_map3_(p1, s1, false);
-      const map3type * oldmap = find_map3_(p1, s1, true);
-      //if (!newmap && oldmap) {
-      //  DEBUG("cluster is changed");
-      //  return true;
-      //} else if (newmap && oldmap) {
+      const std::vector<int> * newmap = find_staged_(p1, s1);
+      const map3type * oldmap = find_map3_(p1, s1);
       if (newmap && oldmap) {
-        for (int i = 0; i < static_cast<int>(newmap->size()); ++i) {
-          const int p2 = (*newmap)[i].first;
+        for (const int row : *newmap) {
+          const int p2 = staged_[4*row + 2];
+          const int s2 = staged_[4*row + 3];
           int findex = -1;
-          if (find_in_list(p2, *oldmap, &findex)) {
+          if (find_sorted_(p2, *oldmap, &findex)) {
             DEBUG("found p2 " << p2);
-            const map2type &oldmap2 = (*oldmap)[findex].second;
-            for (int j = 0; j < static_cast<int>((*newmap)[i].second.size()); ++j) {
-              const int s2 = (*newmap)[i].second[j].first;
-              if (find_in_list(s2, oldmap2, &findex)) {
-                DEBUG("found s2 " << s2);
-              } else {
-                DEBUG("cluster is changed");
-                return true;
-              }
+            if (find_sorted_(s2, (*oldmap)[findex].second, &findex)) {
+              DEBUG("found s2 " << s2);
+            } else {
+              DEBUG("cluster is changed");
+              return true;
             }
           } else {
             DEBUG("cluster is changed");
@@ -613,10 +574,10 @@ void EnergyMapNeighbor::check(const Configuration& config) const {
             const map1type& m1 = m2[sneigh].second;
             if (m1.size() > 0) {
               int tmp;
-              bool found = find_in_list(part1, const_map_()[part2][site2], &tmp);
+              bool found = find_sorted_(part1, const_map_()[part2][site2], &tmp);
               ASSERT(found, "unmatched pair part1: " << part1 << " part2: " << part2
                 << " map: " << map_str());
-              found = find_in_list(site1, const_map_()[part2][site2][tmp].second, &tmp);
+              found = find_sorted_(site1, const_map_()[part2][site2][tmp].second, &tmp);
               ASSERT(found, "unmatched pair part1: " << part1 << " site1: " <<
                 site1 << " part2 " << part2 << " site2: " << site2
                 << " map: " << map_str());
@@ -642,9 +603,24 @@ void EnergyMapNeighbor::neighbors(
   DEBUG("target_particle " << target_particle);
   DEBUG("target_site " << target_site);
   //const vec4 * map4 = const_cast<vec4 * const>(&map()[target_particle]);
-  const map3type * map3 = NULL;
-  ASSERT(!map3, "er");
-  map3 = find_map3_(target_particle, target_site, !new_map);
+  if (new_map) {
+    const std::vector<int> * rows = find_staged_(target_particle, target_site);
+    if (rows) {
+      for (const int row : *rows) {
+        const int part2 = staged_[4*row + 2];
+        if (staged_[4*row + 3] == given_site_index) {
+          const Site& site1 = config.select_particle(part2).site(
+            given_site_index);
+          if (neighbor_criteria.is_accepted(staged_value_[5*row],
+              staged_value_[5*row + 1], site_type0, site1.type())) {
+            neighbors->add_site(part2, given_site_index);
+          }
+        }
+      }
+    }
+    return;
+  }
+  const map3type * map3 = find_map3_(target_particle, target_site);
   if (map3) {
     DEBUG(map_str(*map3));
     for (int pindex = 0; pindex < static_cast<int>(map3->size()); ++pindex) {
@@ -652,7 +628,7 @@ void EnergyMapNeighbor::neighbors(
       DEBUG("part2 " << part2);
       const map2type& map2 = (*map3)[pindex].second;
       int findex = -1;
-      if (find_in_list(given_site_index, map2, &findex)) {
+      if (find_sorted_(given_site_index, map2, &findex)) {
         const Site& site1 = config.select_particle(part2).site(given_site_index);
         const int site_type1 = site1.type();
         const map1type& map1 = map2[findex].second;
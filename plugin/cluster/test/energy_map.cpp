@@ -85,4 +85,57 @@ TEST(EnergyMap, energy_map) {
   }
 }
 
+TEST(EnergyMapAll, flat) {
+  auto map = MakeEnergyMapAll();
+  Configuration config = lj_sample4();
+  LennardJones model;
+  model.precompute(config.model_params());
+  VisitModel visit(MakeVisitModelInner(map));
+  visit.precompute(&config);
+  EXPECT_EQ(0, map->num_particles());
+  model.compute(&config, &visit);
+  EXPECT_EQ(config.num_particles(), map->num_particles());
+  EXPECT_GE(map->capacity(), map->num_particles());
+  EXPECT_EQ(map->num_particles()*map->num_particles(), map->num_changed());
+  visit.finalize(config.selection_of_all(), &config);
+  EXPECT_EQ(0, map->num_changed());
+  EXPECT_GE(map->num_bytes(), 2*sizeof(double)*5*map->num_particles()*
+                              map->num_particles());
+  const double en_lj_all = -16.790321304625856;
+  EXPECT_NEAR(en_lj_all, map->total_energy(), 1e-13);
+  map->check(config);
+
+  // displace a particle and revert
+  Select select(0, config.select_particle(0));
+  select.set_trial_state(0);
+  model.compute(select, &config, &visit);
+  const double en_old = visit.energy();
+  EXPECT_NEAR(en_old, map->energy(0, 0), 1e-13);
+  EXPECT_EQ(0, map->num_changed());
+  select.set_trial_state(1);
+  config.displace_particle(select,
+    Position(std::vector<double>({0.1, 0.2, 0.3})));
+  model.compute(select, &config, &visit);
+  const double en_new = visit.energy();
+  EXPECT_EQ(2*(config.num_particles() - 1), map->num_changed());
+  visit.revert(select);
+  EXPECT_EQ(0, map->num_changed());
+  map->check(config);
+  EXPECT_NEAR(en_lj_all, map->total_energy(), 1e-13);
+
+  // accept the displacement
+  model.compute(select, &config, &visit);
+  visit.finalize(select, &config);
+  map->check(config);
+  EXPECT_NEAR(en_new, map->energy(0, 0), 1e-13);
+  EXPECT_NEAR(en_lj_all - en_old + en_new, map->total_energy(), 1e-12);
+  model.compute(&config, &visit);
+  EXPECT_NEAR(visit.energy(), map->total_energy(), 1e-12);
+
+  // serialize, including the flat maps
+  auto visit2 = test_serialize(visit);
+  EXPECT_NEAR(map->total_energy(),
+              visit2.inner().energy_map().total_energy(), 1e-12);
+}
+
 }  // namespace feasst
@@ -1,6 +1,7 @@
 #include "utils/test/utils.h"
 #include "monte_carlo/test/monte_carlo_utils.h"
 #include "utils/include/progress_report.h"
+#include "utils/include/timer.h"
 #include "math/include/random_mt19937.h"
 #include "system/include/visit_model.h"
 #include "system/include/visit_model_inner.h"
@@ -145,6 +146,29 @@ TEST(MonteCarlo, GCMCmap) {
   }
 }
 
+// Add, remove and move multi-site particles with EnergyMapNeighbor, which
+// must key the pairs by both site indices.
+TEST(MonteCarlo, GCMCmap_trimer) {
+  MonteCarlo mc;
+  mc.set(MakeRandomMT19937({{"seed", "123"}}));
+  mc.add(MakeConfiguration({{"cubic_side_length", "8"},
+    {"particle_type0", "../particle/trimer.fstprt"}}));
+  mc.add(MakePotential({{"Model", "LennardJones"},
+                        {"EnergyMap", "EnergyMapNeighbor"}}));
+  mc.set(MakeThermoParams({{"beta", "1.2"}, {"chemical_potential", "-1"}}));
+  mc.set(MakeMetropolis());
+  mc.add(MakeTrialTranslate({{"tunable_param", "1."}}));
+  mc.add(MakeTrialTransfer({{"particle_type", "0"}}));
+  for (int i = 0; i < 2e3; ++i) {
+    mc.attempt(1);
+    const EnergyMap& map =
+      mc.system().potential(0).visit_model().inner().energy_map();
+    EXPECT_NEAR(mc.criteria().current_energy(), map.total_energy(), 1e-8);
+    map.check(mc.configuration());
+  }
+  EXPECT_GT(mc.configuration().num_particles(), 2);
+}
+
 std::unique_ptr<MonteCarlo> mc_avb_test(
     const bool avb = true,
     const int min_particles = 1,
@@ -244,4 +268,52 @@ TEST(MonteCarlo, MC_AVB2_AVB4_LONG) {
   }
 }
 
+// Time the trials which use EnergyMapNeighbor with many particles.
+TEST(MonteCarlo, neighbor_map_BENCHMARK_LONG) {
+  const int num = 5000, num_per_side = 18;
+  const double length = 30.;
+  const double spacing = length/static_cast<double>(num_per_side);
+  std::vector<std::vector<double> > coords(num, std::vector<double>(3));
+  for (int part = 0; part < num; ++part) {
+    const std::vector<int> lattice = {part % num_per_side,
+      (part/num_per_side) % num_per_side, part/num_per_side/num_per_side};
+    for (int dim = 0; dim < 3; ++dim) {
+      coords[part][dim] = spacing*(lattice[dim] + 0.5) - 0.5*length;
+    }
+  }
+  for (const std::string trial : {"AVB2", "AVB4", "RigidCluster"}) {
+    MonteCarlo mc;
+    mc.add(MakeConfiguration({{"cubic_side_length", str(length)},
+      {"particle_type0", "../particle/lj.fstprt"},
+      {"add_particles_of_type0", str(num)}}));
+    mc.get_system()->get_configuration()->update_positions(coords);
+    mc.add(MakePotential({{"Model", "LennardJones"},
+      {"VisitModel", "VisitModelCell"}, {"min_length", "max_cutoff"},
+      {"EnergyMap", "EnergyMapNeighbor"}}));
+    mc.set(MakeThermoParams({{"beta", "1.2"}, {"chemical_potential", "1."}}));
+    mc.set(MakeMetropolis());
+    if (trial == "RigidCluster") {
+      mc.add(MakeNeighborCriteria({{"energy_maximum", "-0.5"}}));
+      mc.add(MakeTrialRigidCluster({{"particle_type", "0"},
+        {"neighbor_index", "0"}}));
+    } else {
+      mc.add(MakeNeighborCriteria({{"maximum_distance", "3"},
+                                   {"minimum_distance", "1"}}));
+      if (trial == "AVB2") {
+        mc.add(MakeTrialAVB2({{"neighbor_index", "0"},
+                              {"particle_type", "0"}}));
+      } else {
+        mc.add(MakeTrialAVB4({{"neighbor_index", "0"},
+                              {"particle_type", "0"}}));
+      }
+    }
+    const double time = cpu_hours();
+    mc.attempt(1e4);
+    INFO(trial << " time " << 3600.*(cpu_hours() - time) << "s");
+    const double en_map = mc.system().potential(0).visit_model().inner(
+      ).energy_map().total_energy();
+    EXPECT_NEAR(mc.criteria().current_energy(), en_map, 1e-8*num);
+  }
+}
+
 }  // namespace feasst
@@ -14,6 +14,7 @@ class Group;
 class ModelParam;
 class ModelParams;
 class NeighborCriteria;
+class PackedSites;
 class Particle;
 class ParticleFactory;
 class PhysicalConstants;
@@ -82,6 +83,10 @@ class Configuration {
     - set_cutoff_min_to_sigma: if true and cutoff < sigma, cutoff = sigma
       (default: false). This is typically used for HardSphere models that
       didn't specify cutoff.
+    - packed_sites: if true, maintain a PackedSites copy of the sites
+      (default: false).
+      This is also enabled automatically by visitors which require it, such
+      as VisitModelPacked.
    */
   explicit Configuration(argtype args = argtype());
   explicit Configuration(argtype * args);
@@ -290,6 +295,16 @@ class Configuration {
   /// Same as above, but optimized to use existing data structure.
   void num_sites_of_type(const Select& selection, std::vector<int> * num) const;
 
+  /// Enable the PackedSites store and build it from the existing particles.
+  /// Nothing is done if the store is already enabled.
+  void init_packed_sites();
+
+  /// Return true if the PackedSites store is enabled.
+  bool is_packed() const { return static_cast<bool>(packed_); }
+
+  /// Return the PackedSites store. Requires init_packed_sites.
+  const PackedSites& packed_sites() const;
+
   /// Return the number of sites of each type in group.
   std::vector<int> num_sites_of_type(const int group_index = 0.) const {
     return num_sites_of_type(*group_selects()[group_index]); }
@@ -308,15 +323,15 @@ class Configuration {
 
   /// Load coordinates by per-site vector containing per-dimension vector.
   /// Requires coordinates for all sites and dimensions.
-  void update_positions(const std::vector<std::vector<double> > coords);
+  void update_positions(const std::vector<std::vector<double> >& coords);
 
   /**
     Load coordinates and orientations with a per-site vector containing
     per-dimension vector.
     Requires coordinates and orientations for all sites and dimensions.
    */
-  void update_positions(const std::vector<std::vector<double> > coords,
-                        const std::vector<std::vector<double> > eulers);
+  void update_positions(const std::vector<std::vector<double> >& coords,
+                        const std::vector<std::vector<double> >& eulers);
 
   /// Update the positions and properties from a selection.
   /// Includes euler angles.
@@ -330,6 +345,11 @@ class Configuration {
     /// Add missing particles of the same type.
     const bool add_missing = false);
 
+  /// Replace the positions of all particles with those of a config with the
+  /// same domain, particle types and ghosts, such as a copy of this one.
+  /// Return false, without changes, if they differ.
+  bool copy_positions(const Configuration& config);
+
   /// Displace selected particle(s). No periodic boundary conditions applied.
   void displace_particles(const Select& selection,
                           const Position &displacement);
@@ -532,6 +552,17 @@ class Configuration {
   // HWH updates entire particle. Optimize by updating per site.
   void synchronize_(const Configuration& config, const Select& perturbed);
 
+  // Match the particles of a config with the same domain and particle types,
+  // such as a deep copy of this one.
+  // Ghosts are revived or removed, missing particles are added, and the
+  // positions, orientations and physicality of the sites are copied.
+  // Return false, without changes, if the domain, types or number of
+  // particles is not compatible.
+  // Otherwise, add the removed particles to removed, and the revived, added
+  // and updated sites to changed.
+  bool synchronize_particles_(const Configuration& config, Select * removed,
+    Select * changed);
+
   /// Serialize
   void serialize(std::ostream& ostr) const;
 
@@ -545,6 +576,7 @@ class Configuration {
   std::shared_ptr<Domain> domain_;
   bool wrap_;
   int num_cell_lists_ = 0;
+  std::shared_ptr<PackedSites> packed_;
 
   // temporaries (not serialized)
   int newest_particle_index_;
@@ -593,6 +625,9 @@ class Configuration {
   /// Update position trackers of all particles.
   void position_tracker_();
 
+  /// Update the PackedSites store, if enabled, for all sites in a particle.
+  void packed_update_(const int particle_index);
+
   /// Add particle to selection.
   void add_to_selection_(const int particle_index,
                          Select * select) const;
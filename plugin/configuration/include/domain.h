@@ -2,11 +2,13 @@
 #ifndef FEASST_CONFIGURATION_DOMAIN_H_
 #define FEASST_CONFIGURATION_DOMAIN_H_
 
+#include <cmath>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 #include "math/include/position.h"
+#include "math/include/fixed_position.h"
 
 namespace feasst {
 
@@ -109,6 +111,9 @@ class Domain {
   /// Return the yz tilt factor.
   double yz() const { return yz_; }
 
+  /// Set the xy, xz and yz tilt factors.
+  void set_tilt(const double xy, const double xz, const double yz);
+
   /// Disable periodicity in a given dimension.
   void disable(const int dimension) { periodic_[dimension] = false; }
 
@@ -165,6 +170,15 @@ class Domain {
       Position * pbc,
       double * r2) const;
 
+  /// Same as wrap_opt, but for positions with a dimension fixed at compile
+  /// time, which avoids heap-allocated temporaries.
+  template <int D>
+  void wrap_opt(const FixedPosition<D>& pos1,
+      const FixedPosition<D>& pos2,
+      FixedPosition<D> * rel,
+      FixedPosition<D> * pbc,
+      double * r2) const;
+
   /// Return the shift for number of wraps, num_wrap, in a given dimension, dim.
   void unwrap(const int dim, const int num_wrap, Position * shift) const;
 
@@ -195,6 +209,45 @@ class Domain {
   void set_yz_(const double yz);
 };
 
+template <int D>
+void Domain::wrap_opt(const FixedPosition<D>& pos1,
+    const FixedPosition<D>& pos2,
+    FixedPosition<D> * rel,
+    FixedPosition<D> * pbc,
+    double * r2) const {
+  const std::vector<double>& side = side_lengths_.coord();
+  for (int dim = 0; dim < D; ++dim) {
+    rel->set_coord(dim, pos1.coord(dim) - pos2.coord(dim));
+  }
+  pbc->set_to_origin();
+  if (is_tilted_) {
+    // wrap from the highest dimension down, as in wrap_triclinic_opt
+    const double tilt[3][3] = {{0., 0., 0.}, {xy_, 0., 0.}, {xz_, yz_, 0.}};
+    for (int dim = D - 1; dim >= 0; --dim) {
+      if (periodic_[dim]) {
+        const int num_wrap = std::rint(rel->coord(dim)/side[dim]);
+        if (num_wrap != 0) {
+          pbc->add_to_coord(dim, -num_wrap*side[dim]);
+          rel->add_to_coord(dim, -num_wrap*side[dim]);
+          for (int lower = 0; lower < dim; ++lower) {
+            pbc->add_to_coord(lower, -num_wrap*tilt[dim][lower]);
+            rel->add_to_coord(lower, -num_wrap*tilt[dim][lower]);
+          }
+        }
+      }
+    }
+  } else {
+    for (int dim = 0; dim < D; ++dim) {
+      if (periodic_[dim]) {
+        const double dx = side[dim]*std::rint(rel->coord(dim)/side[dim]);
+        pbc->add_to_coord(dim, -dx);
+        rel->add_to_coord(dim, -dx);
+      }
+    }
+  }
+  *r2 = rel->squared_distance();
+}
+
 inline std::shared_ptr<Domain> MakeDomain(argtype args = argtype()) {
   return std::make_shared<Domain>(args); }
 
@@ -0,0 +1,113 @@
+
+#ifndef FEASST_CONFIGURATION_FILE_TRAJECTORY_H_
+#define FEASST_CONFIGURATION_FILE_TRAJECTORY_H_
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "configuration/include/trajectory_frame.h"
+
+namespace feasst {
+
+class Configuration;
+
+typedef std::map<std::string, std::string> argtype;
+
+/**
+  A compressed binary trajectory of the site positions, which does not
+  require external libraries (see FileXTC for an alternative).
+
+  The file begins with the header "FEASSTTrajectory" and a format version,
+  followed by the frames in the order that they were written.
+  Each frame begins with its size in bytes, so that the frames may be
+  indexed without reading their contents (see open).
+  Each frame contains the side lengths and tilt factors of the Domain, the
+  quantization precision, the number of sites and the type of each particle,
+  which may change between frames (e.g., for grand canonical ensembles).
+
+  Each coordinate is quantized to an integer multiple of the precision, and
+  stored as the difference from the same coordinate of the previous site in
+  a variable number of bytes, such that the nearby sites of the same
+  particle often require only one or two bytes per coordinate.
+  Note that orientations (e.g., Euler angles) are not stored.
+
+  Multi-byte numbers are stored in little-endian byte order.
+ */
+class FileTrajectory {
+ public:
+  //@{
+  /** @name Arguments
+    - group_index: write the coordinates of this group index only
+      (default: 0).
+    - group: name of group defined within system (default: "").
+    - append: append file output if set to true.
+      Do not append if false (default: "false").
+    - precision: the coordinates are written to the nearest multiple of
+      this value (default: 1e-4).
+   */
+  explicit FileTrajectory(argtype args = argtype());
+  explicit FileTrajectory(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Write the configuration to file_name as a frame.
+  void write(const std::string& file_name, const Configuration& config) const;
+
+  /// Return true if the file begins with the header of this format.
+  static bool is_format(const std::string& file_name);
+
+  /// Open file_name for reading and index the position of each frame.
+  /// An incomplete last frame (e.g., from a terminated simulation) is
+  /// ignored.
+  void open(const std::string& file_name);
+
+  /// Return the number of frames in the opened file.
+  int num_frames() const { return static_cast<int>(offsets_.size()); }
+
+  /// Load the frame of the opened file into the configuration
+  /// (see TrajectoryFrame::load).
+  void load_frame(const int frame, Configuration * config);
+
+  /**
+    Given the contents of a file, return the beginning and size in bytes of
+    each complete frame.
+    An incomplete last frame is ignored.
+   */
+  static void index(const char * bytes, const size_t size,
+    std::vector<size_t> * begins, std::vector<size_t> * sizes);
+
+  /// Decode the bytes of a frame, as given by index.
+  static void decode(const char * bytes, const size_t size,
+    TrajectoryFrame * frame);
+
+  void serialize(std::ostream& ostr) const;
+  explicit FileTrajectory(std::istream& istr);
+  ~FileTrajectory();
+
+  //@}
+ private:
+  int group_index_;
+  std::string group_;
+  bool append_;
+  double precision_;
+
+  // not serialized
+  std::shared_ptr<std::ifstream> file_;
+  std::vector<std::streamoff> offsets_;
+  std::string bytes_;
+  TrajectoryFrame frame_;
+};
+
+inline std::shared_ptr<FileTrajectory> MakeFileTrajectory(
+    argtype args = argtype()) {
+  return std::make_shared<FileTrajectory>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_CONFIGURATION_FILE_TRAJECTORY_H_
@@ -0,0 +1,65 @@
+
+#ifndef FEASST_CONFIGURATION_MAPPED_TRAJECTORY_H_
+#define FEASST_CONFIGURATION_MAPPED_TRAJECTORY_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "configuration/include/trajectory_frame.h"
+
+namespace feasst {
+
+class Configuration;
+class MappedFileBuffer;
+
+/**
+  Read the frames of a FileTrajectory or FileXYZ, which is detected by its
+  header, by mapping the file into memory (see MappedFileBuffer).
+
+  The frames are indexed once, when the file is opened, and then each frame
+  is decoded directly from the mapped memory into a TrajectoryFrame, without
+  intermediate streams or strings.
+  Reading a frame does not change this object, so that multiple threads may
+  read different frames at the same time, each into their own
+  TrajectoryFrame (e.g., see AnalyzeTrajectory).
+
+  For FileXYZ, if the z side length is zero, then the frame has two
+  dimensions.
+  Orientations (e.g., Euler angles) are not read.
+ */
+class MappedTrajectory {
+ public:
+  /// Map the file and index its frames.
+  explicit MappedTrajectory(const std::string& file_name);
+
+  /// Return true if the file is a FileTrajectory.
+  bool is_compressed() const { return is_compressed_; }
+
+  /// Return the number of frames.
+  int num_frames() const { return static_cast<int>(begins_.size()); }
+
+  /// Read a frame.
+  void read(const int frame, TrajectoryFrame * data) const;
+
+  /// Read a frame into data and load it into the configuration
+  /// (see TrajectoryFrame::load).
+  void load(const int frame, Configuration * config,
+            TrajectoryFrame * data) const;
+
+  ~MappedTrajectory();
+
+ private:
+  std::string file_name_;
+  bool is_compressed_;
+  std::shared_ptr<MappedFileBuffer> buffer_;
+  std::vector<size_t> begins_;
+  std::vector<size_t> sizes_;
+
+  void index_xyz_();
+  void read_xyz_(const char * bytes, const size_t size,
+                 TrajectoryFrame * data) const;
+};
+
+}  // namespace feasst
+
+#endif  // FEASST_CONFIGURATION_MAPPED_TRAJECTORY_H_
@@ -0,0 +1,96 @@
+#ifndef FEASST_CONFIGURATION_PACKED_SITES_H_
+#define FEASST_CONFIGURATION_PACKED_SITES_H_
+
+#include <vector>
+
+namespace feasst {
+
+class Particle;
+class Site;
+
+/**
+  A structure-of-arrays copy of the site coordinates, types and physical
+  state of every particle in a Configuration, including ghosts.
+  Sites are indexed by a global site id, which is the sum of the number of
+  sites in all particles with a lower (selection-based) particle index, plus
+  the index of the site within the particle.
+  Because particles are never erased (only turned into ghosts), these ids are
+  stable for the lifetime of the Configuration.
+
+  This store is optional and is enabled with Configuration::init_packed_sites.
+  Once enabled, the Configuration keeps it synchronized with the particles.
+  It is intended for use in optimized pair loops (e.g., VisitModelPacked)
+  that stream through contiguous memory instead of visiting each Particle,
+  Site and Position.
+
+  This class is a cache of the Configuration and is not serialized.
+ */
+class PackedSites {
+ public:
+  PackedSites() {}
+
+  /// Remove all sites and set the dimension.
+  void clear(const int dimension);
+
+  /// Return the dimension.
+  int dimension() const { return static_cast<int>(coord_.size()); }
+
+  /// Append all sites of a particle, whose index must be num_particles().
+  void add(const Particle& particle);
+
+  /// Update the position, type and physical state of a site.
+  void update(const int particle_index, const int site_index,
+              const Site& site);
+
+  /// Update all sites of a particle.
+  void update(const int particle_index, const Particle& particle);
+
+  /// Set whether or not the particle exists (e.g., false for ghosts).
+  /// Sites of particles that do not exist are never present.
+  void set_exists(const int particle_index, const Particle& particle,
+                  const bool exists);
+
+  /// Return the number of particles, including ghosts.
+  int num_particles() const {
+    return static_cast<int>(particle_start_.size()) - 1; }
+
+  /// Return the number of sites, including ghosts.
+  int num_sites() const { return static_cast<int>(type_.size()); }
+
+  /// Return the global site id of the first site of a particle.
+  int start(const int particle_index) const {
+    return particle_start_[particle_index]; }
+
+  /// Return the global site id of the site in a particle.
+  int id(const int particle_index, const int site_index) const {
+    return particle_start_[particle_index] + site_index; }
+
+  /// Return the contiguous coordinates of all sites in a given dimension.
+  const std::vector<double>& coord(const int dimension) const {
+    return coord_[dimension]; }
+
+  /// Return the site types.
+  const std::vector<int>& type() const { return type_; }
+
+  /// Return 1 if the site is physical and its particle exists. Otherwise 0.
+  const std::vector<int>& present() const { return present_; }
+
+  /// Return the particle index of each site.
+  const std::vector<int>& particle_index() const { return particle_index_; }
+
+  /// Check that the store is consistent with the particles.
+  void check(const std::vector<Particle>& particles) const;
+
+ private:
+  std::vector<std::vector<double> > coord_;  // [dim][site]
+  std::vector<int> type_;
+  std::vector<int> present_;
+  std::vector<int> is_physical_;
+  std::vector<int> exists_;  // per particle
+  std::vector<int> particle_index_;
+  std::vector<int> particle_start_ = {0};
+};
+
+}  // namespace feasst
+
+#endif  // FEASST_CONFIGURATION_PACKED_SITES_H_
@@ -0,0 +1,107 @@
+
+#ifndef FEASST_CONFIGURATION_TRAJECTORY_FRAME_H_
+#define FEASST_CONFIGURATION_TRAJECTORY_FRAME_H_
+
+#include <vector>
+
+namespace feasst {
+
+class Configuration;
+
+/**
+  The Domain and site positions of one frame of a trajectory (e.g., as read by
+  FileTrajectory or MappedTrajectory).
+
+  The coordinates of all sites are stored contiguously, with the dimension as
+  the fastest index, such that the position of each site is a span of
+  dimension values (see site).
+  The memory is reused when another frame is read into the same object.
+ */
+class TrajectoryFrame {
+ public:
+  TrajectoryFrame() {}
+
+  /// Return the dimension.
+  int dimension() const { return dimension_; }
+
+  /// Return the number of sites.
+  int num_sites() const { return num_sites_; }
+
+  /// Return the side lengths of the Domain.
+  const std::vector<double>& side_lengths() const { return side_lengths_; }
+
+  /// Return the xy tilt factor of the Domain.
+  double xy() const { return xy_; }
+
+  /// Return the xz tilt factor of the Domain.
+  double xz() const { return xz_; }
+
+  /// Return the yz tilt factor of the Domain.
+  double yz() const { return yz_; }
+
+  /// Return the coordinates of all sites.
+  const std::vector<double>& coordinates() const { return coordinates_; }
+
+  /// Return a pointer to the dimension coordinates of a site.
+  const double * site(const int index) const {
+    return &coordinates_[dimension_*index]; }
+
+  /**
+    Return the [type, num_sites, num_particles] of each run of particles of
+    the same type, in the order of the sites.
+    Empty if the format does not store the particle types (e.g., FileXYZ).
+   */
+  const std::vector<std::vector<int> >& particle_runs() const {
+    return particle_runs_; }
+
+  /// Set the dimension and number of sites, and remove the particle runs.
+  void resize(const int dimension, const int num_sites);
+
+  /// Set the side length of the Domain in a dimension.
+  void set_side_length(const int dim, const double length) {
+    side_lengths_[dim] = length; }
+
+  /// Set the tilt factors of the Domain.
+  void set_tilt(const double xy, const double xz, const double yz);
+
+  /// Add a run of particles of the same type.
+  void add_particle_run(const int type, const int num_sites,
+                        const int num_particles);
+
+  /// Return a pointer to the coordinates of a site, for setting.
+  double * get_site(const int index) {
+    return &coordinates_[dimension_*index]; }
+
+  /**
+    Load the frame into the configuration.
+    If there are particle runs, the number of particles of each type is
+    changed as needed, and particles of the same type are assigned positions
+    in their order in the frame.
+    Thus, each particle must be written with all of its sites.
+    Otherwise, as FileXYZ, the number of particles of the only type is
+    changed as needed.
+   */
+  void load(Configuration * config);
+
+ private:
+  int dimension_ = 0;
+  int num_sites_ = 0;
+  std::vector<double> side_lengths_;
+  double xy_ = 0.;
+  double xz_ = 0.;
+  double yz_ = 0.;
+  std::vector<double> coordinates_;
+  std::vector<std::vector<int> > particle_runs_;
+
+  // temporary
+  std::vector<std::vector<int> > first_sites_;
+  std::vector<int> next_;
+  std::vector<std::vector<double> > ordered_;
+
+  void set_num_particles_(const int type, const int num,
+                          Configuration * config) const;
+};
+
+}  // namespace feasst
+
+#endif  // FEASST_CONFIGURATION_TRAJECTORY_FRAME_H_
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "utils/include/arguments.h"
 #include "utils/include/utils.h"
 #include "utils/include/debug.h"
@@ -9,6 +10,7 @@
 #include "configuration/include/neighbor_criteria.h"
 #include "configuration/include/model_params.h"
 #include "configuration/include/group.h"
+#include "configuration/include/packed_sites.h"
 #include "configuration/include/file_xyz.h"
 #include "configuration/include/domain.h"
 #include "configuration/include/select.h"
@@ -140,6 +142,10 @@ Configuration::Configuration(argtype * args) {
   if (boolean("set_cutoff_min_to_sigma", args, false)) {
     unique_types_->set_cutoff_min_to_sigma();
   }
+
+  if (boolean("packed_sites", args, false)) {
+    init_packed_sites();
+  }
 }
 
 void Configuration::add_particle_type(const std::string file_name,
@@ -157,6 +163,9 @@ void Configuration::add_particle_type(const std::string file_name,
 void Configuration::add_(const Particle particle) {
   Particle part = particle;
   particles_->add(part);
+  if (packed_) {
+    packed_->add(particles_->particle(particles_->num() - 1));
+  }
   for (std::shared_ptr<Select> select : group_selects_) {
     add_to_selection_(particles_->num() - 1, select.get());
   }
@@ -187,6 +196,9 @@ void Configuration::add_particle_of_type(const int type) {
     }
     newest_particle_index_ = index;
     ++num_particles_of_type_[type];
+    if (packed_) {
+      packed_->set_exists(index, select_particle(index), true);
+    }
   }
 }
 
@@ -202,6 +214,9 @@ void Configuration::remove_particle_(const int particle_index) {
   for (std::shared_ptr<Select> select : group_selects_) {
     select->remove_particle(particle_index);
   }
+  if (packed_) {
+    packed_->set_exists(particle_index, select_particle(particle_index), false);
+  }
 }
 
 void Configuration::remove_particles(const Select& selection) {
@@ -290,6 +305,10 @@ void Configuration::position_tracker_(const int particle_index,
   for (std::shared_ptr<Select> select : group_selects_) {
     ASSERT(!select->group().is_spatial(), "implement updating of groups");
   }
+  if (packed_) {
+    packed_->update(particle_index, site_index,
+                    select_particle(particle_index).site(site_index));
+  }
 }
 
 void Configuration::position_tracker_(const int particle_index) {
@@ -306,6 +325,34 @@ void Configuration::position_tracker_() {
   }
 }
 
+void Configuration::packed_update_(const int particle_index) {
+  if (packed_) {
+    packed_->update(particle_index, select_particle(particle_index));
+  }
+}
+
+void Configuration::init_packed_sites() {
+  if (packed_) {
+    return;
+  }
+  packed_ = std::make_shared<PackedSites>();
+  packed_->clear(dimension());
+  for (const Particle& part : particles_->particles()) {
+    packed_->add(part);
+  }
+  for (const std::shared_ptr<Select>& ghost : ghosts_) {
+    for (const int particle_index : ghost->particle_indices()) {
+      packed_->set_exists(particle_index, select_particle(particle_index),
+                          false);
+    }
+  }
+}
+
+const PackedSites& Configuration::packed_sites() const {
+  ASSERT(packed_, "PackedSites requires Configuration::init_packed_sites");
+  return *packed_;
+}
+
 void Configuration::set(std::shared_ptr<Domain> domain) {
   domain_ = domain;
   position_tracker_();
@@ -350,6 +397,10 @@ void Configuration::check() const {
   }
 
   model_params().check();
+
+  if (packed_) {
+    packed_->check(particles_->particles());
+  }
 }
 
 bool Configuration::are_all_sites_physical() const {
@@ -375,7 +426,7 @@ bool Configuration::are_all_sites_physical() const {
 // }
 
 void Configuration::update_positions(
-    const std::vector<std::vector<double> > coords) {
+    const std::vector<std::vector<double> >& coords) {
   if (coords.size() == 0) {
     return;
   }
@@ -408,8 +459,8 @@ void Configuration::update_positions(
 }
 
 void Configuration::update_positions(
-    const std::vector<std::vector<double> > coords,
-    const std::vector<std::vector<double> > eulers) {
+    const std::vector<std::vector<double> >& coords,
+    const std::vector<std::vector<double> >& eulers) {
   update_positions(coords);
   ASSERT(dimension() == 3, "Eulers require 3 dimensions.");
   Euler euler;
@@ -597,6 +648,9 @@ void Configuration::revive(const Select& selection) {
     for (std::shared_ptr<Select> select : group_selects_) {
       add_to_selection_(particle_index, select.get());
     }
+    if (packed_) {
+      packed_->set_exists(particle_index, part, true);
+    }
     position_tracker_(particle_index);
   }
 }
@@ -664,6 +718,7 @@ void Configuration::set_selection_physical(const Select& select,
         site_indices[ss_index],
         phys);
     }
+    packed_update_(select.particle_indices()[sp_index]);
   }
 }
 
@@ -715,6 +770,7 @@ void Configuration::set_site_type(const int particle_type,
   for (int particle = 0; particle < particles_->num(); ++particle) {
     if (particles_->particle(particle).type() == particle_type) {
       particles_->set_site_type(particle, site, site_type);
+      packed_update_(particle);
     }
   }
 }
@@ -773,7 +829,7 @@ std::string Configuration::status() const {
 }
 
 void Configuration::serialize(std::ostream& ostr) const {
-  feasst_serialize_version(7199, ostr);
+  feasst_serialize_version(7200, ostr);
   feasst_serialize(version(), ostr);
   feasst_serialize(particle_types_, ostr);
   feasst_serialize(unique_types_, ostr);
@@ -788,13 +844,14 @@ void Configuration::serialize(std::ostream& ostr) const {
   feasst_serialize(wrap_, ostr);
   feasst_serialize(num_cell_lists_, ostr);
   feasst_serialize(neighbor_criteria_, ostr);
+  feasst_serialize(is_packed(), ostr);
   feasst_serialize_endcap("Configuration", ostr);
   DEBUG("size: " << ostr.tellp());
 }
 
 Configuration::Configuration(std::istream& istr) {
   const int config_version = feasst_deserialize_version(istr);
-  ASSERT(config_version >= 7199 && config_version <= 7199,
+  ASSERT(config_version >= 7199 && config_version <= 7200,
     "unrecognized config_version: " << config_version);
   std::string checkpoint_version;
   feasst_deserialize(&checkpoint_version, istr);
@@ -879,6 +936,13 @@ Configuration::Configuration(std::istream& istr) {
       }
     }
   }
+  if (config_version >= 7200) {
+    bool packed;
+    feasst_deserialize(&packed, istr);
+    if (packed) {
+      init_packed_sites();
+    }
+  }
   feasst_deserialize_endcap("Configuration", istr);
 }
 
@@ -915,6 +979,118 @@ void Configuration::copy_particles(const Configuration& config,
   }
 }
 
+bool Configuration::copy_positions(const Configuration& config) {
+  const Domain& domain2 = config.domain();
+  if (domain().side_lengths().coord() != domain2.side_lengths().coord() ||
+      domain().xy() != domain2.xy() ||
+      domain().xz() != domain2.xz() ||
+      domain().yz() != domain2.yz() ||
+      particles_->num() != config.particles_->num() ||
+      ghosts_.size() != config.ghosts_.size()) {
+    return false;
+  }
+  for (int type = 0; type < static_cast<int>(ghosts_.size()); ++type) {
+    if (ghosts_[type]->particle_indices() !=
+        config.ghosts_[type]->particle_indices()) {
+      return false;
+    }
+  }
+  for (int part = 0; part < particles_->num(); ++part) {
+    if (particles_->particle(part).type() !=
+        config.particles_->particle(part).type()) {
+      return false;
+    }
+  }
+  for (int part = 0; part < particles_->num(); ++part) {
+    replace_position_(part, config.particles_->particle(part));
+  }
+  return true;
+}
+
+bool Configuration::synchronize_particles_(const Configuration& config,
+    Select * removed, Select * changed) {
+  const Domain& domain2 = config.domain();
+  const int num = particles_->num();
+  if (domain().side_lengths().coord() != domain2.side_lengths().coord() ||
+      domain().xy() != domain2.xy() ||
+      domain().xz() != domain2.xz() ||
+      domain().yz() != domain2.yz() ||
+      num > config.particles_->num() ||
+      ghosts_.size() != config.ghosts_.size()) {
+    return false;
+  }
+  for (int part = 0; part < num; ++part) {
+    if (particles_->particle(part).type() !=
+        config.particles_->particle(part).type()) {
+      return false;
+    }
+  }
+  // add the missing particles, which are removed below if they are ghosts
+  std::vector<bool> is_revived(config.particles_->num(), false);
+  for (int part = num; part < config.particles_->num(); ++part) {
+    add_non_ghost_particle_of_type(config.particles_->particle(part).type());
+    is_revived[part] = true;
+  }
+  for (int type = 0; type < static_cast<int>(ghosts_.size()); ++type) {
+    const std::vector<int>& ghosts = ghosts_[type]->particle_indices();
+    const std::vector<int>& ghosts2 = config.ghosts_[type]->particle_indices();
+    if (ghosts != ghosts2) {
+      std::vector<bool> is_ghost(is_revived.size(), false);
+      for (const int part : ghosts2) {
+        is_ghost[part] = true;
+      }
+      for (const int part : std::vector<int>(ghosts)) {
+        if (!is_ghost[part]) {
+          Select revived;
+          revived.add_particle(select_particle(part), part);
+          revive(revived);
+          is_revived[part] = true;
+        }
+      }
+      std::fill(is_ghost.begin(), is_ghost.end(), false);
+      for (const int part : ghosts_[type]->particle_indices()) {
+        is_ghost[part] = true;
+      }
+      for (const int part : ghosts2) {
+        if (!is_ghost[part]) {
+          if (!is_revived[part]) {
+            removed->add_particle(select_particle(part), part);
+          }
+          is_revived[part] = false;
+          remove_particle_(part);
+        }
+      }
+    }
+  }
+  for (const int part : selection_of_all().particle_indices()) {
+    const Particle& part1 = select_particle(part);
+    const Particle& part2 = config.select_particle(part);
+    for (int site = 0; site < part1.num_sites(); ++site) {
+      const Site& site1 = part1.site(site);
+      const Site& site2 = part2.site(site);
+      bool is_changed = is_revived[part];
+      if (site1.position().coord() != site2.position().coord()) {
+        replace_position_(part, site, site2.position());
+        is_changed = true;
+      }
+      if (site1.is_physical() != site2.is_physical()) {
+        particles_->set_site_physical(part, site, site2.is_physical());
+        packed_update_(part);
+        is_changed = true;
+      }
+      if (site2.is_anisotropic() && !site1.euler().is_equal(site2.euler(), 0)) {
+        particles_->get_particle(part)->get_site(site)->set_euler(
+          site2.euler());
+        is_changed = true;
+      }
+      if (is_changed) {
+        changed->add_site(part, site);
+      }
+    }
+  }
+  return true;
+}
+
 int Configuration::dimension() const { return domain().dimension(); }
 
 void Configuration::synchronize_(const Configuration& config,
@@ -952,6 +1128,7 @@ void Configuration::set_particle_type(const int ptype,
     for (std::shared_ptr<Select> sel : group_selects_) {
       update_selection_(particle_index, sel.get());
     }
+    packed_update_(particle_index);
     // HWH doesn't update type-based cell lists, groups, etc.
   }
 }
@@ -107,6 +107,13 @@ void Domain::set_yz_(const double yz) {
   }
 }
 
+void Domain::set_tilt(const double xy, const double xz, const double yz) {
+  is_tilted_ = false;
+  set_xy_(xy);
+  set_xz_(xz);
+  set_yz_(yz);
+}
+
 double Domain::volume() const {
   double vol = 1.;
   for (double length : side_lengths_.coord()) {
@@ -115,7 +122,22 @@ double Domain::volume() const {
   return vol;
 }
 
+template <int D>
+Position fixed_shift(const Domain& domain, const Position& position) {
+  const FixedPosition<D> pos1(position), origin;
+  FixedPosition<D> rel, pbc;
+  double r2;
+  domain.wrap_opt(pos1, origin, &rel, &pbc, &r2);
+  rel.subtract(pos1);
+  return rel.position();
+}
+
 Position Domain::shift(const Position& position) const {
+  if (position.dimension() == 3) {
+    return fixed_shift<3>(*this, position);
+  } else if (position.dimension() == 2) {
+    return fixed_shift<2>(*this, position);
+  }
   // use the optimized version for consistency
   Position pos2, rel, pbc;
   pos2.set_to_origin_3D();
@@ -0,0 +1,311 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "utils/include/arguments.h"
+#include "utils/include/serialize.h"
+#include "utils/include/debug.h"
+#include "math/include/constants.h"
+#include "configuration/include/particle.h"
+#include "configuration/include/select.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/configuration.h"
+#include "configuration/include/file_trajectory.h"
+
+namespace feasst {
+
+namespace {
+
+// The beginning of the file, followed by a format version.
+const std::string header = "FEASSTTrajectory";
+const uint32_t format_version = 1;
+
+void put_raw(const void * data, const size_t size, std::string * bytes) {
+  bytes->append(static_cast<const char *>(data), size);
+}
+
+// Write an unsigned integer in 7-bit groups, from least to most significant,
+// with the highest bit of each byte set if more bytes follow.
+void put_varint(uint64_t value, std::string * bytes) {
+  while (value >= 0x80) {
+    bytes->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  bytes->push_back(static_cast<char>(value));
+}
+
+// Map signed integers to unsigned, such that small magnitudes remain small.
+void put_signed(const int64_t value, std::string * bytes) {
+  put_varint((static_cast<uint64_t>(value) << 1) ^
+             static_cast<uint64_t>(value >> 63), bytes);
+}
+
+// Read the bytes of a frame in order.
+class FrameReader {
+ public:
+  FrameReader(const char * bytes, const size_t size)
+    : bytes_(bytes), size_(size) {}
+
+  void get_raw(void * data, const size_t size) {
+    ASSERT(position_ + size <= size_, "frame is too short");
+    std::memcpy(data, bytes_ + position_, size);
+    position_ += size;
+  }
+
+  uint64_t get_varint() {
+    uint64_t value = 0;
+    int shift = 0;
+    while (true) {
+      ASSERT(position_ < size_ && shift < 64, "frame is corrupt");
+      const unsigned char byte = bytes_[position_++];
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (byte < 0x80) return value;
+      shift += 7;
+    }
+  }
+
+  int64_t get_signed() {
+    const uint64_t value = get_varint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  bool is_end() const { return position_ == size_; }
+
+ private:
+  const char * bytes_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
+FileTrajectory::FileTrajectory(argtype * args) {
+  group_index_ = 0;
+  if (used("group_index", *args)) {
+    group_index_ = integer("group_index", args);
+    ASSERT(!used("group", *args),
+      "cant specify both group_index and group name");
+  } else {
+    if (used("group", *args)) {
+      group_ = str("group", args);
+    }
+  }
+  append_ = boolean("append", args, false);
+  precision_ = dble("precision", args, 1e-4);
+  ASSERT(precision_ > 0, "precision: " << precision_ << " must be positive");
+}
+FileTrajectory::FileTrajectory(argtype args) : FileTrajectory(&args) {
+  feasst_check_all_used(args);
+}
+FileTrajectory::~FileTrajectory() {}
+
+void FileTrajectory::write(const std::string& file_name,
+    const Configuration& config) const {
+  ASSERT(is_little_endian(), "assumes little-endian byte order");
+  int gindex = group_index_;
+  if (!group_.empty()) {
+    gindex = config.group_index(group_);
+  }
+  const Select& select = config.group_select(gindex);
+  const Domain& domain = config.domain();
+  const int dimension = domain.dimension();
+  std::string frame;
+  const int32_t dim32 = dimension;
+  put_raw(&dim32, sizeof(dim32), &frame);
+  for (int dim = 0; dim < dimension; ++dim) {
+    const double side = domain.side_length(dim);
+    put_raw(&side, sizeof(side), &frame);
+  }
+  const double tilts[3] = {domain.xy(), domain.xz(), domain.yz()};
+  put_raw(tilts, sizeof(tilts), &frame);
+  put_raw(&precision_, sizeof(precision_), &frame);
+
+  // the particle types and their number of sites, as runs of
+  // [type, num_sites, num_particles].
+  std::vector<std::vector<int> > runs;
+  for (int index = 0; index < select.num_particles(); ++index) {
+    const int type = config.select_particle(
+      select.particle_index(index)).type();
+    const int num_sites = static_cast<int>(select.site_indices()[index].size());
+    if (runs.size() == 0 || runs.back()[0] != type ||
+        runs.back()[1] != num_sites) {
+      runs.push_back({type, num_sites, 0});
+    }
+    ++runs.back()[2];
+  }
+  put_varint(runs.size(), &frame);
+  for (const std::vector<int>& run : runs) {
+    for (const int value : run) {
+      put_varint(value, &frame);
+    }
+  }
+
+  // the quantized coordinates, as differences from the previous site.
+  std::vector<int64_t> previous(dimension, 0);
+  for (int index = 0; index < select.num_particles(); ++index) {
+    const Particle& particle = config.select_particle(
+      select.particle_index(index));
+    for (const int site : select.site_indices()[index]) {
+      const Position& position = particle.site(site).position();
+      for (int dim = 0; dim < dimension; ++dim) {
+        const int64_t quantized = std::llround(position.coord(dim)/precision_);
+        put_signed(quantized - previous[dim], &frame);
+        previous[dim] = quantized;
+      }
+    }
+  }
+
+  std::ofstream file;
+  if (append_) {
+    file.open(file_name, std::ofstream::app | std::ofstream::binary);
+  } else {
+    file.open(file_name, std::ofstream::trunc | std::ofstream::binary);
+  }
+  ASSERT(file.good(), "cannot open " << file_name);
+  if (file.tellp() == 0) {
+    file.write(header.data(), header.size());
+    file.write(reinterpret_cast<const char *>(&format_version),
+               sizeof(format_version));
+  }
+  const uint64_t size = frame.size();
+  file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  file.write(frame.data(), frame.size());
+}
+
+bool FileTrajectory::is_format(const std::string& file_name) {
+  std::ifstream file(file_name, std::ifstream::binary);
+  std::string begin(header.size(), ' ');
+  file.read(&begin[0], header.size());
+  return file.good() && begin == header;
+}
+
+void FileTrajectory::open(const std::string& file_name) {
+  ASSERT(is_little_endian(), "assumes little-endian byte order");
+  ASSERT(is_format(file_name), "cannot open " << file_name <<
+    " or it is not a FileTrajectory");
+  file_ = std::make_shared<std::ifstream>(file_name, std::ifstream::binary);
+  file_->seekg(0, std::ifstream::end);
+  const std::streamoff file_size = file_->tellg();
+  file_->seekg(header.size());
+  uint32_t version;
+  file_->read(reinterpret_cast<char *>(&version), sizeof(version));
+  ASSERT(version == format_version, "unrecognized version: " << version);
+  offsets_.clear();
+  std::streamoff offset = file_->tellg();
+  uint64_t size;
+  while (file_->read(reinterpret_cast<char *>(&size), sizeof(size))) {
+    const std::streamoff end = offset + sizeof(size) + size;
+    if (end > file_size) {
+      WARN("ignoring an incomplete frame at the end of " << file_name);
+      break;
+    }
+    offsets_.push_back(offset);
+    offset = end;
+    file_->seekg(offset);
+  }
+  file_->clear();
+}
+
+void FileTrajectory::index(const char * bytes, const size_t size,
+    std::vector<size_t> * begins, std::vector<size_t> * sizes) {
+  ASSERT(is_little_endian(), "assumes little-endian byte order");
+  ASSERT(size >= header.size() + sizeof(format_version) &&
+    std::memcmp(bytes, header.data(), header.size()) == 0,
+    "not a FileTrajectory");
+  uint32_t version;
+  std::memcpy(&version, bytes + header.size(), sizeof(version));
+  ASSERT(version == format_version, "unrecognized version: " << version);
+  begins->clear();
+  sizes->clear();
+  size_t offset = header.size() + sizeof(version);
+  uint64_t frame_size;
+  while (offset + sizeof(frame_size) <= size) {
+    std::memcpy(&frame_size, bytes + offset, sizeof(frame_size));
+    offset += sizeof(frame_size);
+    if (frame_size > size - offset) {
+      WARN("ignoring an incomplete frame at the end of the file");
+      break;
+    }
+    begins->push_back(offset);
+    sizes->push_back(frame_size);
+    offset += frame_size;
+  }
+}
+
+void FileTrajectory::decode(const char * bytes, const size_t size,
+    TrajectoryFrame * frame) {
+  FrameReader reader(bytes, size);
+
+  // domain
+  int32_t dimension;
+  reader.get_raw(&dimension, sizeof(dimension));
+  ASSERT(dimension > 0 && dimension <= 3, "frame is corrupt");
+  std::vector<double> sides(dimension);
+  reader.get_raw(sides.data(), sizeof(double)*dimension);
+  double tilts[3];
+  reader.get_raw(tilts, sizeof(tilts));
+  double precision;
+  reader.get_raw(&precision, sizeof(precision));
+
+  // particle types
+  std::vector<std::vector<int> > runs(reader.get_varint(),
+                                      std::vector<int>(3));
+  int num_sites = 0;
+  for (std::vector<int>& run : runs) {
+    for (int& value : run) {
+      value = static_cast<int>(reader.get_varint());
+    }
+    num_sites += run[1]*run[2];
+  }
+  frame->resize(dimension, num_sites);
+  for (int dim = 0; dim < dimension; ++dim) {
+    frame->set_side_length(dim, sides[dim]);
+  }
+  frame->set_tilt(tilts[0], tilts[1], tilts[2]);
+  for (const std::vector<int>& run : runs) {
+    frame->add_particle_run(run[0], run[1], run[2]);
+  }
+
+  // coordinates
+  int64_t quantized[3] = {0, 0, 0};
+  for (int site = 0; site < num_sites; ++site) {
+    double * coord = frame->get_site(site);
+    for (int dim = 0; dim < dimension; ++dim) {
+      quantized[dim] += reader.get_signed();
+      coord[dim] = precision*static_cast<double>(quantized[dim]);
+    }
+  }
+  ASSERT(reader.is_end(), "frame is corrupt");
+}
+
+void FileTrajectory::load_frame(const int frame, Configuration * config) {
+  ASSERT(file_, "open the file before loading a frame");
+  ASSERT(frame >= 0 && frame < num_frames(), "frame: " << frame <<
+    " is out of range of the number of frames: " << num_frames());
+  file_->seekg(offsets_[frame]);
+  uint64_t size;
+  file_->read(reinterpret_cast<char *>(&size), sizeof(size));
+  bytes_.resize(size);
+  file_->read(&bytes_[0], size);
+  ASSERT(file_->good(), "cannot read frame: " << frame);
+  decode(bytes_.data(), bytes_.size(), &frame_);
+  frame_.load(config);
+}
+
+void FileTrajectory::serialize(std::ostream& ostr) const {
+  feasst_serialize_version(4027, ostr);
+  feasst_serialize(group_index_, ostr);
+  feasst_serialize(group_, ostr);
+  feasst_serialize(append_, ostr);
+  feasst_serialize(precision_, ostr);
+}
+
+FileTrajectory::FileTrajectory(std::istream& istr) {
+  const int version = feasst_deserialize_version(istr);
+  ASSERT(version == 4027, "version mismatch: " << version);
+  feasst_deserialize(&group_index_, istr);
+  feasst_deserialize(&group_, istr);
+  feasst_deserialize(&append_, istr);
+  feasst_deserialize(&precision_, istr);
+}
+
+}  // namespace feasst
@@ -0,0 +1,159 @@
+#include <cstdlib>
+#include <cstring>
+#include "utils/include/debug.h"
+#include "utils/include/file.h"
+#include "math/include/constants.h"
+#include "configuration/include/file_trajectory.h"
+#include "configuration/include/mapped_trajectory.h"
+
+namespace feasst {
+
+namespace {
+
+// Return the end of the line which begins at position, excluding the newline.
+const char * line_end(const char * position, const char * end) {
+  const void * newline = std::memchr(position, '\n', end - position);
+  if (newline == nullptr) {
+    return end;
+  }
+  return static_cast<const char *>(newline);
+}
+
+// Parse the next number of the line, and advance the position beyond it.
+// Return false if there are no more numbers in the line.
+// The mapped file is not null terminated, so copy the number before parsing.
+bool next_number(const char ** position, const char * end, double * value) {
+  const char * pos = *position;
+  while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+    ++pos;
+  }
+  if (pos == end) {
+    return false;
+  }
+  const char * begin = pos;
+  while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\r') {
+    ++pos;
+  }
+  char token[64];
+  const size_t length = static_cast<size_t>(pos - begin);
+  ASSERT(length < sizeof(token), "number is too long");
+  std::memcpy(token, begin, length);
+  token[length] = '\0';
+  char * parsed;
+  *value = std::strtod(token, &parsed);
+  ASSERT(parsed == token + length, "cannot parse: " << token);
+  *position = pos;
+  return true;
+}
+
+}  // namespace
+
+MappedTrajectory::MappedTrajectory(const std::string& file_name)
+  : file_name_(file_name) {
+  buffer_ = std::make_shared<MappedFileBuffer>(file_name);
+  is_compressed_ = FileTrajectory::is_format(file_name);
+  if (is_compressed_) {
+    FileTrajectory::index(buffer_->data(), buffer_->size(), &begins_, &sizes_);
+  } else {
+    index_xyz_();
+  }
+}
+
+MappedTrajectory::~MappedTrajectory() {}
+
+void MappedTrajectory::index_xyz_() {
+  const char * data = buffer_->data();
+  const char * end = data + buffer_->size();
+  const char * position = data;
+  while (position < end) {
+    const char * begin = position;
+    const char * first_end = line_end(position, end);
+    double num_sites;
+    if (!next_number(&position, first_end, &num_sites)) {
+      // ignore blank lines at the end of the file
+      position = first_end + 1;
+      continue;
+    }
+    position = first_end;
+    for (int line = 0; line < static_cast<int>(num_sites) + 1; ++line) {
+      if (position >= end) break;
+      position = line_end(position + 1, end);
+    }
+    if (position >= end) {
+      WARN("ignoring an incomplete frame at the end of " << file_name_);
+      break;
+    }
+    ++position;
+    begins_.push_back(static_cast<size_t>(begin - data));
+    sizes_.push_back(static_cast<size_t>(position - begin));
+  }
+}
+
+void MappedTrajectory::read_xyz_(const char * bytes, const size_t size,
+    TrajectoryFrame * data) const {
+  const char * end = bytes + size;
+  const char * position = bytes;
+  const char * eol = line_end(position, end);
+  double value;
+  bool is_read = next_number(&position, eol, &value);
+  ASSERT(is_read, "cannot read number of sites");
+  const int num_sites = static_cast<int>(value);
+
+  // the second line contains an id, the side lengths and the tilt factors.
+  position = eol + 1;
+  eol = line_end(position, end);
+  std::vector<double> domain;
+  is_read = next_number(&position, eol, &value);
+  ASSERT(is_read, "cannot read domain");
+  while (domain.size() < 6 && next_number(&position, eol, &value)) {
+    domain.push_back(value);
+  }
+  ASSERT(domain.size() >= 2, "cannot read side lengths");
+  int dimension = 3;
+  if (domain.size() < 3 || domain[2] < NEAR_ZERO) {
+    dimension = 2;
+  }
+  data->resize(dimension, num_sites);
+  for (int dim = 0; dim < dimension; ++dim) {
+    data->set_side_length(dim, domain[dim]);
+  }
+  double tilts[3] = {0., 0., 0.};
+  for (int tilt = 0; tilt < 3; ++tilt) {
+    if (dimension + tilt < static_cast<int>(domain.size())) {
+      tilts[tilt] = domain[dimension + tilt];
+    }
+  }
+  data->set_tilt(tilts[0], tilts[1], tilts[2]);
+
+  // each site line contains the type and the coordinates
+  for (int site = 0; site < num_sites; ++site) {
+    position = eol + 1;
+    ASSERT(position < end, "frame is too short");
+    eol = line_end(position, end);
+    is_read = next_number(&position, eol, &value);
+    double * coord = data->get_site(site);
+    for (int dim = 0; dim < dimension; ++dim) {
+      is_read = is_read && next_number(&position, eol, &coord[dim]);
+    }
+    ASSERT(is_read, "cannot read site: " << site);
+  }
+}
+
+void MappedTrajectory::read(const int frame, TrajectoryFrame * data) const {
+  ASSERT(frame >= 0 && frame < num_frames(), "frame: " << frame <<
+    " is out of range of the number of frames: " << num_frames());
+  const char * bytes = buffer_->data() + begins_[frame];
+  if (is_compressed_) {
+    FileTrajectory::decode(bytes, sizes_[frame], data);
+  } else {
+    read_xyz_(bytes, sizes_[frame], data);
+  }
+}
+
+void MappedTrajectory::load(const int frame, Configuration * config,
+    TrajectoryFrame * data) const {
+  read(frame, data);
+  data->load(config);
+}
+
+}  // namespace feasst
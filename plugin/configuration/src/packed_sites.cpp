@@ -0,0 +1,86 @@
+#include "utils/include/debug.h"
+#include "configuration/include/site.h"
+#include "configuration/include/particle.h"
+#include "configuration/include/packed_sites.h"
+
+namespace feasst {
+
+void PackedSites::clear(const int dimension) {
+  coord_.assign(dimension, std::vector<double>());
+  type_.clear();
+  present_.clear();
+  is_physical_.clear();
+  exists_.clear();
+  particle_index_.clear();
+  particle_start_.assign(1, 0);
+}
+
+void PackedSites::add(const Particle& particle) {
+  const int particle_index = num_particles();
+  for (const Site& site : particle.sites()) {
+    ASSERT(site.position().dimension() == dimension(),
+      "site dimension: " << site.position().dimension() << " != " <<
+      dimension());
+    for (int dim = 0; dim < dimension(); ++dim) {
+      coord_[dim].push_back(site.position().coord(dim));
+    }
+    type_.push_back(site.type());
+    is_physical_.push_back(site.is_physical());
+    present_.push_back(site.is_physical());
+    particle_index_.push_back(particle_index);
+  }
+  exists_.push_back(1);
+  particle_start_.push_back(num_sites());
+}
+
+void PackedSites::update(const int particle_index, const int site_index,
+                         const Site& site) {
+  const int sid = id(particle_index, site_index);
+  const std::vector<double>& coord = site.position().coord();
+  for (int dim = 0; dim < dimension(); ++dim) {
+    coord_[dim][sid] = coord[dim];
+  }
+  type_[sid] = site.type();
+  is_physical_[sid] = site.is_physical();
+  present_[sid] = is_physical_[sid]*exists_[particle_index];
+}
+
+void PackedSites::update(const int particle_index, const Particle& particle) {
+  for (int site_index = 0; site_index < particle.num_sites(); ++site_index) {
+    update(particle_index, site_index, particle.site(site_index));
+  }
+}
+
+void PackedSites::set_exists(const int particle_index,
+                             const Particle& particle,
+                             const bool exists) {
+  exists_[particle_index] = exists;
+  update(particle_index, particle);
+}
+
+void PackedSites::check(const std::vector<Particle>& particles) const {
+  ASSERT(static_cast<int>(particles.size()) == num_particles(),
+    "num particles: " << particles.size() << " != " << num_particles());
+  for (int part = 0; part < num_particles(); ++part) {
+    const Particle& particle = particles[part];
+    ASSERT(particle.num_sites() == start(part + 1) - start(part),
+      "size error");
+    // ghost coordinates are only updated when the ghost is revived
+    if (exists_[part] == 0) {
+      continue;
+    }
+    for (int site = 0; site < particle.num_sites(); ++site) {
+      const int sid = id(part, site);
+      const Site& st = particle.site(site);
+      for (int dim = 0; dim < dimension(); ++dim) {
+        ASSERT(coord_[dim][sid] == st.position().coord(dim),
+          "site " << sid << " coordinate mismatch in dimension " << dim);
+      }
+      ASSERT(type_[sid] == st.type(), "site " << sid << " type mismatch");
+      ASSERT(is_physical_[sid] == st.is_physical(),
+        "site " << sid << " physical mismatch");
+    }
+  }
+}
+
+}  // namespace feasst
@@ -0,0 +1,119 @@
+#include "utils/include/debug.h"
+#include "math/include/position.h"
+#include "configuration/include/particle.h"
+#include "configuration/include/select.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/configuration.h"
+#include "configuration/include/trajectory_frame.h"
+
+namespace feasst {
+
+void TrajectoryFrame::resize(const int dimension, const int num_sites) {
+  dimension_ = dimension;
+  num_sites_ = num_sites;
+  side_lengths_.resize(dimension);
+  coordinates_.resize(dimension*num_sites);
+  particle_runs_.clear();
+}
+
+void TrajectoryFrame::set_tilt(const double xy, const double xz,
+    const double yz) {
+  xy_ = xy;
+  xz_ = xz;
+  yz_ = yz;
+}
+
+void TrajectoryFrame::add_particle_run(const int type, const int num_sites,
+    const int num_particles) {
+  particle_runs_.push_back({type, num_sites, num_particles});
+}
+
+// Add or remove particles of the type, from the end, to reach num.
+void TrajectoryFrame::set_num_particles_(const int type, const int num,
+    Configuration * config) const {
+  while (config->num_particles_of_type(type) < num) {
+    config->add_particle_of_type(type);
+  }
+  if (config->num_particles_of_type(type) > num) {
+    Select select;
+    select.add_particle(config->particle_type(type), 0);
+    const Select& all = config->selection_of_all();
+    for (int index = all.num_particles() - 1;
+         index >= 0 && config->num_particles_of_type(type) > num;
+         --index) {
+      const int particle_index = all.particle_index(index);
+      if (config->select_particle(particle_index).type() == type) {
+        select.set_particle(0, particle_index);
+        config->remove_particle(select);
+      }
+    }
+  }
+}
+
+void TrajectoryFrame::load(Configuration * config) {
+  ASSERT(dimension_ == config->dimension(), "frame dimension: " << dimension_
+    << " does not match the Configuration: " << config->dimension());
+  Position sides;
+  sides.set_vector(side_lengths_);
+  config->set_side_lengths(sides);
+  config->get_domain()->set_tilt(xy_, xz_, yz_);
+
+  if (particle_runs_.size() == 0) {
+    if (num_sites_ != config->num_sites()) {
+      ASSERT(config->num_particle_types() == 1, "assumes 1 particle type");
+      const int sites_per_particle = config->particle_type(0).num_sites();
+      ASSERT(num_sites_ % sites_per_particle == 0, "number of sites: " <<
+        num_sites_ << " is incompatible with the sites per particle: " <<
+        sites_per_particle);
+      set_num_particles_(0, num_sites_/sites_per_particle, config);
+    }
+  } else {
+    // the index of the first site of each particle, by type
+    first_sites_.resize(config->num_particle_types());
+    for (std::vector<int>& first : first_sites_) {
+      first.clear();
+    }
+    int site = 0;
+    for (const std::vector<int>& run : particle_runs_) {
+      const int type = run[0], sites = run[1], num = run[2];
+      ASSERT(type < config->num_particle_types(), "particle type: " << type <<
+        " of the frame was not added to the Configuration");
+      ASSERT(sites == config->particle_type(type).num_sites(),
+        "frame particles of type: " << type << " have " << sites << " sites "
+        << "instead of " << config->particle_type(type).num_sites());
+      for (int index = 0; index < num; ++index) {
+        first_sites_[type].push_back(site);
+        site += sites;
+      }
+    }
+    ASSERT(site == num_sites_, "particle runs have " << site << " sites " <<
+      "instead of " << num_sites_);
+    for (int type = 0; type < config->num_particle_types(); ++type) {
+      set_num_particles_(type,
+        static_cast<int>(first_sites_[type].size()), config);
+    }
+  }
+
+  // order the coordinates as the particles in the configuration
+  ordered_.resize(num_sites_);
+  next_.assign(config->num_particle_types(), 0);
+  const Select& all = config->selection_of_all();
+  int site = 0;
+  for (int index = 0; index < all.num_particles(); ++index) {
+    const Particle& particle = config->select_particle(
+      all.particle_index(index));
+    int first = site;
+    if (particle_runs_.size() > 0) {
+      const int type = particle.type();
+      first = first_sites_[type][next_[type]++];
+    }
+    for (int psite = 0; psite < particle.num_sites(); ++psite) {
+      const double * coord = this->site(first + psite);
+      ordered_[site].assign(coord, coord + dimension_);
+      ++site;
+    }
+  }
+  config->update_positions(ordered_);
+}
+
+}  // namespace feasst
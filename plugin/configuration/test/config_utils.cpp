@@ -1,8 +1,10 @@
+#include "utils/test/utils.h"
 #include "utils/include/io.h"
 #include "utils/include/debug.h"
 #include "configuration/test/config_utils.h"
 #include "configuration/include/file_xyz.h"
 #include "configuration/include/domain.h"
+#include "configuration/include/particle.h"
 
 namespace feasst {
 
@@ -27,4 +29,22 @@ Configuration two_particle_configuration(argtype args) {
   return config;
 }
 
+void expect_same_positions(const Configuration& config1,
+    const Configuration& config2, const double tolerance) {
+  ASSERT_EQ(config1.num_particles(), config2.num_particles());
+  const Select& all1 = config1.selection_of_all();
+  const Select& all2 = config2.selection_of_all();
+  for (int index = 0; index < all1.num_particles(); ++index) {
+    const Particle& part1 = config1.select_particle(all1.particle_index(index));
+    const Particle& part2 = config2.select_particle(all2.particle_index(index));
+    EXPECT_EQ(part1.type(), part2.type());
+    for (int site = 0; site < part1.num_sites(); ++site) {
+      for (int dim = 0; dim < config1.dimension(); ++dim) {
+        EXPECT_NEAR(part1.site(site).position().coord(dim),
+                    part2.site(site).position().coord(dim), tolerance);
+      }
+    }
+  }
+}
+
 }  // namespace feasst
@@ -26,6 +26,10 @@ Configuration spce_sample1();
  */
 Configuration two_particle_configuration(argtype args = argtype());
 
+/// Expect the same particle types and site positions, within tolerance.
+void expect_same_positions(const Configuration& config1,
+  const Configuration& config2, const double tolerance);
+
 }  // namespace feasst
 
 #endif  // FEASST_TEST_CONFIGURATION_UTILS_H_
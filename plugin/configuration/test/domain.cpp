@@ -97,6 +97,31 @@ TEST(Domain, wrap) {
   EXPECT_NEAR(0, shift.coord(1), NEAR_ZERO);
 }
 
+TEST(Domain, wrap_opt_fixed) {
+  RandomMT19937 random;
+  for (const argtype& args : std::vector<argtype>({
+      {{"cubic_side_length", "5"}},
+      {{"cubic_side_length", "5"}, {"xy", "1"}, {"xz", "0.5"}, {"yz", "-1"}}})) {
+    auto domain = MakeDomain(args);
+    Position pos1(3), pos2(3), rel(3), pbc(3);
+    Position3D fpos1, fpos2, frel, fpbc;
+    double r2, fr2;
+    for (int trial = 0; trial < 100; ++trial) {
+      random.position_in_cube(3, 20, &pos1);
+      random.position_in_cube(3, 20, &pos2);
+      fpos1.set(pos1);
+      fpos2.set(pos2);
+      domain->wrap_opt(pos1, pos2, &rel, &pbc, &r2);
+      domain->wrap_opt(fpos1, fpos2, &frel, &fpbc, &fr2);
+      EXPECT_NEAR(r2, fr2, 1e-12);
+      for (int dim = 0; dim < 3; ++dim) {
+        EXPECT_NEAR(rel.coord(dim), frel.coord(dim), 1e-12);
+        EXPECT_NEAR(pbc.coord(dim), fpbc.coord(dim), 1e-12);
+      }
+    }
+  }
+}
+
 TEST(Domain, non_cubic) {
   auto domain = MakeDomain({
     {"side_length0", "3"},
@@ -0,0 +1,66 @@
+#include <cstdio>
+#include "utils/test/utils.h"
+#include "configuration/include/file_xyz.h"
+#include "configuration/include/file_trajectory.h"
+#include "configuration/test/config_utils.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/select.h"
+
+namespace feasst {
+
+TEST(FileTrajectory, write_load) {
+  std::remove("tmp/traj.fsttrj");
+  Configuration config = lj_sample4();
+  FileTrajectory traj(argtype({{"append", "true"}}));
+  traj.write("tmp/traj.fsttrj", config);
+  Configuration config2 = lj_sample4();
+  Select select;
+  select.add_particle(config2.particle_type(0), 0);
+  for (int remove = 0; remove < 5; ++remove) {
+    select.set_particle(0, config2.selection_of_all().particle_index(3));
+    config2.remove_particle(select);
+  }
+  config2.set_side_lengths(Position(std::vector<double>({9., 9., 9.})));
+  config2.get_domain()->set_tilt(0.5, 0., 0.);
+  traj.write("tmp/traj.fsttrj", config2);
+  EXPECT_TRUE(FileTrajectory::is_format("tmp/traj.fsttrj"));
+
+  auto config3 = MakeConfiguration({{"cubic_side_length", "8"},
+    {"particle_type0", "../particle/lj.fstprt"}});
+  FileTrajectory traj2 = test_serialize(traj);
+  traj2.open("tmp/traj.fsttrj");
+  EXPECT_EQ(2, traj2.num_frames());
+  traj2.load_frame(1, config3.get());
+  EXPECT_EQ(25, config3->num_particles());
+  EXPECT_NEAR(9., config3->domain().side_length(2), NEAR_ZERO);
+  EXPECT_NEAR(0.5, config3->domain().xy(), NEAR_ZERO);
+  expect_same_positions(config2, *config3, 1e-4);
+  traj2.load_frame(0, config3.get());
+  EXPECT_EQ(30, config3->num_particles());
+  EXPECT_NEAR(8., config3->domain().side_length(2), NEAR_ZERO);
+  EXPECT_NEAR(0., config3->domain().xy(), NEAR_ZERO);
+  expect_same_positions(config, *config3, 1e-4);
+
+  // multiple sites
+  Configuration spce = spce_sample1();
+  FileTrajectory(argtype({{"precision", "1e-6"}})).write("tmp/spce.fsttrj",
+                                                        spce);
+  FileTrajectory traj3;
+  traj3.open("tmp/spce.fsttrj");
+  auto config4 = MakeConfiguration({{"cubic_side_length", "20"},
+    {"particle_type0", "../particle/spce.fstprt"}});
+  traj3.load_frame(0, config4.get());
+  expect_same_positions(spce, *config4, 1e-6);
+
+  TRY(
+    traj3.load_frame(1, config4.get());
+    CATCH_PHRASE("is out of range");
+  );
+  FileXYZ().write("tmp/traj.xyz", spce);
+  TRY(
+    FileTrajectory().open("tmp/traj.xyz");
+    CATCH_PHRASE("is not a FileTrajectory");
+  );
+}
+
+}  // namespace feasst
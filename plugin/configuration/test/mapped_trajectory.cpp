@@ -0,0 +1,109 @@
+#include <cstdio>
+#include "utils/test/utils.h"
+#include "utils/include/timer.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/file_xyz.h"
+#include "configuration/include/file_trajectory.h"
+#include "configuration/include/mapped_trajectory.h"
+#include "configuration/test/config_utils.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/select.h"
+
+namespace feasst {
+
+TEST(MappedTrajectory, xyz_and_compressed) {
+  const std::string xyz_file = "tmp/mapped.xyz", traj_file = "tmp/mapped.fsttrj";
+  std::remove(xyz_file.c_str());
+  std::remove(traj_file.c_str());
+  Configuration config = lj_sample4();
+  FileXYZ xyz(argtype({{"append", "true"}}));
+  FileTrajectory traj(argtype({{"append", "true"}}));
+  xyz.write(xyz_file, config);
+  traj.write(traj_file, config);
+  Configuration config2 = lj_sample4();
+  Select select;
+  select.add_particle(config2.particle_type(0), 0);
+  for (int remove = 0; remove < 5; ++remove) {
+    select.set_particle(0, config2.selection_of_all().particle_index(3));
+    config2.remove_particle(select);
+  }
+  config2.set_side_lengths(Position(std::vector<double>({9., 9., 9.})));
+  xyz.write(xyz_file, config2);
+  traj.write(traj_file, config2);
+
+  for (const std::string& file : {xyz_file, traj_file}) {
+    const MappedTrajectory mapped(file);
+    EXPECT_EQ(file == traj_file, mapped.is_compressed());
+    EXPECT_EQ(2, mapped.num_frames());
+    TrajectoryFrame data;
+    mapped.read(1, &data);
+    EXPECT_EQ(3, data.dimension());
+    EXPECT_EQ(25, data.num_sites());
+    EXPECT_NEAR(9., data.side_lengths()[2], NEAR_ZERO);
+    const Position& pos = config2.particle(1).site(0).position();
+    EXPECT_NEAR(pos.coord(1), data.site(1)[1], 1e-4);
+
+    // load the frames in reverse
+    auto config3 = MakeConfiguration({{"cubic_side_length", "8"},
+      {"particle_type0", "../particle/lj.fstprt"}});
+    mapped.load(1, config3.get(), &data);
+    EXPECT_EQ(25, config3->num_particles());
+    expect_same_positions(config2, *config3, 1e-4);
+    mapped.load(0, config3.get(), &data);
+    EXPECT_EQ(30, config3->num_particles());
+    EXPECT_NEAR(8., config3->domain().side_length(0), NEAR_ZERO);
+    expect_same_positions(config, *config3, 1e-4);
+    TRY(
+      mapped.read(2, &data);
+      CATCH_PHRASE("is out of range");
+    );
+  }
+
+  // an incomplete last frame is ignored
+  {
+    std::ofstream file(xyz_file, std::ofstream::app);
+    file << "30" << std::endl << "-1 8 8 8 0 0 0" << std::endl << "0 1 1 1";
+  }
+  EXPECT_EQ(2, MappedTrajectory(xyz_file).num_frames());
+}
+
+// Compare the time to read frames of a FileXYZ with FileXYZ::load_frame.
+TEST(MappedTrajectory, benchmark_LONG) {
+  const std::string xyz_file = "tmp/mapped_bench.xyz";
+  std::remove(xyz_file.c_str());
+  auto config = MakeConfiguration({{"cubic_side_length", "50"},
+    {"particle_type0", "../particle/lj.fstprt"},
+    {"add_particles_of_type0", "10000"}});
+  RandomMT19937 random;
+  FileXYZ xyz(argtype({{"append", "true"}}));
+  const int num_frames = 10;
+  for (int frame = 0; frame < num_frames; ++frame) {
+    std::vector<std::vector<double> > coords(config->num_sites());
+    for (std::vector<double>& coord : coords) {
+      coord = {random.uniform_real(0., 50.), random.uniform_real(0., 50.),
+               random.uniform_real(0., 50.)};
+    }
+    config->update_positions(coords);
+    xyz.write(xyz_file, *config);
+  }
+  auto config2 = MakeConfiguration({{"cubic_side_length", "50"},
+    {"particle_type0", "../particle/lj.fstprt"}});
+  double begin = cpu_hours();
+  std::ifstream file(xyz_file);
+  while (xyz.load_frame(file, config2.get())) {}
+  const double xyz_hours = cpu_hours() - begin;
+  begin = cpu_hours();
+  const MappedTrajectory mapped(xyz_file);
+  TrajectoryFrame data;
+  for (int frame = 0; frame < mapped.num_frames(); ++frame) {
+    mapped.load(frame, config2.get(), &data);
+  }
+  const double mapped_hours = cpu_hours() - begin;
+  INFO("FileXYZ seconds: " << xyz_hours*3600. << " MappedTrajectory seconds: "
+    << mapped_hours*3600.);
+  EXPECT_EQ(num_frames, mapped.num_frames());
+  EXPECT_LT(mapped_hours, xyz_hours);
+  expect_same_positions(*config, *config2, 1e-4);
+}
+
+}  // namespace feasst
@@ -77,6 +77,7 @@ class Bias {
 
   // HWH hackish interface. See CollectionMatrixSplice::adjust_bounds.
   virtual void set_cm(const int macro, const Bias& bias);
+  virtual void set_cm_shared(const std::vector<double>& shared);
   virtual const CollectionMatrix& cm() const;
   virtual const int visits(const int macro, const int index) const;
   virtual bool is_adjust_allowed(const Macrostate& macro) const {
@@ -15,6 +15,7 @@ namespace feasst {
 
 class Checkpoint;
 class Histogram;
+class OverlapExchange;
 
 /**
   Container for initializing, running and analyzing groups of FlatHistogram
@@ -25,7 +26,7 @@ class Clones {
   Clones() {}
 
   /// Add a MonteCarlo.
-  void add(std::shared_ptr<MonteCarlo> mc) { clones_.push_back(mc); }
+  void add(std::shared_ptr<MonteCarlo> mc);
 
   // HWH this becomes too complicated with deep copies
   // HWH user functional creation of MonteCarlo is less complex
@@ -68,12 +69,61 @@ class Clones {
     Run until all clones are complete.
     If OMP is available, run the clones in parallel threads until all clones
     are complete.
+    The number of clones may exceed the number of threads.
+    Each thread repeatedly takes the clone which is furthest from completion
+    and is not already running, and runs it for a batch of attempts.
+    Complete clones continue to run only if no incomplete clone is available.
+
+    The wall clock hours and the number of trials of each batch are
+    accumulated for each clone, which is used to estimate the cost of each
+    clone (see cost_report).
+
+    If hours_per_rebalance is positive, the macrostate range is periodically
+    re-split between neighboring clones based on this measured cost (see
+    rebalance), so that the clones complete at roughly the same time.
+    A thread which completes a batch rebalances with a neighboring clone
+    that is not running, at most once per hours_per_rebalance for each pair.
+    Rebalancing requires that all clones share the same macrostate Histogram,
+    with adjacent soft ranges that do not overlap (e.g., Macrostate arguments
+    soft_macro_min and soft_macro_max, as in CollectionMatrixSplice),
+    that the clones are already initialized to configurations within their
+    soft ranges, and a Bias which allows adjustment (e.g., TransitionMatrix
+    with new_sweep).
+
+    If share_overlap, after each batch, a clone publishes the
+    CollectionMatrix statistics of its soft range to its neighbors through
+    an OverlapExchange, and combines the latest statistics published by its
+    neighbors with its own for the macrostates that overlap (see
+    CollectionMatrix::set_shared).
+    Thus, overlapping windows benefit from each other's statistics during
+    the run, without waiting for each other.
+    Only the statistics collected by each window are published, so that
+    shared statistics are never counted twice.
+    With an overlap_file_prefix, the exchange is through files, so that
+    windows may be split among Clones in different processes, with each
+    given a window_offset.
 
     args:
-    - omp_batch: If OMP, for each this many steps, check for completion and
-      write aggregate ln_prob (default: 1e6).
+    - omp_batch: If OMP, the number of attempts in a batch, after which a
+      thread checks for completion, writes the aggregate ln_prob and takes
+      the next clone (default: 1e6).
     - ln_prob_file: file name of aggregate ln_prob. If empty (default),
       do not write the file.
+    - hours_per_rebalance: If OMP and positive, the wall clock hours between
+      rebalancing each pair of neighboring clones (default: -1).
+    - min_window_size: the minimum number of macrostates in the soft range
+      of a clone after rebalancing (default: 5).
+    - cost_file: file name of the cost_report, which is written once the
+      clones are complete. If empty (default), do not write the file.
+    - share_overlap: If OMP and true, share the CollectionMatrix statistics
+      of overlapping windows (default: false).
+    - overlap_file_prefix: If not empty, share_overlap through files with
+      this prefix (see OverlapExchange) instead of memory (default: empty).
+    - window_offset: the index of the first clone among all windows,
+      which share_overlap through files (default: 0).
+    - stagger: If OMP and true, offset the checkpoint of each clone by the
+      fraction of its index (see Checkpoint::stagger), so that the clones
+      do not write at once (default: true).
    */
   void run_until_complete(argtype args = argtype());
 
@@ -82,19 +132,65 @@ class Clones {
     With OMP, the first clone will run until finding overlap with the second.
     Once overlap is found, the first and second run in parallel while the second
     finds overlap with the third.
-    This is repeated until all clones are running in parallel.
+    This is repeated until all clones are initialized, and the clones are then
+    scheduled as described in run_until_complete.
    */
   void initialize_and_run_until_complete(
     argtype run_args = argtype(),
     argtype init_args = argtype());
 
+  /// Return the wall clock hours spent running batches of a clone.
+  double hours(const int index) const { return hours_[index]; }
+
+  /// Return the number of trials attempted in batches of a clone.
+  double trials(const int index) const { return trials_[index]; }
+
+  /**
+    Return the estimated wall clock hours for a clone to complete, as
+    projected from the hours spent so far and the fraction of Criteria
+    iterations (e.g., sweeps) to completion.
+    Before the first iteration, half of an iteration is assumed.
+    Return -1 if the clone has not run a batch.
+   */
+  double remaining_hours(const int index) const;
+
+  /**
+    Return a comma-separated report of the cost of each clone, with one line
+    per clone.
+    The columns are the soft range of the macrostate bins, the number of
+    trials, the wall clock hours, the number of Criteria iterations, the
+    trials and hours per iteration and the remaining_hours.
+    Use this report to tune the initial windows.
+   */
+  std::string cost_report() const;
+
+  /**
+    Move macrostates between the clone of lower_index and the clone above,
+    such that the remaining_hours of both are about equal.
+    The remaining hours are assumed to be distributed uniformly among the
+    macrostates of the clone with the larger remaining hours, which gives
+    macrostates at its boundary to the other clone.
+    The CollectionMatrix data, visits and multistate Analyze and Modify
+    of the moved macrostates are transferred to the receiving clone.
+    Only macrostates which do not contain the current configuration of the
+    giving clone are moved, and the remainder are left for a later rebalance.
+    Return the number of macrostates that were moved, which is positive if
+    moved to the upper clone and negative if moved to the lower.
+   */
+  int rebalance(const int lower_index, const int min_window_size = 5);
+
   /// Set the number of Criteria iterations of all clones.
   void set_num_iterations_to_complete(const int iterations);
 
   /// Return the FlatHistogram of a given clone index.
   std::unique_ptr<FlatHistogram> flat_histogram(const int index) const;
 
-  /// Stitch together and return the LnProbability of all clones.
+  /**
+    Stitch together and return the LnProbability of all clones.
+    If the clones share the same macrostate Histogram with adjacent soft
+    ranges, as required to rebalance, then the CollectionMatrix of each soft
+    range is spliced instead.
+   */
   LnProbability ln_prob(
     /// Optionally return spliced macrostates, if not NULL.
     Histogram * macrostates = NULL,
@@ -132,11 +228,21 @@ class Clones {
  private:
   std::vector<std::shared_ptr<MonteCarlo> > clones_;
   std::shared_ptr<Checkpoint> checkpoint_;
+  std::vector<double> hours_;
+  std::vector<double> trials_;
 
   void run_until_complete_omp_(argtype run_args,
                                const bool init = false,
                                argtype init_args = argtype());
   void run_until_complete_serial_();
+  bool is_spliced_() const;
+  void share_overlap_(const int index, const int window_offset,
+    OverlapExchange * exchange,
+    std::vector<std::vector<double> > * received);
+  LnProbability ln_prob_spliced_(Histogram * macrostates,
+    std::vector<double> * multistate_data,
+    const std::string analyze_name,
+    const AnalyzeData& get) const;
 };
 
 /// Construct Clones
@@ -83,6 +83,23 @@ class CollectionMatrix {
   /// Set values
   void set(const int macro, const std::vector<Accumulator>& values);
 
+  /**
+    Return the sum and number of values of the decrease and then the increase
+    of each macrostate from min_macro to max_macro, inclusive.
+    These are the statistics shared with overlapping windows.
+   */
+  std::vector<double> sums(const int min_macro, const int max_macro) const;
+
+  /**
+    Set the statistics shared by other windows, which are combined with
+    the collection matrix when computing the ln_prob (but not in blocks).
+    The format is the same as sums, for every macrostate.
+    If empty, clear the shared statistics.
+    The shared statistics are replaced, not accumulated, and are not
+    serialized.
+   */
+  void set_shared(const std::vector<double>& shared);
+
   /// Update the ln_prob according to the collection matrix.
   void compute_ln_prob(LnProbability * ln_prob,
     /// optionaly compute the ln_prob from a block (if != -1).
@@ -115,7 +132,11 @@ class CollectionMatrix {
   double exp_for_boost_;
   std::vector<std::vector<Accumulator> > matrix_;
 
+  // not serialized
+  std::vector<double> shared_;
+
   int visits_(const int macro, const int block, const bool lower) const;
+  double average_(const int macro, const int state_change) const;
 };
 
 inline std::shared_ptr<CollectionMatrix> MakeCollectionMatrix(
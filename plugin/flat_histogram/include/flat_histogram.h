@@ -108,6 +108,7 @@ class FlatHistogram : public Criteria {
   int set_soft_min(const int index, const System& sys) override;
   void set_cm(const bool inc_max, const int macro,
               const Criteria& crit) override;
+  void set_cm_shared(const std::vector<double>& shared) override;
   void adjust_bounds(const bool left_most, const bool right_most,
     const bool left_complete, const bool right_complete,
     const bool all_min_size, const int min_size, const System& system,
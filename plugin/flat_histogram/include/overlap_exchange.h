@@ -0,0 +1,112 @@
+#ifndef FEASST_FLAT_HISTOGRAM_OVERLAP_EXCHANGE_H_
+#define FEASST_FLAT_HISTOGRAM_OVERLAP_EXCHANGE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace feasst {
+
+typedef std::map<std::string, std::string> argtype;
+
+class Criteria;
+class TripleBuffer;
+
+/**
+  Exchange data between neighboring windows without locks or barriers.
+  Each window publishes its data for a neighboring window, and the neighbor
+  reads the most recently published data whenever it is ready.
+
+  In memory, each pair of window and neighbor has a triple buffer.
+  The window writes to one buffer, the neighbor reads from another, and the
+  third holds the latest published data.
+  Publishing and reading atomically swap with the third buffer, so that
+  neither waits for the other, and unread data is simply replaced.
+  Each pair of window and neighbor assumes that only one thread publishes
+  and only one thread reads at a time.
+
+  Alternatively, with a file_prefix, the data are exchanged through files,
+  so that windows may be in different processes.
+  Each publication is written to a temporary file which is then renamed,
+  so that the neighbor never reads a partially written file.
+  Files remaining from a previous simulation would be read as new data, and
+  thus each window removes the files it publishes (see remove) before any
+  window begins to read.
+
+  This is used by Clones to share the CollectionMatrix statistics of
+  overlapping windows during a simulation.
+ */
+class OverlapExchange {
+ public:
+  //@{
+  /** @name Arguments
+    - file_prefix: if not empty, exchange through files which begin with this
+      prefix, followed by the window and neighbor indices (default: empty).
+   */
+  explicit OverlapExchange(argtype args = argtype());
+  explicit OverlapExchange(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Set the number of windows, which must be done before exchange.
+  /// The window indices range from zero to one less than this number.
+  void resize(const int num_windows);
+
+  /// Return the number of windows.
+  int num_windows() const { return num_windows_; }
+
+  /// Remove the files published by the window, if any.
+  void remove(const int window);
+
+  /// Publish data from the window to a neighboring window.
+  void publish(const int window, const int neighbor,
+               const std::vector<double>& data);
+
+  /// Obtain the latest data published by the neighbor for the window.
+  /// Return false, and leave data unchanged, if nothing new was published
+  /// since the last read.
+  bool read(const int window, const int neighbor, std::vector<double> * data);
+
+  /**
+    Return the data of the CollectionMatrix of the Criteria to be shared with
+    overlapping windows: the center and width of the first macrostate bin in
+    the soft range, followed by CollectionMatrix::sums of the soft range.
+   */
+  static std::vector<double> overlap(const Criteria& criteria);
+
+  /**
+    Add the overlap data from a neighbor to the shared statistics, in the
+    format of CollectionMatrix::set_shared, for macrostates in the soft range
+    of the Criteria.
+    Return the number of macrostates that overlap.
+   */
+  static int add_overlap(const std::vector<double>& data,
+                         const Criteria& criteria,
+                         std::vector<double> * shared);
+
+  ~OverlapExchange();
+
+  //@}
+ private:
+  std::string file_prefix_;
+  int num_windows_ = 0;
+  std::vector<std::unique_ptr<TripleBuffer> > buffers_;
+  std::vector<double> num_published_;
+  std::vector<double> last_read_;
+
+  int channel_(const int window, const int neighbor) const;
+  std::string file_name_(const int window, const int neighbor) const;
+};
+
+inline std::shared_ptr<OverlapExchange> MakeOverlapExchange(
+    argtype args = argtype()) {
+  return std::make_shared<OverlapExchange>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_FLAT_HISTOGRAM_OVERLAP_EXCHANGE_H_
@@ -61,6 +61,7 @@ class WLTM : public Bias {
 
   // HWH hackish interface. See CollectionMatrixSplice::adjust_bounds.
   void set_cm(const int macro, const Bias& bias) override;
+  void set_cm_shared(const std::vector<double>& shared) override;
   const CollectionMatrix& cm() const override;
   const int visits(const int macro, const int index) const override;
   bool is_adjust_allowed(const Macrostate& macro) const override;
@@ -81,6 +81,10 @@ void Bias::set_cm(const int macro, const Bias& bias) {
   FATAL("not implemented");
 }
 
+void Bias::set_cm_shared(const std::vector<double>& shared) {
+  FATAL("not implemented");
+}
+
 const CollectionMatrix& Bias::cm() const {
   FATAL("not implemented");
 }
@@ -6,9 +6,11 @@
 //#else
 //  #include <unistd.h>  // sleep
 //#endif
-#include <thread>         // std::this_thread::sleep_for
-#include <chrono>         // std::chrono::seconds
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #include "utils/include/custom_exception.h"
 #include "utils/include/arguments.h"
 #include "utils/include/debug.h"
@@ -21,7 +23,11 @@
 #include "configuration/include/configuration.h"
 #include "system/include/system.h"
 #include "monte_carlo/include/acceptance.h"
+#include "monte_carlo/include/analyze_factory.h"
+#include "monte_carlo/include/modify_factory.h"
 #include "flat_histogram/include/bias.h"
+#include "flat_histogram/include/collection_matrix.h"
+#include "flat_histogram/include/overlap_exchange.h"
 #include "flat_histogram/include/macrostate.h"
 #include "flat_histogram/include/flat_histogram.h"
 #include "flat_histogram/include/clones.h"
@@ -48,6 +54,12 @@ Clones::~Clones() {}
 //  }
 //}
 
+void Clones::add(std::shared_ptr<MonteCarlo> mc) {
+  clones_.push_back(mc);
+  hours_.push_back(0.);
+  trials_.push_back(0.);
+}
+
 const MonteCarlo& Clones::clone(const int index) const {
   ASSERT(index < num(), "index: " << index << " >= num: " << num());
   return const_cast<MonteCarlo&>(*clones_[index]);
@@ -126,12 +138,17 @@ void Clones::run_until_complete_serial_() {
   }
 }
 
-bool are_all_complete(const std::vector<bool>& is_complete) {
-  bool complete = true;
-  for (const bool comp : is_complete) {
-    if (!comp) complete = false;
+// Return the fraction of iterations to completion.
+static double progress(const Criteria& criteria) {
+  if (criteria.is_complete()) {
+    return 1.;
+  }
+  const int to_complete = criteria.num_iterations_to_complete();
+  if (to_complete <= 0) {
+    return 0.;
   }
-  return complete;
+  return std::min(1., static_cast<double>(criteria.num_iterations())/
+                      static_cast<double>(to_complete));
 }
 
 void Clones::run_until_complete_omp_(argtype run_args,
@@ -144,66 +161,205 @@ void Clones::run_until_complete_omp_(argtype run_args,
   if (used("ln_prob_file", run_args)) {
     ln_prob_file = str("ln_prob_file", &run_args);
   }
+  const double hours_per_rebalance = dble("hours_per_rebalance", &run_args, -1.);
+  const int min_window_size = integer("min_window_size", &run_args, 5);
+  const std::string cost_file = str("cost_file", &run_args, "");
+  const bool share_overlap = boolean("share_overlap", &run_args, false);
+  const std::string overlap_file_prefix =
+    str("overlap_file_prefix", &run_args, "");
+  const int window_offset = integer("window_offset", &run_args, 0);
+  const bool stagger = boolean("stagger", &run_args, true);
   feasst_check_all_used(run_args);
-  std::vector<bool> is_complete(num(), false);
-  std::vector<bool> is_initialized(num(), false);
-  is_initialized[0] = true;
-  #pragma omp parallel
-  {
-    const int thread = omp_get_thread_num();
-    const int num_thread = static_cast<int>(omp_get_num_threads());
-    DEBUG("thread " << thread << " of " << num_thread);
-
-    bool terminated = false;
-    try {
-      ASSERT(num() <= num_thread, "more clones: " << num() << " than OMP threads:"
-        << num_thread << ". Use \"export OMP_NUM_THREADS=\" to set OMP threads.");
-      if (thread < num()) {
-        MonteCarlo * clone = clones_[thread].get();
-        if (init) {
-          // wait until thread is initialized
-          while (!is_initialized[thread]) {
-            std::this_thread::sleep_for (std::chrono::seconds(1));
-          }
-          //while (!is_initialized[thread]) sleep(0.01);
-          DEBUG("thread " << thread << " is initialized");
+  if (hours_per_rebalance > 0) {
+    ASSERT(is_spliced_(), "Rebalancing requires that all clones share the "
+      << "same macrostate Histogram with adjacent soft ranges.");
+  }
+  std::unique_ptr<OverlapExchange> exchange;
+  // the latest overlap received by each clone from below and above.
+  std::vector<std::vector<double> > received;
+  if (share_overlap) {
+    exchange = std::make_unique<OverlapExchange>(
+      argtype({{"file_prefix", overlap_file_prefix}}));
+    if (overlap_file_prefix.empty()) {
+      ASSERT(window_offset == 0, "window_offset requires overlap_file_prefix");
+      exchange->resize(num());
+    } else {
+      exchange->resize(window_offset + num() + 1);
+      for (int index = 0; index < num(); ++index) {
+        exchange->remove(window_offset + index);
+      }
+    }
+    received.resize(2*num());
+  }
 
-          // initialize next thread, if applicable
-          if (thread < num() - 1) initialize(thread + 1, init_args);
-          is_initialized[thread + 1] = true;
-        }
+  // Each clone is a task which is resumed in batches of omp_batch attempts,
+  // and is run by only one thread at a time.
+  // Idle threads take the available clone which is furthest from completion.
+  // Complete clones continue to run only when no incomplete clone is
+  // available.
+  // If init, the thread which takes the highest initialized clone first
+  // initializes the next clone.
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<bool> is_available(num(), true);
+  // The progress may reach one before the Criteria is complete, so also
+  // store whether each clone is complete.
+  std::vector<double> progresses(num());
+  std::vector<bool> completes(num());
+  for (int index = 0; index < num(); ++index) {
+    progresses[index] = progress(clones_[index]->criteria());
+    completes[index] = clones_[index]->criteria().is_complete();
+  }
+  int num_initialized = num();
+  if (init) {
+    num_initialized = 1;
+    for (int index = 1; index < num(); ++index) {
+      is_available[index] = false;
+    }
+  }
+  bool done = false;
+  bool terminated = false;
+  // wall clock time of the last rebalance of each neighboring pair, indexed
+  // by the lower clone.
+  std::vector<double> last_rebalance(std::max(0, num() - 1), omp_get_wtime());
+
+  // Return the index of the next clone, or -1 if none are available.
+  // Assumes the mutex is locked.
+  auto next_clone = [&]() {
+    if (num_initialized < num() && is_available[num_initialized - 1]) {
+      return num_initialized - 1;
+    }
+    int next = -1;
+    for (int index = 0; index < num_initialized; ++index) {
+      if (is_available[index] &&
+          (next == -1 || progresses[index] < progresses[next])) {
+        next = index;
+      }
+    }
+    return next;
+  };
+  auto are_all_complete = [&]() {
+    if (num_initialized < num()) return false;
+    for (const bool complete : completes) {
+      if (!complete) return false;
+    }
+    return true;
+  };
+  done = are_all_complete();
+
+  // Stagger the checkpoints of the clones, so they are not written at once.
+  if (stagger) {
+    for (int index = 0; index < num(); ++index) {
+      Checkpoint * checkpoint = clones_[index]->get_checkpoint();
+      if (checkpoint) {
+        checkpoint->stagger(static_cast<double>(index)/num());
+      }
+    }
+  }
 
-        // continue running while waiting for all threads to complete
-        if (clone->criteria().is_complete()) is_complete[thread] = true;
-        while (!are_all_complete(is_complete)) {
+  #pragma omp parallel
+  {
+    DEBUG("thread " << omp_get_thread_num() << " of "
+      << omp_get_num_threads());
+    while (true) {
+      int index = -1;
+      bool initialize_next = false;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return done || next_clone() != -1; });
+        if (done) break;
+        index = next_clone();
+        is_available[index] = false;
+        initialize_next = index == num_initialized - 1 &&
+                          num_initialized < num();
+      }
+      MonteCarlo * clone = clones_[index].get();
+      bool is_terminated = false;
+      int neighbor = -1;
+      try {
+        if (initialize_next) {
+          initialize(index + 1, init_args);
+          DEBUG("clone " << index + 1 << " is initialized");
+        } else {
+          const double start = omp_get_wtime();
           clone->attempt(omp_batch);
-          if (clone->criteria().is_complete()) is_complete[thread] = true;
-          if (thread == 0) {
-            if (!ln_prob_file.empty()) {
-              std::ofstream file;
-              file.open(ln_prob_file);
-              for (const double value : ln_prob().values()) {
-                file << value << std::endl;
+          hours_[index] += (omp_get_wtime() - start)/60./60.;
+          trials_[index] += omp_batch;
+          if (hours_per_rebalance > 0) {
+            int lower = -1;
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              const double now = omp_get_wtime();
+              for (const int other : {index + 1, index - 1}) {
+                const int low = std::min(index, other);
+                if (other >= 0 && other < num_initialized &&
+                    is_available[other] &&
+                    now - last_rebalance[low] > 60.*60.*hours_per_rebalance) {
+                  is_available[other] = false;
+                  last_rebalance[low] = now;
+                  neighbor = other;
+                  lower = low;
+                  break;
+                }
               }
-              file.close();
             }
+            if (lower != -1) {
+              const int moved = rebalance(lower, min_window_size);
+              DEBUG("rebalanced " << moved << " macrostates above " << lower);
+            }
+          }
+          if (exchange) {
+            share_overlap_(index, window_offset, exchange.get(), &received);
           }
         }
+        if (index == 0 && !initialize_next && !ln_prob_file.empty()) {
+          std::ofstream file;
+          file.open(ln_prob_file);
+          for (const double value : ln_prob().values()) {
+            file << value << std::endl;
+          }
+          file.close();
+        }
+      } catch(const feasst::CustomException& e) {
+        WARN(e.what());
+        is_terminated = true;
       }
-    } catch(const feasst::CustomException& e) {
-      WARN(e.what());
-      terminated = true;
-    }
-    DEBUG("terminated: " << terminated);
-
-    if (thread == 0 && checkpoint_) checkpoint_->write(*this);
-    if (thread < num()) clones_[thread]->write_checkpoint();
-
-    #pragma omp barrier
-    if (terminated && thread == 0) {
-      FATAL("Clones::run_until_complete_omp was terminated.");
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (initialize_next) {
+          is_available[index + 1] = true;
+          ++num_initialized;
+        }
+        progresses[index] = progress(clone->criteria());
+        completes[index] = clone->criteria().is_complete();
+        is_available[index] = true;
+        if (neighbor != -1) {
+          progresses[neighbor] = progress(clones_[neighbor]->criteria());
+          completes[neighbor] = clones_[neighbor]->criteria().is_complete();
+          is_available[neighbor] = true;
+        }
+        if (is_terminated) {
+          terminated = true;
+          done = true;
+        } else if (are_all_complete()) {
+          done = true;
+        }
+      }
+      changed.notify_all();
     }
   }
+  DEBUG("terminated: " << terminated);
+  if (!cost_file.empty()) {
+    std::ofstream file(cost_file);
+    file << cost_report();
+  }
+  if (checkpoint_) checkpoint_->write(*this);
+  for (std::shared_ptr<MonteCarlo> clone : clones_) {
+    clone->write_checkpoint();
+  }
+  if (terminated) {
+    FATAL("Clones::run_until_complete_omp was terminated.");
+  }
 
 #else // _OPENMP
 FATAL("Not complied with OMP");
@@ -230,6 +386,9 @@ LnProbability Clones::ln_prob(Histogram * macrostates,
     std::vector<double> * multistate_data,
     const std::string analyze_name,
     const AnalyzeData& get) const {
+  if (is_spliced_()) {
+    return ln_prob_spliced_(macrostates, multistate_data, analyze_name, get);
+  }
   std::vector<double> ln_prob;
   std::vector<double> edges;
   double shift = 0.;
@@ -326,16 +485,197 @@ LnProbability Clones::ln_prob(Histogram * macrostates,
   return lnpi;
 }
 
+bool Clones::is_spliced_() const {
+  if (num() < 2) {
+    return false;
+  }
+  const Macrostate& macro0 = clone(0).criteria().macrostate();
+  for (int index = 1; index < num(); ++index) {
+    const Macrostate& macro = clone(index).criteria().macrostate();
+    if (macro.histogram().edges() != macro0.histogram().edges()) {
+      return false;
+    }
+    if (macro.soft_min() !=
+        clone(index - 1).criteria().macrostate().soft_max() + 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+LnProbability Clones::ln_prob_spliced_(Histogram * macrostates,
+    std::vector<double> * multistate_data,
+    const std::string analyze_name,
+    const AnalyzeData& get) const {
+  std::vector<std::vector<Accumulator> > data =
+    clone(0).criteria().bias().cm().matrix();
+  if (multistate_data) {
+    *multistate_data = SeekAnalyze().multistate_data(analyze_name, clone(0),
+                                                     get);
+  }
+  for (int index = 1; index < num(); ++index) {
+    const Macrostate& macro = clone(index).criteria().macrostate();
+    int max_bin = macro.soft_max();
+    if (index == num() - 1) {
+      max_bin = macro.histogram().size() - 1;
+    }
+    const CollectionMatrix& cm = clone(index).criteria().bias().cm();
+    std::vector<double> clone_data;
+    if (multistate_data) {
+      clone_data = SeekAnalyze().multistate_data(analyze_name, clone(index),
+                                                 get);
+    }
+    for (int bin = macro.soft_min(); bin <= max_bin; ++bin) {
+      data[bin] = cm.matrix()[bin];
+      if (multistate_data) {
+        (*multistate_data)[bin] = clone_data[bin];
+      }
+    }
+  }
+  if (macrostates) {
+    *macrostates = clone(0).criteria().macrostate().histogram();
+  }
+  LnProbability lnpi;
+  lnpi.resize(static_cast<int>(data.size()));
+  CollectionMatrix(data).compute_ln_prob(&lnpi);
+  lnpi.normalize();
+  return lnpi;
+}
+
+void Clones::share_overlap_(const int index, const int window_offset,
+    OverlapExchange * exchange,
+    std::vector<std::vector<double> > * received) {
+  Criteria * criteria = clones_[index]->get_criteria();
+  const std::vector<double> data = OverlapExchange::overlap(*criteria);
+  const int window = window_offset + index;
+  bool is_new = false;
+  for (const int neighbor : {window - 1, window + 1}) {
+    if (neighbor >= 0 && neighbor < exchange->num_windows()) {
+      exchange->publish(window, neighbor, data);
+      std::vector<double> * rec = &(*received)[2*index + (neighbor > window)];
+      if (exchange->read(window, neighbor, rec)) {
+        is_new = true;
+      }
+    }
+  }
+  if (is_new) {
+    std::vector<double> shared;
+    for (const int above : {0, 1}) {
+      const std::vector<double>& rec = (*received)[2*index + above];
+      if (!rec.empty()) {
+        OverlapExchange::add_overlap(rec, *criteria, &shared);
+      }
+    }
+    criteria->set_cm_shared(shared);
+    criteria->update();
+  }
+}
+
+double Clones::remaining_hours(const int index) const {
+  if (hours_[index] <= 0.) {
+    return -1.;
+  }
+  const Criteria& criteria = clone(index).criteria();
+  if (criteria.is_complete()) {
+    return 0.;
+  }
+  const int to_complete = criteria.num_iterations_to_complete();
+  if (to_complete <= 0) {
+    return -1.;
+  }
+  const double prog = std::max(progress(criteria), 0.5/to_complete);
+  return hours_[index]*(1. - prog)/prog;
+}
+
+std::string Clones::cost_report() const {
+  std::stringstream ss;
+  ss << "clone,soft_min,soft_max,trials,hours,iterations,trials_per_iteration,"
+     << "hours_per_iteration,remaining_hours" << std::endl;
+  for (int index = 0; index < num(); ++index) {
+    const Criteria& criteria = clone(index).criteria();
+    const int iterations = criteria.num_iterations();
+    ss << index << ","
+       << criteria.macrostate().soft_min() << ","
+       << criteria.macrostate().soft_max() << ","
+       << trials_[index] << ","
+       << hours_[index] << ","
+       << iterations << ",";
+    if (iterations > 0) {
+      ss << trials_[index]/static_cast<double>(iterations) << ","
+         << hours_[index]/static_cast<double>(iterations) << ",";
+    } else {
+      ss << ",,";
+    }
+    ss << remaining_hours(index) << std::endl;
+  }
+  return ss.str();
+}
+
+int Clones::rebalance(const int lower_index, const int min_window_size) {
+  ASSERT(lower_index >= 0 && lower_index < num() - 1,
+    "lower_index: " << lower_index << " is out of range");
+  const double lower_hours = remaining_hours(lower_index);
+  const double upper_hours = remaining_hours(lower_index + 1);
+  if (lower_hours < 0 || upper_hours < 0) {
+    return 0;
+  }
+  MonteCarlo * lower = clones_[lower_index].get();
+  MonteCarlo * upper = clones_[lower_index + 1].get();
+  const bool adjusted_up = lower_hours > upper_hours;
+  const double give_hours = std::max(lower_hours, upper_hours);
+  const double take_hours = std::min(lower_hours, upper_hours);
+  if (give_hours <= 0.) {
+    return 0;
+  }
+  const MonteCarlo& give = adjusted_up ? *lower : *upper;
+  const int size = give.criteria().macrostate().num_macrostates_in_soft_range();
+  const int num_move = std::min(size - min_window_size, static_cast<int>(
+    0.5*static_cast<double>(size)*(give_hours - take_hours)/give_hours));
+  std::vector<int> states;
+  for (int move = 0; move < num_move; ++move) {
+    if (adjusted_up) {
+      const int macro = lower->criteria().macrostate().soft_max();
+      if (lower->get_criteria()->set_soft_max(macro - 1, lower->system()) == 0) {
+        break;
+      }
+      upper->get_criteria()->set_cm(false, macro, lower->criteria());
+      states.push_back(macro);
+    } else {
+      const int macro = upper->criteria().macrostate().soft_min();
+      if (upper->get_criteria()->set_soft_min(macro + 1, upper->system()) == 0) {
+        break;
+      }
+      lower->get_criteria()->set_cm(true, macro, upper->criteria());
+      states.push_back(macro);
+    }
+  }
+  if (states.size() > 0) {
+    lower->get_criteria()->update();
+    upper->get_criteria()->update();
+    lower->get_analyze_factory()->adjust_bounds(adjusted_up, states,
+                                                upper->get_analyze_factory());
+    lower->get_modify_factory()->adjust_bounds(adjusted_up, states,
+                                               upper->get_modify_factory());
+  }
+  const int num_moved = static_cast<int>(states.size());
+  if (adjusted_up) {
+    return num_moved;
+  }
+  return -num_moved;
+}
+
 void Clones::serialize(std::ostream& ostr) const {
-  feasst_serialize_version(2845, ostr);
+  feasst_serialize_version(2846, ostr);
   feasst_serialize(clones_, ostr);
+  feasst_serialize(hours_, ostr);
+  feasst_serialize(trials_, ostr);
 //  feasst_serialize(checkpoint_, ostr);
   feasst_serialize_endcap("Clones", ostr);
 }
 
 Clones::Clones(std::istream& istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(version == 2845, "version: " << version);
+  ASSERT(version >= 2845 && version <= 2846, "version: " << version);
   // HWH for unknown reasons, this does not work
   //feasst_deserialize(&clones_, istr);
   int dim1;
@@ -348,6 +688,13 @@ Clones::Clones(std::istream& istr) {
       clones_[index] = std::make_shared<MonteCarlo>(istr);
     }
   }
+  if (version >= 2846) {
+    feasst_deserialize(&hours_, istr);
+    feasst_deserialize(&trials_, istr);
+  } else {
+    hours_.resize(num(), 0.);
+    trials_.resize(num(), 0.);
+  }
 //  // HWH for unknown reasons, this function template does not work.
 //  //feasst_deserialize(checkpoint_, istr);
 //  { int existing;
@@ -27,11 +27,12 @@ CollectionMatrix::CollectionMatrix(argtype args)
 
 int CollectionMatrix::visits_(const int macro, const int block, const bool lower) const {
   if (block == -1) {
-    if (lower) {
-      return matrix_[macro][1].num_values();
-    } else {
-      return matrix_[macro][0].num_values();
+    const int change = lower ? 1 : 0;
+    int visits = matrix_[macro][change].num_values();
+    if (!shared_.empty()) {
+      visits += static_cast<int>(shared_[4*macro + 2*change + 1]);
     }
+    return visits;
   } else {
     if (lower) {
       return matrix_[macro][1].blocks()[0].size();
@@ -42,6 +43,35 @@ int CollectionMatrix::visits_(const int macro, const int block, const bool lower
   FATAL("unrecognized");
 }
 
+double CollectionMatrix::average_(const int macro,
+                                  const int state_change) const {
+  const Accumulator& acc = matrix_[macro][state_change];
+  if (shared_.empty()) {
+    return acc.average();
+  }
+  const double num = acc.num_values() + shared_[4*macro + 2*state_change + 1];
+  return (acc.sum() + shared_[4*macro + 2*state_change])/num;
+}
+
+std::vector<double> CollectionMatrix::sums(const int min_macro,
+                                           const int max_macro) const {
+  std::vector<double> data;
+  for (int macro = min_macro; macro <= max_macro; ++macro) {
+    for (const Accumulator& acc : matrix_[macro]) {
+      data.push_back(acc.sum());
+      data.push_back(acc.num_values());
+    }
+  }
+  return data;
+}
+
+void CollectionMatrix::set_shared(const std::vector<double>& shared) {
+  ASSERT(shared.empty() ||
+         static_cast<int>(shared.size()) == 4*static_cast<int>(matrix_.size()),
+    "size: " << shared.size() << " != 4*" << matrix_.size());
+  shared_ = shared;
+}
+
 void CollectionMatrix::compute_ln_prob(
     LnProbability * ln_prob,
     const int block) const {
@@ -88,7 +118,7 @@ void CollectionMatrix::compute_ln_prob(
     } else {
       double prob_decrease;
       if (block == -1) {
-        prob_decrease = matrix_[macro][0].average();
+        prob_decrease = average_(macro, 0);
       } else {
         prob_decrease = matrix_[macro][0].blocks()[0][block];
       }
@@ -98,7 +128,7 @@ void CollectionMatrix::compute_ln_prob(
       } else {
         double prob_increase;
         if (block == -1) {
-          prob_increase = matrix_[macro - 1][1].average();
+          prob_increase = average_(macro - 1, 1);
         } else {
           prob_increase = matrix_[macro - 1][1].blocks()[0][block];
         }
@@ -222,6 +252,7 @@ void CollectionMatrix::resize(const int num_macrostates) {
       mat2.reset();
     }
   }
+  shared_.clear();
 }
 
 void CollectionMatrix::set(const int macro, const std::vector<Accumulator>& values) {
@@ -271,6 +271,10 @@ void FlatHistogram::set_cm(const bool inc_max, const int macro, const Criteria&
   bias_->set_cm(macro, crit.bias());
 }
 
+void FlatHistogram::set_cm_shared(const std::vector<double>& shared) {
+  bias_->set_cm_shared(shared);
+}
+
 void FlatHistogram::check_left_and_right_most_(const bool left_most, const bool right_most,
   const bool all_min_size,
   const int min_size, const System& system, const System * upper_sys,
@@ -0,0 +1,191 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "utils/include/arguments.h"
+#include "utils/include/debug.h"
+#include "utils/include/io.h"
+#include "utils/include/max_precision.h"
+#include "math/include/histogram.h"
+#include "monte_carlo/include/criteria.h"
+#include "flat_histogram/include/macrostate.h"
+#include "flat_histogram/include/bias.h"
+#include "flat_histogram/include/collection_matrix.h"
+#include "flat_histogram/include/overlap_exchange.h"
+
+namespace feasst {
+
+// Lock-free triple buffer for a single writer and a single reader.
+// The middle index is shared, and its fresh bit is set when it holds data
+// which has not been read.
+class TripleBuffer {
+ public:
+  void write(const std::vector<double>& data) {
+    slots_[write_] = data;
+    write_ = middle_.exchange(write_ | fresh_, std::memory_order_acq_rel)
+             & index_;
+  }
+
+  bool read(std::vector<double> * data) {
+    if ((middle_.load(std::memory_order_acquire) & fresh_) == 0) {
+      return false;
+    }
+    read_ = middle_.exchange(read_, std::memory_order_acq_rel) & index_;
+    *data = slots_[read_];
+    return true;
+  }
+
+ private:
+  static const int fresh_ = 4;
+  static const int index_ = 3;
+  std::vector<double> slots_[3];
+  std::atomic<int> middle_{1};
+  int write_ = 0;
+  int read_ = 2;
+};
+
+OverlapExchange::OverlapExchange(argtype * args) {
+  file_prefix_ = str("file_prefix", args, "");
+}
+OverlapExchange::OverlapExchange(argtype args) : OverlapExchange(&args) {
+  feasst_check_all_used(args);
+}
+
+OverlapExchange::~OverlapExchange() {}
+
+void OverlapExchange::resize(const int num_windows) {
+  num_windows_ = num_windows;
+  const int num_channels = 2*num_windows;
+  buffers_.clear();
+  if (file_prefix_.empty()) {
+    for (int channel = 0; channel < num_channels; ++channel) {
+      buffers_.push_back(std::make_unique<TripleBuffer>());
+    }
+  }
+  num_published_.assign(num_channels, 0.);
+  last_read_.assign(num_channels, 0.);
+}
+
+int OverlapExchange::channel_(const int window, const int neighbor) const {
+  ASSERT(window >= 0 && window < num_windows_,
+    "window: " << window << " is out of range of " << num_windows_);
+  ASSERT(std::abs(window - neighbor) == 1,
+    "window: " << window << " and neighbor: " << neighbor << " are not "
+    << "adjacent");
+  ASSERT(neighbor >= 0 && neighbor < num_windows_,
+    "neighbor: " << neighbor << " is out of range of " << num_windows_);
+  if (neighbor > window) {
+    return 2*window + 1;
+  }
+  return 2*window;
+}
+
+std::string OverlapExchange::file_name_(const int window,
+                                        const int neighbor) const {
+  return file_prefix_ + str(window) + "_" + str(neighbor) + ".txt";
+}
+
+void OverlapExchange::remove(const int window) {
+  if (file_prefix_.empty()) return;
+  for (const int neighbor : {window - 1, window + 1}) {
+    if (neighbor >= 0 && neighbor < num_windows_) {
+      std::remove(file_name_(window, neighbor).c_str());
+    }
+  }
+}
+
+void OverlapExchange::publish(const int window, const int neighbor,
+                              const std::vector<double>& data) {
+  const int channel = channel_(window, neighbor);
+  if (file_prefix_.empty()) {
+    buffers_[channel]->write(data);
+  } else {
+    num_published_[channel] += 1.;
+    const std::string file_name = file_name_(window, neighbor);
+    const std::string tmp_name = file_name + ".tmp";
+    {
+      std::ofstream file(tmp_name);
+      file << MAX_PRECISION << num_published_[channel] << " " << data.size();
+      for (const double value : data) {
+        file << " " << value;
+      }
+      file << std::endl;
+    }
+    ASSERT(std::rename(tmp_name.c_str(), file_name.c_str()) == 0,
+      "could not rename " << tmp_name << " to " << file_name);
+  }
+}
+
+bool OverlapExchange::read(const int window, const int neighbor,
+                           std::vector<double> * data) {
+  // the neighbor publishes on the channel of the neighbor to the window
+  const int channel = channel_(neighbor, window);
+  if (file_prefix_.empty()) {
+    return buffers_[channel]->read(data);
+  }
+  std::ifstream file(file_name_(neighbor, window));
+  double num_published;
+  int size;
+  if (!(file >> num_published >> size)) {
+    return false;
+  }
+  if (num_published == last_read_[channel]) {
+    return false;
+  }
+  std::vector<double> values(size);
+  for (double& value : values) {
+    if (!(file >> value)) {
+      return false;
+    }
+  }
+  last_read_[channel] = num_published;
+  *data = values;
+  return true;
+}
+
+std::vector<double> OverlapExchange::overlap(const Criteria& criteria) {
+  const Macrostate& macro = criteria.macrostate();
+  const Histogram& hist = macro.histogram();
+  const int bin = macro.soft_min();
+  std::vector<double> data = {hist.center_of_bin(bin),
+                              hist.edges()[bin + 1] - hist.edges()[bin]};
+  const std::vector<double> sums = criteria.bias().cm().sums(
+    macro.soft_min(), macro.soft_max());
+  data.insert(data.end(), sums.begin(), sums.end());
+  return data;
+}
+
+int OverlapExchange::add_overlap(const std::vector<double>& data,
+                                 const Criteria& criteria,
+                                 std::vector<double> * shared) {
+  const Macrostate& macro = criteria.macrostate();
+  const Histogram& hist = macro.histogram();
+  if (shared->empty()) {
+    shared->resize(4*hist.size(), 0.);
+  }
+  ASSERT(static_cast<int>(shared->size()) == 4*hist.size(),
+    "size: " << shared->size());
+  ASSERT(data.size() >= 2, "size: " << data.size());
+  const double center0 = data[0];
+  const double width = data[1];
+  const int num_data = (static_cast<int>(data.size()) - 2)/4;
+  int num_overlap = 0;
+  for (int bin = macro.soft_min(); bin <= macro.soft_max(); ++bin) {
+    const double center = hist.center_of_bin(bin);
+    const int data_bin = static_cast<int>(std::round((center - center0)/width));
+    if (data_bin >= 0 && data_bin < num_data) {
+      ASSERT(std::abs(hist.edges()[bin + 1] - hist.edges()[bin] - width) <
+             1e-8*width &&
+             std::abs(center - center0 - data_bin*width) < 1e-8*width,
+        "overlapping windows must have the same macrostate bins");
+      for (int index = 0; index < 4; ++index) {
+        (*shared)[4*bin + index] += data[2 + 4*data_bin + index];
+      }
+      ++num_overlap;
+    }
+  }
+  return num_overlap;
+}
+
+}  // namespace feasst
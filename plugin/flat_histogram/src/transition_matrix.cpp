@@ -299,6 +299,10 @@ void TransitionMatrix::set_cm(const CollectionMatrix& cm) {
   collection_->compute_ln_prob(ln_prob_.get());
 }
 
+void TransitionMatrix::set_cm_shared(const std::vector<double>& shared) {
+  collection_->set_shared(shared);
+}
+
 int TransitionMatrix::num_iterations(const int state, const Macrostate& macro) const {
   if (new_sweep_ == 0 || state == -1) {
     if (new_sweep_ != 0) {
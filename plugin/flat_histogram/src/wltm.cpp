@@ -178,6 +178,9 @@ const TransitionMatrix& WLTM::transition_matrix() const {
 void WLTM::set_cm(const int macro, const Bias& bias) {
   transition_matrix_->set_cm(macro, bias); }
 
+void WLTM::set_cm_shared(const std::vector<double>& shared) {
+  transition_matrix_->set_cm_shared(shared); }
+
 const CollectionMatrix& WLTM::cm() const {
   return transition_matrix().cm(); }
 
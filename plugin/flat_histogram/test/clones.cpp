@@ -1,3 +1,6 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
 #include "utils/test/utils.h"
 #include "utils/include/checkpoint.h"
 #include "math/include/histogram.h"
@@ -80,12 +83,13 @@ std::unique_ptr<MonteCarlo> monte_carlo(const int thread, const int min, const i
 // 0 1 2 3 4 5 6                : 8 total
 //           5 6 7 8 9          : 7 total
 //                 8 9 10 11 12 : 6 total
-Clones make_clones(const int max, const int min = 0, const int overlap = 4) {
+Clones make_clones(const int max, const int min = 0, const int overlap = 4,
+                   const int num = 2) {
   Clones clones;
   std::vector<std::vector<int> > bounds = WindowExponential({
     {"maximum", str(max)},
     {"minimum", str(min)},
-    {"num", "2"},
+    {"num", str(num)},
     {"overlap", str(overlap)},
     {"alpha", "2"}}).boundaries();
   for (int index = 0; index < static_cast<int>(bounds.size()); ++index) {
@@ -133,6 +137,116 @@ TEST(Clones, lj_fh) {
   for (int i = 9; i < 13; ++i) EXPECT_EQ(energy[i], energy1[i - 5]);
 }
 
+TEST(Clones, lj_fh_share_overlap) {
+  for (const std::string prefix : {"", "tmp/clones_overlap"}) {
+    Clones clones = make_clones(12);
+    clones.initialize_and_run_until_complete({{"omp_batch", str(1e2)},
+      {"share_overlap", "true"}, {"overlap_file_prefix", prefix}});
+    for (int index = 0; index < clones.num(); ++index) {
+      EXPECT_TRUE(clones.clone(index).criteria().is_complete());
+    }
+    EXPECT_NEAR(clones.ln_prob().value(0), -36.9, 0.7);
+  }
+}
+
+// Schedule more clones than threads.
+TEST(Clones, lj_fh_num_threads) {
+  Clones clones = make_clones(12, 0, 2, 4);
+  EXPECT_EQ(clones.num(), 4);
+#ifdef _OPENMP
+  const int max_threads = omp_get_max_threads();
+  omp_set_num_threads(2);
+#endif // _OPENMP
+  clones.initialize_and_run_until_complete({{"omp_batch", str(1e2)}});
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif // _OPENMP
+  for (int index = 0; index < clones.num(); ++index) {
+    EXPECT_TRUE(clones.clone(index).criteria().is_complete());
+  }
+  EXPECT_NEAR(clones.ln_prob().value(0), -36.9, 1.);
+}
+
+// Clones which share the macrostate histogram, with adjacent soft ranges.
+Clones make_soft_clones(const int max, const int num = 2) {
+  Clones clones;
+  std::vector<std::vector<int> > bounds = WindowExponential({
+    {"maximum", str(max)},
+    {"minimum", "0"},
+    {"num", str(num)},
+    {"overlap", "0"},
+    {"alpha", "2"}}).boundaries();
+  for (int index = 0; index < static_cast<int>(bounds.size()); ++index) {
+    auto mc = std::make_shared<MonteCarlo>();
+    mc->add(MakeConfiguration({{"cubic_side_length", "8"},
+                              {"particle_type0", "../particle/lj.fstprt"},
+                              {"add_particles_of_type0", "1"}}));
+    mc->add(MakePotential(MakeLennardJones()));
+    mc->add(MakePotential(MakeLongRangeCorrections()));
+    mc->set(MakeThermoParams({{"beta", str(1./1.5)},
+      {"chemical_potential", "-2.352321"}}));
+    mc->set(MakeMetropolis());
+    mc->add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "1."}}));
+    mc->add(MakeTrialTransfer({{"particle_type", "0"}, {"weight", "4"}}));
+    mc->run(MakeRun({{"until_num_particles", str(bounds[index][0])}}));
+    mc->set(MakeFlatHistogram(
+      MakeMacrostateNumParticles(
+        Histogram({{"width", "1"}, {"max", str(max)}, {"min", "0"}}),
+        {{"soft_macro_min", str(bounds[index][0])},
+         {"soft_macro_max", str(bounds[index][1])}}),
+      MakeTransitionMatrix({{"min_sweeps", "20"}, {"new_sweep", "1"}})));
+    mc->add(MakeCriteriaUpdater({{"trials_per_update", "1e2"}}));
+    mc->add(MakeEnergy({{"trials_per_update", "1"},
+                        {"trials_per_write", "1e2"},
+                        {"multistate", "true"}}));
+    clones.add(mc);
+  }
+  return test_serialize(clones);
+}
+
+TEST(Clones, lj_fh_rebalance) {
+  Clones clones = make_soft_clones(12);
+  EXPECT_EQ(clones.num(), 2);
+  EXPECT_EQ(0, clones.rebalance(0));
+  EXPECT_EQ(-1, clones.remaining_hours(0));
+  clones.run_until_complete({{"omp_batch", str(1e2)},
+    {"hours_per_rebalance", str(1e-9)},
+    {"min_window_size", "2"},
+    {"cost_file", "tmp/clones_cost.txt"}});
+  int num_states = 0;
+  for (int index = 0; index < clones.num(); ++index) {
+    const Criteria& crit = clones.clone(index).criteria();
+    EXPECT_TRUE(crit.is_complete());
+    EXPECT_GE(crit.macrostate().num_macrostates_in_soft_range(), 2);
+    num_states += crit.macrostate().num_macrostates_in_soft_range();
+    EXPECT_GT(clones.hours(index), 0.);
+    EXPECT_GT(clones.trials(index), 0.);
+    EXPECT_EQ(0., clones.remaining_hours(index));
+  }
+  EXPECT_EQ(13, num_states);
+  EXPECT_EQ(0, clones.clone(0).criteria().macrostate().soft_min());
+  EXPECT_EQ(clones.clone(0).criteria().macrostate().soft_max() + 1,
+            clones.clone(1).criteria().macrostate().soft_min());
+  std::stringstream report(clones.cost_report());
+  std::string line;
+  int num_lines = 0;
+  while (std::getline(report, line)) ++num_lines;
+  EXPECT_EQ(clones.num() + 1, num_lines);
+
+  // the spliced ln_prob and energy cover the entire histogram.
+  Histogram macrostates;
+  std::vector<double> energy;
+  const LnProbability lnpi = clones.ln_prob(&macrostates, &energy, "Energy");
+  EXPECT_EQ(13, lnpi.size());
+  EXPECT_EQ(13, static_cast<int>(energy.size()));
+  EXPECT_EQ(12, macrostates.center_of_bin(12));
+  EXPECT_NEAR(lnpi.value(0), -36.9, 1.5);
+
+  Clones clones2 = test_serialize(clones);
+  EXPECT_DOUBLE_EQ(clones.hours(1), clones2.hours(1));
+  EXPECT_TRUE(clones2.ln_prob().is_equal(lnpi, 1e-8));
+}
+
 double energy_av4(const int macro, const MonteCarlo& mc) {
   return mc.analyzers().back()->analyzers()[macro]->accumulator().average();
 }
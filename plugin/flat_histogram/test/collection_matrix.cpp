@@ -37,6 +37,38 @@ TEST(CollectionMatrix, serialize) {
 //  EXPECT_EQ(1, colmat3.min_blocks_());
 }
 
+// shared statistics are combined as if collected in the same matrix
+TEST(CollectionMatrix, shared) {
+  CollectionMatrix own, other, all;
+  for (CollectionMatrix * cm : {&own, &other, &all}) cm->resize(3);
+  own.increment(0, 1, 0.5);
+  own.increment(1, 0, 0.25);
+  other.increment(0, 1, 0.3);
+  other.increment(1, 0, 0.1);
+  other.increment(1, 1, 0.2);
+  other.increment(2, 0, 0.4);
+  all.increment(0, 1, 0.5);
+  all.increment(0, 1, 0.3);
+  all.increment(1, 0, 0.25);
+  all.increment(1, 0, 0.1);
+  all.increment(1, 1, 0.2);
+  all.increment(2, 0, 0.4);
+  std::vector<double> shared = other.sums(0, 2);
+  EXPECT_EQ(12, static_cast<int>(shared.size()));
+  EXPECT_DOUBLE_EQ(0.3, shared[2]);
+  EXPECT_DOUBLE_EQ(1., shared[3]);
+  own.set_shared(shared);
+  LnProbability lnpi, lnpi_all;
+  lnpi.resize(3);
+  lnpi_all.resize(3);
+  own.compute_ln_prob(&lnpi);
+  all.compute_ln_prob(&lnpi_all);
+  EXPECT_TRUE(lnpi.is_equal(lnpi_all, 1e-12));
+  own.set_shared(std::vector<double>());
+  own.compute_ln_prob(&lnpi);
+  EXPECT_FALSE(lnpi.is_equal(lnpi_all, 1e-12));
+}
+
 //TEST(CollectionMatrix, blocks) {
 //  auto cm = MakeCollectionMatrix();
 //  cm->resize(6);
@@ -0,0 +1,102 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
+#include <cstdio>
+#include <vector>
+#include "utils/test/utils.h"
+#include "flat_histogram/include/overlap_exchange.h"
+
+namespace feasst {
+
+TEST(OverlapExchange, publish_read) {
+  for (const std::string prefix : {"", "tmp/overlap"}) {
+    for (const std::string name : {"0_1", "1_0", "1_2", "2_1"}) {
+      std::remove((prefix + name + ".txt").c_str());
+    }
+    OverlapExchange exchange(argtype({{"file_prefix", prefix}}));
+    exchange.resize(3);
+    std::vector<double> data = {-1.};
+    EXPECT_FALSE(exchange.read(1, 0, &data));
+    EXPECT_EQ(1, static_cast<int>(data.size()));
+    exchange.publish(0, 1, {1., 2.});
+    EXPECT_FALSE(exchange.read(1, 2, &data));
+    EXPECT_TRUE(exchange.read(1, 0, &data));
+    EXPECT_EQ(2, static_cast<int>(data.size()));
+    EXPECT_DOUBLE_EQ(2., data[1]);
+    EXPECT_FALSE(exchange.read(1, 0, &data));
+
+    // unread data is replaced by the latest
+    exchange.publish(0, 1, {3.});
+    exchange.publish(0, 1, {4., 5., 6.});
+    EXPECT_TRUE(exchange.read(1, 0, &data));
+    EXPECT_EQ(3, static_cast<int>(data.size()));
+    EXPECT_DOUBLE_EQ(6., data[2]);
+    EXPECT_FALSE(exchange.read(1, 0, &data));
+
+    // windows must be adjacent
+    TRY(
+      exchange.publish(0, 2, data);
+      CATCH_PHRASE("are not adjacent");
+    );
+  }
+}
+
+// The files of a previous simulation are not read once removed.
+TEST(OverlapExchange, remove) {
+  const std::string prefix = "tmp/overlap_remove";
+  {
+    OverlapExchange previous(argtype({{"file_prefix", prefix}}));
+    previous.resize(3);
+    previous.publish(1, 0, {1.});
+    previous.publish(1, 2, {2.});
+  }
+  OverlapExchange exchange(argtype({{"file_prefix", prefix}}));
+  exchange.resize(3);
+  std::vector<double> data;
+  exchange.remove(1);
+  EXPECT_FALSE(exchange.read(0, 1, &data));
+  EXPECT_FALSE(exchange.read(2, 1, &data));
+  exchange.publish(1, 0, {3.});
+  EXPECT_TRUE(exchange.read(0, 1, &data));
+  EXPECT_DOUBLE_EQ(3., data[0]);
+}
+
+// The reader never obtains a partially published buffer.
+TEST(OverlapExchange, threads) {
+  OverlapExchange exchange;
+  exchange.resize(2);
+  const int num_publish = 1e4, size = 100;
+  bool is_consistent = true;
+  double last = 0.;
+  #ifdef _OPENMP
+  #pragma omp parallel num_threads(2)
+  #endif // _OPENMP
+  {
+    int thread = 0, num_threads = 1;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    num_threads = omp_get_num_threads();
+    #endif // _OPENMP
+    if (thread == 0) {
+      for (int publish = 1; publish <= num_publish; ++publish) {
+        exchange.publish(0, 1, std::vector<double>(size, publish));
+      }
+    }
+    if (thread == 1 || num_threads == 1) {
+      std::vector<double> data;
+      while (last < num_publish) {
+        if (exchange.read(1, 0, &data)) {
+          for (const double value : data) {
+            if (value != data[0]) is_consistent = false;
+          }
+          if (data[0] <= last) is_consistent = false;
+          last = data[0];
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(is_consistent);
+  EXPECT_DOUBLE_EQ(num_publish, last);
+}
+
+}  // namespace feasst
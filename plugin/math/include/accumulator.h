@@ -109,6 +109,19 @@ class Accumulator {
   /// Zero all accumulated values.
   void reset();
 
+  /**
+    Combine the values accumulated by another Accumulator, as if they were
+    accumulated after those of this one (e.g., from parallel threads).
+    The moments, minimum and maximum are exact.
+    The block sizes are those of the combined number of values, and the
+    partial blocks are completed with the blocks of the other Accumulator.
+    The block averages are also exact if the number of values in this
+    Accumulator is a multiple of the smallest block size of the other.
+    Otherwise, a block of the other is divided in proportion to the number
+    of values needed to complete a block.
+   */
+  void merge(const Accumulator& accumulator);
+
   /// Return the maximum value accumulated.
   double max() const { return max_; }
 
@@ -173,6 +186,15 @@ class Accumulator {
 
   // Set the highest order of moments recorded.
   void set_moments_(const int num_moments);
+
+  // Add the blocks and partial block of another Accumulator to the blocks of
+  // the given operation, given the number of values in the partial block.
+  void add_blocks_(const Accumulator& accumulator, const int bop,
+                   double * num_partial);
+
+  // Add a sum of a number of values to the blocks of the given operation.
+  void add_to_block_(const long double sum, const double num, const int bop,
+                     double * num_partial);
 };
 
 inline std::shared_ptr<Accumulator> MakeAccumulator(argtype args = argtype()) {
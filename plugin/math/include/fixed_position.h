@@ -0,0 +1,151 @@
+#ifndef FEASST_MATH_FIXED_POSITION_H_
+#define FEASST_MATH_FIXED_POSITION_H_
+
+#include <cmath>
+#include <string>
+#include <sstream>
+#include "utils/include/debug.h"
+#include "math/include/position.h"
+
+namespace feasst {
+
+/**
+  A Position with a dimension that is fixed at compile time.
+  The coordinates are stored inline, so that temporaries on the stack or as
+  class members never allocate memory on the heap, and loops over dimensions
+  may be unrolled by the compiler.
+
+  This class is intended for the optimized inner loops of, e.g., Domain,
+  VisitModel and Perturb.
+  Position remains the general purpose (and serialized) representation, and
+  FixedPosition may be converted to and from Position.
+
+  The arithmetic is constexpr so that it may be evaluated at compile time.
+  Note that std::array is not used for storage because its non-const element
+  access is not constexpr in C++14.
+ */
+template <int D>
+class FixedPosition {
+  static_assert(D > 0, "FixedPosition requires a positive dimension");
+
+ public:
+  /// Initialize coordinates on the origin.
+  constexpr FixedPosition() : coord_() {}
+
+  /// Initialize coordinates from a Position of the same dimension.
+  explicit FixedPosition(const Position& position) { set(position); }
+
+  /// Return the dimensionality of the position.
+  static constexpr int dimension() { return D; }
+
+  /// Get coordinate value of one dimension.
+  constexpr double coord(const int dimension) const {
+    return coord_[dimension]; }
+
+  /// Set coordinate value of one dimension.
+  constexpr void set_coord(const int dimension, const double coord) {
+    coord_[dimension] = coord; }
+
+  /// Add to coordinate value of one dimension.
+  constexpr void add_to_coord(const int dimension, const double coord) {
+    coord_[dimension] += coord; }
+
+  /// Return a pointer to the contiguous coordinates.
+  constexpr const double * data() const { return coord_; }
+
+  /// Set the coordinates from a Position of the same dimension.
+  void set(const Position& position) {
+    ASSERT(position.dimension() == D,
+      "dimension: " << position.dimension() << " != " << D);
+    set(position.coord().data());
+  }
+
+  /// Set the coordinates from a contiguous array of length D.
+  constexpr void set(const double * coord) {
+    for (int dim = 0; dim < D; ++dim) coord_[dim] = coord[dim];
+  }
+
+  /// Set the position of self to the origin.
+  constexpr void set_to_origin() {
+    for (int dim = 0; dim < D; ++dim) coord_[dim] = 0.;
+  }
+
+  /// Add position vector to self.
+  constexpr void add(const FixedPosition& position) {
+    for (int dim = 0; dim < D; ++dim) coord_[dim] += position.coord_[dim];
+  }
+
+  /// Subtract the position vector from self.
+  constexpr void subtract(const FixedPosition& position) {
+    for (int dim = 0; dim < D; ++dim) coord_[dim] -= position.coord_[dim];
+  }
+
+  /// Divide self by the position vector.
+  constexpr void divide(const FixedPosition& position) {
+    for (int dim = 0; dim < D; ++dim) coord_[dim] /= position.coord_[dim];
+  }
+
+  /// Multiply self by a constant.
+  constexpr void multiply(const double constant) {
+    for (int dim = 0; dim < D; ++dim) coord_[dim] *= constant;
+  }
+
+  /// Return the dot product of position vector with self.
+  constexpr double dot_product(const FixedPosition& position) const {
+    double prod = 0.;
+    for (int dim = 0; dim < D; ++dim) prod += coord_[dim]*position.coord_[dim];
+    return prod;
+  }
+
+  /// Return the squared distance of self from the origin.
+  constexpr double squared_distance() const { return dot_product(*this); }
+
+  /// Return the squared distance between self and position.
+  constexpr double squared_distance(const FixedPosition& position) const {
+    double r2 = 0.;
+    for (int dim = 0; dim < D; ++dim) {
+      const double dx = coord_[dim] - position.coord_[dim];
+      r2 += dx*dx;
+    }
+    return r2;
+  }
+
+  /// Return the distance of self from the origin.
+  double distance() const { return std::sqrt(squared_distance()); }
+
+  /// Return distance between self and position.
+  double distance(const FixedPosition& position) const {
+    return std::sqrt(squared_distance(position)); }
+
+  /// Copy the coordinates into an existing Position.
+  /// No memory is allocated if the Position already has dimension D.
+  void position(Position * position) const {
+    std::vector<double> * coord = position->get_coord();
+    coord->resize(D);
+    for (int dim = 0; dim < D; ++dim) (*coord)[dim] = coord_[dim];
+  }
+
+  /// Return the coordinates as a Position.
+  Position position() const {
+    Position pos(D);
+    position(&pos);
+    return pos;
+  }
+
+  /// Return coordinates as a string.
+  std::string str() const {
+    std::stringstream ss;
+    for (int dim = 0; dim < D; ++dim) ss << coord_[dim] << ",";
+    return ss.str();
+  }
+
+ private:
+  double coord_[D];
+};
+
+typedef FixedPosition<2> Position2D;
+typedef FixedPosition<3> Position3D;
+
+}  // namespace feasst
+
+#endif  // FEASST_MATH_FIXED_POSITION_H_
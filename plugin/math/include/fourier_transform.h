@@ -0,0 +1,31 @@
+#ifndef FEASST_MATH_FOURIER_TRANSFORM_H_
+#define FEASST_MATH_FOURIER_TRANSFORM_H_
+
+#include <vector>
+#include <complex>
+
+namespace feasst {
+
+/**
+  Compute the discrete Fourier transform of a sequence in place,
+  \f$X_m = \sum_j x_j e^{-2\pi i jm/n}\f$.
+  If inverse, the sign of the exponent is positive and the result is not
+  normalized by n.
+  Lengths which are a power of two use the radix-2 fast Fourier transform.
+  Other lengths are summed directly, which scales as \f$n^2\f$.
+ */
+void fourier_transform(std::vector<std::complex<double> > * data,
+                       const bool inverse = false);
+
+/**
+  Same as above, but for a grid in any number of dimensions, where the
+  number of points in each dimension is given by num.
+  The first dimension varies fastest in data.
+ */
+void fourier_transform(const std::vector<int>& num,
+                       std::vector<std::complex<double> > * data,
+                       const bool inverse = false);
+
+}  // namespace feasst
+
+#endif  // FEASST_MATH_FOURIER_TRANSFORM_H_
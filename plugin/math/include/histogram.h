@@ -98,6 +98,10 @@ class Histogram {
   /// Return the histogram.
   const std::deque<double>& histogram() const { return histogram_; }
 
+  /// Add the counts of each bin of another Histogram with the same bins
+  /// (e.g., from parallel threads), and expand if needed.
+  void merge(const Histogram& histogram);
+
   /// Return Histogram in a human-readable format.
   const std::string str() const;
 
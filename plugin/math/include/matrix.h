@@ -4,6 +4,7 @@
 
 #include <string>
 #include <vector>
+#include "math/include/fixed_position.h"
 
 namespace feasst {
 
@@ -127,6 +128,21 @@ class RotationMatrix : public Matrix {
   /// Same as above, but optimized with temporary storage.
   void rotate(const Position& pivot, Position * rotated, Position * temp) const;
 
+  /// Same as above, but for positions with a dimension fixed at compile time.
+  template <int D>
+  void rotate(const FixedPosition<D>& pivot,
+              FixedPosition<D> * rotated) const {
+    FixedPosition<D> rel = *rotated;
+    rel.subtract(pivot);
+    for (int row = 0; row < D; ++row) {
+      double coord = 0.;
+      for (int col = 0; col < D; ++col) {
+        coord += rel.coord(col)*value(row, col);
+      }
+      rotated->set_coord(row, coord + pivot.coord(row));
+    }
+  }
+
   /// Compute rotation matrix based on quaternions (3D only).
   void quaternion(const Position& quaternion);
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include "utils/include/arguments.h"
 #include "utils/include/debug.h"
 #include "utils/include/utils.h"
@@ -37,7 +39,7 @@ void Accumulator::accumulate(double value) {
       block_size_.erase(block_size_.begin());
       block_size_.push_back(new_block_size);
       sum_block_.erase(sum_block_.begin());
-      sum_block_.push_back(sum());
+      sum_block_.push_back(sum() - value);
       block_averages_.erase(block_averages_.begin());
       block_averages_.push_back(MakeAccumulator({{"max_block_operations", "0"},
         {"num_moments", feasst::str(num_moments())}}));
@@ -133,6 +135,104 @@ double Accumulator::stdev_of_av() const {
   return std()/std::sqrt(num_values());
 }
 
+void Accumulator::merge(const Accumulator& accumulator) {
+  ASSERT(num_moments() == accumulator.num_moments(), "num_moments: " <<
+    num_moments() << " != " << accumulator.num_moments());
+  ASSERT(max_block_operations_ == accumulator.max_block_operations_,
+    "max_block_operations: " << max_block_operations_ << " != " <<
+    accumulator.max_block_operations_);
+  if (accumulator.num_values() == 0) {
+    return;
+  }
+  if (num_values() == 0) {
+    *this = accumulator;
+    for (std::shared_ptr<Accumulator>& block : block_averages_) {
+      block = std::make_shared<Accumulator>(*block);
+    }
+    return;
+  }
+  const Accumulator old(*this);
+  for (int mo = 0; mo < num_moments(); ++mo) {
+    val_moment_[mo] += accumulator.val_moment_[mo];
+  }
+  if (max_ < accumulator.max_) max_ = accumulator.max_;
+  if (min_ > accumulator.min_) min_ = accumulator.min_;
+  last_value_ = accumulator.last_value_;
+  if (max_block_operations_ == 0) {
+    return;
+  }
+
+  // add the block sizes that accumulate would have added for all values
+  while (block_power_*block_size_.back() < num_values() + 0.1) {
+    block_size_.erase(block_size_.begin());
+    block_size_.push_back(block_power_*block_size_.back());
+    sum_block_.erase(sum_block_.begin());
+    sum_block_.push_back(0.0L);
+    blocks_.erase(blocks_.begin());
+    blocks_.push_back(std::vector<double>());
+  }
+  for (int bop = 0; bop < max_block_operations_; ++bop) {
+    double num_partial = 0.;
+    const std::vector<double>& old_size = old.block_size_;
+    if (std::find(old_size.begin(), old_size.end(), block_size_[bop]) ==
+        old_size.end()) {
+      add_blocks_(old, bop, &num_partial);
+    } else {
+      num_partial = std::fmod(old.num_values(), block_size_[bop]);
+    }
+    add_blocks_(accumulator, bop, &num_partial);
+    block_averages_[bop] = MakeAccumulator({{"max_block_operations", "0"},
+      {"num_moments", feasst::str(num_moments())}});
+    for (const double block : blocks_[bop]) {
+      block_averages_[bop]->accumulate(block);
+    }
+  }
+}
+
+void Accumulator::add_blocks_(const Accumulator& accumulator,
+    const int bop,
+    double * num_partial) {
+  // use the largest block size which fits evenly in the partial block
+  const std::vector<double>& size = accumulator.block_size_;
+  int abop = 0;
+  for (int index = 1; index < accumulator.max_block_operations_; ++index) {
+    if (size[index] < block_size_[bop] + 0.1 &&
+        std::abs(std::fmod(*num_partial, size[index])) < 0.1) {
+      abop = index;
+    }
+  }
+  for (const double block : accumulator.blocks_[abop]) {
+    add_to_block_(block*size[abop], size[abop], bop, num_partial);
+  }
+  add_to_block_(accumulator.sum_block_[abop],
+    std::fmod(accumulator.num_values(), size[abop]), bop, num_partial);
+}
+
+void Accumulator::add_to_block_(const long double sum,
+    const double num,
+    const int bop,
+    double * num_partial) {
+  const double size = block_size_[bop];
+  long double remaining_sum = sum;
+  double remaining = num;
+  while (remaining > 0.1) {
+    const double fill = std::min(remaining, size - *num_partial);
+    long double part = remaining_sum;
+    if (fill < remaining) {
+      part = remaining_sum*fill/remaining;
+    }
+    sum_block_[bop] += part;
+    *num_partial += fill;
+    remaining_sum -= part;
+    remaining -= fill;
+    if (*num_partial > size - 0.1) {
+      blocks_[bop].push_back(sum_block_[bop]/size);
+      sum_block_[bop] = 0.0L;
+      *num_partial = 0.;
+    }
+  }
+}
+
 void Accumulator::set_moments_(const int num_moments) {
   ASSERT(num_moments > 0, "num_moments: " << num_moments << " >0");
   val_moment_.resize(num_moments);
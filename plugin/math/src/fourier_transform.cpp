@@ -0,0 +1,100 @@
+#include <cmath>
+#include "utils/include/debug.h"
+#include "math/include/constants.h"
+#include "math/include/fourier_transform.h"
+
+namespace feasst {
+
+static bool is_power_of_two(const int num) {
+  return num > 0 && (num & (num - 1)) == 0;
+}
+
+// Iterative, in place radix-2 transform with bit reversal.
+static void fft_radix2(std::complex<double> * data, const int num,
+                       const double sign) {
+  for (int index = 1, rev = 0; index < num; ++index) {
+    int bit = num >> 1;
+    for (; rev & bit; bit >>= 1) {
+      rev ^= bit;
+    }
+    rev ^= bit;
+    if (index < rev) {
+      std::swap(data[index], data[rev]);
+    }
+  }
+  for (int len = 2; len <= num; len <<= 1) {
+    const double angle = sign*2.*PI/static_cast<double>(len);
+    const std::complex<double> wlen(std::cos(angle), std::sin(angle));
+    for (int begin = 0; begin < num; begin += len) {
+      std::complex<double> w(1., 0.);
+      for (int k = 0; k < len/2; ++k) {
+        const std::complex<double> even = data[begin + k];
+        const std::complex<double> odd = w*data[begin + k + len/2];
+        data[begin + k] = even + odd;
+        data[begin + k + len/2] = even - odd;
+        w *= wlen;
+      }
+    }
+  }
+}
+
+static void dft_direct(std::complex<double> * data, const int num,
+                       const double sign) {
+  std::vector<std::complex<double> > result(num);
+  for (int m = 0; m < num; ++m) {
+    for (int j = 0; j < num; ++j) {
+      const double angle = sign*2.*PI*static_cast<double>((j*m) % num)/
+                           static_cast<double>(num);
+      result[m] += data[j]*std::complex<double>(std::cos(angle),
+                                                std::sin(angle));
+    }
+  }
+  std::copy(result.begin(), result.end(), data);
+}
+
+static void transform_line(std::complex<double> * data, const int num,
+                           const bool inverse) {
+  const double sign = inverse ? 1. : -1.;
+  if (is_power_of_two(num)) {
+    fft_radix2(data, num, sign);
+  } else {
+    dft_direct(data, num, sign);
+  }
+}
+
+void fourier_transform(std::vector<std::complex<double> > * data,
+                       const bool inverse) {
+  transform_line(data->data(), static_cast<int>(data->size()), inverse);
+}
+
+void fourier_transform(const std::vector<int>& num,
+                       std::vector<std::complex<double> > * data,
+                       const bool inverse) {
+  int total = 1;
+  for (const int n : num) {
+    total *= n;
+  }
+  ASSERT(total == static_cast<int>(data->size()), "size: " << data->size()
+    << " does not match the number of points: " << total);
+  std::vector<std::complex<double> > line;
+  int stride = 1;
+  for (const int n : num) {
+    line.resize(n);
+    // transform each line along this dimension, gathered into line
+    for (int outer = 0; outer < total/(n*stride); ++outer) {
+      for (int inner = 0; inner < stride; ++inner) {
+        const int begin = outer*n*stride + inner;
+        for (int index = 0; index < n; ++index) {
+          line[index] = (*data)[begin + index*stride];
+        }
+        transform_line(line.data(), n, inverse);
+        for (int index = 0; index < n; ++index) {
+          (*data)[begin + index*stride] = line[index];
+        }
+      }
+    }
+    stride *= n;
+  }
+}
+
+}  // namespace feasst
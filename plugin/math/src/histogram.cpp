@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <cmath>
 #include "utils/include/debug.h"
 #include "utils/include/arguments.h"
@@ -104,6 +105,20 @@ double Histogram::center_of_bin(const int bin) const {
   return 0.5*(edges_[bin] + edges_[bin + 1]);
 }
 
+void Histogram::merge(const Histogram& histogram) {
+  for (int hbin = 0; hbin < histogram.size(); ++hbin) {
+    const double count = histogram.histogram_[hbin];
+    if (count != 0.) {
+      const double center = histogram.center_of_bin(hbin);
+      add(center, false);
+      const int this_bin = bin(center);
+      ASSERT(std::abs(center_of_bin(this_bin) - center) <
+             1e-8*std::max(1., std::abs(center)), "bins do not match");
+      histogram_[this_bin] += count;
+    }
+  }
+}
+
 void Histogram::add(const double value, const bool update) {
   // initialize histogram if not already and formula is set
   ASSERT(edges_.size() != 0, "size error");
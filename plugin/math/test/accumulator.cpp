@@ -1,3 +1,4 @@
+#include <cmath>
 #include "utils/test/utils.h"
 #include "math/include/accumulator.h"
 #include "math/include/constants.h"
@@ -53,6 +54,19 @@ TEST(Accumulator, constructor) {
   EXPECT_EQ(0, a.sum_of_squared());
 }
 
+// The first block of a new block size does not count its last value twice.
+TEST(Accumulator, new_block_size) {
+  Accumulator a;
+  for (int i = 0; i < 128; ++i) {
+    a.accumulate(i);
+  }
+  EXPECT_EQ(std::vector<double>({4, 8, 16, 32, 64, 128}), a.block_size());
+  EXPECT_EQ(std::vector<double>({31.5, 95.5}), a.blocks()[4]);
+  EXPECT_EQ(std::vector<double>({63.5}), a.blocks()[5]);
+  EXPECT_NEAR(63.5, a.block_averages()[4]->average(), NEAR_ZERO);
+  EXPECT_NEAR(32., a.block_averages()[4]->std()/std::sqrt(2.), NEAR_ZERO);
+}
+
 TEST(Accumulator, is_equivalent) {
   auto a = MakeAccumulator();
   auto b = MakeAccumulator();
@@ -64,6 +78,76 @@ TEST(Accumulator, is_equivalent) {
   EXPECT_TRUE(a->is_equivalent(*b, 10, 1));
 }
 
+TEST(Accumulator, merge) {
+  Accumulator all, first, second;
+  for (int i = 0; i < 32; ++i) {
+    all.accumulate(i*i);
+    if (i < 16) {
+      first.accumulate(i*i);
+    } else {
+      second.accumulate(i*i);
+    }
+  }
+  Accumulator empty;
+  empty.merge(first);
+  empty.merge(second);
+  first.merge(second);
+  for (const Accumulator& acc : {first, empty}) {
+    EXPECT_EQ(all.num_values(), acc.num_values());
+    EXPECT_NEAR(all.average(), acc.average(), NEAR_ZERO);
+    EXPECT_NEAR(all.stdev(), acc.stdev(), NEAR_ZERO);
+    EXPECT_EQ(all.max(), acc.max());
+    EXPECT_EQ(all.min(), acc.min());
+    EXPECT_EQ(all.last_value(), acc.last_value());
+    EXPECT_EQ(all.blocks()[0], acc.blocks()[0]);
+  }
+
+  // merging into an empty Accumulator does not share the block averages
+  Accumulator copy;
+  copy.merge(second);
+  const double block_stdev = second.block_stdev();
+  for (int i = 0; i < 64; ++i) {
+    copy.accumulate(i);
+  }
+  EXPECT_EQ(block_stdev, second.block_stdev());
+}
+
+// The block statistics of merged Accumulators are the same as if the values
+// were accumulated in series.
+TEST(Accumulator, merge_blocks) {
+  for (const int num_first : {256, 300}) {
+    Accumulator all, first, second;
+    for (int i = 0; i < 1000; ++i) {
+      const double value = std::sin(0.01*i*i) + i % 7;
+      all.accumulate(value);
+      if (i < num_first) {
+        first.accumulate(value);
+      } else {
+        second.accumulate(value);
+      }
+    }
+    first.merge(second);
+    EXPECT_EQ(all.block_size(), first.block_size());
+    for (int bop = 0; bop < all.max_block_operations(); ++bop) {
+      ASSERT_EQ(all.blocks()[bop].size(), first.blocks()[bop].size());
+      EXPECT_EQ(all.block_averages()[bop]->num_values(),
+                first.block_averages()[bop]->num_values());
+    }
+    // the first values fill whole blocks of the second
+    if (num_first == 256) {
+      for (int bop = 0; bop < all.max_block_operations(); ++bop) {
+        for (int block = 0; block < static_cast<int>(all.blocks()[bop].size());
+             ++block) {
+          EXPECT_NEAR(all.blocks()[bop][block], first.blocks()[bop][block],
+                      NEAR_ZERO);
+        }
+        EXPECT_NEAR(all.block_stdev(bop), first.block_stdev(bop), NEAR_ZERO);
+      }
+      EXPECT_NEAR(all.block_stdev(), first.block_stdev(), NEAR_ZERO);
+    }
+  }
+}
+
 TEST(Accumulator, serialize_with_inf) {
   Accumulator acc;
   acc.accumulate(std::numeric_limits<long double>::max());
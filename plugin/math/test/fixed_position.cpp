@@ -0,0 +1,45 @@
+#include <cmath>
+#include "utils/test/utils.h"
+#include "math/include/constants.h"
+#include "math/include/fixed_position.h"
+
+namespace feasst {
+
+constexpr double fixed_dot() {
+  FixedPosition<3> pos1, pos2;
+  pos1.set_coord(0, 1.);
+  pos1.set_coord(2, 2.);
+  pos2.set_coord(0, 3.);
+  pos2.set_coord(2, 4.);
+  pos1.add(pos2);
+  return pos1.dot_product(pos2);
+}
+
+TEST(FixedPosition, arithmetic) {
+  static_assert(fixed_dot() == 36., "constexpr arithmetic");
+  static_assert(Position2D::dimension() == 2, "dimension");
+  Position pos({3.5, 796.4, -45.4});
+  Position3D fpos(pos);
+  EXPECT_EQ(3, fpos.dimension());
+  EXPECT_EQ(796.4, fpos.coord(1));
+  EXPECT_NEAR(pos.squared_distance(), fpos.squared_distance(), NEAR_ZERO);
+  EXPECT_NEAR(pos.distance(), fpos.distance(), NEAR_ZERO);
+  Position3D fpos2;
+  EXPECT_EQ(0., fpos2.squared_distance());
+  fpos2.set_coord(0, 1.);
+  EXPECT_NEAR(pos.squared_distance(Position({1., 0., 0.})),
+              fpos.squared_distance(fpos2), NEAR_ZERO);
+  fpos2.subtract(fpos);
+  fpos2.multiply(-1.);
+  fpos2.add_to_coord(0, 1.);
+  EXPECT_EQ(pos.coord(), fpos2.position().coord());
+
+  // copy into an existing Position without changing its storage
+  Position pos2(3);
+  const double * data = pos2.coord().data();
+  fpos.position(&pos2);
+  EXPECT_EQ(data, pos2.coord().data());
+  EXPECT_EQ(pos.coord(), pos2.coord());
+}
+
+}  // namespace feasst
@@ -0,0 +1,58 @@
+#include <cmath>
+#include <complex>
+#include "utils/test/utils.h"
+#include "math/include/constants.h"
+#include "math/include/fourier_transform.h"
+
+namespace feasst {
+
+TEST(FourierTransform, line) {
+  for (const int num : {1, 2, 6, 8, 16}) {
+    std::vector<std::complex<double> > data(num), direct(num);
+    for (int j = 0; j < num; ++j) {
+      data[j] = std::complex<double>(std::cos(0.3*j*j), 0.1*j - 0.5);
+    }
+    for (int m = 0; m < num; ++m) {
+      for (int j = 0; j < num; ++j) {
+        direct[m] += data[j]*std::exp(std::complex<double>(0., -2.*PI*j*m/num));
+      }
+    }
+    std::vector<std::complex<double> > transform = data;
+    fourier_transform(&transform);
+    for (int m = 0; m < num; ++m) {
+      EXPECT_NEAR(std::abs(transform[m] - direct[m]), 0., 1e-12);
+    }
+    fourier_transform(&transform, true);
+    for (int j = 0; j < num; ++j) {
+      EXPECT_NEAR(std::abs(transform[j]/static_cast<double>(num) - data[j]),
+                  0., 1e-12);
+    }
+  }
+}
+
+TEST(FourierTransform, grid) {
+  const std::vector<int> num = {4, 3, 8};
+  std::vector<std::complex<double> > data(4*3*8);
+  for (int index = 0; index < static_cast<int>(data.size()); ++index) {
+    data[index] = std::sin(0.7*index);
+  }
+  std::vector<std::complex<double> > transform = data;
+  fourier_transform(num, &transform);
+  for (int m0 = 0; m0 < num[0]; ++m0) {
+  for (int m1 = 0; m1 < num[1]; ++m1) {
+  for (int m2 = 0; m2 < num[2]; ++m2) {
+    std::complex<double> direct;
+    for (int j0 = 0; j0 < num[0]; ++j0) {
+    for (int j1 = 0; j1 < num[1]; ++j1) {
+    for (int j2 = 0; j2 < num[2]; ++j2) {
+      const double angle = -2.*PI*(static_cast<double>(j0*m0)/num[0] +
+        static_cast<double>(j1*m1)/num[1] + static_cast<double>(j2*m2)/num[2]);
+      direct += data[j0 + num[0]*(j1 + num[1]*j2)]*
+                std::exp(std::complex<double>(0., angle));
+    }}}
+    EXPECT_NEAR(std::abs(transform[m0 + num[0]*(m1 + num[1]*m2)] - direct),
+                0., 1e-10);
+  }}}
+}
+
+}  // namespace feasst
@@ -122,6 +122,23 @@ TEST(Histogram, constructor) {
   }
 }
 
+TEST(Histogram, merge) {
+  Histogram hist, hist2;
+  hist.set_width_center(1., 0.);
+  hist2.set_width_center(1., 0.);
+  hist.add(-1.);
+  hist.add(0.2);
+  hist2.add(0.1);
+  hist2.add(3.);
+  hist.merge(hist2);
+  EXPECT_EQ(5, hist.size());
+  EXPECT_NEAR(-1., hist.center_of_bin(0), NEAR_ZERO);
+  EXPECT_EQ(1, hist.histogram()[0]);
+  EXPECT_EQ(2, hist.histogram()[1]);
+  EXPECT_EQ(0, hist.histogram()[2]);
+  EXPECT_EQ(1, hist.histogram()[4]);
+}
+
 TEST(Histogram, args) {
   Histogram hist({{"width", "0.1"}, {"max", "6"}});
   Histogram hist2 = test_serialize(hist);
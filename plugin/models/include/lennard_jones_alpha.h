@@ -76,6 +76,15 @@ class LennardJonesAlpha : public LennardJones {
     const int type2,
     const ModelParams& model_params) override;
 
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   /// Return the derivative in the potential energy with respect to distance.
   double du_dr(
     const double distance,
@@ -104,6 +113,9 @@ class LennardJonesAlpha : public LennardJones {
  protected:
   void serialize_lennard_jones_alpha_(std::ostream& ostr) const;
 
+  // Return true if energy_batch may use the flattened tables.
+  bool is_batchable_(const ModelParams& model_params) const;
+
  private:
   double alpha_;
   int delta_sigma_index_ = -1;
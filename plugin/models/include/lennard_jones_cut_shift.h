@@ -46,6 +46,15 @@ class LennardJonesCutShift : public LennardJonesAlpha {
       const int type2,
       const ModelParams& model_params) override;
 
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   std::shared_ptr<Model> create(std::istream& istr) const override {
     return std::make_shared<LennardJonesCutShift>(istr); }
   std::shared_ptr<Model> create(argtype * args) const override {
@@ -56,6 +65,9 @@ class LennardJonesCutShift : public LennardJonesAlpha {
 
 private:
   EnergyAtCutOff shift_;
+
+  // temporary and not serialized
+  std::vector<double> flat_shift_;
 };
 
 inline std::shared_ptr<LennardJonesCutShift> MakeLennardJonesCutShift(
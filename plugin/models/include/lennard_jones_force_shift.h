@@ -33,6 +33,15 @@ class LennardJonesForceShift : public LennardJonesAlpha {
       const int type2,
       const ModelParams& model_params) override;
 
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   std::shared_ptr<Model> create(std::istream& istr) const override {
     return std::make_shared<LennardJonesForceShift>(istr); }
   std::shared_ptr<Model> create(argtype * args) const override {
@@ -45,6 +54,9 @@ class LennardJonesForceShift : public LennardJonesAlpha {
   EnergyAtCutOff shift_;
   EnergyDerivAtCutOff force_shift_;
   bool precomputed_ = false;
+
+  // temporary and not serialized
+  std::vector<double> flat_shift_, flat_force_shift_, flat_cutoff_;
 };
 
 inline std::shared_ptr<LennardJonesForceShift> MakeLennardJonesForceShift(
@@ -38,6 +38,15 @@ class Mie : public ModelTwoBody {
       const int type2,
       const ModelParams& model_params) override;
 
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   std::shared_ptr<Model> create(std::istream& istr) const override {
     return std::make_shared<Mie>(istr); }
   std::shared_ptr<Model> create(argtype * args) const override {
@@ -54,6 +63,9 @@ class Mie : public ModelTwoBody {
   int mie_lambda_r_index_ = -1;
   int mie_lambda_a_index_ = -1;
   MiePrefactor prefactor_;
+
+  // flattened tables (temporary and not serialized)
+  std::vector<double> sigma_sq_, lambda_r_, lambda_a_, flat_prefactor_;
 };
 
 inline std::shared_ptr<Mie> MakeMie(argtype args = argtype()) {
@@ -2,6 +2,7 @@
 #ifndef FEASST_MODELS_SQUARE_WELL_H_
 #define FEASST_MODELS_SQUARE_WELL_H_
 
+#include <vector>
 #include "system/include/model_two_body.h"
 
 namespace feasst {
@@ -27,6 +28,18 @@ class SquareWell : public ModelTwoBody {
     const int type2,
     const ModelParams& model_params) override;
 
+  /// Same as base class, but also flatten the parameter tables.
+  void precompute(const ModelParams& existing) override;
+
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   std::shared_ptr<Model> create(std::istream& istr) const override {
     return std::make_shared<SquareWell>(istr); }
   std::shared_ptr<Model> create(argtype * args) const override {
@@ -34,6 +47,10 @@ class SquareWell : public ModelTwoBody {
   void serialize(std::ostream& ostr) const override;
   explicit SquareWell(std::istream& istr);
   virtual ~SquareWell() {}
+
+ private:
+  // temporary and not serialized
+  std::vector<double> sigma_sq_, epsilon_;
 };
 
 inline std::shared_ptr<SquareWell> MakeSquareWell() {
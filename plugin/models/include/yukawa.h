@@ -2,6 +2,7 @@
 #ifndef FEASST_MODELS_YUKAWA_H_
 #define FEASST_MODELS_YUKAWA_H_
 
+#include <vector>
 #include "system/include/model_two_body.h"
 
 namespace feasst {
@@ -31,6 +32,18 @@ class Yukawa : public ModelTwoBody {
       const int type2,
       const ModelParams& model_params) override;
 
+  /// Same as base class, but also flatten the parameter tables.
+  void precompute(const ModelParams& existing) override;
+
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   /// Set the value of the kappa parameter.
   void set_kappa(const double kappa = 1) { kappa_ = kappa; }
   double kappa() const { return kappa_; }
@@ -46,6 +59,9 @@ class Yukawa : public ModelTwoBody {
   //@}
  private:
   double kappa_;
+
+  // temporary and not serialized
+  std::vector<double> epsilon_, sigma_;
 };
 
 inline std::shared_ptr<Yukawa> MakeYukawa(argtype args = argtype()) {
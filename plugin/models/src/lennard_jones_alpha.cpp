@@ -52,7 +52,7 @@ LennardJonesAlpha::LennardJonesAlpha(std::istream& istr) : LennardJones(istr) {
 }
 
 void LennardJonesAlpha::precompute(const ModelParams& existing) {
-  Model::precompute(existing);
+  LennardJones::precompute(existing);
   delta_sigma_index_ = existing.index("delta_sigma");
   lambda_index_ = existing.index("lambda");
   TRACE("lambda_index_ " << lambda_index_);
@@ -195,4 +195,38 @@ Lambda::Lambda(std::istream& istr) : ModelParam(istr) {
   ASSERT(version == 2045, "mismatch version: " << version);
 }
 
+bool LennardJonesAlpha::is_batchable_(const ModelParams& model_params) const {
+  return is_flat_(model_params) && !lambda_ && delta_sigma_index_ == -1;
+}
+
+void LennardJonesAlpha::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  if (!is_batchable_(model_params)) {
+    ModelTwoBody::energy_batch(num, squared_distance, type1, type2,
+                               model_params, energy);
+    return;
+  }
+  const double * epsilon = epsilon_.data();
+  const double * sigma_sq = sigma_sq_.data();
+  const double half_alpha = 0.5*alpha_;
+  const double threshold_sq = hard_sphere_threshold_sq();
+  #pragma omp simd
+  for (int pair = 0; pair < num; ++pair) {
+    const int index = flat_index_(type1[pair], type2[pair]);
+    const double r2 = squared_distance[pair];
+    const double sig_sq = sigma_sq[index];
+    const double rinv_alpha = std::pow(sig_sq/r2, half_alpha);
+    double en = 4.*epsilon[index]*rinv_alpha*(rinv_alpha - 1.);
+    if (r2 == 0 || r2 < threshold_sq*sig_sq) {
+      en = NEAR_INFINITY;
+    }
+    energy[pair] = en;
+  }
+}
+
 }  // namespace feasst
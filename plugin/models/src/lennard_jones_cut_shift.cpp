@@ -44,6 +44,9 @@ void LennardJonesCutShift::precompute(const ModelParams& existing) {
   shift_.set_model(this); // note the model is used here for the computation
   shift_.set_param(existing);
   shift_.set_model(NULL); // remove model immediately
+  if (is_flat_(existing)) {
+    flatten_(shift_, &flat_shift_);
+  }
 }
 
 double LennardJonesCutShift::energy(
@@ -58,4 +61,26 @@ double LennardJonesCutShift::energy(
   return en - shift;
 }
 
+void LennardJonesCutShift::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  if (!is_batchable_(model_params) ||
+      static_cast<int>(flat_shift_.size()) != flat_num_types_*flat_num_types_) {
+    ModelTwoBody::energy_batch(num, squared_distance, type1, type2,
+                               model_params, energy);
+    return;
+  }
+  LennardJonesAlpha::energy_batch(num, squared_distance, type1, type2,
+                                  model_params, energy);
+  const double * shift = flat_shift_.data();
+  #pragma omp simd
+  for (int pair = 0; pair < num; ++pair) {
+    energy[pair] -= shift[flat_index_(type1[pair], type2[pair])];
+  }
+}
+
 }  // namespace feasst
@@ -51,6 +51,11 @@ void LennardJonesForceShift::precompute(const ModelParams& existing) {
   force_shift_.set_model(this);
   force_shift_.set_param(existing);
   force_shift_.set_model(NULL);
+  if (is_flat_(existing)) {
+    flatten_(shift_, &flat_shift_);
+    flatten_(force_shift_, &flat_force_shift_);
+    flatten_(existing.select(cutoff_index()), &flat_cutoff_);
+  }
 }
 
 double LennardJonesForceShift::energy(
@@ -70,4 +75,30 @@ double LennardJonesForceShift::energy(
   return en - shift - (distance - cutoff)*force_shift;
 }
 
+void LennardJonesForceShift::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  if (!is_batchable_(model_params) ||
+      static_cast<int>(flat_cutoff_.size()) != flat_num_types_*flat_num_types_) {
+    ModelTwoBody::energy_batch(num, squared_distance, type1, type2,
+                               model_params, energy);
+    return;
+  }
+  LennardJonesAlpha::energy_batch(num, squared_distance, type1, type2,
+                                  model_params, energy);
+  const double * shift = flat_shift_.data();
+  const double * force_shift = flat_force_shift_.data();
+  const double * cutoff = flat_cutoff_.data();
+  #pragma omp simd
+  for (int pair = 0; pair < num; ++pair) {
+    const int index = flat_index_(type1[pair], type2[pair]);
+    const double distance = std::sqrt(squared_distance[pair]);
+    energy[pair] -= shift[index] + (distance - cutoff[index])*force_shift[index];
+  }
+}
+
 }  // namespace feasst
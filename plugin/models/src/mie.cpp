@@ -55,6 +55,15 @@ void Mie::precompute(const ModelParams& existing) {
       prefactor_.compute(type1, type2, existing);
     }
   }
+  if (sigma_index() != -1) {
+    flatten_(existing.select(sigma_index()), &sigma_sq_);
+    for (double& sigma : sigma_sq_) {
+      sigma *= sigma;
+    }
+    flatten_(existing.select(mie_lambda_r_index_), &lambda_r_);
+    flatten_(existing.select(mie_lambda_a_index_), &lambda_a_);
+    flatten_(prefactor_, &flat_prefactor_);
+  }
 }
 
 double Mie::energy(
@@ -75,4 +84,29 @@ double Mie::energy(
   return en;
 }
 
+void Mie::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  if (!is_flat_(model_params)) {
+    ModelTwoBody::energy_batch(num, squared_distance, type1, type2,
+                               model_params, energy);
+    return;
+  }
+  const double * sigma_sq = sigma_sq_.data();
+  const double * lambda_r = lambda_r_.data();
+  const double * lambda_a = lambda_a_.data();
+  const double * prefactor = flat_prefactor_.data();
+  #pragma omp simd
+  for (int pair = 0; pair < num; ++pair) {
+    const int index = flat_index_(type1[pair], type2[pair]);
+    const double s_r_sq = sigma_sq[index]/squared_distance[pair];
+    energy[pair] = prefactor[index]*(std::pow(s_r_sq, 0.5*lambda_r[index]) -
+                                     std::pow(s_r_sq, 0.5*lambda_a[index]));
+  }
+}
+
 }  // namespace feasst
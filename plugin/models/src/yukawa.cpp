@@ -47,4 +47,37 @@ double Yukawa::energy(
   return epsilon*std::exp(-kappa_*(distance/sigma - 1.))/(distance/sigma);
 }
 
+void Yukawa::precompute(const ModelParams& existing) {
+  ModelTwoBody::precompute(existing);
+  if (sigma_index() != -1 && epsilon_index() != -1) {
+    flatten_(existing.select(epsilon_index()), &epsilon_);
+    flatten_(existing.select(sigma_index()), &sigma_);
+  }
+}
+
+void Yukawa::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  if (!is_flat_(model_params)) {
+    ModelTwoBody::energy_batch(num, squared_distance, type1, type2,
+                               model_params, energy);
+    return;
+  }
+  const double * epsilon = epsilon_.data();
+  const double * sigma = sigma_.data();
+  const double kappa = kappa_;
+  #pragma omp simd
+  for (int pair = 0; pair < num; ++pair) {
+    const int index = flat_index_(type1[pair], type2[pair]);
+    const double reduced_distance =
+      std::sqrt(squared_distance[pair])/sigma[index];
+    energy[pair] = epsilon[index]*std::exp(-kappa*(reduced_distance - 1.))/
+                   reduced_distance;
+  }
+}
+
 }  // namespace feasst
@@ -55,4 +55,20 @@ TEST(LennardJonesCutShift, analytical_lambda) {
   EXPECT_NEAR(NEAR_ZERO, shift->energy(3*3, 0, 0, config->model_params()), NEAR_ZERO);
 }
 
+TEST(LennardJonesCutShift, energy_batch) {
+  auto config = MakeConfiguration({{"particle_type0", "../particle/co2_epm2.fstprt"}});
+  auto model = MakeLennardJonesCutShift();
+  model->precompute(config->model_params());
+  const std::vector<double> r2 = {0.1, 9., 12., 16., 100.};
+  const std::vector<int> type1 = {0, 0, 1, 1, 0};
+  const std::vector<int> type2 = {0, 1, 0, 1, 1};
+  std::vector<double> energy(r2.size());
+  model->energy_batch(5, r2.data(), type1.data(), type2.data(),
+                      config->model_params(), energy.data());
+  for (int pair = 0; pair < 5; ++pair) {
+    EXPECT_NEAR(model->energy(r2[pair], type1[pair], type2[pair],
+                              config->model_params()), energy[pair], 1e-10);
+  }
+}
+
 }  // namespace feasst
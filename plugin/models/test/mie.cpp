@@ -25,4 +25,20 @@ TEST(Mie, analytical) {
   EXPECT_NEAR(-0.000198678220854467, lrc2->energy(), NEAR_ZERO);
 }
 
+TEST(Mie, energy_batch) {
+  auto config = MakeConfiguration({{"particle_type0", "../particle/mie.fstprt"}});
+  auto model = MakeMie();
+  model->precompute(config->model_params());
+  const std::vector<double> r2 = {1., 2.25, 4.};
+  const std::vector<int> type1 = {0, 0, 0};
+  const std::vector<int> type2 = {0, 0, 0};
+  std::vector<double> energy(r2.size());
+  model->energy_batch(3, r2.data(), type1.data(), type2.data(),
+                      config->model_params(), energy.data());
+  for (int pair = 0; pair < 3; ++pair) {
+    EXPECT_NEAR(model->energy(r2[pair], type1[pair], type2[pair],
+                              config->model_params()), energy[pair], 1e-10);
+  }
+}
+
 }  // namespace feasst
@@ -1,4 +1,5 @@
 #include "utils/test/utils.h"
+#include "configuration/include/configuration.h"
 #include "models/include/square_well.h"
 
 namespace feasst {
@@ -9,4 +10,20 @@ TEST(SquareWell, serialize) {
     "SquareWell 2094 -1 -1 -1 -1 553 ");
 }
 
+TEST(SquareWell, energy_batch) {
+  auto config = MakeConfiguration({{"particle_type0", "../particle/lj.fstprt"}});
+  auto model = MakeSquareWell();
+  model->precompute(config->model_params());
+  const std::vector<double> r2 = {0.5, 1., 4.};
+  const std::vector<int> type1 = {0, 0, 0};
+  const std::vector<int> type2 = {0, 0, 0};
+  std::vector<double> energy(r2.size());
+  model->energy_batch(3, r2.data(), type1.data(), type2.data(),
+                      config->model_params(), energy.data());
+  for (int pair = 0; pair < 3; ++pair) {
+    EXPECT_NEAR(model->energy(r2[pair], type1[pair], type2[pair],
+                              config->model_params()), energy[pair], 1e-10);
+  }
+}
+
 }  // namespace feasst
@@ -10,11 +10,25 @@
 
 namespace feasst {
 
+class AnalyzeQueue;
+class AnalyzeSnapshot;
 class Configuration;
 class TrialFactory;
 
 /**
   Perform a read-only action every so many trials.
+
+  If the asynchronous argument is true (see Stepper), updates and writes are
+  instead performed in order on a background thread with a snapshot of the
+  System (see System::snapshot), Criteria and TrialFactory.
+  The snapshots are reused, so that only the positions and stored energies
+  (see System::update_snapshot), the state of a Metropolis Criteria and the
+  statistics of the trials (see TrialFactory::update_snapshot) are copied
+  when the particles are unchanged.
+  Other Criteria, such as FlatHistogram, are deep copied.
+  The trials only wait if the number of pending updates and writes reaches
+  asynchronous_queue.
+  Use wait_asynchronous before accessing the results.
  */
 class Analyze : public Stepper {
  public:
@@ -44,6 +58,9 @@ class Analyze : public Stepper {
       const System& system,
       const TrialFactory& trial_factory);
 
+  /// Wait until all asynchronous updates and writes are complete.
+  virtual void wait_asynchronous();
+
   // Access to factory of Analyze objects.
   virtual const std::vector<std::shared_ptr<Analyze> >& analyzers() const;
   virtual const Analyze& analyze(const int index) const;
@@ -64,6 +81,18 @@ class Analyze : public Stepper {
   void check_update_(const Criteria& criteria,
     const System& system,
     const TrialFactory& trial_factory);
+
+ private:
+  // temporary and not serialized
+  // The snapshots are declared first, to be destroyed after the queue.
+  std::vector<std::shared_ptr<AnalyzeSnapshot> > snapshots_;
+  int snapshot_ = 0;
+  std::shared_ptr<AnalyzeQueue> queue_;
+
+  void asynchronous_(const bool is_update, const bool is_write,
+    const Criteria& criteria,
+    const System& system,
+    const TrialFactory& trial_factory);
 };
 
 /**
@@ -42,6 +42,9 @@ class AnalyzeFactory : public Analyze {
     const System& system,
     const TrialFactory& trial_factory) override;
 
+  /// Wait for the asynchronous updates and writes of all Analyze objects.
+  void wait_asynchronous() override;
+
   /// For use with CollectionMatrixSplice, transfer multistate between threads.
   void adjust_bounds(const bool adjusted_up, const std::vector<int>& states,
     AnalyzeFactory * analyze_factory);
@@ -50,6 +53,10 @@ class AnalyzeFactory : public Analyze {
     const System& system,
     const TrialFactory& trial_factory) override;
 
+  /// Merge each Analyze object of the factory.
+  void merge(const Stepper& stepper) override;
+  bool is_mergeable() const override;
+
   Analyze * get_analyze(const int index) override {
     return analyzers_[index].get(); }
 
@@ -60,7 +67,7 @@ class AnalyzeFactory : public Analyze {
     return std::make_shared<AnalyzeFactory>(istr); }
   void serialize(std::ostream& ostr) const override;
   explicit AnalyzeFactory(std::istream& istr);
-  virtual ~AnalyzeFactory() {}
+  virtual ~AnalyzeFactory();
 
  private:
   std::vector<std::shared_ptr<Analyze> > analyzers_;
@@ -171,11 +171,17 @@ class Criteria {
   void synchronize_(const Criteria& criteria) { data_ = criteria.data(); }
   const SynchronizeData& data() const { return data_; }
 
+  // Update a copy of the given Criteria for asynchronous Analyze.
+  // Return false, without changes, if a deep copy is required instead
+  // (default).
+  virtual bool update_snapshot(const Criteria& criteria) { return false; }
+
   // HWH hackish adjust_bounds interface. See CollectionMatrixSplice.
   virtual int set_soft_max(const int index, const System& sys);
   virtual int set_soft_min(const int index, const System& sys);
   virtual void set_cm(const bool inc_max, const int macro,
                       const Criteria& crit);
+  virtual void set_cm_shared(const std::vector<double>& shared);
   virtual void adjust_bounds(const bool left_most, const bool right_most,
     const bool left_complete, const bool right_complete,
     const bool all_min_size,
@@ -205,6 +211,7 @@ class Criteria {
  protected:
   std::string class_name_ = "Criteria";
   void serialize_criteria_(std::ostream& ostr) const;
+  void update_snapshot_criteria_(const Criteria& criteria);
   bool was_accepted_ = false;
   SynchronizeData data_;
   void check_num_iterations_(const int num_trials_per_iteration);
@@ -44,6 +44,7 @@ class Metropolis : public Criteria {
     return std::make_shared<Metropolis>(istr); }
   std::shared_ptr<Criteria> create(argtype * args) const override {
     return std::make_shared<Metropolis>(args); }
+  bool update_snapshot(const Criteria& criteria) override;
   void serialize(std::ostream& ostr) const override;
   explicit Metropolis(std::istream& istr);
   ~Metropolis() {}
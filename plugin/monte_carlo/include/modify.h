@@ -16,11 +16,12 @@ class TrialFactory;
 /**
   Perform an action every so many trials that may change the system, criteria
   or trials.
+  Thus, unlike Analyze, a Modify is never asynchronous.
  */
 class Modify : public Stepper {
  public:
   Modify() : Stepper() {}
-  explicit Modify(argtype * args) : Stepper(args) {}
+  explicit Modify(argtype * args);
 
   /// Initialize and precompute before trials.
   virtual void initialize(Criteria * criteria,
@@ -51,6 +51,10 @@ class ModifyFactory : public Modify {
     Random * random,
     TrialFactory * trial_factory) override;
 
+  /// Merge each Modify object of the factory.
+  void merge(const Stepper& stepper) override;
+  bool is_mergeable() const override;
+
   Modify * get_modify(const int index) override {
     return modifiers_[index].get(); }
 
@@ -150,6 +150,14 @@ class MonteCarlo {
   AnalyzeFactory * get_analyze_factory();
   ModifyFactory * get_modify_factory();
 
+  /**
+    Exchange the System with another MonteCarlo by swapping pointers, without
+    copying the Configuration (e.g., ReplicaExchange).
+    The ThermoParams remain with each MonteCarlo, while the current energy of
+    the Criteria is exchanged along with the System.
+   */
+  void exchange_system(MonteCarlo * mc);
+
   // HWH hackish interface. See CollectionMatrixSplice::adjust_bounds.
   void adjust_bounds(const bool left_most, const bool right_most,
     const bool left_complete, const bool right_complete,
@@ -203,7 +211,8 @@ class MonteCarlo {
   /// Remove an analyze by index.
   void remove_analyze(const int index);
 
-  /// Return all analyzers.
+  /// Return all analyzers, after waiting for any asynchronous updates and
+  /// writes (see Analyze).
   const std::vector<std::shared_ptr<Analyze> >& analyzers() const;
 
   /// Return an Analyze by index.
@@ -234,6 +243,9 @@ class MonteCarlo {
   /// Write checkpoint file
   void write_checkpoint() const;
 
+  /// Return the checkpoint, or NULL if there is none.
+  Checkpoint * get_checkpoint() { return checkpoint_.get(); }
+
   /// Attempt one trial, with subsequent analysers and modifiers.
   // void attempt() { attempt_(1, trial_factory_.get(), random_.get()); }
 
@@ -10,6 +10,8 @@
 
 namespace feasst {
 
+class Select;
+
 /**
   Rotate the positions of the selection.
   In 2D, the tunable parameter is the maximum angle of rotation.
@@ -69,9 +71,15 @@ class PerturbRotate : public PerturbMove {
 
   // temporary and not serialized
   RotationMatrix rot_mat1_, rot_mat2_, rot_mat3_;
-  Position axis_tmp_, vec1_, vec2_;
+  Position axis_tmp_, vec1_, vec2_, rotated_position_;
   Euler euler_;
 
+  // rotate the selection with positions of fixed dimension
+  template <int D>
+  void update_selection_(const Position& pivot,
+      const RotationMatrix& rotation,
+      Select * rotated);
+
   const Position& piv_sel_(const Position& pivot, const TrialSelect * select);
 
   // optimization
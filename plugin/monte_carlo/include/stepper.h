@@ -57,6 +57,16 @@ class Stepper {
       If multistate_aggregate, automatically set to false.
     - Accumulator arguments.
     - configuration_index: index of configuration (default: 0)
+    - asynchronous: if true, perform the updates and writes of an Analyze on a
+      background thread, using a snapshot of the System, Criteria and
+      TrialFactory taken on the trial that the update or write is due.
+      Thus, trials do not wait for file output or expensive analysis
+      (default: false).
+      The snapshot shares nothing with the System (see System::snapshot).
+      Not available for multistate, or for a Modify (e.g., PairDistribution),
+      which may change the System, Criteria or TrialFactory on update.
+    - asynchronous_queue: maximum number of pending asynchronous updates and
+      writes before the trials wait for them to complete (default: 2).
    */
   explicit Stepper(argtype args = argtype());
   explicit Stepper(argtype * args);
@@ -123,12 +133,30 @@ class Stepper {
   /// Get the accumulator.
   Accumulator * get_accumulator();
 
+  /**
+    Add the statistics of another Stepper of the same class, such as a copy
+    that was updated on another thread (e.g., see AnalyzeTrajectory).
+    By default, only the accumulator is added, and only if is_mergeable.
+    Derived classes with other statistics should also override.
+   */
+  virtual void merge(const Stepper& stepper);
+
+  /// Return true if merge adds all of the statistics.
+  /// Derived classes opt in by overriding (default: false).
+  virtual bool is_mergeable() const { return false; }
+
   /// Return the number of trials since update.
   int trials_since_update() const { return trials_since_update_; }
 
   /// Return the number of trials since write.
   int trials_since_write() const { return trials_since_write_; }
 
+  /// Return true if updates and writes are asynchronous.
+  bool is_asynchronous() const { return is_asynchronous_; }
+
+  /// Return the maximum number of pending asynchronous updates and writes.
+  int asynchronous_queue() const { return asynchronous_queue_; }
+
   /// Return true if aggregating the write of multistate.
   bool is_multistate_aggregate() const { return is_multistate_aggregate_; }
 
@@ -190,6 +218,8 @@ class Stepper {
   int state_ = 0;
   int configuration_index_;
   bool rewrite_header_;
+  bool is_asynchronous_;
+  int asynchronous_queue_;
 };
 
 }  // namespace feasst
@@ -182,6 +182,10 @@ class Trial {
 
   // prefetch synchronization
   virtual void synchronize_(const Trial& trial) { data_ = trial.data(); }
+
+  // Update a copy of the given Trial with its statistics, tunable parameters
+  // and Acceptance.
+  void update_snapshot(const Trial& trial);
   const SynchronizeData& data() const { return data_; }
 
   // Access to factory of Trial objects.
@@ -92,6 +92,9 @@ class TrialFactory : public Trial {
 
   bool is_equal(const TrialFactory& factory) const;
   void synchronize_(const Trial& trial) override;
+
+  // Update a copy of the given TrialFactory, as in Trial::update_snapshot.
+  void update_snapshot(const TrialFactory& factory);
   Trial * get_trial(const int index) { return trials_[index].get(); }
 
   void set_tunable(const int trial_index, const double tunable);
@@ -5,6 +5,7 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace feasst {
 
@@ -24,6 +25,13 @@ typedef std::map<std::string, std::string> argtype;
   The use of reference potentials in stages is a generalization of the dual-cut
   configurational bias (DC-CB) methodology as described in
   http://doi.org/10.1080/002689798167881.
+
+  With num_threads, the random realizations of the steps are still performed
+  in order, and the energy of the last step is computed with the System.
+  The energies of the remaining steps are computed concurrently, each thread
+  with a deep copy of the System that matches the particles and potential data
+  of the System during the first step.
+  Thus, the results are the same as with one thread.
  */
 class TrialStage {
  public:
@@ -38,6 +46,8 @@ class TrialStage {
       Otherwise, if full potential is desired, set to -1 (default: -1).
     - new_only: do not compute the Rosenbluth of the old configuration
       (default: false).
+    - num_threads: number of OpenMP threads used to compute the energies of
+      the steps. If -1, use the maximum number of threads (default: 1).
    */
   explicit TrialStage(argtype * args);
 
@@ -52,6 +62,9 @@ class TrialStage {
   /// Return true if the trial computes new configuration only.
   bool is_new_only() const { return is_new_only_; }
 
+  /// Return the number of threads.
+  int num_threads() const { return num_threads_; }
+
   /// Return the Rosenbluth.
   const Rosenbluth& rosenbluth() const;
 
@@ -140,7 +153,18 @@ class TrialStage {
   std::shared_ptr<TrialSelect> select_;
   std::shared_ptr<Rosenbluth> rosenbluth_;
   bool is_new_only_;
+  int num_threads_;
+
+  // temporary and not serialized
+  std::vector<double> step_energy_, step_excluded_;
+  std::vector<std::vector<double> > step_profile_;
+
   void set_rosenbluth_energy_(const int step, System * system);
+  void set_rosenbluth_energy_(const int step, const double energy,
+    const double excluded, const std::vector<double>& profile);
+  int num_step_threads_() const;
+  void synchronize_threads_(const int num_threads, System * system);
+  void compute_steps_threads_(const int num_threads, System * system);
 };
 
 /// Return the optional arguments relevant to TrialStage.
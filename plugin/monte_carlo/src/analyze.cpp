@@ -1,4 +1,10 @@
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include "utils/include/debug.h"
+#include "utils/include/custom_exception.h"
 #include "utils/include/arguments.h"
 #include "utils/include/serialize_extra.h"
 #include "configuration/include/select.h"
@@ -11,6 +17,100 @@
 
 namespace feasst {
 
+/**
+  A bounded first-in first-out queue of tasks performed by one background
+  thread.
+  The thread is joined upon destruction, after the remaining tasks.
+ */
+class AnalyzeQueue {
+ public:
+  explicit AnalyzeQueue(const int max_size) : max_size_(max_size) {
+    worker_ = std::thread(&AnalyzeQueue::work_, this);
+  }
+
+  /// Wait until the queue is not full.
+  /// Then, at most max_size tasks are pending or in progress.
+  void wait_to_push() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] {
+      return static_cast<int>(tasks_.size()) < max_size_; });
+  }
+
+  /// Add a task, but first wait if the queue is full.
+  void push(std::function<void()> task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] {
+      return static_cast<int>(tasks_.size()) < max_size_; });
+    tasks_.push_back(std::move(task));
+    cond_.notify_all();
+  }
+
+  /// Wait until all tasks are complete. Return the error, if any.
+  std::string wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+    std::string error;
+    std::swap(error, error_);
+    return error;
+  }
+
+  ~AnalyzeQueue() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    worker_.join();
+  }
+
+ private:
+  int max_size_;
+  bool stop_ = false;
+  bool busy_ = false;
+  std::string error_;
+  std::deque<std::function<void()> > tasks_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread worker_;
+
+  void work_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cond_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      std::function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      cond_.notify_all();
+      std::string error;
+      try {
+        task();
+      } catch (const CustomException& e) {
+        error = e.what();
+      }
+      lock.lock();
+      if (error_.empty()) {
+        error_ = error;
+      }
+      busy_ = false;
+      cond_.notify_all();
+    }
+  }
+};
+
+/**
+  The copies read by an asynchronous update or write.
+ */
+class AnalyzeSnapshot {
+ public:
+  std::shared_ptr<Criteria> criteria;
+  std::shared_ptr<System> system;
+  std::shared_ptr<TrialFactory> trial_factory;
+};
+
 std::map<std::string, std::shared_ptr<Analyze> >& Analyze::deserialize_map() {
   static std::map<std::string, std::shared_ptr<Analyze> >* ans =
      new std::map<std::string, std::shared_ptr<Analyze> >();
@@ -53,14 +153,73 @@ void Analyze::trial(const Criteria& criteria,
       (stop_after_iteration() == -1 || criteria.num_iterations() <= stop_after_iteration())) {
     if ((criteria.phase() > start_after_phase()) &&
         (criteria.num_iterations() > start_after_iteration())) {
-      check_update_(criteria, system, trial_factory);
-      if (is_time(trials_per_write(), &trials_since_write_)) {
-        write_to_file(criteria, system, trial_factory);
+      if (is_asynchronous()) {
+        const bool is_update =
+          is_time(trials_per_update(), &trials_since_update_);
+        const bool is_write =
+          is_time(trials_per_write(), &trials_since_write_);
+        if (is_update || is_write) {
+          asynchronous_(is_update, is_write, criteria, system, trial_factory);
+        }
+      } else {
+        check_update_(criteria, system, trial_factory);
+        if (is_time(trials_per_write(), &trials_since_write_)) {
+          write_to_file(criteria, system, trial_factory);
+        }
       }
     }
   }
 }
 
+void Analyze::asynchronous_(const bool is_update, const bool is_write,
+    const Criteria& criteria,
+    const System& system,
+    const TrialFactory& trial_factory) {
+  if (!queue_) {
+    queue_ = std::make_shared<AnalyzeQueue>(asynchronous_queue());
+    snapshots_.resize(asynchronous_queue() + 1);
+  }
+
+  // Once the queue is not full, the snapshot of the task that many before
+  // this one is no longer read, and is reused.
+  queue_->wait_to_push();
+  std::shared_ptr<AnalyzeSnapshot>& snapshot = snapshots_[snapshot_];
+  snapshot_ = (snapshot_ + 1) % static_cast<int>(snapshots_.size());
+  if (!snapshot) {
+    snapshot = std::make_shared<AnalyzeSnapshot>();
+    snapshot->system = std::make_shared<System>(system.snapshot());
+  } else {
+    snapshot->system->update_snapshot(system);
+  }
+  if (snapshot->trial_factory &&
+      snapshot->trial_factory->num() == trial_factory.num()) {
+    snapshot->trial_factory->update_snapshot(trial_factory);
+  } else {
+    snapshot->trial_factory =
+      std::make_shared<TrialFactory>(deep_copy(trial_factory));
+  }
+  if (!snapshot->criteria || !snapshot->criteria->update_snapshot(criteria)) {
+    snapshot->criteria = deep_copy_derived(const_cast<Criteria*>(&criteria));
+  }
+  const AnalyzeSnapshot * snap = snapshot.get();
+  queue_->push([this, is_update, is_write, snap]() {
+    if (is_update) {
+      update(*snap->criteria, *snap->system, *snap->trial_factory);
+    }
+    if (is_write) {
+      write_to_file(*snap->criteria, *snap->system, *snap->trial_factory);
+    }
+  });
+}
+
+void Analyze::wait_asynchronous() {
+  if (queue_) {
+    const std::string error = queue_->wait();
+    ASSERT(error.empty(), "asynchronous " << class_name() << " failed: "
+      << error);
+  }
+}
+
 void Analyze::write_to_file(const Criteria& criteria,
     const System& system,
     const TrialFactory& trial_factory) {
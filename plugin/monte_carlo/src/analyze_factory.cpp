@@ -1,3 +1,4 @@
+#include "utils/include/custom_exception.h"
 #include "utils/include/serialize.h"
 #include "math/include/accumulator.h"
 #include "system/include/system.h"
@@ -174,6 +175,21 @@ void AnalyzeFactory::write_to_file(const Criteria& criteria,
   }
 }
 
+void AnalyzeFactory::wait_asynchronous() {
+  for (std::shared_ptr<Analyze> analyze : analyzers_) {
+    analyze->wait_asynchronous();
+  }
+}
+
+AnalyzeFactory::~AnalyzeFactory() {
+  // complete the asynchronous tasks before the Analyze objects are destroyed.
+  try {
+    wait_asynchronous();
+  } catch (const CustomException& e) {
+    WARN(e.what());
+  }
+}
+
 void AnalyzeFactory::adjust_bounds(const bool adjusted_up,
     const std::vector<int>& states,
     AnalyzeFactory * analyze_factory) {
@@ -214,4 +230,24 @@ void AnalyzeFactory::serialize(std::ostream& ostr) const {
   feasst_serialize_fstdr(analyzers_, ostr);
 }
 
+void AnalyzeFactory::merge(const Stepper& stepper) {
+  ASSERT(class_name() == stepper.class_name(), "cannot merge " <<
+    stepper.class_name() << " into " << class_name());
+  const AnalyzeFactory& factory = dynamic_cast<const AnalyzeFactory&>(stepper);
+  ASSERT(num() == factory.num(), "number: " << factory.num() <<
+    " != " << num());
+  for (int index = 0; index < num(); ++index) {
+    analyzers_[index]->merge(*factory.analyzers_[index]);
+  }
+}
+
+bool AnalyzeFactory::is_mergeable() const {
+  for (const auto& stepper : analyzers_) {
+    if (!stepper->is_mergeable()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace feasst
@@ -189,6 +189,17 @@ void Criteria::serialize_criteria_(std::ostream& ostr) const {
   feasst_serialize_fstobj(data_, ostr);
 }
 
+void Criteria::update_snapshot_criteria_(const Criteria& criteria) {
+  was_accepted_ = criteria.was_accepted_;
+  data_ = criteria.data_;
+  previous_energy_ = criteria.previous_energy_;
+  previous_energy_profile_ = criteria.previous_energy_profile_;
+  phase_ = criteria.phase_;
+  expanded_state_ = criteria.expanded_state_;
+  num_expanded_states_ = criteria.num_expanded_states_;
+  num_iterations_to_complete_ = criteria.num_iterations_to_complete_;
+}
+
 Criteria::Criteria(std::istream& istr) {
   istr >> class_name_;
   const int version = feasst_deserialize_version(istr);
@@ -267,6 +278,10 @@ void Criteria::set_cm(const bool inc_max, const int macro, const Criteria& crit)
   FATAL("not implemented");
 }
 
+void Criteria::set_cm_shared(const std::vector<double>& shared) {
+  FATAL("not implemented");
+}
+
 void Criteria::adjust_bounds(const bool left_most, const bool right_most,
   const bool left_complete, const bool right_complete,
   const bool all_min_size,
@@ -61,6 +61,16 @@ class MapMetropolis {
 
 static MapMetropolis mapper_ = MapMetropolis();
 
+bool Metropolis::update_snapshot(const Criteria& criteria) {
+  if (criteria.class_name() != class_name()) {
+    return false;
+  }
+  update_snapshot_criteria_(criteria);
+  num_trials_per_iteration_ =
+    static_cast<const Metropolis&>(criteria).num_trials_per_iteration_;
+  return true;
+}
+
 Metropolis::Metropolis(std::istream& istr) : Criteria(istr) {
   const int version = feasst_deserialize_version(istr);
   ASSERT(version == 278, "version mismatch: " << version);
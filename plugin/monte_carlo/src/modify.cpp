@@ -7,6 +7,11 @@
 
 namespace feasst {
 
+Modify::Modify(argtype * args) : Stepper(args) {
+  ASSERT(!is_asynchronous(), "Modify cannot be asynchronous because it may "
+    << "change the System, Criteria or trials.");
+}
+
 std::map<std::string, std::shared_ptr<Modify> >& Modify::deserialize_map() {
   static std::map<std::string, std::shared_ptr<Modify> >* ans =
      new std::map<std::string, std::shared_ptr<Modify> >();
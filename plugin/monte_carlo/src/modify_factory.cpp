@@ -158,4 +158,24 @@ void ModifyFactory::serialize(std::ostream& ostr) const {
   feasst_serialize_fstdr(modifiers_, ostr);
 }
 
+void ModifyFactory::merge(const Stepper& stepper) {
+  ASSERT(class_name() == stepper.class_name(), "cannot merge " <<
+    stepper.class_name() << " into " << class_name());
+  const ModifyFactory& factory = dynamic_cast<const ModifyFactory&>(stepper);
+  ASSERT(num() == factory.num(), "number: " << factory.num() <<
+    " != " << num());
+  for (int index = 0; index < num(); ++index) {
+    modifiers_[index]->merge(*factory.modifiers_[index]);
+  }
+}
+
+bool ModifyFactory::is_mergeable() const {
+  for (const auto& stepper : modifiers_) {
+    if (!stepper->is_mergeable()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace feasst
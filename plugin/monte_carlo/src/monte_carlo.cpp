@@ -265,6 +265,34 @@ void MonteCarlo::set(const System& system) {
   // HWH used in clones.cpp to transfer configurations
 }
 
+void MonteCarlo::exchange_system(MonteCarlo * mc) {
+  ASSERT(criteria_set_ && mc->criteria_set_,
+    "set Criteria before exchanging the System.");
+  const int num_configs = system_->num_configurations();
+  ASSERT(num_configs == mc->system_->num_configurations(),
+    "the number of Configurations must be the same.");
+  auto thermo_params = std::make_shared<ThermoParams>(
+    system_->thermo_params());
+  auto mc_thermo_params = std::make_shared<ThermoParams>(
+    mc->system_->thermo_params());
+  std::swap(system_, mc->system_);
+  system_->set(thermo_params);
+  mc->system_->set(mc_thermo_params);
+  for (int config = 0; config < num_configs; ++config) {
+    const double energy = criteria_->current_energy(config);
+    const std::vector<double> profile =
+      criteria_->current_energy_profile(config);
+    criteria_->set_current_energy(mc->criteria_->current_energy(config),
+                                  config);
+    criteria_->set_current_energy_profile(
+      mc->criteria_->current_energy_profile(config), config);
+    mc->criteria_->set_current_energy(energy, config);
+    mc->criteria_->set_current_energy_profile(profile, config);
+  }
+  criteria_->update_state(*system_, Acceptance());
+  mc->criteria_->update_state(*mc->system_, Acceptance());
+}
+
 void MonteCarlo::set(std::shared_ptr<Criteria> criteria) {
   ASSERT(system_set_, "set System before Criteria.");
   criteria_ = criteria;
@@ -500,6 +528,7 @@ void MonteCarlo::after_trial_modify_() {
 }
 
 void MonteCarlo::serialize(std::ostream& ostr) const {
+  analyze_factory_->wait_asynchronous();
   feasst_serialize_version(529, ostr);
   feasst_serialize(system_, ostr);
   feasst_serialize_fstdr(criteria_, ostr);
@@ -736,6 +765,7 @@ void MonteCarlo::ghost_trial_(
 }
 
 void MonteCarlo::write_to_file() {
+  analyze_factory_->wait_asynchronous();
   analyze_factory_->write_to_file(*criteria_, *system_, *trial_factory_);
   modify_factory_->write_to_file(criteria_.get(), system_.get(), trial_factory_.get());
 }
@@ -818,7 +848,10 @@ void MonteCarlo::run_until_complete() {
   run_until_complete_(trial_factory_.get(), random_.get()); }
 void MonteCarlo::delay_finalize_() {
   trial_factory_->delay_finalize(); }
-AnalyzeFactory * MonteCarlo::get_analyze_factory() { return analyze_factory_.get(); }
+AnalyzeFactory * MonteCarlo::get_analyze_factory() {
+  analyze_factory_->wait_asynchronous();
+  return analyze_factory_.get();
+}
 ModifyFactory * MonteCarlo::get_modify_factory() { return modify_factory_.get(); }
 void MonteCarlo::remove_modify(const int index) { modify_factory_->remove(index); }
 void MonteCarlo::remove_analyze(const int index) { analyze_factory_->remove(index); }
@@ -827,8 +860,10 @@ const Modify& MonteCarlo::modify(const int index) const {
 int MonteCarlo::num_modifiers() const {
   return static_cast<int>(modify_factory_->modifiers().size()); }
 const std::vector<std::shared_ptr<Analyze> >& MonteCarlo::analyzers() const {
+  analyze_factory_->wait_asynchronous();
   return analyze_factory_->analyzers(); }
 const Analyze& MonteCarlo::analyze(const int index) const {
+  analyze_factory_->wait_asynchronous();
   return analyze_factory_->analyze(index); }
 int MonteCarlo::num_analyzers() const {
   return static_cast<int>(analyze_factory_->analyzers().size()); }
@@ -41,6 +41,13 @@ void PerturbRotate::update_selection(const Position& pivot,
   Select * rotated = select->get_mobile();
   DEBUG("rotation matrix : " << rotation.str());
   DEBUG("rotated " << rotated->str());
+  if (pivot.dimension() == 3) {
+    update_selection_<3>(pivot, rotation, rotated);
+    return;
+  } else if (pivot.dimension() == 2) {
+    update_selection_<2>(pivot, rotation, rotated);
+    return;
+  }
   for (int select_index = 0;
        select_index < rotated->num_particles();
        ++select_index) {
@@ -56,6 +63,26 @@ void PerturbRotate::update_selection(const Position& pivot,
   }
 }
 
+template <int D>
+void PerturbRotate::update_selection_(const Position& pivot,
+    const RotationMatrix& rotation,
+    Select * rotated) {
+  const FixedPosition<D> fixed_pivot(pivot);
+  FixedPosition<D> fixed_position;
+  for (int select_index = 0;
+       select_index < rotated->num_particles();
+       ++select_index) {
+    for (int site = 0;
+         site < static_cast<int>(rotated->site_indices(select_index).size());
+         ++site) {
+      fixed_position.set(rotated->site_positions()[select_index][site]);
+      rotation.rotate(fixed_pivot, &fixed_position);
+      fixed_position.position(&rotated_position_);
+      rotated->set_site_position(select_index, site, rotated_position_);
+    }
+  }
+}
+
 void PerturbRotate::update_eulers(const RotationMatrix& rotation,
     TrialSelect * select,
     const System * system) {
@@ -63,6 +63,12 @@ Stepper::Stepper(argtype * args) {
 //    accumulator_.set_moments(integer("num_moments", args));
 //  }
   configuration_index_ = integer("configuration_index", args, 0);
+  is_asynchronous_ = boolean("asynchronous", args, false);
+  asynchronous_queue_ = integer("asynchronous_queue", args, 2);
+  ASSERT(asynchronous_queue_ > 0,
+    "asynchronous_queue: " << asynchronous_queue_ << " must be positive.");
+  ASSERT(!is_asynchronous_ || !is_multistate(),
+    "asynchronous is not implemented for multistate.");
 }
 
 bool Stepper::is_time(const int trials_per, int * trials_since) {
@@ -110,7 +116,7 @@ void Stepper::set_state(const int state) {
 
 void Stepper::serialize(std::ostream& ostr) const {
   ostr << class_name() << " ";
-  feasst_serialize_version(497, ostr);
+  feasst_serialize_version(498, ostr);
   feasst_serialize(trials_since_update_, ostr);
   feasst_serialize(trials_since_write_, ostr);
   feasst_serialize(trials_per_update_, ostr);
@@ -128,6 +134,8 @@ void Stepper::serialize(std::ostream& ostr) const {
   feasst_serialize(configuration_index_, ostr);
   feasst_serialize(rewrite_header_, ostr);
   feasst_serialize(accumulator_, ostr);
+  feasst_serialize(is_asynchronous_, ostr);
+  feasst_serialize(asynchronous_queue_, ostr);
   feasst_serialize_endcap("Stepper", ostr);
 }
 
@@ -135,7 +143,7 @@ Stepper::Stepper(std::istream& istr) {
   std::string name;
   istr >> name;
   const int version = feasst_deserialize_version(istr);
-  ASSERT(497 == version, version);
+  ASSERT(version >= 497 && version <= 498, "version: " << version);
   feasst_deserialize(&trials_since_update_, istr);
   feasst_deserialize(&trials_since_write_, istr);
   feasst_deserialize(&trials_per_update_, istr);
@@ -161,6 +169,12 @@ Stepper::Stepper(std::istream& istr) {
       accumulator_ = std::make_shared<Accumulator>(istr);
     }
   }
+  is_asynchronous_ = false;
+  asynchronous_queue_ = 2;
+  if (version >= 498) {
+    feasst_deserialize(&is_asynchronous_, istr);
+    feasst_deserialize(&asynchronous_queue_, istr);
+  }
   feasst_deserialize_endcap("Stepper", istr);
 }
 
@@ -172,4 +186,11 @@ const Accumulator& Stepper::accumulator() const { return *accumulator_; }
 
 Accumulator * Stepper::get_accumulator() { return accumulator_.get(); }
 
+void Stepper::merge(const Stepper& stepper) {
+  ASSERT(class_name() == stepper.class_name(), "cannot merge " <<
+    stepper.class_name() << " into " << class_name());
+  ASSERT(is_mergeable(), class_name() << " cannot be merged");
+  accumulator_->merge(*stepper.accumulator_);
+}
+
 }  // namespace feasst
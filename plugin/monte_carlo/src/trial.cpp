@@ -93,6 +93,17 @@ std::string Trial::status() const {
   return ss.str();
 }
 
+void Trial::update_snapshot(const Trial& trial) {
+  data_ = trial.data();
+  *acceptance_ = trial.accept();
+  for (int index = 0; index < num_stages(); ++index) {
+    const Tunable& tunable = trial.stage(index).perturb().tunable();
+    if (tunable.is_enabled()) {
+      get_stage_(index)->set_tunable(tunable.value());
+    }
+  }
+}
+
 void Trial::tune() {
   int num_real_attempts = num_attempts() - num_auto_reject();
   DEBUG("num " << num_attempts());
@@ -256,6 +256,15 @@ void TrialFactory::synchronize_(const Trial& trial) {
   }
 }
 
+void TrialFactory::update_snapshot(const TrialFactory& factory) {
+  ASSERT(num() == factory.num(), "num: " << num() << " != " << factory.num());
+  Trial::update_snapshot(factory);
+  for (int itrial = 0; itrial < num(); ++itrial) {
+    trials_[itrial]->update_snapshot(factory.trial(itrial));
+  }
+  last_index_ = factory.last_index();
+}
+
 std::map<std::string, std::shared_ptr<TrialFactoryNamed> >& TrialFactoryNamed::deserialize_map() {
   static std::map<std::string, std::shared_ptr<TrialFactoryNamed> >* ans =
      new std::map<std::string, std::shared_ptr<TrialFactoryNamed> >();
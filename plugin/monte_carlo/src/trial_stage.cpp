@@ -1,4 +1,8 @@
 #include <cmath>
+#include <algorithm>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
 #include "utils/include/serialize.h"
 #include "utils/include/arguments.h"
 #include "configuration/include/configuration.h"
@@ -18,11 +22,15 @@ TrialStage::TrialStage(argtype * args) {
   rosenbluth_->resize(integer("num_steps", args, 1));
   reference_ = integer("reference_index", args, -1);
   is_new_only_ = boolean("new_only", args, false);
+  num_threads_ = integer("num_threads", args, 1);
+  ASSERT(num_threads_ == -1 || num_threads_ >= 1,
+    "num_threads: " << num_threads_);
 }
 
 argtype get_stage_args(argtype * args) {
   argtype tmp_args;
-  for (const std::string key : {"num_steps", "reference_index", "new_only"}) {
+  for (const std::string key : {"num_steps", "reference_index", "new_only",
+                                "num_threads"}) {
     if (used(key, *args)) tmp_args.insert({key, str(key, args)});
   }
   return tmp_args;
@@ -73,14 +81,75 @@ void TrialStage::set_rosenbluth_energy_(const int step, System * system) {
   } else {
     energy = system->reference_energy(select_->mobile(), reference_, select_->configuration_index());
   }
-  const double excluded = select().exclude_energy();
+  const int config = select_->configuration_index();
+  set_rosenbluth_energy_(step, energy, select().exclude_energy(),
+    system->stored_energy_profile(config));
+}
+
+void TrialStage::set_rosenbluth_energy_(const int step, const double energy,
+    const double excluded, const std::vector<double>& profile) {
   ASSERT(!std::isinf(energy), "energy: " << energy << " is inf.");
   ASSERT(!std::isnan(energy), "energy: " << energy << " is nan.");
   ASSERT(!std::isinf(excluded), "excluded: " << excluded << " is inf.");
   ASSERT(!std::isnan(excluded), "excluded: " << excluded << " is nan.");
   rosenbluth_->set_energy(step, energy, excluded);
+  rosenbluth_->set_energy_profile(step, profile);
+}
+
+int TrialStage::num_step_threads_() const {
+  int num_threads = 1;
+  #ifdef _OPENMP
+  num_threads = num_threads_;
+  if (num_threads == -1) {
+    num_threads = omp_get_max_threads();
+  }
+  #endif // _OPENMP
+  // the last step is computed with the System
+  return std::min(num_threads, rosenbluth_->num() - 1);
+}
+
+void TrialStage::synchronize_threads_(const int num_threads, System * system) {
+  system->resize_thread_systems_(num_threads);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    int thread = 0;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    #endif // _OPENMP
+    system->synchronize_thread_system_(thread);
+  }
+}
+
+void TrialStage::compute_steps_threads_(const int num_threads,
+    System * system) {
+  const int num_steps = rosenbluth_->num() - 1;
   const int config = select_->configuration_index();
-  rosenbluth_->set_energy_profile(step, system->stored_energy_profile(config));
+  step_energy_.resize(num_steps);
+  step_profile_.resize(num_steps);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    int thread = 0;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    #endif // _OPENMP
+    System * thread_system = system->get_thread_system_(thread);
+    #pragma omp for schedule(static)
+    for (int step = 0; step < num_steps; ++step) {
+      const Select& stored = rosenbluth_->stored(step);
+      thread_system->get_configuration(config)->update_positions(stored, true);
+      if (reference_ == -1) {
+        step_energy_[step] = thread_system->perturbed_energy(stored, config);
+      } else {
+        step_energy_[step] = thread_system->reference_energy(stored,
+          reference_, config);
+      }
+      step_profile_[step] = thread_system->stored_energy_profile(config);
+    }
+  }
+  for (int step = 0; step < num_steps; ++step) {
+    set_rosenbluth_energy_(step, step_energy_[step], step_excluded_[step],
+      step_profile_[step]);
+  }
 }
 
 void TrialStage::attempt(System * system,
@@ -98,7 +167,12 @@ void TrialStage::attempt(System * system,
     set_rosenbluth_energy_(0, system);
     rosenbluth_->compute(system->thermo_params().beta(), random, old);
   } else {
-    for (int step = 0; step < rosenbluth_->num(); ++step) {
+    const int num_steps = rosenbluth_->num();
+    const int num_threads = num_step_threads_();
+    if (num_threads > 1) {
+      step_excluded_.resize(num_steps);
+    }
+    for (int step = 0; step < num_steps; ++step) {
       // DEBUG(perturb_->class_name());
       bool is_position_held = false;
       if (step == 0 && old == 1) is_position_held = true;
@@ -107,9 +181,21 @@ void TrialStage::attempt(System * system,
       DEBUG("updating state " << select_->mobile().trial_state());
       rosenbluth_->store(step, select_->mobile());
       DEBUG("ref " << reference_);
-      set_rosenbluth_energy_(step, system);
+      if (num_threads > 1 && step < num_steps - 1) {
+        // the copies match the System with the perturbation of the first step
+        // (e.g., a revived ghost), and the remaining steps only move mobile.
+        if (step == 0) {
+          synchronize_threads_(num_threads, system);
+        }
+        step_excluded_[step] = select().exclude_energy();
+      } else {
+        set_rosenbluth_energy_(step, system);
+      }
       perturb_->revert(system);
     }
+    if (num_threads > 1) {
+      compute_steps_threads_(num_threads, system);
+    }
     rosenbluth_->compute(system->thermo_params().beta(), random, old);
     DEBUG("old " << old << " num " << rosenbluth_->num());
     if (old != 1) {
@@ -149,17 +235,18 @@ bool TrialStage::are_constraints_satisfied(const int old,
 }
 
 void TrialStage::serialize(std::ostream& ostr) const {
-  feasst_serialize_version(135, ostr);
+  feasst_serialize_version(136, ostr);
   feasst_serialize(reference_, ostr);
   feasst_serialize_fstdr(perturb_, ostr);
   feasst_serialize_fstdr(select_, ostr);
   feasst_serialize(rosenbluth_, ostr);
   feasst_serialize(is_new_only_, ostr);
+  feasst_serialize(num_threads_, ostr);
 }
 
 TrialStage::TrialStage(std::istream& istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(version == 135, "version");
+  ASSERT(version >= 135 && version <= 136, "version: " << version);
   feasst_deserialize(&reference_, istr);
   // HWH for unknown reasons, this function template doesn't work
   //feasst_deserialize_fstdr(perturb_, istr);
@@ -187,6 +274,10 @@ TrialStage::TrialStage(std::istream& istr) {
     }
   }
   feasst_deserialize(&is_new_only_, istr);
+  num_threads_ = 1;
+  if (version >= 136) {
+    feasst_deserialize(&num_threads_, istr);
+  }
 }
 
 void TrialStage::set(std::shared_ptr<Perturb> perturb) { perturb_ = perturb; }
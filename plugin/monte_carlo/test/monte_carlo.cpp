@@ -5,6 +5,7 @@
 #include "utils/include/io.h"
 #include "utils/include/checkpoint.h"
 #include "utils/include/progress_report.h"
+#include "utils/include/timer.h"
 #include "math/include/accumulator.h"
 #include "math/include/random_mt19937.h"
 #include "configuration/include/domain.h"
@@ -12,6 +13,7 @@
 #include "system/include/long_range_corrections.h"
 #include "system/include/visit_model_intra.h"
 #include "system/include/visit_model_cell.h"
+#include "system/include/visit_model_verlet.h"
 #include "system/include/dont_visit_model.h"
 #include "system/include/ideal_gas.h"
 #include "system/include/thermo_params.h"
@@ -371,6 +373,65 @@ TEST(MonteCarlo, GCMC_cell) {
   }
 }
 
+TEST(MonteCarlo, GCMC_NPT_verlet) {
+  MonteCarlo mc;
+  mc.add(MakeConfiguration({{"cubic_side_length", "8"}, {"particle_type0", "../particle/lj.fstprt"}}));
+  mc.add(MakePotential(MakeLennardJones(), MakeVisitModelVerlet({{"skin", "0.3"}})));
+  mc.set(MakeThermoParams({{"beta", "1.2"}, {"chemical_potential", "-2"},
+                           {"pressure", "0.2"}}));
+  mc.set(MakeMetropolis());
+  mc.add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "1."}}));
+  mc.add(MakeTrialTransfer({{"particle_type", "0"}}));
+  mc.add(MakeTrialVolume({{"weight", "0.1"}, {"tunable_param", "0.5"}}));
+  mc.add(MakeCheckEnergy({{"trials_per_update", str(1e2)}, {"tolerance", str(1e-9)}}));
+  mc.add(MakeTune());
+  for (int i = 0; i < 1e3; ++i) {
+    mc.attempt(1);
+    mc.system().potential(0).visit_model().check(mc.configuration());
+  }
+  EXPECT_GT(mc.configuration().num_particles(), 0);
+}
+
+// Compare the time of translations of 10^4 LJ particles at a density of 0.8
+// using a cell list or a Verlet list.
+TEST(MonteCarlo, verlet_BENCHMARK_LONG) {
+  const int num = 10000, num_per_side = 22;
+  const double length = std::pow(num/0.8, 1./3.);
+  const double spacing = length/static_cast<double>(num_per_side);
+  std::vector<std::vector<double> > coords(num, std::vector<double>(3));
+  for (int part = 0; part < num; ++part) {
+    const std::vector<int> lattice = {part % num_per_side,
+      (part/num_per_side) % num_per_side, part/num_per_side/num_per_side};
+    for (int dim = 0; dim < 3; ++dim) {
+      coords[part][dim] = spacing*(lattice[dim] + 0.5) - 0.5*length;
+    }
+  }
+  for (const std::string type : {"cell", "verlet"}) {
+    auto config = MakeConfiguration({{"cubic_side_length", str(length)},
+      {"particle_type0", "../particle/lj.fstprt"}});
+    for (int part = 0; part < num; ++part) {
+      config->add_particle_of_type(0);
+    }
+    config->update_positions(coords);
+    MonteCarlo mc;
+    mc.set(MakeRandomMT19937({{"seed", "123"}}));
+    mc.add(config);
+    if (type == "cell") {
+      mc.add(MakePotential(MakeLennardJones(),
+                           MakeVisitModelCell({{"min_length", "max_cutoff"}})));
+    } else {
+      mc.add(MakePotential(MakeLennardJones(), MakeVisitModelVerlet()));
+    }
+    mc.set(MakeThermoParams({{"beta", "1.2"}}));
+    mc.set(MakeMetropolis());
+    mc.add(MakeTrialTranslate({{"tunable_param", "0.1"}}));
+    const double time = cpu_hours();
+    mc.attempt(1e5);
+    INFO(type << " energy " << mc.criteria().current_energy() << " time " <<
+         3600.*(cpu_hours() - time) << "s");
+  }
+}
+
 TEST(MonteCarlo, ConstrainNumParticles) {
   for (const double minimum : {0, 1}) {
     MonteCarlo mc;
@@ -0,0 +1,123 @@
+
+#ifndef FEASST_MPI_CLONES_MPI_H_
+#define FEASST_MPI_CLONES_MPI_H_
+
+#include <string>
+#include <memory>
+#include <vector>
+#include "flat_histogram/include/clones.h"
+
+namespace feasst {
+
+class ThreadMPI;
+
+/**
+  Distribute FlatHistogram MonteCarlo windows among MPI ranks, which may be on
+  many nodes.
+
+  The windows are divided into contiguous ranges, one for each rank (see
+  first_window and last_window), and each rank adds only the windows it owns.
+  Within a rank, the windows are run as Clones, which may use OMP threads.
+
+  Initialization is bottom up, as in Clones::initialize.
+  Each rank waits for the rank below to hand over a configuration which
+  overlaps with its first window, initializes its own windows, and then runs
+  its last window until it finds a configuration which overlaps with the
+  first window of the rank above, which is sent over MPI.
+
+  Once the windows of all ranks are complete, the windows are gathered on
+  the first rank, which stitches them together as in Clones::ln_prob and
+  writes the ln_prob_file, and the result is broadcast to all ranks.
+
+  For example, on a single machine, run with "mpirun -np 4 ./a.out".
+ */
+class ClonesMPI {
+ public:
+  //@{
+  /** @name Arguments
+    - num_windows: the total number of windows among all ranks.
+    - ln_prob_file: file name of the stitched ln_prob, written by the first
+      rank. If empty (default), do not write the file.
+   */
+  explicit ClonesMPI(argtype args = argtype());
+  explicit ClonesMPI(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Return the index of this rank.
+  int rank() const;
+
+  /// Return the number of ranks.
+  int num_ranks() const;
+
+  /// Return the total number of windows among all ranks.
+  int num_windows() const { return num_windows_; }
+
+  /// Return the index of the first window owned by a rank.
+  /// If rank is -1, use this rank.
+  int first_window(const int rank = -1) const;
+
+  /// Return the index of the last window owned by a rank, as above.
+  int last_window(const int rank = -1) const;
+
+  /// Add the MonteCarlo of the next window owned by this rank, in order.
+  void add(std::shared_ptr<MonteCarlo> mc);
+
+  /// Return the Clones of the windows owned by this rank.
+  const Clones& clones() const { return *clones_; }
+
+  /// Return the writable Clones, as above.
+  Clones * get_clones() { return clones_.get(); }
+
+  /**
+    Initialize all windows bottom up among the ranks, as described above.
+
+    args:
+    - attempt_batch: perform this many attempts in a batch between checking
+      for overlap (default: 1).
+    - max_batch: maximum number of batches. Infinite if -1 (default: -1).
+   */
+  void initialize(argtype args = argtype());
+
+  /**
+    Run the windows of each rank until complete (see
+    Clones::run_until_complete), and then collectively stitch the windows of
+    all ranks.
+    Return the stitched ln_prob, which is the same on every rank.
+    If overlap_file_prefix is given with share_overlap, the window_offset
+    is set to the first_window of this rank.
+    The checkpoints are staggered by the index of each window among all
+    ranks, instead of among the windows of this rank.
+   */
+  LnProbability run_until_complete(argtype args = argtype());
+
+  /**
+    Collectively gather the windows of all ranks on the first rank, stitch
+    them together and broadcast the result to all ranks.
+    If ln_prob_file, the first rank writes the stitched ln_prob.
+   */
+  LnProbability ln_prob();
+
+  ~ClonesMPI();
+
+  //@}
+ private:
+  int num_windows_;
+  std::string ln_prob_file_;
+  std::shared_ptr<ThreadMPI> thread_;
+  std::unique_ptr<Clones> clones_;
+
+  void receive_from_lower_(argtype args);
+  void send_to_upper_(argtype args);
+};
+
+inline std::shared_ptr<ClonesMPI> MakeClonesMPI(argtype args = argtype()) {
+  return std::make_shared<ClonesMPI>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_MPI_CLONES_MPI_H_
@@ -0,0 +1,225 @@
+#include "mpi.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include "utils/include/arguments.h"
+#include "utils/include/debug.h"
+#include "utils/include/io.h"
+#include "utils/include/checkpoint.h"
+#include "math/include/utils_math.h"
+#include "math/include/histogram.h"
+#include "configuration/include/configuration.h"
+#include "system/include/system.h"
+#include "monte_carlo/include/acceptance.h"
+#include "flat_histogram/include/macrostate.h"
+#include "flat_histogram/include/flat_histogram.h"
+#include "flat_histogram/include/overlap_exchange.h"
+#include "mpi/include/thread_mpi.h"
+#include "mpi/include/clones_mpi.h"
+
+namespace feasst {
+
+namespace {
+
+// the size is sent as a long long, and the characters in chunks which fit
+// in the int count of MPI, so that a window may exceed 2 GB.
+const long long max_chunk = std::numeric_limits<int>::max();
+
+void send_string(const std::string& str, const int destination,
+                 const int tag) {
+  long long size = static_cast<long long>(str.size());
+  MPI_Send(&size, 1, MPI_LONG_LONG, destination, tag, MPI_COMM_WORLD);
+  for (long long first = 0; first < size; first += max_chunk) {
+    const int chunk = static_cast<int>(std::min(max_chunk, size - first));
+    MPI_Send(str.data() + first, chunk, MPI_CHAR, destination, tag,
+             MPI_COMM_WORLD);
+  }
+}
+
+std::string receive_string(const int source, const int tag) {
+  long long size;
+  MPI_Recv(&size, 1, MPI_LONG_LONG, source, tag, MPI_COMM_WORLD,
+           MPI_STATUS_IGNORE);
+  std::string str(size, ' ');
+  for (long long first = 0; first < size; first += max_chunk) {
+    const int chunk = static_cast<int>(std::min(max_chunk, size - first));
+    MPI_Recv(&str[first], chunk, MPI_CHAR, source, tag, MPI_COMM_WORLD,
+             MPI_STATUS_IGNORE);
+  }
+  return str;
+}
+
+// tags of the messages between neighboring ranks
+const int tag_overlap = 1;
+const int tag_config = 2;
+const int tag_gather = 3;
+
+}  // namespace
+
+ClonesMPI::ClonesMPI(argtype * args) {
+  num_windows_ = integer("num_windows", args);
+  ln_prob_file_ = str("ln_prob_file", args, "");
+  thread_ = MakeThreadMPI();
+  clones_ = std::make_unique<Clones>();
+  ASSERT(num_windows_ >= num_ranks(), "num_windows: " << num_windows_ <<
+    " must be at least the number of ranks: " << num_ranks());
+}
+ClonesMPI::ClonesMPI(argtype args) : ClonesMPI(&args) {
+  feasst_check_all_used(args);
+}
+
+ClonesMPI::~ClonesMPI() {}
+
+int ClonesMPI::rank() const { return thread_->thread(); }
+
+int ClonesMPI::num_ranks() const { return thread_->num(); }
+
+int ClonesMPI::first_window(const int rank) const {
+  const int index = rank == -1 ? this->rank() : rank;
+  return num_windows_*index/num_ranks();
+}
+
+int ClonesMPI::last_window(const int rank) const {
+  const int index = rank == -1 ? this->rank() : rank;
+  return first_window(index + 1) - 1;
+}
+
+void ClonesMPI::add(std::shared_ptr<MonteCarlo> mc) {
+  ASSERT(clones_->num() < last_window() - first_window() + 1,
+    "rank: " << rank() << " owns windows " << first_window() << " to " <<
+    last_window());
+  clones_->add(mc);
+}
+
+void ClonesMPI::receive_from_lower_(argtype args) {
+  feasst_check_all_used(args);
+  MonteCarlo * first = clones_->get_clone(0);
+  std::unique_ptr<FlatHistogram> fh = clones_->flat_histogram(0);
+  Acceptance empty;
+  double overlap[2] = {fh->macrostate().value(0), 0.};
+  if (fh->macrostate().is_allowed(first->system(), first->criteria(),
+                                  empty)) {
+    overlap[1] = 1.;
+  }
+  MPI_Send(overlap, 2, MPI_DOUBLE, rank() - 1, tag_overlap, MPI_COMM_WORLD);
+  if (overlap[1] == 0.) {
+    std::stringstream ss(receive_string(rank() - 1, tag_config));
+    Configuration config(ss);
+    first->get_system()->get_configuration()->copy_particles(config, true);
+    first->initialize_criteria();
+    DEBUG("rank " << rank() << " received num " <<
+      first->configuration().num_particles());
+  }
+}
+
+void ClonesMPI::send_to_upper_(argtype args) {
+  const int attempt_batch = integer("attempt_batch", &args, 1);
+  const int max_batch = integer("max_batch", &args, -1);
+  feasst_check_all_used(args);
+  double overlap[2];
+  MPI_Recv(overlap, 2, MPI_DOUBLE, rank() + 1, tag_overlap, MPI_COMM_WORLD,
+           MPI_STATUS_IGNORE);
+  if (overlap[1] == 1.) {
+    DEBUG("already initialized");
+    return;
+  }
+  const int last = clones_->num() - 1;
+  MonteCarlo * lower = clones_->get_clone(last);
+  std::unique_ptr<FlatHistogram> fh = clones_->flat_histogram(last);
+  const double macro_upper_min = overlap[0];
+  const double macro_lower_max =
+    fh->macrostate().histogram().center_of_last_bin();
+  Acceptance empty;
+  int batch = 0;
+  while (!is_in_interval(fh->macrostate().value(lower->system(),
+                           lower->criteria(), empty),
+                         macro_upper_min, macro_lower_max)) {
+    lower->attempt(attempt_batch);
+    ++batch;
+    ASSERT(max_batch == -1 || batch < max_batch,
+      "reached maximum batch: " << batch);
+  }
+  std::stringstream ss;
+  lower->configuration().serialize(ss);
+  send_string(ss.str(), rank() + 1, tag_config);
+}
+
+void ClonesMPI::initialize(argtype args) {
+  ASSERT(clones_->num() == last_window() - first_window() + 1,
+    "rank: " << rank() << " has " << clones_->num() << " windows but owns "
+    << last_window() - first_window() + 1);
+  if (rank() > 0) {
+    receive_from_lower_(argtype());
+  }
+  for (int upper = 1; upper < clones_->num(); ++upper) {
+    clones_->initialize(upper, args);
+  }
+  if (rank() < num_ranks() - 1) {
+    send_to_upper_(args);
+  }
+}
+
+LnProbability ClonesMPI::run_until_complete(argtype args) {
+  if (used("overlap_file_prefix", args)) {
+    ASSERT(!used("window_offset", args),
+      "window_offset is set by ClonesMPI");
+    args["window_offset"] = str(first_window());
+
+    // Remove the files of a previous simulation before any rank reads.
+    OverlapExchange exchange({{"file_prefix", args["overlap_file_prefix"]}});
+    exchange.resize(num_windows_);
+    for (int window = first_window(); window <= last_window(); ++window) {
+      exchange.remove(window);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+  }
+  ASSERT(!used("stagger", args), "stagger is set by ClonesMPI");
+  for (int index = 0; index < clones_->num(); ++index) {
+    Checkpoint * checkpoint = clones_->get_clone(index)->get_checkpoint();
+    if (checkpoint) {
+      checkpoint->stagger(static_cast<double>(first_window() + index)/
+                          num_windows_);
+    }
+  }
+  args["stagger"] = "false";
+  clones_->run_until_complete(args);
+  return ln_prob();
+}
+
+LnProbability ClonesMPI::ln_prob() {
+  std::vector<double> values;
+  if (rank() == 0) {
+    Clones all;
+    for (int index = 0; index < clones_->num(); ++index) {
+      all.add(clones_->get_clones()[index]);
+    }
+    for (int source = 1; source < num_ranks(); ++source) {
+      for (int window = first_window(source); window <= last_window(source);
+           ++window) {
+        std::stringstream ss(receive_string(source, tag_gather));
+        all.add(std::make_shared<MonteCarlo>(ss));
+      }
+    }
+    values = all.ln_prob().values();
+    if (!ln_prob_file_.empty()) {
+      std::ofstream file(ln_prob_file_);
+      for (const double value : values) {
+        file << value << std::endl;
+      }
+    }
+  } else {
+    for (int index = 0; index < clones_->num(); ++index) {
+      std::stringstream ss;
+      clones_->clone(index).serialize(ss);
+      send_string(ss.str(), 0, tag_gather);
+    }
+  }
+  int size = static_cast<int>(values.size());
+  MPI_Bcast(&size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  values.resize(size);
+  MPI_Bcast(values.data(), size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  return LnProbability(values);
+}
+
+}  // namespace feasst
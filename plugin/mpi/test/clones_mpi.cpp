@@ -0,0 +1,64 @@
+#include "utils/test/utils.h"
+#include "math/include/histogram.h"
+#include "configuration/include/configuration.h"
+#include "system/include/potential.h"
+#include "system/include/thermo_params.h"
+#include "system/include/lennard_jones.h"
+#include "system/include/long_range_corrections.h"
+#include "monte_carlo/include/run.h"
+#include "monte_carlo/include/metropolis.h"
+#include "monte_carlo/include/trial_transfer.h"
+#include "monte_carlo/include/trial_translate.h"
+#include "steppers/include/check_energy.h"
+#include "steppers/include/tune.h"
+#include "steppers/include/criteria_updater.h"
+#include "flat_histogram/include/flat_histogram.h"
+#include "flat_histogram/include/transition_matrix.h"
+#include "flat_histogram/include/macrostate_num_particles.h"
+#include "flat_histogram/include/window_exponential.h"
+#include "mpi/include/clones_mpi.h"
+
+namespace feasst {
+
+std::shared_ptr<MonteCarlo> lj_window(const int min, const int max) {
+  auto mc = std::make_shared<MonteCarlo>();
+  mc->add(MakeConfiguration({{"cubic_side_length", "8"},
+                            {"particle_type0", "../particle/lj.fstprt"},
+                            {"add_particles_of_type0", "1"}}));
+  mc->add(MakePotential(MakeLennardJones()));
+  mc->add(MakePotential(MakeLongRangeCorrections()));
+  mc->set(MakeThermoParams({{"beta", str(1./1.5)},
+    {"chemical_potential", "-2.352321"}}));
+  mc->set(MakeMetropolis());
+  mc->add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "1."}}));
+  mc->add(MakeTrialTransfer({{"particle_type", "0"}, {"weight", "4"}}));
+  mc->run(MakeRun({{"until_num_particles", str(min)}}));
+  mc->set(MakeFlatHistogram(
+    MakeMacrostateNumParticles(
+      Histogram({{"width", "1"}, {"max", str(max)}, {"min", str(min)}})),
+    MakeTransitionMatrix({{"min_sweeps", "10"}})));
+  mc->add(MakeCheckEnergy({{"trials_per_update", "1e2"}}));
+  mc->add(MakeTune());
+  mc->add(MakeCriteriaUpdater({{"trials_per_update", "1e2"}}));
+  return mc;
+}
+
+// Run with, e.g., mpirun -np 2 ./bin/unittest --gtest_filter=ClonesMPI*
+TEST(ClonesMPI, lj_LONG) {
+  auto clones = MakeClonesMPI({{"num_windows", "2"},
+                               {"ln_prob_file", "tmp/clones_mpi_lnpi.txt"}});
+  std::vector<std::vector<int> > bounds = WindowExponential({
+    {"maximum", "12"}, {"minimum", "0"}, {"num", "2"}, {"overlap", "4"},
+    {"alpha", "2"}}).boundaries();
+  for (int window = clones->first_window(); window <= clones->last_window();
+       ++window) {
+    clones->add(lj_window(bounds[window][0], bounds[window][1]));
+  }
+  clones->initialize();
+  const LnProbability ln_prob =
+    clones->run_until_complete({{"omp_batch", "1e1"}});
+  EXPECT_EQ(13, ln_prob.size());
+  EXPECT_NEAR(ln_prob.value(0), -36.9, 0.7);
+}
+
+}  // namespace feasst
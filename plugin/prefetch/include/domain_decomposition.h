@@ -0,0 +1,135 @@
+
+#ifndef FEASST_PREFETCH_DOMAIN_DECOMPOSITION_H_
+#define FEASST_PREFETCH_DOMAIN_DECOMPOSITION_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "monte_carlo/include/monte_carlo.h"
+
+namespace feasst {
+
+typedef std::map<std::string, std::string> argtype;
+
+class Perturb;
+class TrialSelect;
+
+/**
+  Attempt local trials concurrently in non-interacting spatial domains.
+
+  Each sweep, the cuboid Domain is divided into a grid of sub-domains with an
+  even number in each dimension, and the grid is shifted by a random offset.
+  The sub-domains are colored as a checkerboard, such that sub-domains of the
+  same color are separated by at least one sub-domain of another color.
+  For each color, in a random order, the sub-domains of that color are
+  distributed among the threads.
+  Each thread performs local TrialTranslate and TrialRotate moves of the
+  particles in its sub-domains, on its own copy of the System, while the
+  other sub-domains are held fixed.
+  A move is rejected if the first site of the particle leaves its sub-domain,
+  so that the number of particles in each sub-domain is constant during the
+  sweep.
+  After each color, the threads copy the particles moved by the others,
+  which are finalized to update the cells of each Potential, and the change
+  in energy is added to the Criteria.
+
+  The sub-domains must be wider than the cutoff plus twice the maximum
+  distance between the first site of a particle and its other sites.
+  Thus, by default, the width is at least twice the maximum cutoff.
+
+  Only TrialTranslate and TrialRotate with the Metropolis acceptance and
+  short-ranged pair potentials of isotropic sites are supported (e.g., no
+  Ewald, ParticleMeshEwald or EnergyMap).
+  LongRangeCorrections are allowed because the number of particles is
+  constant.
+  The copies of the System are kept between calls to attempt, and only the
+  particles that moved since the last sweep are updated.
+  A new copy is made if the number of particles or Potentials changed.
+  Particles may be added serially with the until_num_particles argument of
+  Run.
+  The Trial statistics and tunable parameters are not updated.
+  Analyze and Modify are performed after each sweep, once for each trial.
+ */
+class DomainDecomposition : public MonteCarlo {
+ public:
+  //@{
+  /** @name Arguments
+    - min_width: minimum width of the sub-domains.
+      If -1, use twice the maximum cutoff (default: -1).
+   */
+  explicit DomainDecomposition(argtype args = argtype());
+  explicit DomainDecomposition(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Return the number of sub-domains in each dimension of the last sweep.
+  const std::vector<int>& num_domains() const { return num_domains_; }
+
+  /// Return the number of threads used in the last sweep.
+  int num_threads() const { return num_threads_; }
+
+  /// Return the number of local trials attempted.
+  double num_attempts() const { return num_attempts_; }
+
+  /// Return the number of local trials accepted.
+  double num_accepted() const { return num_accepted_; }
+
+  /// Attempt trials serially, as in MonteCarlo, to add particles.
+  void run_until_num_particles(const int num_particles,
+                               const int particle_type,
+                               const int configuration_index) override;
+
+  void serialize(std::ostream& ostr) const override;
+  explicit DomainDecomposition(std::istream& istr);
+  virtual ~DomainDecomposition();
+
+  //@}
+ protected:
+  void attempt_(int num_trials, TrialFactory * trial_factory,
+                Random * random) override;
+  void run_until_complete_(TrialFactory * trial_factory,
+                           Random * random) override;
+
+ private:
+  double min_width_;
+  double num_attempts_ = 0.;
+  double num_accepted_ = 0.;
+
+  // temporary and not serialized
+  bool is_serial_ = false;
+  int num_threads_ = 0;
+  std::vector<int> num_domains_;
+  std::vector<double> offset_;
+  std::vector<double> cumulative_weight_;
+  std::vector<std::unique_ptr<System> > systems_;
+  std::vector<std::shared_ptr<Random> > randoms_;
+  std::vector<std::vector<std::shared_ptr<Perturb> > > perturbs_;
+  std::vector<std::shared_ptr<TrialSelect> > selects_;
+  std::vector<std::vector<int> > domain_particles_;
+  std::vector<std::vector<int> > moved_;
+  std::vector<std::vector<double> > delta_energy_profile_;
+  std::vector<int> num_attempts_thread_;
+  std::vector<int> num_accepted_thread_;
+
+  void create_(TrialFactory * trial_factory, Random * random);
+  bool update_copy_(const int thread);
+  System * system_(const int thread);
+  int domain_(const Position& position, const Domain& domain) const;
+  int color_(const int domain) const;
+  void build_domains_(Random * random);
+  void local_trials_(const int domain, const int thread);
+  void copy_moved_(const int thread);
+  int sweep_(Random * random);
+};
+
+inline std::shared_ptr<DomainDecomposition> MakeDomainDecomposition(
+    argtype args = argtype()) {
+  return std::make_shared<DomainDecomposition>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_PREFETCH_DOMAIN_DECOMPOSITION_H_
@@ -17,10 +17,10 @@ class Thread;
 // https://cvw.cac.cornell.edu/OpenMP/whileloop
 
 /**
-  Define a pool of threads, each with their own MonteCarlo object and
-  relevant quantities for reversion.
+  Store the quantities of a trial attempted by one thread in one cycle, which
+  the other threads use to imitate or ghost the trial, or to revert.
 */
-class Pool {
+class PoolTrial {
  public:
   void set_index(const int index) {
     index_ = index; }
@@ -33,15 +33,40 @@ class Pool {
   bool auto_rejected() const { return auto_rejected_; }
   void set_endpoint(const bool endpoint) { endpoint_ = endpoint; }
   bool endpoint() const { return endpoint_; }
+  void set_state_old(const int state) { state_old_ = state; }
+  int state_old() const { return state_old_; }
+  void set_state_new(const int state) { state_new_ = state; }
+  int state_new() const { return state_new_; }
   const std::string str() const;
-  std::unique_ptr<MonteCarlo> mc;
 
  private:
-  int index_;
-  double ln_prob_;
-  bool accepted_;
+  int index_ = 0;
+  double ln_prob_ = 0.;
+  bool accepted_ = false;
   bool auto_rejected_ = false;
   bool endpoint_ = true;
+  int state_old_ = 0;
+  int state_new_ = 0;
+};
+
+/**
+  Define a pool of threads, each with their own MonteCarlo object and a ring
+  buffer of the trials attempted in the most recent cycles.
+*/
+class Pool {
+ public:
+  /// Return the number of cycles stored in the ring buffer.
+  static int num_slots() { return 3; }
+
+  /// Return the trial of the given cycle.
+  PoolTrial * get_trial(const int cycle) { return &trials_[cycle % num_slots()]; }
+  const PoolTrial& trial(const int cycle) const {
+    return trials_[cycle % num_slots()]; }
+
+  std::unique_ptr<MonteCarlo> mc;
+
+ private:
+  PoolTrial trials_[3];
 };
 
 /**
@@ -74,6 +99,19 @@ class Pool {
   automatically copied every time, or ones manually choosen based on which
   sites were perturbed.
 
+  Each cycle, every thread attempts one trial, and the first accepted trial
+  is committed by an atomic minimum over the thread indices.
+  The cycle requires a single barrier after the trials are attempted.
+  Afterwards, each thread reconciles its own clone using only the ring buffer
+  of the pool: it reverts its trial if it is after the committed one, imitates
+  the rejected trials before it, and copies the committed trial.
+  The committed thread waits, with atomic counters rather than a barrier,
+  only until the other threads have copied from it.
+  Meanwhile, the trial indices of the next cycle were already generated, so
+  that threads which finish reconciling immediately begin the next cycle.
+  Barriers are otherwise only used to periodically check that all threads are
+  equal, and to check criteria for completion.
+
   Prefetch is not used for the until_num_particles argument in Run.
  */
 class Prefetch : public MonteCarlo {
@@ -0,0 +1,152 @@
+#ifndef FEASST_PREFETCH_REPLICA_EXCHANGE_H_
+#define FEASST_PREFETCH_REPLICA_EXCHANGE_H_
+
+#include <string>
+#include <memory>
+#include <vector>
+#include "monte_carlo/include/monte_carlo.h"
+
+namespace feasst {
+
+class Checkpoint;
+class Random;
+
+/**
+  Container for running MonteCarlo replicas at different ThermoParams (e.g.,
+  beta, chemical potential or pressure) concurrently, and exchanging their
+  configurations, also known as parallel tempering.
+
+  Replicas should be added in order of their ThermoParams, because exchanges
+  are only attempted between neighboring replicas.
+  If OMP is available, the replicas are run in parallel threads for a batch
+  of trials, after which exchanges are attempted between neighboring pairs.
+  The pairs alternate between those with an even and an odd lower index.
+  The number of replicas may exceed the number of threads.
+
+  An exchange swaps the System of the two replicas without copying
+  (see MonteCarlo::exchange_system), and is accepted with probability
+
+  \f$\min\left(1, e^{(\beta_i - \beta_j)(U_i - U_j)
+  - \sum_t(\beta_i\mu_{i,t} - \beta_j\mu_{j,t})(N_{i,t} - N_{j,t})
+  + (\beta_iP_i - \beta_jP_j)(V_i - V_j)}\right)\f$
+
+  where the chemical potential and pressure terms are included only if both
+  replicas have them.
+
+  Each configuration is tracked as it moves among the replicas.
+  A round trip is recorded when a configuration which began at the first
+  replica visits the last replica and returns to the first.
+  The round trip time is the number of exchange steps of the round trip.
+
+  Each replica is restricted to one Configuration.
+ */
+class ReplicaExchange {
+ public:
+  //@{
+  /** @name Arguments
+    - trials_per_exchange: number of trials attempted by each replica between
+      attempts to exchange neighboring replicas (default: 1e3).
+    - exchange_file: file name of the exchange_report, which is written after
+      each run. If empty (default), do not write the file.
+   */
+  explicit ReplicaExchange(argtype args = argtype());
+  explicit ReplicaExchange(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Add a MonteCarlo replica.
+  void add(std::shared_ptr<MonteCarlo> mc);
+
+  /// Return the number of replicas.
+  int num() const { return static_cast<int>(replicas_.size()); }
+
+  /// Return a read-only replica.
+  const MonteCarlo& replica(const int index) const;
+
+  /// Return a writable replica.
+  MonteCarlo * get_replica(const int index);
+
+  /// Add a checkpoint, which is checked after each exchange step.
+  void set(std::shared_ptr<Checkpoint> checkpoint);
+
+  /// Set the random number generator for the exchanges.
+  void set(std::shared_ptr<Random> random);
+
+  /// Run the replicas and attempt exchanges for the given number of steps.
+  void run(const int num_exchanges);
+
+  /// Return the number of exchange steps.
+  double num_exchanges() const { return num_exchanges_; }
+
+  /// Return the number of attempted exchanges between the replica of
+  /// lower_index and the replica above.
+  double num_attempted(const int lower_index) const {
+    return num_attempted_[lower_index]; }
+
+  /// Return the number of accepted exchanges, as above.
+  double num_accepted(const int lower_index) const {
+    return num_accepted_[lower_index]; }
+
+  /// Return the fraction of accepted exchanges, as above.
+  double acceptance(const int lower_index) const;
+
+  /// Return the index of the configuration in the replica of given index.
+  /// Configurations are indexed by the replica to which they were added.
+  int walker(const int index) const { return walker_[index]; }
+
+  /// Return the number of round trips.
+  double num_round_trips() const { return num_round_trips_; }
+
+  /// Return the average number of exchange steps per round trip.
+  /// Return -1 if no round trips have been completed.
+  double round_trip_exchanges() const;
+
+  /**
+    Return a comma-separated report of the exchanges, with one line per
+    neighboring pair of replicas.
+    The columns are the lower replica index, the attempted and accepted
+    exchanges, and the acceptance.
+    The last line reports the number of round trips and the average number
+    of exchange steps and trials per round trip.
+   */
+  std::string exchange_report() const;
+
+  /// Serialize
+  void serialize(std::ostream& ostr) const;
+
+  /// Deserialize
+  explicit ReplicaExchange(std::istream& istr);
+  ~ReplicaExchange();
+
+  //@}
+ private:
+  std::vector<std::shared_ptr<MonteCarlo> > replicas_;
+  std::shared_ptr<Checkpoint> checkpoint_;
+  std::shared_ptr<Random> random_;
+  int trials_per_exchange_;
+  std::string exchange_file_;
+  double num_exchanges_ = 0.;
+  std::vector<double> num_attempted_;
+  std::vector<double> num_accepted_;
+  std::vector<int> walker_;
+  std::vector<int> direction_;
+  std::vector<double> last_first_;
+  double num_round_trips_ = 0.;
+  double sum_round_trip_exchanges_ = 0.;
+
+  double ln_prob_exchange_(const int lower_index) const;
+  void exchange_(const int parity);
+  void update_round_trips_();
+};
+
+inline std::shared_ptr<ReplicaExchange> MakeReplicaExchange(
+    argtype args = argtype()) {
+  return std::make_shared<ReplicaExchange>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_PREFETCH_REPLICA_EXCHANGE_H_
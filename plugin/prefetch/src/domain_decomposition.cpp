@@ -0,0 +1,397 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
+#include <algorithm>
+#include <cmath>
+#include "utils/include/arguments.h"
+#include "utils/include/serialize.h"
+#include "math/include/utils_math.h"
+#include "math/include/random_mt19937.h"
+#include "threads/include/thread_omp.h"
+#include "configuration/include/select.h"
+#include "configuration/include/particle.h"
+#include "configuration/include/model_params.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/configuration.h"
+#include "system/include/visit_model_inner.h"
+#include "system/include/visit_model.h"
+#include "system/include/potential.h"
+#include "system/include/potential_factory.h"
+#include "system/include/system.h"
+#include "system/include/thermo_params.h"
+#include "monte_carlo/include/criteria.h"
+#include "monte_carlo/include/trial.h"
+#include "monte_carlo/include/trial_stage.h"
+#include "monte_carlo/include/trial_factory.h"
+#include "monte_carlo/include/perturb.h"
+#include "monte_carlo/include/trial_select_particle.h"
+#include "prefetch/include/domain_decomposition.h"
+
+namespace feasst {
+
+DomainDecomposition::DomainDecomposition(argtype * args) {
+  min_width_ = dble("min_width", args, -1.);
+}
+DomainDecomposition::DomainDecomposition(argtype args)
+  : DomainDecomposition(&args) {
+  feasst_check_all_used(args);
+}
+DomainDecomposition::~DomainDecomposition() {}
+
+System * DomainDecomposition::system_(const int thread) {
+  if (thread == 0) {
+    return get_system();
+  }
+  return systems_[thread].get();
+}
+
+void DomainDecomposition::create_(TrialFactory * trial_factory,
+                                  Random * random) {
+  if (ThreadOMP().is_enabled()) {
+    #pragma omp parallel
+    {
+      num_threads_ = ThreadOMP().num();
+    }
+  } else {
+    num_threads_ = 1;
+  }
+  ASSERT(criteria().class_name() == "Metropolis",
+    "DomainDecomposition requires Metropolis, not " << criteria().class_name());
+  for (const PotentialFactory * potentials :
+       {&system().unoptimized(), &system().optimized()}) {
+    for (int pot = 0; pot < potentials->num(); ++pot) {
+      const VisitModel& visit = potentials->potential(pot).visit_model();
+      const std::string& name = visit.class_name();
+      ASSERT(name == "VisitModel" || name == "VisitModelCell" ||
+             name == "VisitModelIntra" || name == "VisitModelBond" ||
+             name == "DontVisitModel" || name == "LongRangeCorrections",
+        "DomainDecomposition requires short-ranged potentials, not " << name);
+      ASSERT(!visit.inner().is_energy_map(),
+        "DomainDecomposition does not support an EnergyMap");
+    }
+  }
+  const Configuration& config = configuration();
+  const Domain& domain = config.domain();
+  ASSERT(!domain.is_tilted(), "DomainDecomposition requires a cuboid domain");
+
+  // determine the number of sub-domains in each dimension
+  double min_width = min_width_;
+  if (min_width == -1) {
+    min_width = 2.*maximum(config.model_params().select("cutoff").values());
+  }
+  num_domains_.clear();
+  for (int dim = 0; dim < config.dimension(); ++dim) {
+    const int num = 2*static_cast<int>(
+      domain.side_length(dim)/(2.*min_width));
+    ASSERT(num >= 2, "The side length: " << domain.side_length(dim) <<
+      " in dimension: " << dim << " is less than twice the min_width: " <<
+      min_width);
+    num_domains_.push_back(num);
+  }
+
+  // cumulative weights of the local trials
+  cumulative_weight_.clear();
+  double weight = 0.;
+  for (int index = 0; index < trial_factory->num(); ++index) {
+    const Trial& trial = trial_factory->trial(index);
+    ASSERT(trial.class_name() == "TrialTranslate" ||
+           trial.class_name() == "TrialRotate",
+      "DomainDecomposition does not support " << trial.class_name());
+    ASSERT(trial.num_stages() == 1, "requires one stage");
+    weight += trial.weight();
+    cumulative_weight_.push_back(weight);
+  }
+  ASSERT(weight > 0., "no Trials to attempt.");
+
+  // copy the System, Random and Perturb for each thread
+  systems_.resize(num_threads_);
+  randoms_.resize(num_threads_);
+  perturbs_.resize(num_threads_);
+  selects_.resize(num_threads_);
+  moved_.resize(num_threads_);
+  delta_energy_profile_.resize(num_threads_);
+  num_attempts_thread_.resize(num_threads_);
+  num_accepted_thread_.resize(num_threads_);
+  for (int thread = 0; thread < num_threads_; ++thread) {
+    if (thread > 0 && !update_copy_(thread)) {
+      std::stringstream ss;
+      system().serialize(ss);
+      systems_[thread] = std::make_unique<System>(ss);
+    }
+    randoms_[thread] = MakeRandomMT19937({{"seed",
+      str(random->uniform(0, 2147483646))}});
+    perturbs_[thread].clear();
+    for (int index = 0; index < trial_factory->num(); ++index) {
+      std::stringstream ss;
+      trial_factory->trial(index).stage(0).perturb().serialize(ss);
+      perturbs_[thread].push_back(Perturb().deserialize(ss));
+    }
+    selects_[thread] = MakeTrialSelectParticle();
+  }
+}
+
+bool DomainDecomposition::update_copy_(const int thread) {
+  System * copy = systems_[thread].get();
+  if (!copy ||
+      copy->unoptimized().num() != system().unoptimized().num() ||
+      copy->optimized().num() != system().optimized().num()) {
+    return false;
+  }
+  const Configuration& config = configuration();
+  Configuration * config_copy = copy->get_configuration();
+  const Select& all = config.selection_of_all();
+  if (config.domain().side_lengths().coord() !=
+      config_copy->domain().side_lengths().coord() ||
+      all.particle_indices() !=
+      config_copy->selection_of_all().particle_indices()) {
+    return false;
+  }
+  for (const int particle : all.particle_indices()) {
+    const Particle& part = config.select_particle(particle);
+    const Particle& part_copy = config_copy->select_particle(particle);
+    for (int site = 0; site < part.num_sites(); ++site) {
+      if (part.site(site).position().coord() !=
+          part_copy.site(site).position().coord()) {
+        const Select select(particle, part);
+        config_copy->update_positions(select);
+        copy->finalize(select);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+int DomainDecomposition::domain_(const Position& position,
+                                 const Domain& domain) const {
+  int id = 0;
+  int stride = 1;
+  for (int dim = 0; dim < static_cast<int>(num_domains_.size()); ++dim) {
+    double scaled = position.coord(dim)/domain.side_length(dim) + 0.5
+                    - offset_[dim];
+    scaled -= std::floor(scaled);
+    const int num = num_domains_[dim];
+    const int index = std::min(num - 1, static_cast<int>(scaled*num));
+    id += stride*index;
+    stride *= num;
+  }
+  return id;
+}
+
+int DomainDecomposition::color_(const int domain) const {
+  int color = 0;
+  int remainder = domain;
+  for (int dim = 0; dim < static_cast<int>(num_domains_.size()); ++dim) {
+    const int index = remainder % num_domains_[dim];
+    remainder /= num_domains_[dim];
+    color += (index % 2) << dim;
+  }
+  return color;
+}
+
+void DomainDecomposition::build_domains_(Random * random) {
+  const Configuration& config = configuration();
+  offset_.resize(config.dimension());
+  for (double& offset : offset_) {
+    offset = random->uniform();
+  }
+  domain_particles_.assign(product(num_domains_), std::vector<int>());
+  const Select& all = config.group_select(0);
+  for (int index = 0; index < all.num_particles(); ++index) {
+    const int particle = all.particle_index(index);
+    const Position& position = config.select_particle(particle).site(0).position();
+    domain_particles_[domain_(position, config.domain())].push_back(particle);
+  }
+}
+
+void DomainDecomposition::local_trials_(const int domain, const int thread) {
+  System * system = system_(thread);
+  Configuration * config = system->get_configuration();
+  Random * random = randoms_[thread].get();
+  TrialSelect * select = selects_[thread].get();
+  std::vector<double> * delta_profile = &delta_energy_profile_[thread];
+  const std::vector<int>& particles = domain_particles_[domain];
+  const int num = static_cast<int>(particles.size());
+  const double beta = this->system().thermo_params().beta();
+  for (int attempt = 0; attempt < num; ++attempt) {
+    const int particle = particles[random->uniform(0, num - 1)];
+    const double ran = random->uniform()*cumulative_weight_.back();
+    int index = 0;
+    while (ran >= cumulative_weight_[index]) ++index;
+    Perturb * perturb = perturbs_[thread][index].get();
+    select->set_mobile(Select(particle, config->select_particle(particle)));
+    select->set_mobile_original(system);
+    select->set_trial_state(0);
+    const double energy_old = system->perturbed_energy(select->mobile());
+    const std::vector<double> profile_old = system->stored_energy_profile();
+    perturb->perturb(system, select, random);
+    bool accepted = false;
+    const Position& position = config->select_particle(particle).site(0).position();
+    if (domain_(position, config->domain()) == domain) {
+      const double energy_new = system->perturbed_energy(select->mobile());
+      const double delta_energy = energy_new - energy_old;
+      if (delta_energy <= 0 || random->uniform() < std::exp(-beta*delta_energy)) {
+        accepted = true;
+        const std::vector<double>& profile_new = system->stored_energy_profile();
+        for (int pot = 0; pot < static_cast<int>(profile_new.size()); ++pot) {
+          (*delta_profile)[pot] += profile_new[pot] - profile_old[pot];
+        }
+      }
+    }
+    ++num_attempts_thread_[thread];
+    if (accepted) {
+      system->finalize(select->mobile());
+      perturb->finalize(system);
+      moved_[thread].push_back(particle);
+      ++num_accepted_thread_[thread];
+    } else {
+      perturb->revert(system);
+      system->revert(select->mobile());
+    }
+  }
+}
+
+void DomainDecomposition::copy_moved_(const int thread) {
+  System * system = system_(thread);
+  Configuration * config = system->get_configuration();
+  for (int other = 0; other < num_threads_; ++other) {
+    if (other != thread) {
+      const Configuration& other_config = system_(other)->configuration();
+      for (const int particle : moved_[other]) {
+        const Select select(particle, other_config.select_particle(particle));
+        config->update_positions(select);
+        // update the cells of the moved particle in each Potential
+        system->finalize(select);
+      }
+    }
+  }
+}
+
+int DomainDecomposition::sweep_(Random * random) {
+  build_domains_(random);
+  const int num_colors = 1 << static_cast<int>(num_domains_.size());
+  std::vector<std::vector<int> > color_domains(num_colors);
+  int num_trials = 0;
+  for (int domain = 0; domain < static_cast<int>(domain_particles_.size());
+       ++domain) {
+    if (domain_particles_[domain].size() > 0) {
+      color_domains[color_(domain)].push_back(domain);
+      num_trials += static_cast<int>(domain_particles_[domain].size());
+    }
+  }
+  std::vector<int> colors(num_colors);
+  for (int color = 0; color < num_colors; ++color) {
+    colors[color] = color;
+  }
+  for (int color = num_colors - 1; color > 0; --color) {
+    std::swap(colors[color], colors[random->uniform(0, color)]);
+  }
+  const int num_potentials =
+    static_cast<int>(criteria().current_energy_profile().size());
+  for (int thread = 0; thread < num_threads_; ++thread) {
+    delta_energy_profile_[thread].assign(num_potentials, 0.);
+    num_attempts_thread_[thread] = 0;
+    num_accepted_thread_[thread] = 0;
+  }
+
+  #pragma omp parallel num_threads(num_threads_)
+  {
+    int thread = 0;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    #endif // _OPENMP
+    for (const int color : colors) {
+      const std::vector<int>& domains = color_domains[color];
+      #pragma omp for schedule(dynamic)
+      for (int index = 0; index < static_cast<int>(domains.size()); ++index) {
+        local_trials_(domains[index], thread);
+      }
+      std::vector<int> * moved = &moved_[thread];
+      std::sort(moved->begin(), moved->end());
+      moved->erase(std::unique(moved->begin(), moved->end()), moved->end());
+      #pragma omp barrier
+      copy_moved_(thread);
+      #pragma omp barrier
+      moved->clear();
+    }
+  }
+
+  std::vector<double> profile = criteria().current_energy_profile();
+  double energy = criteria().current_energy();
+  for (int thread = 0; thread < num_threads_; ++thread) {
+    for (int pot = 0; pot < num_potentials; ++pot) {
+      profile[pot] += delta_energy_profile_[thread][pot];
+      energy += delta_energy_profile_[thread][pot];
+    }
+    num_attempts_ += num_attempts_thread_[thread];
+    num_accepted_ += num_accepted_thread_[thread];
+  }
+  get_criteria()->set_current_energy_profile(profile);
+  get_criteria()->set_current_energy(energy);
+  return num_trials;
+}
+
+void DomainDecomposition::attempt_(int num_trials,
+                                   TrialFactory * trial_factory,
+                                   Random * random) {
+  if (is_serial_) {
+    MonteCarlo::attempt_(num_trials, trial_factory, random);
+    return;
+  }
+  before_attempts_();
+  create_(trial_factory, random);
+  int itrial = 0;
+  while (itrial < num_trials) {
+    const int num = sweep_(random);
+    ASSERT(num > 0, "no particles to attempt local trials");
+    for (int trial = 0; trial < num; ++trial) {
+      after_trial_analyze_();
+      after_trial_modify_();
+    }
+    itrial += num;
+  }
+}
+
+void DomainDecomposition::run_until_complete_(TrialFactory * trial_factory,
+                                              Random * random) {
+  before_attempts_();
+  create_(trial_factory, random);
+  while (!criteria().is_complete()) {
+    const int num = sweep_(random);
+    ASSERT(num > 0, "no particles to attempt local trials");
+    for (int trial = 0; trial < num; ++trial) {
+      after_trial_analyze_();
+      after_trial_modify_();
+    }
+  }
+  write_checkpoint();
+  write_to_file();
+}
+
+void DomainDecomposition::run_until_num_particles(const int num_particles,
+    const int particle_type,
+    const int configuration_index) {
+  is_serial_ = true;
+  MonteCarlo::run_until_num_particles(num_particles, particle_type,
+                                      configuration_index);
+  is_serial_ = false;
+}
+
+void DomainDecomposition::serialize(std::ostream& ostr) const {
+  MonteCarlo::serialize(ostr);
+  feasst_serialize_version(8451, ostr);
+  feasst_serialize(min_width_, ostr);
+  feasst_serialize(num_attempts_, ostr);
+  feasst_serialize(num_accepted_, ostr);
+}
+
+DomainDecomposition::DomainDecomposition(std::istream& istr)
+  : MonteCarlo(istr) {
+  const int version = feasst_deserialize_version(istr);
+  ASSERT(version == 8451, "version: " << version);
+  feasst_deserialize(&min_width_, istr);
+  feasst_deserialize(&num_attempts_, istr);
+  feasst_deserialize(&num_accepted_, istr);
+}
+
+}  // namespace feasst
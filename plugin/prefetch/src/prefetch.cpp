@@ -1,9 +1,11 @@
 #ifdef _OPENMP
   #include <omp.h>
 #endif // _OPENMP
+#include <atomic>
 #include <cmath>
 #include <limits>
 #include <random>
+#include <thread>
 #include "utils/include/arguments.h"
 #include "utils/include/serialize.h"
 #include "threads/include/thread_omp.h"
@@ -19,9 +21,6 @@
 #include "monte_carlo/include/trial_stage.h"
 #include "prefetch/include/prefetch.h"
 
-// use this to make prefetch serial and simply debugging
-// #define DEBUG_SERIAL_MODE_5324634
-
 namespace feasst {
 
 Prefetch::Prefetch(argtype args) {
@@ -30,9 +29,6 @@ Prefetch::Prefetch(argtype args) {
   load_balance_ = boolean("load_balance", &args, false);
   ghost_ = boolean("ghost", &args, false);
   is_synchronize_ = boolean("synchronize", &args, false);
-  #ifdef DEBUG_SERIAL_MODE_5324634
-    WARN("DEBUG_SERIAL_MODE_5324634");
-  #endif
   feasst_check_all_used(args);
 }
 
@@ -131,371 +127,217 @@ void Prefetch::attempt_(
     create(&pool_);
   }
 
-  int itrial = 0;
-  int first_thread_accepted;
+  // Generate the trial indices of a cycle in main, before its cache loads.
+  auto generate_indices = [&](const int cycle) {
+    if (load_balance_) {
+      // perform the same type of trial on each thread.
+      const int index = trial_factory->random_index(random);
+      for (int ithread = 0; ithread < num_threads_; ++ithread) {
+        pool_[ithread].get_trial(cycle)->set_index(index);
+      }
+    } else {
+      // randomly generator the type of trial for each thread.
+      for (int ithread = 0; ithread < num_threads_; ++ithread) {
+        pool_[ithread].get_trial(cycle)->set_index(
+          trial_factory->random_index(random));
+      }
+    }
+  };
+
+  // The first thread accepted in each cycle of the ring buffer.
+  std::atomic<int> first_accepted[3];
+  ASSERT(Pool::num_slots() == 3, "num_slots: " << Pool::num_slots());
+  first_accepted[0] = num_threads_;
+  generate_indices(0);
+
+  // Monotonic counters for the reconciliation with the accepted thread.
+  std::atomic<int> num_copied(0), num_synchronized(0), cycle_committed(-1);
   int proc_id = 0;
   #ifdef _OPENMP
-  #pragma omp parallel private(proc_id)
+  #pragma omp parallel private(proc_id) num_threads(num_threads_)
   {
     proc_id = omp_get_thread_num();
-  #endif // _OPENMP
-
-    // num_trials may change to terminate loop
-    bool complete = false;
-    while (!complete) {
-      #ifndef _OPENMP
-      for (proc_id = 0; proc_id < num_threads_; ++proc_id) {
-      #endif // _OPENMP
-
-      double previous_energy = criteria().current_energy();
-      DEBUG("previous_energy " << previous_energy);
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      #pragma omp critical
-      {
-      #endif
-
+    Pool * pool = &pool_[proc_id];
+    MonteCarlo * mc = clone_(proc_id);
+    int itrial = 0;
+    int since_check = trials_since_check_;
+    int expected_copies = 0;
+    int expected_synchronized = 0;
+    int cycle = 0;
+    bool thread_complete = false;
+    while (!thread_complete) {
+      DEBUG("proc_id " << proc_id << " begins cycle " << cycle);
+
+      // Speculatively prepare the next cycle, which no thread has started.
       if (proc_id == 0) {
-        DEBUG("************************");
-        DEBUG("* Begin Prefetch cycle *");
-        DEBUG("************************");
-        DEBUG("N " << clone_(proc_id)->configuration().num_particles());
+        first_accepted[(cycle + 1) % Pool::num_slots()] = num_threads_;
+        generate_indices(cycle + 1);
       }
 
-      // ordered list of index of trial to perform on each thread.
-      if (proc_id == 0) {
-        if (load_balance_) {
-          // perform the same type of trial on each thread.
-          const int index = trial_factory->random_index(random);
-          for (int ithread = 0; ithread < num_threads_; ++ithread) {
-            pool_[ithread].set_index(index);
-          }
-        } else {
-          // randomly generator the type of trial for each thread.
-          for (int ithread = 0; ithread < num_threads_; ++ithread) {
-            pool_[ithread].set_index(trial_factory->random_index(random));
-          }
-        }
-//        for (int ithread = 0; ithread < num_threads_; ++ithread) {
-//          DEBUG("num attempts " << pool_[ithread].mc.trials().num_attempts() << " "
-//                                << pool_[ithread].mc.trials().num_success() << " " << &pool_[ithread].mc);
-//        }
-//        DEBUG("num attempts main " << trials().num_attempts() << " "
-//                                     << trials().num_success() << " " << this);
-      }
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      }
-      #endif
-
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
-      // set random number generators to store (zero storage for selecting trial?).
-      Pool * pool = &pool_[proc_id];
-      MonteCarlo * mc = clone_(proc_id);
-      mc->load_cache_(true);
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      #pragma omp critical
-      {
-      #endif
-
       // Each processor attempts their trial in parallel,
       // without analyze modify or checkpoint.
       // Store new macrostate and acceptance prob
-      pool->set_accepted(mc->attempt_trial(pool->index()));
-      pool->set_auto_rejected(mc->trial(pool->index()).accept().reject());
-      pool->set_endpoint(mc->trial(pool->index()).accept().endpoint());
-      pool->set_ln_prob(mc->trial(pool->index()).accept().ln_metropolis_prob());
-      DEBUG("proc id " << proc_id << " ln prob " << pool->ln_prob());
-      DEBUG("critical proc_id " << proc_id << " " << pool->str());
-      DEBUG("nump " << mc->system().configuration().num_particles());
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
+      PoolTrial * trial = pool->get_trial(cycle);
+      mc->load_cache_(true);
+      trial->set_accepted(mc->attempt_trial(trial->index()));
+      const Acceptance& accept = mc->trial(trial->index()).accept();
+      trial->set_auto_rejected(accept.reject());
+      trial->set_endpoint(accept.endpoint());
+      trial->set_ln_prob(accept.ln_metropolis_prob());
+      trial->set_state_old(mc->criteria().state_old());
+      trial->set_state_new(mc->criteria().state_new());
+      DEBUG("proc_id " << proc_id << " " << trial->str());
+
+      // Commit the first accepted trial.
+      std::atomic<int> * first = &first_accepted[cycle % Pool::num_slots()];
+      if (trial->accepted()) {
+        int current = first->load();
+        while (proc_id < current &&
+               !first->compare_exchange_weak(current, proc_id)) {}
       }
-      #endif
 
-      #ifdef _OPENMP
       #pragma omp barrier
-      #endif // _OPENMP
 
-      // Determine first trial accepted (if any).
-      if (proc_id == 0) {
-        first_thread_accepted = num_threads_;
-        for (int ithread = 0; ithread < num_threads_; ++ithread) {
-          if (pool_[ithread].accepted() &&
-              first_thread_accepted == num_threads_) {
-            first_thread_accepted = ithread;
-            DEBUG(MAX_PRECISION << ithread << " accepted, en: " << clone_(ithread)->criteria().current_energy());
-          }
-        }
-        DEBUG("first thread " << first_thread_accepted);
-      }
-
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
+      const int first_thread_accepted = first->load();
+      DEBUG("first thread " << first_thread_accepted);
 
       // any trial after accepted may contribute as a ghost
-      if (proc_id == 0 && ghost_) {
-        DEBUG("Update criteria with ghost trials (for TM) for each thread after first accepted");
+      if (ghost_) {
         for (int ithread = first_thread_accepted + 1;
              ithread < num_threads_;
              ++ithread) {
-          const Criteria& old_criteria = clone_(ithread)->criteria();
-          for (int jthread = 0; jthread < num_threads_; ++jthread) {
-            DEBUG("ghost " << ithread << " " << jthread);
-            DEBUG("first accepted " << first_thread_accepted);
-            clone_(jthread)->ghost_trial_(
-              pool_[ithread].ln_prob(),
-              old_criteria.state_old(),
-              old_criteria.state_new(),
-              pool_[ithread].endpoint());
-          }
+          const PoolTrial& other = pool_[ithread].trial(cycle);
+          mc->ghost_trial_(other.ln_prob(), other.state_old(),
+                           other.state_new(), other.endpoint());
         }
       }
 
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      #pragma omp critical
-      {
-      #endif
-
       // revert trials after accepted trial.
-      if (first_thread_accepted != num_threads_) {
-        if (proc_id > first_thread_accepted) {
-          DEBUG("reverting trial " << proc_id);
-          mc->revert_(pool->index(), pool->accepted(), pool->endpoint(),
-                      pool->auto_rejected(), pool->ln_prob());
-        }
+      if (first_thread_accepted != num_threads_ &&
+          proc_id > first_thread_accepted) {
+        DEBUG("reverting trial " << proc_id);
+        mc->revert_(trial->index(), trial->accepted(), trial->endpoint(),
+                    trial->auto_rejected(), trial->ln_prob());
       }
 
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      }
-      #endif
-
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
-      // testing decouple here HWH
-      if (proc_id == 0) {
-        DEBUG("for each thread up to the first accepted, "
-           << "update other threads (incl. main) regarding failed attempt by "
-           << "thread. update steppers");
-        for (int ithread = 0; ithread < first_thread_accepted; ++ithread) {
-          DEBUG("imitate failed " << ithread);
-          // loop through other threads to update
-          const Criteria& old_criteria = clone_(ithread)->criteria();
-          DEBUG("nump " << clone_(ithread)->configuration().num_particles());
-          for (int jthread = 0; jthread < num_threads_; ++jthread) {
-            if (ithread != jthread) {
-              DEBUG("j " << jthread <<
-                   " index " << pool_[ithread].index() <<
-                   " lnp " << pool_[ithread].ln_prob() <<
-                   " old " << old_criteria.state_old() <<
-                   " new " << old_criteria.state_new());
-              clone_(jthread)->imitate_trial_rejection_(
-                pool_[ithread].index(),
-                pool_[ithread].ln_prob(),
-                pool_[ithread].endpoint(),
-                pool_[ithread].auto_rejected(),
-                old_criteria.state_old(),
-                old_criteria.state_new()
-              );
-            } else {
-              // Update TM on rejection
-              clone_(jthread)->get_criteria()->imitate_trial_rejection_(
-                pool_[ithread].ln_prob(),
-                old_criteria.state_old(),
-                old_criteria.state_new(),
-                pool_[ithread].endpoint()
-              );
-            }
-            if (jthread == 0) {
-              after_trial_analyze_();
-            }
-          }
-          DEBUG("num attempts " << pool->mc->trials().num_attempts() << " "
-                                << pool->mc->trials().num_success() << " " << &pool->mc);
+      // for each thread up to the first accepted, update this thread regarding
+      // the failed attempt.
+      for (int ithread = 0; ithread < first_thread_accepted; ++ithread) {
+        const PoolTrial& other = pool_[ithread].trial(cycle);
+        if (ithread != proc_id) {
+          mc->imitate_trial_rejection_(other.index(), other.ln_prob(),
+            other.endpoint(), other.auto_rejected(), other.state_old(),
+            other.state_new());
+        } else {
+          // Update TM on rejection
+          mc->get_criteria()->imitate_trial_rejection_(other.ln_prob(),
+            other.state_old(), other.state_new(), other.endpoint());
+        }
+        if (proc_id == 0) {
+          after_trial_analyze_();
         }
-        DEBUG("num attempts main " << trials().num_attempts() << " "
-                                     << trials().num_success() << " " << this);
       }
 
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      #pragma omp critical
-      {
-      #endif
-
+      // Replicate first accepted trial in all other threads.
+      // The accepted thread waits until the others have copied its cache
+      // before finalizing, and until the others have synchronized before
+      // its cache is unloaded or modified.
       if (first_thread_accepted < num_threads_) {
-        DEBUG("Replicate first accepted trial in all other threads in proc_id " << proc_id);
-        Pool * accepted_pool = &pool_[first_thread_accepted];
+        const MonteCarlo& cln = *clone_(first_thread_accepted);
+        const int index = pool_[first_thread_accepted].trial(cycle).index();
+        expected_copies += num_threads_ - 1;
         if (proc_id != first_thread_accepted) {
           // load/unload system energies and random numbers
-          mc->unload_cache_(*clone_(first_thread_accepted));
-          mc->attempt_trial(accepted_pool->index());
+          mc->unload_cache_(cln);
+          num_copied.fetch_add(1);
+          mc->attempt_trial(index);
+        } else {
+          while (num_copied.load() < expected_copies) {
+            std::this_thread::yield();
+          }
         }
-        mc->finalize_(accepted_pool->index());
-      } else {
-        DEBUG("all rejected, en: " << criteria().current_energy());
-      }
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      }
-      #endif
-
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      #pragma omp critical
-      {
-      #endif
-
-      if (first_thread_accepted < num_threads_) {
+        mc->finalize_(index);
         if (is_synchronize_) {
-          DEBUG("synchronize other threads with first accepted thread " << proc_id);
-          Pool * accepted_pool = &pool_[first_thread_accepted];
+          expected_synchronized += num_threads_ - 1;
           if (proc_id != first_thread_accepted) {
-            DEBUG(proc_id);
-            DEBUG(first_thread_accepted);
-            DEBUG(accepted_pool->index());
-            const MonteCarlo& cln = *clone_(first_thread_accepted);
-            DEBUG(cln.trial(accepted_pool->index()).accept().perturbed().str());
-            mc->synchronize_(cln,
-              cln.trial(accepted_pool->index()).accept().perturbed());
+            while (cycle_committed.load() < cycle) {
+              std::this_thread::yield();
+            }
+            mc->synchronize_(cln, cln.trial(index).accept().perturbed());
+            num_synchronized.fetch_add(1);
+          } else {
+            cycle_committed.store(cycle);
+            while (num_synchronized.load() < expected_synchronized) {
+              std::this_thread::yield();
+            }
           }
         }
         if (proc_id == 0) {
           after_trial_analyze_();
         }
+      } else {
+        DEBUG("all rejected, en: " << mc->criteria().current_energy());
       }
 
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      }
-      #endif
-
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      #pragma omp critical
-      {
-      #endif
-
       // disable cache
       mc->load_cache_(false);
 
       // update last trial for tuning
-      int last_thread = first_thread_accepted;
-      if (last_thread >= num_threads_) {
-        last_thread = num_threads_ - 1;
-      }
+      const int last_thread = std::min(first_thread_accepted, num_threads_ - 1);
       if (proc_id != last_thread) {
-        const MonteCarlo& cln = *clone_(last_thread);
-        mc->get_trial_factory()->set_last_index(cln.trials().last_index());
-        mc->get_criteria()->set_was_accepted(cln.criteria().was_accepted());
+        const PoolTrial& last = pool_[last_thread].trial(cycle);
+        mc->get_trial_factory()->set_last_index(last.index());
+        mc->get_criteria()->set_was_accepted(last.accepted());
       }
 
       // perform after trial on all clones/main after multiple trials performed
       // do this in serial so that files are not written to by multiple threads
       // simultaneously
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      }
       #pragma omp critical
       {
-      #else
-      {
-      #endif
       for (int im = 0;
            im < std::min(num_threads_, first_thread_accepted + 1);
            ++im) {
-        // DEBUG("im " << im << " first " << first_thread_accepted);
         mc->after_trial_modify_();
       }
       }
 
-      DEBUG("update itrial");
-      //if (proc_id <= first_thread_accepted) {
-      //  ++itrial;
-      //  ++trials_since_check_;
-      if (proc_id == 0) {
-        int increment = num_threads_;
-        if (first_thread_accepted < num_threads_) {
-          increment = first_thread_accepted + 1;
+      const int increment = std::min(num_threads_, first_thread_accepted + 1);
+      itrial += increment;
+      since_check += increment;
+
+      // periodically check that all threads are equal
+      if (since_check >= trials_per_check_) {
+        since_check = 0;
+        #pragma omp barrier
+        if (proc_id > 0) {
+          const double energy = criteria().current_energy();
+          DEBUG("check that the current energy of all threads and main are the same: " << energy);
+          const double tolerance = 1e-8;
+          const double diff = mc->criteria().current_energy() - energy;
+          ASSERT(std::abs(diff) <= tolerance, "diff: " << diff);
+          ASSERT(system().configuration().is_equal(mc->system().configuration(), tolerance), "configs not equal thread" << proc_id);
+          ASSERT(trials().is_equal(mc->trials()), "trials not equal thread" << proc_id);
+          ASSERT(criteria().is_equal(mc->criteria(), tolerance), "criteria not equal: " << proc_id);
         }
-        itrial += increment;
-        trials_since_check_ += increment;
-      }
-
-//      #ifdef DEBUG_SERIAL_MODE_5324634
-//      }
-//      #endif
-
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      #pragma omp critical
-      {
-      #endif
-
-      DEBUG("periodically check that all threads are equal");
-      if (trials_since_check_ >= trials_per_check_ && proc_id > 0) {
-        trials_since_check_ = 0;
-        const double energy = criteria().current_energy();
-        DEBUG("check that the current energy of all threads and main are the same: " << energy);
-        const double tolerance = 1e-8;
-        const MonteCarlo& mcc = *clone_(proc_id);
-        const double diff = mcc.criteria().current_energy() - energy;
-        ASSERT(std::abs(diff) <= tolerance, "diff: " << diff);
-        ASSERT(system().configuration().is_equal(mcc.system().configuration(), tolerance), "configs not equal thread" << proc_id);
-        ASSERT(trials().is_equal(mcc.trials()), "trials not equal thread" << proc_id);
-        ASSERT(criteria().is_equal(mcc.criteria(), tolerance), "criteria not equal: " << proc_id);
-
-        // periodically equate all clones to first thread to prevent drift
-//        std::stringstream clone_ss;
-//        MonteCarlo::serialize(clone_ss);
-//        pool_[proc_id].mc = MonteCarlo(clone_ss);
-//        clone_(proc_id)->seed_random(rand());  // HWH not thread safe // HWH consider setting RNG to previous seeds manually
+        #pragma omp barrier
       }
 
-      #ifdef DEBUG_SERIAL_MODE_5324634
-      }
-      #endif
-
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
-
       DEBUG("itrial: " << itrial);
       if (check_criteria_for_completion) {
-        if (criteria().is_complete()) {
-          complete = true;
-        }
-      } else {
-        if (itrial >= num_trials) {
-          complete = true;
-        }
+        // The Criteria of each thread are identical, as checked above, so
+        // each thread reaches completion on the same cycle without a barrier.
+        thread_complete = mc->criteria().is_complete();
+      } else if (itrial >= num_trials) {
+        thread_complete = true;
       }
-      #ifdef _OPENMP
-      #pragma omp barrier
-      #endif // _OPENMP
+      ++cycle;
+    }
+    if (proc_id == 0) {
+      trials_since_check_ = since_check;
     }
   }
+  #endif // _OPENMP
 }
 
 void Prefetch::run(std::shared_ptr<Action> action) {
@@ -565,7 +407,7 @@ Prefetch::Prefetch(std::istream& istr) : MonteCarlo(istr) {
   feasst_deserialize(&ghost_, istr);
 }
 
-const std::string Pool::str() const {
+const std::string PoolTrial::str() const {
   std::stringstream ss;
   ss << index_ << " " << ln_prob_ << " " << accepted_;
   return ss.str();
@@ -0,0 +1,239 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "utils/include/custom_exception.h"
+#include "utils/include/arguments.h"
+#include "utils/include/debug.h"
+#include "utils/include/serialize.h"
+#include "utils/include/checkpoint.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/configuration.h"
+#include "system/include/system.h"
+#include "system/include/thermo_params.h"
+#include "monte_carlo/include/criteria.h"
+#include "prefetch/include/replica_exchange.h"
+
+namespace feasst {
+
+ReplicaExchange::ReplicaExchange(argtype * args) {
+  trials_per_exchange_ = integer("trials_per_exchange", args, 1e3);
+  ASSERT(trials_per_exchange_ > 0,
+    "trials_per_exchange: " << trials_per_exchange_);
+  exchange_file_ = str("exchange_file", args, "");
+  random_ = std::make_shared<RandomMT19937>();
+}
+ReplicaExchange::ReplicaExchange(argtype args) : ReplicaExchange(&args) {
+  feasst_check_all_used(args);
+}
+
+ReplicaExchange::~ReplicaExchange() {}
+
+void ReplicaExchange::add(std::shared_ptr<MonteCarlo> mc) {
+  ASSERT(mc->system().num_configurations() == 1,
+    "ReplicaExchange is restricted to one Configuration per replica.");
+  if (num() > 0) {
+    num_attempted_.push_back(0.);
+    num_accepted_.push_back(0.);
+  }
+  walker_.push_back(num());
+  direction_.push_back(0);
+  last_first_.push_back(0.);
+  replicas_.push_back(mc);
+}
+
+const MonteCarlo& ReplicaExchange::replica(const int index) const {
+  ASSERT(index < num(), "index: " << index << " >= num: " << num());
+  return const_cast<MonteCarlo&>(*replicas_[index]);
+}
+
+MonteCarlo * ReplicaExchange::get_replica(const int index) {
+  ASSERT(index < num(), "index: " << index << " >= num: " << num());
+  return replicas_[index].get();
+}
+
+void ReplicaExchange::set(std::shared_ptr<Checkpoint> checkpoint) {
+  checkpoint_ = checkpoint;
+}
+
+void ReplicaExchange::set(std::shared_ptr<Random> random) {
+  random_ = random;
+}
+
+double ReplicaExchange::ln_prob_exchange_(const int lower_index) const {
+  const MonteCarlo& lower = replica(lower_index);
+  const MonteCarlo& upper = replica(lower_index + 1);
+  const ThermoParams& thermo_lower = lower.system().thermo_params();
+  const ThermoParams& thermo_upper = upper.system().thermo_params();
+  const Configuration& config_lower = lower.configuration();
+  const Configuration& config_upper = upper.configuration();
+  double ln_prob = (thermo_lower.beta() - thermo_upper.beta())*
+    (lower.criteria().current_energy() - upper.criteria().current_energy());
+  const int num_mu = std::min(thermo_lower.num_chemical_potentials(),
+                              thermo_upper.num_chemical_potentials());
+  for (int type = 0; type < num_mu; ++type) {
+    ln_prob -= (thermo_lower.beta_mu(type) - thermo_upper.beta_mu(type))*
+      static_cast<double>(config_lower.num_particles_of_type(type) -
+                          config_upper.num_particles_of_type(type));
+  }
+  if (thermo_lower.is_pressure() && thermo_upper.is_pressure()) {
+    ln_prob += (thermo_lower.beta()*thermo_lower.pressure() -
+                thermo_upper.beta()*thermo_upper.pressure())*
+      (config_lower.domain().volume() - config_upper.domain().volume());
+  }
+  return ln_prob;
+}
+
+void ReplicaExchange::exchange_(const int parity) {
+  for (int lower = parity; lower < num() - 1; lower += 2) {
+    num_attempted_[lower] += 1.;
+    const double ln_prob = ln_prob_exchange_(lower);
+    DEBUG("lower " << lower << " ln_prob " << ln_prob);
+    if (ln_prob >= 0. || random_->uniform() < std::exp(ln_prob)) {
+      replicas_[lower]->exchange_system(replicas_[lower + 1].get());
+      std::swap(walker_[lower], walker_[lower + 1]);
+      num_accepted_[lower] += 1.;
+    }
+  }
+}
+
+void ReplicaExchange::update_round_trips_() {
+  if (num() < 2) {
+    return;
+  }
+  const int first = walker_[0];
+  if (direction_[first] != 1) {
+    if (direction_[first] == -1) {
+      num_round_trips_ += 1.;
+      sum_round_trip_exchanges_ += num_exchanges_ - last_first_[first];
+    }
+    direction_[first] = 1;
+    last_first_[first] = num_exchanges_;
+  }
+  const int last = walker_[num() - 1];
+  if (direction_[last] == 1) {
+    direction_[last] = -1;
+  }
+}
+
+void ReplicaExchange::run(const int num_exchanges) {
+  ASSERT(num() > 0, "add replicas before run.");
+  if (num_exchanges_ == 0.) {
+    update_round_trips_();
+  }
+  for (int step = 0; step < num_exchanges; ++step) {
+    // Each replica is a task which is run by only one thread.
+    bool terminated = false;
+    #pragma omp parallel for schedule(dynamic)
+    for (int index = 0; index < num(); ++index) {
+      try {
+        replicas_[index]->attempt(trials_per_exchange_);
+      } catch(const feasst::CustomException& e) {
+        WARN(e.what());
+        #pragma omp critical
+        terminated = true;
+      }
+    }
+    if (terminated) {
+      FATAL("ReplicaExchange::run was terminated.");
+    }
+    exchange_(static_cast<int>(num_exchanges_) % 2);
+    num_exchanges_ += 1.;
+    update_round_trips_();
+    if (checkpoint_) checkpoint_->check(*this);
+  }
+  if (!exchange_file_.empty()) {
+    std::ofstream file(exchange_file_);
+    file << exchange_report();
+  }
+  if (checkpoint_) checkpoint_->write(*this);
+}
+
+double ReplicaExchange::acceptance(const int lower_index) const {
+  ASSERT(lower_index >= 0 && lower_index < num() - 1,
+    "lower_index: " << lower_index);
+  if (num_attempted_[lower_index] == 0.) {
+    return 0.;
+  }
+  return num_accepted_[lower_index]/num_attempted_[lower_index];
+}
+
+double ReplicaExchange::round_trip_exchanges() const {
+  if (num_round_trips_ == 0.) {
+    return -1.;
+  }
+  return sum_round_trip_exchanges_/num_round_trips_;
+}
+
+std::string ReplicaExchange::exchange_report() const {
+  std::stringstream ss;
+  ss << "lower,attempted,accepted,acceptance" << std::endl;
+  for (int lower = 0; lower < num() - 1; ++lower) {
+    ss << lower << ","
+       << num_attempted_[lower] << ","
+       << num_accepted_[lower] << ","
+       << acceptance(lower) << std::endl;
+  }
+  ss << "round_trips," << num_round_trips_ << ","
+     << round_trip_exchanges() << ",";
+  if (num_round_trips_ > 0.) {
+    ss << round_trip_exchanges()*trials_per_exchange_;
+  }
+  ss << std::endl;
+  return ss.str();
+}
+
+void ReplicaExchange::serialize(std::ostream& ostr) const {
+  feasst_serialize_version(4275, ostr);
+  feasst_serialize(replicas_, ostr);
+  feasst_serialize_fstdr(random_, ostr);
+  feasst_serialize(trials_per_exchange_, ostr);
+  feasst_serialize(exchange_file_, ostr);
+  feasst_serialize(num_exchanges_, ostr);
+  feasst_serialize(num_attempted_, ostr);
+  feasst_serialize(num_accepted_, ostr);
+  feasst_serialize(walker_, ostr);
+  feasst_serialize(direction_, ostr);
+  feasst_serialize(last_first_, ostr);
+  feasst_serialize(num_round_trips_, ostr);
+  feasst_serialize(sum_round_trip_exchanges_, ostr);
+  feasst_serialize_endcap("ReplicaExchange", ostr);
+}
+
+ReplicaExchange::ReplicaExchange(std::istream& istr) {
+  const int version = feasst_deserialize_version(istr);
+  ASSERT(version == 4275, "version: " << version);
+  int dim1;
+  istr >> dim1;
+  replicas_.resize(dim1);
+  for (int index = 0; index < dim1; ++index) {
+    int existing;
+    istr >> existing;
+    if (existing != 0) {
+      replicas_[index] = std::make_shared<MonteCarlo>(istr);
+    }
+  }
+  { int existing;
+    istr >> existing;
+    if (existing != 0) {
+      random_ = random_->deserialize(istr);
+    }
+  }
+  feasst_deserialize(&trials_per_exchange_, istr);
+  feasst_deserialize(&exchange_file_, istr);
+  feasst_deserialize(&num_exchanges_, istr);
+  feasst_deserialize(&num_attempted_, istr);
+  feasst_deserialize(&num_accepted_, istr);
+  feasst_deserialize(&walker_, istr);
+  feasst_deserialize(&direction_, istr);
+  feasst_deserialize(&last_first_, istr);
+  feasst_deserialize(&num_round_trips_, istr);
+  feasst_deserialize(&sum_round_trip_exchanges_, istr);
+  feasst_deserialize_endcap("ReplicaExchange", istr);
+}
+
+}  // namespace feasst
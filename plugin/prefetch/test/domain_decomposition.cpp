@@ -0,0 +1,157 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
+#include "utils/test/utils.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/configuration.h"
+#include "configuration/include/domain.h"
+#include "system/include/system.h"
+#include "system/include/potential.h"
+#include "system/include/thermo_params.h"
+#include "system/include/lennard_jones.h"
+#include "system/include/hard_sphere.h"
+#include "system/include/long_range_corrections.h"
+#include "system/include/visit_model_cell.h"
+#include "monte_carlo/include/metropolis.h"
+#include "monte_carlo/include/run.h"
+#include "monte_carlo/include/remove_trial.h"
+#include "monte_carlo/include/trial_add.h"
+#include "monte_carlo/include/trial_translate.h"
+#include "steppers/include/check_energy.h"
+#include "prefetch/include/domain_decomposition.h"
+
+namespace feasst {
+
+// Add particles to a MonteCarlo, or a derived class, for translations.
+void domain_mc(MonteCarlo * mc, const double side, const int num,
+               const bool hard_sphere, const int trials_per) {
+  mc->set(MakeRandomMT19937({{"seed", "123"}}));
+  if (hard_sphere) {
+    mc->add(MakeConfiguration({{"cubic_side_length", str(side)},
+      {"particle_type", "../particle/hard_sphere.fstprt"}}));
+    mc->add(MakePotential(MakeHardSphere(),
+      MakeVisitModelCell({{"min_length", "max_cutoff"}})));
+  } else {
+    mc->add(MakeConfiguration({{"cubic_side_length", str(side)},
+      {"particle_type", "../particle/lj.fstprt"}}));
+    mc->add(MakePotential(MakeLennardJones(),
+      MakeVisitModelCell({{"min_length", "max_cutoff"}})));
+    mc->add(MakePotential(MakeLongRangeCorrections()));
+  }
+  mc->set(MakeThermoParams({{"beta", "1.2"}, {"chemical_potential", "1."}}));
+  mc->set(MakeMetropolis());
+  mc->add(MakeTrialAdd({{"particle_type", "0"}}));
+  mc->run(MakeRun({{"until_num_particles", str(num)}}));
+  mc->run(MakeRemoveTrial({{"name", "TrialAdd"}}));
+  mc->add(MakeTrialTranslate({{"tunable_param", "0.5"}}));
+  mc->add(MakeCheckEnergy({{"trials_per_update", str(trials_per)},
+                           {"tolerance", "1e-8"}}));
+}
+
+// Set the number of threads, so that multiple threads are used even if the
+// test is run with a single core, and return the previous number.
+int set_num_threads(const int num_threads) {
+  int previous = 1;
+  #ifdef _OPENMP
+  previous = omp_get_max_threads();
+  omp_set_num_threads(num_threads);
+  #endif // _OPENMP
+  return previous;
+}
+
+TEST(DomainDecomposition, lj) {
+  const int max_threads = set_num_threads(4);
+  auto mc = MakeDomainDecomposition({{"min_width", "3.1"}});
+  domain_mc(mc.get(), 16, 400, false, 1e3);
+  const double energy = mc->criteria().current_energy();
+  mc->attempt(1e4);
+  EXPECT_EQ(4, mc->num_domains()[0]);
+  EXPECT_GT(mc->num_accepted(), 0.1*mc->num_attempts());
+  EXPECT_NE(energy, mc->criteria().current_energy());
+  EXPECT_NEAR(mc->criteria().current_energy(), mc->get_system()->energy(),
+              1e-8);
+  #ifdef _OPENMP
+  EXPECT_EQ(4, mc->num_threads());
+  #endif // _OPENMP
+  auto mc2 = test_serialize_unique(*mc);
+  EXPECT_EQ(mc->num_attempts(), mc2->num_attempts());
+  set_num_threads(max_threads);
+}
+
+TEST(DomainDecomposition, hard_sphere) {
+  const int max_threads = set_num_threads(4);
+  auto mc = MakeDomainDecomposition();
+  domain_mc(mc.get(), 8, 200, true, 1e3);
+  mc->attempt(1e4);
+  EXPECT_EQ(4, mc->num_domains()[0]);
+  EXPECT_EQ(0., mc->criteria().current_energy());
+  EXPECT_EQ(0., mc->get_system()->energy());
+
+  // The copies of the System are copied again after a serial addition, and
+  // are otherwise updated between attempts.
+  mc->add(MakeTrialAdd({{"particle_type", "0"}}));
+  mc->run(MakeRun({{"until_num_particles", "201"}}));
+  mc->run(MakeRemoveTrial({{"name", "TrialAdd"}}));
+  mc->attempt(1e3);
+  mc->attempt(1e3);
+  EXPECT_EQ(201, mc->configuration().num_particles());
+  EXPECT_EQ(0., mc->get_system()->energy());
+  set_num_threads(max_threads);
+}
+
+TEST(DomainDecomposition, min_width) {
+  TRY(
+    auto mc = MakeDomainDecomposition({{"min_width", "5"}});
+    domain_mc(mc.get(), 8, 10, true, 1e3);
+    mc->attempt(1e2);
+    CATCH_PHRASE("is less than twice the min_width");
+  );
+}
+
+TEST(DomainDecomposition, energy_map) {
+  TRY(
+    auto mc = MakeDomainDecomposition();
+    mc->add(MakeConfiguration({{"cubic_side_length", "8"},
+      {"particle_type", "../particle/hard_sphere.fstprt"},
+      {"add_particles_of_type0", "10"}}));
+    mc->add(MakePotential({{"Model", "HardSphere"},
+                           {"EnergyMap", "EnergyMapAll"}}));
+    mc->set(MakeThermoParams({{"beta", "1.2"}}));
+    mc->set(MakeMetropolis());
+    mc->add(MakeTrialTranslate({{"tunable_param", "0.5"}}));
+    mc->attempt(1e2);
+    CATCH_PHRASE("does not support an EnergyMap");
+  );
+}
+
+// Print the speedup of DomainDecomposition relative to a serial MonteCarlo.
+void domain_speedup(const bool hard_sphere) {
+  #ifdef _OPENMP
+  const double side = 40;
+  const int num = 0.5*side*side*side;
+  const int trials = 2e6;
+  MonteCarlo serial;
+  domain_mc(&serial, side, num, hard_sphere, trials);
+  double begin = omp_get_wtime();
+  serial.attempt(trials);
+  const double serial_seconds = omp_get_wtime() - begin;
+  auto mc = MakeDomainDecomposition();
+  domain_mc(mc.get(), side, num, hard_sphere, trials);
+  begin = omp_get_wtime();
+  mc->attempt(trials);
+  const double seconds = omp_get_wtime() - begin;
+  INFO("hard_sphere " << hard_sphere << " threads " << mc->num_threads() <<
+       " serial s " << serial_seconds << " domain decomposition s " <<
+       seconds << " speedup " << serial_seconds/seconds);
+  #endif // _OPENMP
+}
+
+TEST(DomainDecomposition, lj_speedup_LONG) {
+  domain_speedup(false);
+}
+
+TEST(DomainDecomposition, hard_sphere_speedup_LONG) {
+  domain_speedup(true);
+}
+
+}  // namespace feasst
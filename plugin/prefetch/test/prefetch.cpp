@@ -1,3 +1,6 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
 #include "utils/test/utils.h"
 #include "threads/include/thread_omp.h"
 #include "math/include/random_mt19937.h"
@@ -38,7 +41,8 @@
 
 namespace feasst {
 
-void run_prefetch(const int trials, const int trials_per) {
+// Return the wall clock seconds of the prefetch trials.
+double run_prefetch(const int trials, const int trials_per) {
   auto mc = MakePrefetch();
   //auto mc = MakePrefetch({{"trials_per_check", "1"}});
 //  mc->set(MakeRandomMT19937({{"seed", "1592943710"}}));
@@ -60,9 +64,21 @@ void run_prefetch(const int trials, const int trials_per) {
   mc->run(MakeRemoveTrial({{"name", "TrialAdd"}}));
   // activate prefetch after initial configuration
   mc->activate_prefetch(true);
+  #ifdef _OPENMP
+  const double begin = omp_get_wtime();
+  #endif // _OPENMP
   mc->attempt(trials);
 //  EXPECT_EQ(mc->analyze(0).trials_since_write(),
 //            mc->modify(0).trials_since_update());
+  #ifdef _OPENMP
+  const double seconds = omp_get_wtime() - begin;
+  #else // _OPENMP
+  const double seconds = 0.;
+  #endif // _OPENMP
+  EXPECT_EQ(50, mc->configuration().num_particles());
+  EXPECT_NEAR(mc->criteria().current_energy(),
+              mc->get_system()->unoptimized_energy(0), 1e-8);
+  return seconds;
 }
 
 TEST(Prefetch, NVT_benchmark) {
@@ -73,6 +89,23 @@ TEST(Prefetch, NVT_benchmark_LONG) {
   run_prefetch(1e6, 1e3); // 5.4s on 4 cores of i7-4770K @ 3.5GHz
 }
 
+// Print the trials per second with 1 to 32 threads.
+void prefetch_scaling(const int trials) {
+  #ifdef _OPENMP
+  const int max_threads = omp_get_max_threads();
+  for (int num_threads = 1; num_threads <= 32; num_threads *= 2) {
+    omp_set_num_threads(num_threads);
+    const double seconds = run_prefetch(trials, trials/10);
+    INFO("threads " << num_threads << " trials/s " << trials/seconds);
+  }
+  omp_set_num_threads(max_threads);
+  #endif // _OPENMP
+}
+
+TEST(Prefetch, scaling_BENCHMARK_LONG) {
+  prefetch_scaling(1e6);
+}
+
 void prefetch(System system, const int sync = 0) {
   auto mc = MakePrefetch({{"trials_per_check", "1"}, {"synchronize", str(sync)}});
   mc->set(MakeRandomMT19937({{"seed", "123"}}));
@@ -137,10 +170,53 @@ TEST(Prefetch, MUVT) {
   prefetch(sys);
 }
 
+// Each thread finds the Criteria complete on the same cycle.
+TEST(Prefetch, run_until_complete) {
+  #ifdef _OPENMP
+  const int max_threads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  auto mc = MakePrefetch({{"trials_per_check", "1"}});
+  mc->set(MakeRandomMT19937({{"seed", "123"}}));
+  mc->add(MakeConfiguration({{"cubic_side_length", "8"},
+                             {"particle_type0", "../particle/lj.fstprt"}}));
+  mc->add(MakePotential(MakeLennardJones()));
+  mc->set(MakeThermoParams({{"beta", str(1./1.5)},
+     {"chemical_potential", "-2.352321"}}));
+  mc->set(MakeFlatHistogram(
+    MakeMacrostateNumParticles(
+      Histogram({{"width", "1"}, {"max", "5"}, {"min", "0"}})),
+    MakeTransitionMatrix({{"min_sweeps", "5"}})));
+  mc->add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "1."}}));
+  mc->add(MakeTrialAdd({{"particle_type", "0"}}));
+  mc->add(MakeTrialRemove({{"particle_type", "0"}}));
+  mc->add(MakeCriteriaUpdater({{"trials_per_update", str(1e1)}}));
+  mc->activate_prefetch(true);
+  mc->run_until_complete();
+  EXPECT_TRUE(mc->criteria().is_complete());
+  for (int thread = 1; thread < static_cast<int>(mc->pool().size());
+       ++thread) {
+    EXPECT_TRUE(mc->clone_(thread)->criteria().is_complete());
+  }
+  omp_set_num_threads(max_threads);
+  #endif // _OPENMP
+}
+
 TEST(Prefetch, MUVT_spce) {
   prefetch(spce({{"alpha", str(5.6/20)}, {"kmax_squared", "38"}, {"erfc_table_size", str(2e4)}}), 1);
 }
 
+// The eik of Ewald are finalized and synchronized among multiple threads,
+// even if this test is run with a single core.
+TEST(Prefetch, MUVT_spce_threads) {
+  #ifdef _OPENMP
+  const int max_threads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  prefetch(spce({{"alpha", str(5.6/20)}, {"kmax_squared", "38"},
+                 {"erfc_table_size", str(2e4)}}), 1);
+  omp_set_num_threads(max_threads);
+  #endif // _OPENMP
+}
+
 TEST(Prefetch, NVT_spce) {
   auto mc = MakePrefetch({{"synchronize", "true"}});
   //auto mc = MakePrefetch({{"synchronize", "false"}});
@@ -0,0 +1,107 @@
+#include "utils/test/utils.h"
+#include "utils/include/checkpoint.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/configuration.h"
+#include "system/include/system.h"
+#include "system/include/potential.h"
+#include "system/include/thermo_params.h"
+#include "system/include/lennard_jones.h"
+#include "system/include/long_range_corrections.h"
+#include "monte_carlo/include/metropolis.h"
+#include "monte_carlo/include/run.h"
+#include "monte_carlo/include/remove_trial.h"
+#include "monte_carlo/include/trial_add.h"
+#include "monte_carlo/include/trial_translate.h"
+#include "monte_carlo/include/trial_transfer.h"
+#include "steppers/include/check_energy.h"
+#include "steppers/include/tune.h"
+#include "prefetch/include/replica_exchange.h"
+
+namespace feasst {
+
+std::shared_ptr<MonteCarlo> replica_mc(const double beta, const double mu,
+                                       const bool transfer) {
+  auto mc = MakeMonteCarlo();
+  mc->set(MakeRandomMT19937({{"seed", "time"}}));
+  mc->add(MakeConfiguration({{"cubic_side_length", "8"},
+    {"particle_type", "../particle/lj.fstprt"}}));
+  mc->add(MakePotential(MakeLennardJones()));
+  mc->add(MakePotential(MakeLongRangeCorrections()));
+  mc->set(MakeThermoParams({{"beta", str(beta)},
+                            {"chemical_potential", str(mu)}}));
+  mc->set(MakeMetropolis());
+  mc->add(MakeTrialAdd({{"particle_type", "0"}}));
+  mc->run(MakeRun({{"until_num_particles", "50"}}));
+  mc->run(MakeRemoveTrial({{"name", "TrialAdd"}}));
+  mc->add(MakeTrialTranslate({{"tunable_param", "1."}}));
+  if (transfer) {
+    mc->add(MakeTrialTransfer({{"particle_type", "0"}}));
+  }
+  mc->add(MakeCheckEnergy({{"trials_per_update", "1e2"},
+                           {"tolerance", "1e-8"}}));
+  mc->add(MakeTune());
+  return mc;
+}
+
+TEST(ReplicaExchange, same_thermo_params) {
+  auto replicas = MakeReplicaExchange({{"trials_per_exchange", "1e2"}});
+  for (int index = 0; index < 3; ++index) {
+    replicas->add(replica_mc(1., -2., false));
+  }
+  replicas->run(5);
+  EXPECT_EQ(5, replicas->num_exchanges());
+  EXPECT_EQ(3, replicas->num_attempted(0));
+  EXPECT_EQ(2, replicas->num_attempted(1));
+  for (int lower = 0; lower < 2; ++lower) {
+    EXPECT_EQ(1., replicas->acceptance(lower));
+  }
+  // with alternating exchanges of even and odd pairs, the first walker
+  // reaches the last replica after two steps and returns after five.
+  EXPECT_EQ(0, replicas->walker(0));
+  EXPECT_EQ(1, replicas->num_round_trips());
+  EXPECT_EQ(5, replicas->round_trip_exchanges());
+}
+
+TEST(ReplicaExchange, beta) {
+  auto replicas = MakeReplicaExchange({{"trials_per_exchange", "1e2"},
+    {"exchange_file", "tmp/replica_exchange.csv"}});
+  const std::vector<double> betas = {0.8, 0.9, 1.};
+  for (const double beta : betas) {
+    replicas->add(replica_mc(beta, -2., false));
+  }
+  replicas->set(MakeCheckpoint({{"checkpoint_file", "tmp/replica.fst"},
+                                {"num_hours", "0.0001"}}));
+  replicas->run(40);
+  for (int index = 0; index < replicas->num(); ++index) {
+    const MonteCarlo& mc = replicas->replica(index);
+    EXPECT_EQ(betas[index], mc.system().thermo_params().beta());
+    EXPECT_EQ(50, mc.configuration().num_particles());
+    EXPECT_NEAR(mc.criteria().current_energy(),
+      replicas->get_replica(index)->get_system()->energy(), 1e-8);
+  }
+  for (int lower = 0; lower < replicas->num() - 1; ++lower) {
+    EXPECT_EQ(20, replicas->num_attempted(lower));
+    EXPECT_GT(replicas->acceptance(lower), 0.);
+  }
+  INFO(replicas->exchange_report());
+  auto replicas2 = test_serialize_unique(*replicas);
+  EXPECT_EQ(replicas->num_round_trips(), replicas2->num_round_trips());
+  EXPECT_EQ(replicas->walker(0), replicas2->walker(0));
+  replicas2->run(2);
+  EXPECT_EQ(42, replicas2->num_exchanges());
+}
+
+TEST(ReplicaExchange, chemical_potential) {
+  auto replicas = MakeReplicaExchange({{"trials_per_exchange", "1e2"}});
+  for (const double mu : {-4., -3., -2.}) {
+    replicas->add(replica_mc(1., mu, true));
+  }
+  replicas->run(20);
+  for (int index = 0; index < replicas->num(); ++index) {
+    const MonteCarlo& mc = replicas->replica(index);
+    EXPECT_NEAR(mc.criteria().current_energy(),
+      replicas->get_replica(index)->get_system()->energy(), 1e-8);
+  }
+}
+
+}  // namespace feasst
@@ -0,0 +1,83 @@
+
+#ifndef FEASST_STEPPERS_ANALYZE_TRAJECTORY_H_
+#define FEASST_STEPPERS_ANALYZE_TRAJECTORY_H_
+
+#include <string>
+#include <memory>
+#include "monte_carlo/include/action.h"
+
+namespace feasst {
+
+class Analyze;
+class Modify;
+
+typedef std::map<std::string, std::string> argtype;
+
+/**
+  Update all Analyze and Modify objects (e.g., PairDistribution, Scattering,
+  DensityProfile or AnalyzeCluster) once for each frame of a FileTrajectory or
+  FileXYZ, and then write them to file.
+  This is a faster alternative to ReadConfigFromFile for post processing,
+  which reads the frames with a MappedTrajectory and distributes contiguous
+  blocks of frames among OpenMP threads.
+
+  Each thread beyond the first updates its own copy of the MonteCarlo, and
+  the copies are merged into the original in the order of the frames
+  (see Stepper::merge).
+  With more than one thread, every Analyze and Modify must be mergeable
+  (e.g., not MeanSquaredDisplacement, which depends on the order of frames).
+  Thus, the Analyze and Modify should not have been updated before, and should
+  not write to file during update (e.g., Movie), or change the System.
+  As with ReadConfigFromFile, the Criteria state is updated for each frame,
+  but the energy is not recomputed.
+ */
+class AnalyzeTrajectory : public Action {
+ public:
+  //@{
+  /** @name Arguments
+    - input_file: name of FileTrajectory or FileXYZ to analyze.
+    - num_threads: number of OpenMP threads.
+      If -1, use the maximum number of threads (default: -1).
+    - first_frame: index of the first frame to analyze (default: 0).
+    - last_frame: index of the last frame to analyze.
+      If -1, analyze until the last frame in the file (default: -1).
+    - frame_stride: analyze every this many frames (default: 1).
+   */
+  explicit AnalyzeTrajectory(argtype args = argtype());
+  explicit AnalyzeTrajectory(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  void run(MonteCarlo * mc) override;
+  std::shared_ptr<Action> create(std::istream& istr) const override {
+    return std::make_shared<AnalyzeTrajectory>(istr); }
+  std::shared_ptr<Action> create(argtype * args) const override {
+    return std::make_shared<AnalyzeTrajectory>(args); }
+  void serialize(std::ostream& ostr) const override;
+  explicit AnalyzeTrajectory(std::istream& istr);
+  virtual ~AnalyzeTrajectory() {}
+
+  //@}
+ private:
+  std::string input_file_;
+  int num_threads_;
+  int first_frame_;
+  int last_frame_;
+  int frame_stride_;
+
+  void update_(MonteCarlo * mc) const;
+  void update_analyze_(Analyze * analyze, const MonteCarlo& mc) const;
+  void update_modify_(Modify * modify, MonteCarlo * mc) const;
+};
+
+inline std::shared_ptr<AnalyzeTrajectory> MakeAnalyzeTrajectory(
+    argtype args = argtype()) {
+  return std::make_shared<AnalyzeTrajectory>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_STEPPERS_ANALYZE_TRAJECTORY_H_
@@ -42,6 +42,8 @@ class Density : public Analyze {
 
   const Accumulator& density() const { return accumulator(); }
 
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("Density"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
@@ -48,6 +48,10 @@ class DensityProfile : public Analyze {
       const System& system,
       const TrialFactory& trial_factory) override;
 
+  /// Also merge the histograms of each site type.
+  void merge(const Stepper& stepper) override;
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("DensityProfile"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
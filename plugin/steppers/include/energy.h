@@ -43,6 +43,8 @@ class Energy : public Analyze {
   /// Return the energy.
   const Accumulator& energy() const { return accumulator(); }
 
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("Energy"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
@@ -55,6 +55,10 @@ class ExtensiveMoments : public Analyze {
       const int j, const int i) const {
     return moments_[p][m][k][j][i]; }
 
+  /// Also merge the extensive moments.
+  void merge(const Stepper& stepper) override;
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("ExtensiveMoments"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
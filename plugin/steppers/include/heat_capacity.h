@@ -46,6 +46,13 @@ class HeatCapacity : public Analyze {
       const System& system,
       const TrialFactory& trial_factory) override;
 
+  /// Return the energy.
+  const Accumulator& energy() const { return energy_; }
+
+  /// Also merge the energy.
+  void merge(const Stepper& stepper) override;
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("HeatCapacity"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
@@ -11,21 +11,26 @@ namespace feasst {
 
 class FileVMD;
 class FileXYZ;
+class FileTrajectory;
 
 typedef std::map<std::string, std::string> argtype;
 
 // HWH allow different formats.
 // HWH for example, incorportate FileXYZPatch
 /**
-  Write a trajectory of the site positions using FileXYZ format.
+  Write a trajectory of the site positions using FileXYZ format, or the
+  compressed FileTrajectory format.
   Appends to existing file by default.
  */
 class Movie : public AnalyzeWriteOnly {
  public:
   //@{
   /** @name Arguments
-    - FileXYZ arguments (e.g., group_index).
-    - FileVMD arguments (e.g., min_sigma).
+    - compressed: if true, write a FileTrajectory instead of FileXYZ, and do
+      not write the FileVMD files (default: false).
+    - FileXYZ arguments (e.g., group_index), if not compressed.
+    - FileVMD arguments (e.g., min_sigma), if not compressed.
+    - FileTrajectory arguments (e.g., precision), if compressed.
     - Stepper arguments.
     - append is always set to true via Stepper:set_append().
    */
@@ -61,6 +66,7 @@ class Movie : public AnalyzeWriteOnly {
  private:
   std::unique_ptr<FileXYZ> xyz_;
   std::unique_ptr<FileVMD> vmd_;
+  std::unique_ptr<FileTrajectory> trajectory_;
 };
 
 inline std::shared_ptr<Movie> MakeMovie(argtype args = argtype()) {
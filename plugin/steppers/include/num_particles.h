@@ -46,6 +46,8 @@ class NumParticles : public Analyze {
 
   const Accumulator& num_particles() const { return accumulator(); }
 
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override {
     return std::string("NumParticles"); }
@@ -75,6 +75,10 @@ class PairDistribution : public Modify {
 
   const grtype& radial(const Configuration& config);
 
+  /// Also merge the histograms and the number of updates.
+  void merge(const Stepper& stepper) override;
+  bool is_mergeable() const override { return true; }
+
   std::string write(Criteria * criteria,
     System * system,
     TrialFactory * trial_factory) override;
@@ -5,6 +5,7 @@
 #include <string>
 #include <fstream>
 #include "configuration/include/file_xyz.h"
+#include "configuration/include/file_trajectory.h"
 #include "monte_carlo/include/modify.h"
 
 namespace feasst {
@@ -16,12 +17,20 @@ namespace feasst {
   For each update, set the configuration to the next.
   Once the end of file is reached, the Criteria is set to complete.
   Thus, use with "Run until_criteria_complete true"
+
+  A compressed FileTrajectory (e.g., from Movie with compressed) is detected
+  by its header, and its frames are read in any order by index.
+  For faster post processing with multiple threads, see AnalyzeTrajectory.
  */
 class ReadConfigFromFile : public ModifyUpdateOnly {
  public:
   //@{
   /** @name Arguments
-    - input_file: name of FileXYZ to input Configuration.
+    - input_file: name of FileXYZ or FileTrajectory to input Configuration.
+    - first_frame: index of the first frame of a FileTrajectory to read
+      (default: 0).
+    - frame_stride: read every this many frames of a FileTrajectory
+      (default: 1).
     - Stepper arguments.
    */
   explicit ReadConfigFromFile(argtype args = argtype());
@@ -53,9 +62,13 @@ class ReadConfigFromFile : public ModifyUpdateOnly {
   std::string input_file_;
   bool set_complete_next_update_ = false;
   FileXYZ xyz_;
+  int first_frame_;
+  int frame_stride_;
+  int frame_ = 0;
 
   // not serialized
   std::ifstream file_;
+  std::unique_ptr<FileTrajectory> trajectory_;
 
   void load_(Criteria * criteria, System * system);
 };
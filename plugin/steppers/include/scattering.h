@@ -55,6 +55,10 @@ class Scattering : public Analyze {
       const System& system,
       const TrialFactory& trial_factory) override;
 
+  /// Also merge the intensity of each wave vector.
+  void merge(const Stepper& stepper) override;
+  bool is_mergeable() const override { return true; }
+
   int num_vectors() const { return static_cast<int>(kvecs_.size()); }
 
   // serialize
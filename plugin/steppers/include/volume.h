@@ -42,6 +42,8 @@ class Volume : public Analyze {
 
   const Accumulator& volume() const { return accumulator(); }
 
+  bool is_mergeable() const override { return true; }
+
   // serialize
   std::string class_name() const override { return std::string("Volume"); }
   std::shared_ptr<Analyze> create(std::istream& istr) const override {
@@ -0,0 +1,212 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
+#include <algorithm>
+#include <sstream>
+#include "utils/include/arguments.h"
+#include "utils/include/serialize.h"
+#include "utils/include/debug.h"
+#include "math/include/accumulator.h"
+#include "configuration/include/mapped_trajectory.h"
+#include "system/include/system.h"
+#include "monte_carlo/include/acceptance.h"
+#include "monte_carlo/include/criteria.h"
+#include "monte_carlo/include/monte_carlo.h"
+#include "monte_carlo/include/analyze_factory.h"
+#include "monte_carlo/include/modify_factory.h"
+#include "steppers/include/analyze_trajectory.h"
+
+namespace feasst {
+
+AnalyzeTrajectory::AnalyzeTrajectory(argtype * args) {
+  class_name_ = "AnalyzeTrajectory";
+  input_file_ = str("input_file", args);
+  num_threads_ = integer("num_threads", args, -1);
+  first_frame_ = integer("first_frame", args, 0);
+  last_frame_ = integer("last_frame", args, -1);
+  frame_stride_ = integer("frame_stride", args, 1);
+  ASSERT(num_threads_ == -1 || num_threads_ > 0,
+    "num_threads: " << num_threads_);
+  ASSERT(first_frame_ >= 0, "first_frame: " << first_frame_);
+  ASSERT(frame_stride_ > 0, "frame_stride: " << frame_stride_);
+}
+AnalyzeTrajectory::AnalyzeTrajectory(argtype args) : AnalyzeTrajectory(&args) {
+  feasst_check_all_used(args);
+}
+
+class MapAnalyzeTrajectory {
+ public:
+  MapAnalyzeTrajectory() {
+    auto obj = MakeAnalyzeTrajectory({{"input_file", "placeholder"}});
+    obj->deserialize_map()["AnalyzeTrajectory"] = obj;
+  }
+};
+
+static MapAnalyzeTrajectory mapper_AnalyzeTrajectory = MapAnalyzeTrajectory();
+
+AnalyzeTrajectory::AnalyzeTrajectory(std::istream& istr) : Action(istr) {
+  const int version = feasst_deserialize_version(istr);
+  ASSERT(version == 3712, "mismatch version: " << version);
+  feasst_deserialize(&input_file_, istr);
+  feasst_deserialize(&num_threads_, istr);
+  feasst_deserialize(&first_frame_, istr);
+  feasst_deserialize(&last_frame_, istr);
+  feasst_deserialize(&frame_stride_, istr);
+}
+
+void AnalyzeTrajectory::serialize(std::ostream& ostr) const {
+  ostr << class_name_ << " ";
+  serialize_action_(ostr);
+  feasst_serialize_version(3712, ostr);
+  feasst_serialize(input_file_, ostr);
+  feasst_serialize(num_threads_, ostr);
+  feasst_serialize(first_frame_, ostr);
+  feasst_serialize(last_frame_, ostr);
+  feasst_serialize(frame_stride_, ostr);
+}
+
+// Update an Analyze, or those of the current state of a multistate
+// AnalyzeFactory.
+void AnalyzeTrajectory::update_analyze_(Analyze * analyze,
+    const MonteCarlo& mc) const {
+  if (analyze->class_name() == "AnalyzeFactory") {
+    if (analyze->is_multistate()) {
+      update_analyze_(analyze->get_analyze(mc.criteria().state()), mc);
+    } else {
+      const int num = static_cast<int>(analyze->analyzers().size());
+      for (int index = 0; index < num; ++index) {
+        update_analyze_(analyze->get_analyze(index), mc);
+      }
+    }
+  } else {
+    analyze->update(mc.criteria(), mc.system(), mc.trials());
+  }
+}
+
+void AnalyzeTrajectory::update_modify_(Modify * modify,
+    MonteCarlo * mc) const {
+  if (modify->class_name() == "ModifyFactory") {
+    if (modify->is_multistate()) {
+      update_modify_(modify->get_modify(mc->criteria().state()), mc);
+    } else {
+      const int num = static_cast<int>(modify->modifiers().size());
+      for (int index = 0; index < num; ++index) {
+        update_modify_(modify->get_modify(index), mc);
+      }
+    }
+  } else {
+    modify->update(mc->get_criteria(), mc->get_system(), mc->get_random(),
+                   mc->get_trial_factory());
+  }
+}
+
+void AnalyzeTrajectory::update_(MonteCarlo * mc) const {
+  Acceptance acceptance;
+  mc->get_criteria()->update_state(mc->system(), acceptance);
+  for (int index = 0; index < mc->num_analyzers(); ++index) {
+    update_analyze_(mc->get_analyze_factory()->get_analyze(index), *mc);
+  }
+  for (int index = 0; index < mc->num_modifiers(); ++index) {
+    update_modify_(mc->get_modify_factory()->get_modify(index), mc);
+  }
+}
+
+void AnalyzeTrajectory::run(MonteCarlo * mc) {
+  const MappedTrajectory trajectory(input_file_);
+  int last = trajectory.num_frames() - 1;
+  if (last_frame_ != -1) {
+    ASSERT(last_frame_ <= last, "last_frame: " << last_frame_ <<
+      " is beyond the number of frames: " << trajectory.num_frames());
+    last = last_frame_;
+  }
+  std::vector<int> frames;
+  for (int frame = first_frame_; frame <= last; frame += frame_stride_) {
+    frames.push_back(frame);
+  }
+  for (int index = 0; index < mc->num_analyzers(); ++index) {
+    ASSERT(mc->analyze(index).accumulator().num_values() == 0,
+      "Analyze: " << mc->analyze(index).class_name() << " was updated before");
+  }
+  for (int index = 0; index < mc->num_modifiers(); ++index) {
+    ASSERT(mc->modify(index).accumulator().num_values() == 0,
+      "Modify: " << mc->modify(index).class_name() << " was updated before");
+  }
+  int num_threads = 1;
+  #ifdef _OPENMP
+    num_threads = num_threads_;
+    if (num_threads == -1) {
+      num_threads = omp_get_max_threads();
+    }
+  #endif // _OPENMP
+  num_threads = std::max(1, std::min(num_threads,
+                                     static_cast<int>(frames.size())));
+  if (num_threads > 1) {
+    for (int index = 0; index < mc->num_analyzers(); ++index) {
+      ASSERT(mc->analyze(index).is_mergeable(), "Analyze: " <<
+        mc->analyze(index).class_name() << " cannot be merged. " <<
+        "Use num_threads=1.");
+    }
+    for (int index = 0; index < mc->num_modifiers(); ++index) {
+      ASSERT(mc->modify(index).is_mergeable(), "Modify: " <<
+        mc->modify(index).class_name() << " cannot be merged. " <<
+        "Use num_threads=1.");
+    }
+  }
+
+  // The first thread updates the original, and the others update copies.
+  std::vector<std::shared_ptr<MonteCarlo> > copies;
+  if (num_threads > 1) {
+    std::stringstream ss;
+    mc->serialize(ss);
+    const std::string serialized = ss.str();
+    for (int thread = 1; thread < num_threads; ++thread) {
+      std::stringstream copy(serialized);
+      copies.push_back(std::make_shared<MonteCarlo>(copy));
+    }
+  }
+  std::vector<std::string> errors(num_threads);
+  #pragma omp parallel num_threads(num_threads)
+  {
+    int thread = 0;
+    #ifdef _OPENMP
+      thread = omp_get_thread_num();
+    #endif // _OPENMP
+    MonteCarlo * thread_mc = mc;
+    if (thread > 0) {
+      thread_mc = copies[thread - 1].get();
+    }
+    const int num_frames = static_cast<int>(frames.size());
+    const int begin = num_frames*thread/num_threads;
+    const int end = num_frames*(thread + 1)/num_threads;
+    TrajectoryFrame data;
+    try {
+      for (int index = begin; index < end; ++index) {
+        trajectory.load(frames[index],
+          thread_mc->get_system()->get_configuration(), &data);
+        update_(thread_mc);
+      }
+    } catch (const std::exception& e) {
+      errors[thread] = e.what();
+    }
+  }
+  for (const std::string& error : errors) {
+    ASSERT(error.empty(), error);
+  }
+  for (const std::shared_ptr<MonteCarlo>& copy : copies) {
+    mc->get_analyze_factory()->merge(*copy->get_analyze_factory());
+    mc->get_modify_factory()->merge(*copy->get_modify_factory());
+  }
+
+  // As in serial, end with the last frame (e.g., for normalization by the
+  // density).
+  if (num_threads > 1) {
+    TrajectoryFrame data;
+    trajectory.load(frames.back(), mc->get_system()->get_configuration(),
+                    &data);
+    Acceptance acceptance;
+    mc->get_criteria()->update_state(mc->system(), acceptance);
+  }
+  mc->write_to_file();
+}
+
+}  // namespace feasst
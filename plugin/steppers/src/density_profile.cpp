@@ -115,6 +115,15 @@ std::string DensityProfile::write(const Criteria& criteria,
   return ss.str();
 }
 
+void DensityProfile::merge(const Stepper& stepper) {
+  Analyze::merge(stepper);
+  const DensityProfile& profile = dynamic_cast<const DensityProfile&>(stepper);
+  ASSERT(data_.size() == profile.data_.size(), "size mismatch");
+  for (int type = 0; type < static_cast<int>(data_.size()); ++type) {
+    data_[type].merge(profile.data_[type]);
+  }
+}
+
 void DensityProfile::serialize(std::ostream& ostr) const {
   Stepper::serialize(ostr);
   feasst_serialize_version(9687, ostr);
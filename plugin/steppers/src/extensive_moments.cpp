@@ -87,6 +87,20 @@ std::string ExtensiveMoments::write(const Criteria& criteria,
   return ss.str();
 }
 
+void ExtensiveMoments::merge(const Stepper& stepper) {
+  Analyze::merge(stepper);
+  const ExtensiveMoments& extensive =
+    dynamic_cast<const ExtensiveMoments&>(stepper);
+  ASSERT(moments_.size() == extensive.moments_.size(), "size mismatch");
+  for (int p = 0; p < static_cast<int>(moments_.size()); ++p) {
+  for (int m = 0; m < static_cast<int>(moments_[p].size()); ++m) {
+  for (int k = 0; k < static_cast<int>(moments_[p][m].size()); ++k) {
+  for (int j = 0; j < static_cast<int>(moments_[p][m][k].size()); ++j) {
+  for (int i = 0; i < static_cast<int>(moments_[p][m][k][j].size()); ++i) {
+    moments_[p][m][k][j][i].merge(extensive.moments_[p][m][k][j][i]);
+  }}}}}
+}
+
 void ExtensiveMoments::serialize(std::ostream& ostr) const {
   Stepper::serialize(ostr);
   feasst_serialize_version(1647, ostr);
@@ -64,6 +64,11 @@ std::string HeatCapacity::write(const Criteria& criteria,
   return ss.str();
 }
 
+void HeatCapacity::merge(const Stepper& stepper) {
+  Analyze::merge(stepper);
+  energy_.merge(dynamic_cast<const HeatCapacity&>(stepper).energy_);
+}
+
 void HeatCapacity::serialize(std::ostream& ostr) const {
   Stepper::serialize(ostr);
   feasst_serialize_version(2347, ostr);
@@ -2,6 +2,7 @@
 #include "utils/include/serialize.h"
 #include "configuration/include/file_vmd.h"
 #include "configuration/include/file_xyz.h"
+#include "configuration/include/file_trajectory.h"
 #include "monte_carlo/include/criteria.h"
 #include "steppers/include/movie.h"
 
@@ -21,8 +22,12 @@ Movie::Movie(argtype * args) : AnalyzeWriteOnly(args) {
   set_append();
   ASSERT(!output_file().empty(), "file name is required");
   args->insert({"append", "true"}); // always append
-  xyz_ = std::make_unique<FileXYZ>(args);
-  vmd_ = std::make_unique<FileVMD>(args);
+  if (boolean("compressed", args, false)) {
+    trajectory_ = std::make_unique<FileTrajectory>(args);
+  } else {
+    xyz_ = std::make_unique<FileXYZ>(args);
+    vmd_ = std::make_unique<FileVMD>(args);
+  }
 }
 Movie::Movie(argtype args) : Movie(&args) { feasst_check_all_used(args); }
 Movie::~Movie() {}
@@ -34,6 +39,13 @@ void Movie::initialize(Criteria * criteria,
   ASSERT(!name.empty(), "file name required. Did you forget to " <<
     "Analyze::set_output_file()?");
 
+  if (trajectory_) {
+    if (state() == criteria->state()) {
+      trajectory_->write(name, configuration(*system));
+    }
+    return;
+  }
+
   // write xyz
   if (state() == criteria->state()) {
     xyz_->write(name, configuration(*system));
@@ -49,22 +61,30 @@ std::string Movie::write(const Criteria& criteria,
     const System& system,
     const TrialFactory& trial_factory) {
   // ensure the following order matches the header from initialization.
-  xyz_->write(output_file(criteria), configuration(system));
+  if (trajectory_) {
+    trajectory_->write(output_file(criteria), configuration(system));
+  } else {
+    xyz_->write(output_file(criteria), configuration(system));
+  }
   return std::string("");
 }
 
 void Movie::serialize(std::ostream& ostr) const {
   Stepper::serialize(ostr);
-  feasst_serialize_version(536, ostr);
+  feasst_serialize_version(537, ostr);
   feasst_serialize(xyz_, ostr);
   feasst_serialize(vmd_, ostr);
+  feasst_serialize(trajectory_, ostr);
 }
 
 Movie::Movie(std::istream& istr) : AnalyzeWriteOnly(istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(version == 536, "version mismatch:" << version);
+  ASSERT(version >= 536 && version <= 537, "version mismatch:" << version);
   feasst_deserialize(xyz_, istr);
   feasst_deserialize(vmd_, istr);
+  if (version >= 537) {
+    feasst_deserialize(trajectory_, istr);
+  }
 }
 
 }  // namespace feasst
@@ -219,6 +219,20 @@ const grtype& PairDistribution::radial(const Configuration& config) {
   return radial_;
 }
 
+void PairDistribution::merge(const Stepper& stepper) {
+  Modify::merge(stepper);
+  const PairDistribution& pair = dynamic_cast<const PairDistribution&>(stepper);
+  for (int itype = 0; itype < static_cast<int>(inter_.radial_.size());
+       ++itype) {
+    for (int jtype = 0; jtype < static_cast<int>(inter_.radial_.size());
+         ++jtype) {
+      inter_.radial_[itype][jtype].merge(pair.inter_.radial_[itype][jtype]);
+      intra_.radial_[itype][jtype].merge(pair.intra_.radial_[itype][jtype]);
+    }
+  }
+  num_updates_ += pair.num_updates_;
+}
+
 void PairDistribution::serialize(std::ostream& ostr) const {
   Stepper::serialize(ostr);
   feasst_serialize_version(2034, ostr);
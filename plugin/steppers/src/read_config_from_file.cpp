@@ -9,6 +9,10 @@ namespace feasst {
 
 ReadConfigFromFile::ReadConfigFromFile(argtype * args) : ModifyUpdateOnly(args) {
   input_file_ = str("input_file", args);
+  first_frame_ = integer("first_frame", args, 0);
+  frame_stride_ = integer("frame_stride", args, 1);
+  ASSERT(first_frame_ >= 0, "first_frame: " << first_frame_);
+  ASSERT(frame_stride_ > 0, "frame_stride: " << frame_stride_);
   xyz_ = FileXYZ(args);
 }
 ReadConfigFromFile::ReadConfigFromFile(argtype args) : ReadConfigFromFile(&args) {
@@ -32,6 +36,18 @@ void ReadConfigFromFile::load_(Criteria * criteria, System * system) {
     return;
   }
   Configuration * config = system->get_configuration();
+  if (trajectory_) {
+    if (frame_ < trajectory_->num_frames()) {
+      trajectory_->load_frame(frame_, config);
+      Acceptance acc_;
+      criteria->update_state(*system, acc_);
+      frame_ += frame_stride_;
+    }
+    if (frame_ >= trajectory_->num_frames()) {
+      set_complete_next_update_ = true;
+    }
+    return;
+  }
   if (xyz_.load_frame(file_, config)) {
     Acceptance acc_;
     criteria->update_state(*system, acc_);
@@ -45,8 +61,18 @@ void ReadConfigFromFile::load_(Criteria * criteria, System * system) {
 void ReadConfigFromFile::initialize(Criteria * criteria,
     System * system,
     TrialFactory * trial_factory) {
-  file_.open(input_file_);
-  ASSERT(file_.good(), "cannot open " << input_file_);
+  if (FileTrajectory::is_format(input_file_)) {
+    trajectory_ = std::make_unique<FileTrajectory>();
+    trajectory_->open(input_file_);
+    if (frame_ == 0) {
+      frame_ = first_frame_;
+    }
+  } else {
+    ASSERT(first_frame_ == 0 && frame_stride_ == 1,
+      "first_frame and frame_stride require a FileTrajectory");
+    file_.open(input_file_);
+    ASSERT(file_.good(), "cannot open " << input_file_);
+  }
   load_(criteria, system);
 }
 
@@ -60,18 +86,28 @@ void ReadConfigFromFile::update(Criteria * criteria,
 
 void ReadConfigFromFile::serialize(std::ostream& ostr) const {
   Stepper::serialize(ostr);
-  feasst_serialize_version(6782, ostr);
+  feasst_serialize_version(6783, ostr);
   feasst_serialize(input_file_, ostr);
   feasst_serialize(set_complete_next_update_, ostr);
   feasst_serialize_fstobj(xyz_, ostr);
+  feasst_serialize(first_frame_, ostr);
+  feasst_serialize(frame_stride_, ostr);
+  feasst_serialize(frame_, ostr);
 }
 
 ReadConfigFromFile::ReadConfigFromFile(std::istream& istr) : ModifyUpdateOnly(istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(version == 6782, "version mismatch:" << version);
+  ASSERT(version >= 6782 && version <= 6783, "version mismatch:" << version);
   feasst_deserialize(&input_file_, istr);
   feasst_deserialize(&set_complete_next_update_, istr);
   feasst_deserialize_fstobj(&xyz_, istr);
+  first_frame_ = 0;
+  frame_stride_ = 1;
+  if (version >= 6783) {
+    feasst_deserialize(&first_frame_, istr);
+    feasst_deserialize(&frame_stride_, istr);
+    feasst_deserialize(&frame_, istr);
+  }
 }
 
 }  // namespace feasst
@@ -126,17 +126,34 @@ std::string Scattering::write(const Criteria& criteria,
   return ss.str();
 }
 
+void Scattering::merge(const Stepper& stepper) {
+  Analyze::merge(stepper);
+  const Scattering& scattering = dynamic_cast<const Scattering&>(stepper);
+  ASSERT(iq_.size() == scattering.iq_.size(), "size mismatch");
+  for (int k = 0; k < static_cast<int>(iq_.size()); ++k) {
+    iq_[k].merge(scattering.iq_[k]);
+  }
+}
+
 void Scattering::serialize(std::ostream& ostr) const {
   Stepper::serialize(ostr);
-  feasst_serialize_version(6301, ostr);
+  feasst_serialize_version(6302, ostr);
   feasst_serialize(num_frequency_, ostr);
+  feasst_serialize_fstobj(kvecs_, ostr);
+  feasst_serialize(site_ff_, ostr);
+  feasst_serialize_fstobj(iq_, ostr);
 }
 
 Scattering::Scattering(std::istream& istr)
   : Analyze(istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(6301 == version, "version mismatch:" << version);
+  ASSERT(version >= 6301 && version <= 6302, "version mismatch:" << version);
   feasst_deserialize(&num_frequency_, istr);
+  if (version >= 6302) {
+    feasst_deserialize_fstobj(&kvecs_, istr);
+    feasst_deserialize(&site_ff_, istr);
+    feasst_deserialize_fstobj(&iq_, istr);
+  }
 }
 
 }  // namespace feasst
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include "utils/test/utils.h"
+#include "math/include/accumulator.h"
+#include "monte_carlo/include/monte_carlo.h"
+#include "monte_carlo/include/analyze_factory.h"
+#include "steppers/include/density_profile.h"
+#include "steppers/include/heat_capacity.h"
+#include "steppers/include/pair_distribution.h"
+#include "steppers/include/analyze_trajectory.h"
+
+namespace feasst {
+
+TEST(AnalyzeTrajectory, serialize) {
+  auto action = MakeAnalyzeTrajectory({{"input_file", "tmp/traj.xyz"},
+    {"num_threads", "2"}, {"frame_stride", "2"}});
+  auto action2 = test_serialize<AnalyzeTrajectory, Action>(*action);
+}
+
+// Compare the analysis of a FileXYZ and FileTrajectory with one and multiple
+// threads.
+TEST(AnalyzeTrajectory, threads) {
+  for (const std::string file : {"tmp/analyze_traj.xyz",
+                                 "tmp/analyze_traj.fsttrj"}) {
+    std::remove(file.c_str());
+  }
+  auto mc = MakeMonteCarlo({{
+    {"Configuration", {{"cubic_side_length", "8"},
+      {"particle_type0", "../particle/lj.fstprt"},
+      {"add_particles_of_type0", "10"}}},
+    {"Potential", {{"Model", "LennardJones"}}},
+    {"ThermoParams", {{"beta", "1"}, {"chemical_potential0", "1"}}},
+    {"Metropolis", {{}}},
+    {"TrialTranslate", {{}}},
+    {"TrialAdd", {{"particle_type", "0"}}},
+    {"Movie", {{"output_file", "tmp/analyze_traj.xyz"},
+               {"trials_per_write", "1"}}},
+    {"Movie", {{"output_file", "tmp/analyze_traj.fsttrj"},
+               {"trials_per_write", "1"}, {"compressed", "true"}}},
+  }});
+  mc->attempt(30);
+  for (const std::string file : {"tmp/analyze_traj.xyz",
+                                 "tmp/analyze_traj.fsttrj"}) {
+    std::vector<Accumulator> num_particles;
+    std::vector<std::vector<std::vector<std::vector<double> > > > profiles;
+    std::vector<grtype> grs;
+    std::vector<std::string> scattering;
+    std::vector<Accumulator> energies;
+    for (const std::string num_threads : {"1", "3"}) {
+      auto mc2 = MakeMonteCarlo({{
+        {"Configuration", {{"cubic_side_length", "8"},
+          {"particle_type0", "../particle/lj.fstprt"}}},
+        {"Potential", {{"VisitModel", "DontVisitModel"}}},
+        {"ThermoParams", {{"beta", "1"}, {"chemical_potential0", "1"}}},
+        {"Metropolis", {{}}},
+        {"NumParticles", {{"output_file", "tmp/analyze_traj_num.csv"}}},
+        {"DensityProfile", {{"output_file", "tmp/analyze_traj_dens.csv"}}},
+        {"Scattering", {{"num_frequency", "2"},
+                        {"output_file", "tmp/analyze_traj_iq.csv"}}},
+        {"HeatCapacity", {{"output_file", "tmp/analyze_traj_cv.csv"}}},
+        {"PairDistribution", {{"output_file", "tmp/analyze_traj_gr.csv"}}},
+        {"AnalyzeTrajectory", {{"input_file", file},
+          {"num_threads", num_threads},
+          {"first_frame", "1"}, {"frame_stride", "2"}}},
+      }});
+      num_particles.push_back(mc2->analyze(0).accumulator());
+      profiles.push_back(DensityProfile(mc2->analyze(1)).profile());
+      scattering.push_back(mc2->get_analyze_factory()->get_analyze(2)->write(
+        mc2->criteria(), mc2->system(), mc2->trials()));
+      energies.push_back(HeatCapacity(mc2->analyze(3)).energy());
+      grs.push_back(PairDistribution(mc2->modify(0)).radial(
+        mc2->configuration()));
+    }
+    EXPECT_EQ(15, num_particles[0].num_values());
+    EXPECT_EQ(num_particles[0].num_values(), num_particles[1].num_values());
+    EXPECT_NEAR(num_particles[0].average(), num_particles[1].average(),
+                NEAR_ZERO);
+    EXPECT_GT(num_particles[0].max(), 10);
+    EXPECT_EQ(profiles[0], profiles[1]);
+    EXPECT_EQ(scattering[0], scattering[1]);
+    EXPECT_EQ(15, energies[1].num_values());
+    EXPECT_NEAR(energies[0].average(), energies[1].average(), NEAR_ZERO);
+    ASSERT_EQ(grs[0].size(), grs[1].size());
+    for (int bin = 0; bin < static_cast<int>(grs[0].size()); ++bin) {
+      EXPECT_NEAR(grs[0][bin].second[0][0], grs[1][bin].second[0][0],
+                  NEAR_ZERO);
+    }
+  }
+
+  // The Analyze must not have been updated before.
+  TRY(
+    auto mc3 = MakeMonteCarlo({{
+      {"Configuration", {{"cubic_side_length", "8"},
+        {"particle_type0", "../particle/lj.fstprt"}}},
+      {"Potential", {{"VisitModel", "DontVisitModel"}}},
+      {"ThermoParams", {{"beta", "1"}, {"chemical_potential0", "1"}}},
+      {"Metropolis", {{}}},
+      {"NumParticles", {{}}},
+      {"AnalyzeTrajectory", {{"input_file", "tmp/analyze_traj.xyz"}}},
+      {"AnalyzeTrajectory", {{"input_file", "tmp/analyze_traj.xyz"}}},
+    }});
+    CATCH_PHRASE("was updated before");
+  );
+
+  // With threads, the Analyze must be mergeable.
+  TRY(
+    auto mc4 = MakeMonteCarlo({{
+      {"Configuration", {{"cubic_side_length", "8"},
+        {"particle_type0", "../particle/lj.fstprt"}}},
+      {"Potential", {{"VisitModel", "DontVisitModel"}}},
+      {"ThermoParams", {{"beta", "1"}, {"chemical_potential0", "1"}}},
+      {"Metropolis", {{}}},
+      {"MeanSquaredDisplacement", {{}}},
+      {"AnalyzeTrajectory", {{"input_file", "tmp/analyze_traj.xyz"},
+                             {"num_threads", "2"}}},
+    }});
+    CATCH_PHRASE("cannot be merged");
+  );
+}
+
+}  // namespace feasst
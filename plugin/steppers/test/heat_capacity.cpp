@@ -1,4 +1,6 @@
 #include "utils/test/utils.h"
+#include "math/include/accumulator.h"
+#include "monte_carlo/include/monte_carlo.h"
 #include "steppers/include/heat_capacity.h"
 
 namespace feasst {
@@ -8,4 +10,36 @@ TEST(HeatCapacity, serialize) {
   auto an2 = test_serialize<HeatCapacity, Analyze>(*an);
 }
 
+// Merging the updates of two copies is the same as updating one in serial.
+TEST(HeatCapacity, merge) {
+  auto mc = MakeMonteCarlo({{
+    {"RandomMT19937", {{"seed", "123"}}},
+    {"Configuration", {{"cubic_side_length", "8"},
+      {"particle_type0", "../particle/lj.fstprt"},
+      {"add_particles_of_type0", "10"}}},
+    {"Potential", {{"Model", "LennardJones"}}},
+    {"ThermoParams", {{"beta", "1"}}},
+    {"Metropolis", {{}}},
+    {"TrialTranslate", {{}}},
+  }});
+  auto serial = MakeHeatCapacity();
+  auto first = MakeHeatCapacity();
+  auto second = MakeHeatCapacity();
+  for (int attempt = 0; attempt < 41; ++attempt) {
+    mc->attempt(1);
+    serial->update(mc->criteria(), mc->system(), mc->trials());
+    if (attempt < 17) {
+      first->update(mc->criteria(), mc->system(), mc->trials());
+    } else {
+      second->update(mc->criteria(), mc->system(), mc->trials());
+    }
+  }
+  first->merge(*second);
+  EXPECT_EQ(41, first->energy().num_values());
+  EXPECT_NEAR(serial->energy().average(), first->energy().average(), 1e-12);
+  EXPECT_NEAR(serial->energy().stdev(), first->energy().stdev(), 1e-12);
+  EXPECT_EQ(serial->write(mc->criteria(), mc->system(), mc->trials()),
+            first->write(mc->criteria(), mc->system(), mc->trials()));
+}
+
 }  // namespace feasst
@@ -1,4 +1,22 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
 #include "utils/test/utils.h"
+#include "utils/include/timer.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/configuration.h"
+#include "configuration/include/file_trajectory.h"
+#include "system/include/lennard_jones.h"
+#include "system/include/visit_model_cell.h"
+#include "system/include/potential.h"
+#include "system/include/thermo_params.h"
+#include "monte_carlo/include/monte_carlo.h"
+#include "monte_carlo/include/metropolis.h"
+#include "monte_carlo/include/trial_translate.h"
+#include "monte_carlo/include/trial_add.h"
+#include "monte_carlo/include/trial_transfer.h"
+#include "monte_carlo/include/run.h"
+#include "monte_carlo/include/remove_trial.h"
 #include "steppers/include/movie.h"
 
 namespace feasst {
@@ -9,4 +27,53 @@ TEST(Movie, serialize) {
   //auto movie2 = test_serialize<Movie, Analyze>(*movie);
 }
 
+// Compare the size and the time to write the Movie of a grand canonical
+// simulation of 10^4 LJ particles, with FileXYZ or compressed.
+TEST(Movie, compressed_BENCHMARK_LONG) {
+  std::map<std::string, double> seconds, bytes;
+  for (const std::string format : {"none", "xyz", "compressed"}) {
+    const std::string file = "tmp/movie_bench_" + format;
+    std::remove(file.c_str());
+    MonteCarlo mc;
+    mc.set(MakeRandomMT19937({{"seed", "123"}}));
+    mc.add(MakeConfiguration({{"cubic_side_length", "30"},
+      {"particle_type0", "../particle/lj.fstprt"}}));
+    mc.add(MakePotential(MakeLennardJones(),
+      MakeVisitModelCell({{"min_length", "max_cutoff"}})));
+    mc.set(MakeThermoParams({{"beta", "1.2"}, {"chemical_potential", "-1."}}));
+    mc.set(MakeMetropolis());
+    mc.add(MakeTrialTranslate({{"tunable_param", "0.5"}}));
+    mc.add(MakeTrialAdd({{"particle_type", "0"}}));
+    mc.run(MakeRun({{"until_num_particles", "10000"}}));
+    mc.run(MakeRemoveTrial({{"name", "TrialAdd"}}));
+    mc.add(MakeTrialTransfer({{"particle_type", "0"}, {"weight", "0.2"}}));
+    if (format == "xyz") {
+      mc.add(MakeMovie({{"trials_per_write", "1e3"}, {"output_file", file}}));
+    } else if (format == "compressed") {
+      mc.add(MakeMovie({{"trials_per_write", "1e3"}, {"output_file", file},
+        {"compressed", "true"}}));
+    }
+    const double begin = cpu_hours();
+    mc.attempt(1e5);
+    seconds[format] = 3600.*(cpu_hours() - begin);
+    if (format != "none") {
+      std::ifstream stream(file, std::ifstream::ate);
+      bytes[format] = stream.tellg();
+      INFO(format << " bytes: " << bytes[format] << " seconds: " <<
+           seconds[format] - seconds["none"]);
+    }
+    if (format == "compressed") {
+      FileTrajectory traj;
+      traj.open(file);
+      EXPECT_EQ(101, traj.num_frames());
+      auto config = MakeConfiguration({{"cubic_side_length", "30"},
+        {"particle_type0", "../particle/lj.fstprt"}});
+      traj.load_frame(100, config.get());
+      EXPECT_EQ(mc.configuration().num_particles(), config->num_particles());
+    }
+  }
+  INFO("trials without a Movie seconds: " << seconds["none"]);
+  EXPECT_LT(bytes["compressed"], 0.3*bytes["xyz"]);
+}
+
 }  // namespace feasst
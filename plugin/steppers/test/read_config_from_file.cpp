@@ -4,6 +4,8 @@
 #include "configuration/include/physical_constants.h"
 #include "monte_carlo/include/monte_carlo.h"
 #include "monte_carlo/include/criteria.h"
+#include "configuration/include/file_xyz.h"
+#include "configuration/include/file_trajectory.h"
 #include "steppers/include/read_config_from_file.h"
 
 namespace feasst {
@@ -34,4 +36,65 @@ TEST(ReadConfigFromFile, test) {
   EXPECT_TRUE(mc->criteria().is_complete());
 }
 
+TEST(ReadConfigFromFile, compressed) {
+  for (const std::string file : {"tmp/read_compressed.xyz",
+                                 "tmp/read_compressed.fsttrj"}) {
+    std::remove(file.c_str());
+  }
+  auto mc = MakeMonteCarlo({{
+    {"Configuration", {{"cubic_side_length", "8"},
+      {"particle_type0", "../particle/lj.fstprt"},
+      {"add_particles_of_type0", "5"}}},
+    {"Potential", {{"Model", "LennardJones"}}},
+    {"ThermoParams", {{"beta", "1"}, {"chemical_potential0", "1"}}},
+    {"Metropolis", {{}}},
+    {"TrialTranslate", {{}}},
+    {"TrialTransfer", {{"particle_type", "0"}}},
+    {"Movie", {{"output_file", "tmp/read_compressed.xyz"},
+               {"trials_per_write", "1"}}},
+    {"Movie", {{"output_file", "tmp/read_compressed.fsttrj"},
+               {"trials_per_write", "1"}, {"compressed", "true"}}},
+  }});
+  mc->attempt(10);
+  FileTrajectory traj;
+  traj.open("tmp/read_compressed.fsttrj");
+  EXPECT_EQ(11, traj.num_frames());
+
+  // read frames 1, 4, 7 and 10, and compare with the xyz file.
+  auto mc2 = MakeMonteCarlo({{
+    {"Configuration", {{"cubic_side_length", "8"},
+      {"particle_type0", "../particle/lj.fstprt"}}},
+    {"Potential", {{"VisitModel", "DontVisitModel"}}},
+    {"ThermoParams", {{"beta", "1"}, {"chemical_potential0", "1"}}},
+    {"Metropolis", {{}}},
+    {"ReadConfigFromFile", {{"input_file", "tmp/read_compressed.fsttrj"},
+      {"first_frame", "1"}, {"frame_stride", "3"}}},
+  }});
+  auto xyz_config = MakeConfiguration({{"cubic_side_length", "8"},
+    {"particle_type0", "../particle/lj.fstprt"}});
+  std::ifstream xyz_file("tmp/read_compressed.xyz");
+  FileXYZ xyz;
+  xyz.load_frame(xyz_file, xyz_config.get());
+  for (int frame = 1; frame <= 10; ++frame) {
+    xyz.load_frame(xyz_file, xyz_config.get());
+    if (frame % 3 == 1) {
+      const Configuration& config = mc2->configuration();
+      EXPECT_EQ(xyz_config->num_particles(), config.num_particles());
+      if (config.num_particles() > 0) {
+        EXPECT_NEAR(xyz_config->particle(0).site(0).position().coord(1),
+                    config.particle(0).site(0).position().coord(1), 1e-4);
+      }
+      EXPECT_FALSE(mc2->criteria().is_complete());
+      mc2->attempt(1);
+    }
+  }
+  EXPECT_TRUE(mc2->criteria().is_complete());
+  TRY(
+    MakeReadConfigFromFile({{"input_file", "tmp/read_compressed.xyz"},
+      {"first_frame", "1"}})->initialize(
+        mc2->get_criteria(), mc2->get_system(), NULL);
+    CATCH_PHRASE("require a FileTrajectory");
+  );
+}
+
 }  // namespace feasst
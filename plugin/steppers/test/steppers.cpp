@@ -1,14 +1,26 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
 #include "utils/test/utils.h"
+#include "math/include/accumulator.h"
+#include "math/include/random_mt19937.h"
 #include "system/include/lennard_jones.h"
 #include "system/include/long_range_corrections.h"
 #include "system/include/potential.h"
+#include "system/include/visit_model_cell.h"
 #include "system/include/thermo_params.h"
 #include "monte_carlo/test/monte_carlo_utils.h"
 #include "monte_carlo/include/monte_carlo.h"
 #include "monte_carlo/include/metropolis.h"
 #include "monte_carlo/include/trial_translate.h"
+#include "monte_carlo/include/trial_transfer.h"
 #include "steppers/include/log.h"
 #include "steppers/include/movie.h"
+#include "steppers/include/energy.h"
+#include "steppers/include/scattering.h"
 
 namespace feasst {
 
@@ -28,4 +40,93 @@ TEST(Steppers, CheckForSameFileName) {
   );
 }
 
+std::string read_file(const std::string& file_name) {
+  std::ifstream file(file_name);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+TEST(Steppers, asynchronous) {
+  for (const std::string async : {"false", "true"}) {
+    std::remove(("tmp/async_" + async + ".xyz").c_str());
+    std::remove(("tmp/async_" + async + ".csv").c_str());
+    MonteCarlo mc;
+    mc.set(MakeRandomMT19937({{"seed", "1234"}}));
+    mc.add(MakeConfiguration({{"cubic_side_length", "8"},
+      {"particle_type0", "../particle/lj.fstprt"},
+      {"add_particles_of_type0", "20"}}));
+    mc.add(MakePotential(MakeLennardJones()));
+    mc.set(MakeThermoParams({{"beta", "1.2"}, {"chemical_potential", "1."}}));
+    mc.set(MakeMetropolis());
+    mc.add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "1."}}));
+    // transfers change the particles in the snapshots
+    mc.add(MakeTrialTransfer({{"particle_type", "0"}, {"weight", "0.1"}}));
+    mc.add(MakeMovie({{"trials_per_write", "1e2"}, {"asynchronous", async},
+      {"output_file", "tmp/async_" + async + ".xyz"}}));
+    mc.add(MakeLog({{"trials_per_write", "1e2"}, {"asynchronous", async},
+      {"output_file", "tmp/async_" + async + ".csv"}}));
+    mc.add(MakeEnergy({{"trials_per_update", "10"}, {"asynchronous", async},
+      {"asynchronous_queue", "1"}}));
+    mc.attempt(1e3);
+    EXPECT_EQ(100, mc.analyze(2).accumulator().num_values());
+    if (async == "true") {
+      EXPECT_TRUE(mc.analyze(0).is_asynchronous());
+      EXPECT_EQ(read_file("tmp/async_false.xyz"),
+                read_file("tmp/async_true.xyz"));
+      EXPECT_EQ(read_file("tmp/async_false.csv"),
+                read_file("tmp/async_true.csv"));
+      auto mc2 = test_serialize_unique(mc);
+      EXPECT_TRUE(mc2->analyze(1).is_asynchronous());
+      mc2->attempt(1e2);
+    }
+  }
+  TRY(
+    MonteCarlo mc;
+    mc.add(MakeLog({{"asynchronous", "true"}, {"multistate", "true"}}));
+    CATCH_PHRASE("asynchronous is not implemented for multistate");
+  );
+}
+
+// Compare the wall time of the trials with synchronous and asynchronous
+// Scattering and Movie, which is only expected to be shorter when another
+// core is available for the background thread.
+TEST(Steppers, asynchronous_BENCHMARK_LONG) {
+  const int cores = std::thread::hardware_concurrency();
+  INFO("cores " << cores);
+  std::map<std::string, double> seconds;
+  for (const std::string async : {"false", "true"}) {
+    MonteCarlo mc;
+    mc.set(MakeRandomMT19937({{"seed", "1234"}}));
+    mc.add(MakeConfiguration({{"cubic_side_length", "20"},
+      {"particle_type0", "../particle/lj.fstprt"},
+      {"add_particles_of_type0", "1000"}}));
+    mc.add(MakePotential(MakeLennardJones(),
+      MakeVisitModelCell({{"min_length", "3"}})));
+    mc.set(MakeThermoParams({{"beta", "1.2"}, {"chemical_potential", "1."}}));
+    mc.set(MakeMetropolis());
+    mc.add(MakeTrialTranslate({{"weight", "1."}, {"tunable_param", "1."}}));
+    mc.add(MakeScattering({{"trials_per_update", "1e3"}, {"num_frequency", "6"},
+      {"trials_per_write", "1e5"}, {"asynchronous", async},
+      {"output_file", "tmp/async_bench_" + async + "_iq.csv"}}));
+    mc.add(MakeMovie({{"trials_per_write", "1e3"}, {"asynchronous", async},
+      {"output_file", "tmp/async_bench_" + async + ".xyz"}}));
+    const auto begin = std::chrono::steady_clock::now();
+    mc.attempt(1e5);
+    mc.write_to_file();
+    const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - begin;
+    seconds[async] = duration.count();
+    INFO("asynchronous " << async << " " << seconds[async] << "s");
+  }
+  // the analysis overlaps with the trials only with more than one core
+  if (cores > 1) {
+    EXPECT_LT(seconds["true"], seconds["false"]);
+  }
+  EXPECT_EQ(read_file("tmp/async_bench_false_iq.csv"),
+            read_file("tmp/async_bench_true_iq.csv"));
+  EXPECT_EQ(read_file("tmp/async_bench_false.xyz"),
+            read_file("tmp/async_bench_true.xyz"));
+}
+
 }  // namespace feasst
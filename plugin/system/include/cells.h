@@ -21,6 +21,8 @@ class Cells {
   /// Create the number, length and neighbors.
   /// By default, abort if there aren't more than \f$3^D\f$ cells,
   /// where D is the dimension.
+  /// The neighbors of each cell, including itself, are unique, as in
+  /// SortedCells, even with only two cells in a dimension.
   void create(const double min_length, const std::vector<double> side_lengths);
 
   /// Return the number.
@@ -92,6 +94,7 @@ class Cells {
   /// Build neighbors. HWH optimize this
   void build_neighbors_2D_();
   void build_neighbors_3D_();
+  void add_neighbor_(const int cell, const int neighbor);
 
   /// Build list of particles in cells.
   void build_particles_();
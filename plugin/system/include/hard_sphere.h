@@ -4,6 +4,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "system/include/model_two_body.h"
 
 namespace feasst {
@@ -34,6 +35,18 @@ class HardSphere : public ModelTwoBody {
     const int type2,
     const ModelParams& model_params) override;
 
+  /// Same as base class, but also flatten the parameter tables.
+  void precompute(const ModelParams& existing) override;
+
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   std::shared_ptr<Model> create(std::istream& istr) const override {
     return std::make_shared<HardSphere>(istr); }
   std::shared_ptr<Model> create(argtype * args) const override {
@@ -41,6 +54,10 @@ class HardSphere : public ModelTwoBody {
   void serialize(std::ostream& ostr) const override;
   explicit HardSphere(std::istream& istr);
   virtual ~HardSphere() {}
+
+ private:
+  // temporary and not serialized
+  std::vector<double> sigma_sq_;
 };
 
 inline std::shared_ptr<HardSphere> MakeHardSphere() {
@@ -5,6 +5,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
 #include "system/include/model_two_body.h"
 
 namespace feasst {
@@ -40,6 +41,18 @@ class LennardJones : public ModelTwoBody {
       const int type2,
       const ModelParams& model_params) override;
 
+  /// Same as base class, but also flatten epsilon and sigma squared.
+  void precompute(const ModelParams& existing) override;
+
+  /// Vectorized implementation of the base class.
+  void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) override;
+
   /// Return the threshold for hard sphere interaction.
   double hard_sphere_threshold() const;
   const double& hard_sphere_threshold_sq() const {
@@ -57,6 +70,9 @@ class LennardJones : public ModelTwoBody {
  protected:
   void serialize_lennard_jones_(std::ostream& ostr) const;
 
+  // flattened tables (temporary and not serialized)
+  std::vector<double> epsilon_, sigma_sq_;
+
  private:
   double hard_sphere_threshold_sq_;
 };
@@ -2,10 +2,12 @@
 #ifndef FEASST_SYSTEM_MODEL_TWO_BODY_H_
 #define FEASST_SYSTEM_MODEL_TWO_BODY_H_
 
+#include <vector>
 #include "system/include/model.h"
 
 namespace feasst {
 
+class ModelParam;
 class VisitModel;
 
 class ModelTwoBody : public Model {
@@ -56,9 +58,46 @@ class ModelTwoBody : public Model {
     Configuration * config,
     VisitModel * visitor) override;
 
+  /**
+    Compute the energies of num pairs, given their squared distances and the
+    types of both sites, and store the result in energy.
+    All pairs are assumed to be within the cutoff.
+
+    By default, energy is called for each pair.
+    Derived classes may override this function to loop over the flattened
+    parameter tables computed in precompute, which removes the virtual call
+    and nested lookup of each pair and allows the compiler to vectorize.
+    Derived classes should fall back to the default when the tables do not
+    match the model_params (e.g., if precompute was not called).
+    As with other precomputed quantities, precompute must be called again
+    after the model parameters are changed.
+   */
+  virtual void energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy);
+
   int num_body() const override { return 2; }
   virtual ~ModelTwoBody() {}
   explicit ModelTwoBody(std::istream& istr) : Model(istr) {}
+
+ protected:
+  /// Store the mixed values of a parameter in a table, flattened by the
+  /// index type1*num_types + type2.
+  void flatten_(const ModelParam& param, std::vector<double> * table);
+
+  /// Return true if the flattened tables match the number of site types.
+  bool is_flat_(const ModelParams& model_params) const;
+
+  /// Return the flattened index of a pair of site types.
+  int flat_index_(const int type1, const int type2) const {
+    return type1*flat_num_types_ + type2; }
+
+  // number of site types in the flattened tables (temporary, not serialized)
+  int flat_num_types_ = 0;
 };
 
 }  // namespace feasst
@@ -0,0 +1,101 @@
+#ifndef FEASST_SYSTEM_PAIR_BATCH_H_
+#define FEASST_SYSTEM_PAIR_BATCH_H_
+
+#include <vector>
+
+namespace feasst {
+
+class Domain;
+class ModelParams;
+class ModelTwoBody;
+
+/**
+  Gather the sites which may interact with a given site into contiguous
+  buffers, so that the minimum image distances, cutoff masks and energies
+  may be computed with vectorizable loops instead of one pair at a time.
+
+  The kernels are compiled for AVX-512, AVX2 and a scalar default when the
+  compiler supports function multiversioning (GCC on x86-64), and the best
+  version is selected at runtime according to the processor.
+
+  The gathered pairs within the cutoff are then staged and their energies
+  are computed with one call to ModelTwoBody::energy_batch.
+
+  This class is temporary storage and is not serialized.
+ */
+class PairBatch {
+ public:
+  PairBatch() {}
+
+  /// Remove all gathered sites and set the dimension.
+  void clear(const int dimension);
+
+  /// Gather a site given its coordinates and type.
+  void add(const std::vector<double>& coord, const int type) {
+    add(coord.data(), type); }
+
+  /// Same as above, but with a pointer to the contiguous coordinates.
+  void add(const double * coord, const int type);
+
+  /// Return the number of gathered sites.
+  int num() const { return static_cast<int>(type_.size()); }
+
+  /// Compute the minimum image squared distances between the given
+  /// coordinates and all gathered sites. The domain must not be tilted.
+  void compute_squared_distance(const std::vector<double>& coord,
+                                const Domain& domain);
+
+  /// Return the squared distances of the last computation.
+  const std::vector<double>& squared_distance() const { return r2_; }
+
+  /// Return the sum of the energies between a site of type1 and the gathered
+  /// sites within the cutoff, after the squared distances were computed.
+  double energy(const int type1,
+                const ModelParams& model_params,
+                const int cutoff_index,
+                ModelTwoBody * model);
+
+  /// Stage a pair within the cutoff, given its squared distance and the type
+  /// of the second site.
+  void add_pair(const double squared_distance, const int type2) {
+    pair_r2_.push_back(squared_distance);
+    pair_type2_.push_back(type2);
+  }
+
+  /// Return the number of staged pairs.
+  int num_pairs() const { return static_cast<int>(pair_r2_.size()); }
+
+  /// Return the sum of the energies of the staged pairs with a site of type1,
+  /// then remove the staged pairs.
+  double pair_energy(const int type1,
+                     const ModelParams& model_params,
+                     ModelTwoBody * model);
+
+ private:
+  std::vector<std::vector<double> > coord_;
+  std::vector<int> type_;
+  std::vector<double> r2_;
+  std::vector<double> side_;
+  std::vector<int> periodic_;
+  std::vector<double> pair_r2_, pair_energy_;
+  std::vector<int> pair_type1_, pair_type2_;
+};
+
+/// Compute the minimum image squared distance, r2, between xyz1 and each of
+/// the num sites with coordinates coord[dim][site], in a cuboid domain.
+void batch_squared_distance(const int num, const int dimension,
+  const double * xyz1, const double * const * coord, const double * side,
+  const int * periodic, double * r2);
+
+/// Compute the Lennard-Jones energy of num pairs with the given squared
+/// distances and site types, given the flattened tables of epsilon and sigma
+/// squared (see ModelTwoBody::energy_batch).
+/// Pairs closer than the hard sphere threshold are NEAR_INFINITY.
+void batch_lennard_jones(const int num, const double * r2,
+  const int * type1, const int * type2, const int num_types,
+  const double * epsilon, const double * sigma_sq,
+  const double hard_sphere_threshold_sq, double * energy);
+
+}  // namespace feasst
+
+#endif  // FEASST_SYSTEM_PAIR_BATCH_H_
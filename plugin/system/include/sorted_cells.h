@@ -0,0 +1,135 @@
+#ifndef FEASST_SYSTEM_SORTED_CELLS_H_
+#define FEASST_SYSTEM_SORTED_CELLS_H_
+
+#include <vector>
+
+namespace feasst {
+
+/**
+  Divide a cuboid domain into cells, as in Cells, but store the sites of all
+  cells in contiguous arrays which are sorted by cell.
+  The particle index, site index, type and packed coordinates of each site
+  are stored in a slot.
+  The slots of each cell are a contiguous block that begins at an offset,
+  followed by a few empty slots so that sites may enter the cell.
+
+  A site moves between cells in constant time by swapping the last site of
+  the old cell into its slot, and then occupying an empty slot of the new
+  cell.
+  If the new cell has no empty slots, or after a number of moves equal to
+  the number of sites, the blocks are sorted again.
+  The blocks are sorted in the Morton (Z-order) of the cell coordinates, so
+  that neighboring cells tend to be near in memory.
+
+  The cell ids and the neighbors of each cell are identical to Cells given
+  the same minimum length and domain sides, except that duplicate neighbors
+  are removed.
+  This class is temporary storage and is not serialized.
+ */
+class SortedCells {
+ public:
+  SortedCells() {}
+
+  /// Create the cells, as in Cells::create.
+  /// If there are not enough cells, num_total is zero.
+  void create(const double min_length, const std::vector<double>& side_lengths);
+
+  /// Return the total number of cells.
+  int num_total() const { return static_cast<int>(begin_.size()); }
+
+  /// Return the number of cells in a dimension.
+  int num(const int dimension) const { return num_[dimension]; }
+
+  /// Return the unique cell number of the scaled coordinates, as in Cells::id.
+  int id(const double * scaled_coord) const;
+
+  /// Return the index of the first neighbor of a cell in neighbor.
+  int neighbor_begin(const int cell) const { return neighbor_begin_[cell]; }
+
+  /// Return the index after the last neighbor of a cell in neighbor.
+  int neighbor_end(const int cell) const { return neighbor_begin_[cell + 1]; }
+
+  /// Return the neighboring cells (including self) of all cells, flattened.
+  const std::vector<int>& neighbor() const { return neighbor_; }
+
+  /// Return the cells in the Morton order of their coordinates.
+  const std::vector<int>& order() const { return order_; }
+
+  /// Return the first slot of a cell.
+  int begin(const int cell) const { return begin_[cell]; }
+
+  /// Return the slot after the last site in a cell.
+  int end(const int cell) const { return end_[cell]; }
+
+  /// Return the particle index of a slot.
+  int particle(const int slot) const { return particle_[slot]; }
+
+  /// Return the site index of a slot.
+  int site(const int slot) const { return site_[slot]; }
+
+  /// Return the site type of a slot.
+  int type(const int slot) const { return type_[slot]; }
+
+  /// Return the packed coordinates of a slot.
+  const double * coord(const int slot) const {
+    return &coord_[slot*dimension()]; }
+
+  /// Return the dimension.
+  int dimension() const { return static_cast<int>(num_.size()); }
+
+  /// Return the number of sites.
+  int num_sites() const { return num_sites_; }
+
+  /// Return the cell of a site, or -1 if the site is not in a cell.
+  int cell(const int particle_index, const int site_index) const;
+
+  /// Add a site to a cell, or move it if already in a cell.
+  /// Also update the packed coordinates and type.
+  void update(const int particle_index, const int site_index, const int cell,
+              const double * coord, const int type);
+
+  /// Add a site which is not in a cell, without placing it in a slot until
+  /// the next sort.
+  /// This is more efficient than update when adding many sites.
+  void add_unsorted(const int particle_index, const int site_index,
+    const int cell, const double * coord, const int type);
+
+  /// Remove a site.
+  void remove(const int particle_index, const int site_index);
+
+  /// Sort the blocks in the Morton order of the cells, and place the sites
+  /// which were added unsorted.
+  void sort();
+
+  /// Return the number of sorts.
+  int num_sorts() const { return num_sorts_; }
+
+  /// Check that the slots and the index of each site are consistent.
+  void check() const;
+
+ private:
+  std::vector<int> num_;
+  std::vector<int> neighbor_, neighbor_begin_;
+  std::vector<int> order_;  // cells in Morton order
+  std::vector<int> begin_, end_, capacity_;  // per cell
+  std::vector<int> particle_, site_, type_, cell_;  // per slot
+  std::vector<double> coord_;  // per slot and dimension
+  std::vector<std::vector<int> > slot_;  // per particle and site
+  int num_sites_ = 0;
+  int num_moves_ = 0;
+  int num_sorts_ = 0;
+  std::vector<int> pending_particle_, pending_site_, pending_type_,
+                   pending_cell_;
+  std::vector<double> pending_coord_;
+
+  int slot_of_(const int particle_index, const int site_index) const;
+  void set_slot_(const int particle_index, const int site_index,
+                 const int slot);
+  void remove_slot_(const int slot);
+  void place_(const int slot, const int particle_index, const int site_index,
+              const int cell, const double * coord, const int type);
+};
+
+}  // namespace feasst
+
+#endif  // FEASST_SYSTEM_SORTED_CELLS_H_
@@ -64,6 +64,22 @@ class System {
   /// Return the dimensionality of the system.
   int dimension(const int config = 0) const;
 
+  /**
+    Return a copy for read-only use on another thread.
+    Nothing is shared with this System, so that this System may continue to
+    change while the copy is read.
+   */
+  System snapshot() const;
+
+  /**
+    Update a snapshot with the given System, of which it is a snapshot.
+    The positions are copied into each Configuration with the same
+    particles and domain, and otherwise the Configuration is deep copied.
+    Similarly, only the stored energies are copied into the same number of
+    Potentials, and otherwise the Potentials are deep copied.
+   */
+  void update_snapshot(const System& system);
+
   //@}
   /** @name Potentails
     Store and retrieve a list of potentials.
@@ -248,6 +264,20 @@ class System {
 
   void synchronize_(const System& system, const Select& perturbed);
 
+  // Resize the number of deep copies of this System used by threads to
+  // compute energies concurrently (e.g., TrialStage).
+  // Call outside of the parallel region.
+  void resize_thread_systems_(const int num_threads);
+
+  // Return the copy for the given thread, after matching its particles and
+  // potential data with this System. The copy is deep copied again when the
+  // particles cannot be matched (e.g., the volume changed).
+  System * synchronize_thread_system_(const int thread);
+
+  // Return the copy for the given thread, without synchronization.
+  System * get_thread_system_(const int thread) {
+    return thread_systems_[thread].get(); }
+
   /// Return the header of the status for periodic output.
   std::string status_header() const;
 
@@ -277,9 +307,12 @@ class System {
   // in a trial, this temporarily stores that reference potential index.
   int ref_used_last_ = -1;
   double delta_volume_previous_ = 1e30;  // implemented for Gibbs ensemble.
+  std::vector<std::shared_ptr<System> > thread_systems_;
 
   PotentialFactory * reference_(const int index, const int config);
   PotentialFactory * potentials_(const int config);
+  void finalize_potentials_(const Select& select, const int config);
+  bool synchronize_particles_(const System& system);
 };
 
 inline std::shared_ptr<System> MakeSystem() {
@@ -61,6 +61,10 @@ class ThermoParams {
   /// Return the chemical potential of the particle type.
   double chemical_potential(const int particle_type = 0) const;
 
+  /// Return the number of chemical potentials.
+  int num_chemical_potentials() const {
+    return static_cast<int>(chemical_potentials_.size()); }
+
   /// Return the dimensionless product of beta and the chemical potential.
   double beta_mu(const int particle_type = 0) const;
 
@@ -70,6 +74,9 @@ class ThermoParams {
   /// Set the pressure.
   void set_pressure(const double pressure);
 
+  /// Return true if the pressure is set.
+  bool is_pressure() const { return pressure_initialized_; }
+
   /// Return a human readable string.
   std::string str() const;
 
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
 #include "system/include/synchronize_data.h"
 
 namespace feasst {
@@ -41,6 +42,13 @@ class VisitModel {
       Must be > 1e10 because too low could result in an accepted trial.
       If -1, ignore energy_cutoff (default: -1).
     - VisitModelInner: derived class VisitModelInner (default: VisitModelInner).
+    - num_threads: number of OpenMP threads used to compute the energy of the
+      entire Configuration, when implemented by the derived class.
+      If -1, use the maximum number of threads.
+      The energy of each thread is summed in order of the threads, so that the
+      energy is reproducible for a given number of threads.
+      Requires the default VisitModelInner without an EnergyMap, and does not
+      use energy_cutoff (default: 1).
    */
   explicit VisitModel(argtype args);
   explicit VisitModel(argtype * args);
@@ -52,6 +60,9 @@ class VisitModel {
 
   double energy_cutoff() const { return energy_cutoff_; }
 
+  /// Return the number of threads for the entire Configuration.
+  int num_threads() const { return num_threads_; }
+
   void set_inner(const std::shared_ptr<VisitModelInner> inner);
 
   const VisitModelInner& inner() const;
@@ -190,6 +201,19 @@ class VisitModel {
   std::shared_ptr<Position> relative_, pbc_, origin_;
   void init_relative_(const Domain& domain);
 
+  // Prepare an inner and positions for each thread, and return the number of
+  // threads to compute the energy of the entire Configuration.
+  int init_threads_(const Domain& domain);
+  VisitModelInner * get_thread_inner_(const int thread) {
+    return thread_inner_[thread].get(); }
+  Position * get_thread_relative_(const int thread) {
+    return thread_relative_[thread].get(); }
+  Position * get_thread_pbc_(const int thread) {
+    return thread_pbc_[thread].get(); }
+
+  // Sum the energy of the threads, in order, into the inner.
+  double sum_thread_energy_();
+
   SynchronizeData data_;  // all data is copied at synchronization
   SynchronizeData manual_data_;  // data is manually copied
 
@@ -201,6 +225,11 @@ class VisitModel {
   int cutoff_index_ = -1;
   int charge_index_ = -1;
   double energy_cutoff_;
+  int num_threads_ = 1;
+
+  // temporary and not serialized
+  std::vector<std::shared_ptr<VisitModelInner> > thread_inner_;
+  std::vector<std::shared_ptr<Position> > thread_relative_, thread_pbc_;
 };
 
 inline std::shared_ptr<VisitModel> MakeVisitModel(argtype args = argtype()) {
@@ -10,7 +10,9 @@
 namespace feasst {
 
 class Cells;
+class PairBatch;
 class Select;
+class SortedCells;
 
 typedef std::map<std::string, std::string> argtype;
 
@@ -28,7 +30,17 @@ class VisitModelCell : public VisitModel {
     - cell_group_index: compute cells only in given group index (default: 0).
     - cell_group: as above, but use the name of the group, not the index.
       Do not use at the same time as cell_group_index (default: "").
+    - batch: if true, gather the sites in the neighboring cells of each site
+      into contiguous buffers and compute the energies with the vectorized
+      kernels of PairBatch.
+      Requires a cuboid domain and the default VisitModelInner without an
+      EnergyMap (default: false).
+    - sorted: if true, also store the sites in a SortedCells, and loop over
+      its contiguous arrays to compute the energy (default: false).
     - VisitModel arguments.
+      If num_threads > 1, the cells are distributed among the threads to
+      compute the energy of the entire Configuration, which is not
+      implemented with batch or sorted.
    */
   explicit VisitModelCell(argtype args);
   explicit VisitModelCell(argtype * args);
@@ -45,6 +57,9 @@ class VisitModelCell : public VisitModel {
   /// Return the cells.
   const Cells& cells() const;
 
+  /// Return the SortedCells, if used.
+  const SortedCells& sorted_cells() const;
+
   /// Return the unique cell number for the position.
   int cell_id(const Domain& domain, const Position& position) const;
 
@@ -88,10 +103,30 @@ class VisitModelCell : public VisitModel {
   std::string min_length_;
   int group_index_;
   std::string group_;
+  bool batch_;
+  bool sorted_;
 
   // temporary and not serialized
   std::shared_ptr<Select> one_site_select_;
   double opt_r2_;
+  std::shared_ptr<PairBatch> pair_batch_;
+  std::shared_ptr<SortedCells> sorted_cells_;
+
+  void batch_add_(const Select& cell_parts, const int first_select_index,
+                  const int part1_index, const Configuration& config);
+  void batch_add_sorted_(const int cell, const int first_slot,
+                         const int part1_index, const Configuration& config);
+  void build_sorted_(Configuration * config);
+  void compute_sorted_(ModelTwoBody * model, const ModelParams& model_params,
+                       Configuration * config);
+  void compute_sorted_(ModelTwoBody * model, const ModelParams& model_params,
+                       const Select& selection, Configuration * config);
+  void compute_batch_(ModelTwoBody * model, const ModelParams& model_params,
+                      Configuration * config);
+  void compute_threads_(ModelTwoBody * model, const ModelParams& model_params,
+                        Configuration * config, const int num_threads);
+  void compute_batch_(ModelTwoBody * model, const ModelParams& model_params,
+                      const Select& selection, Configuration * config);
 
   void position_tracker_(const Select& select, Configuration * config);
   double min_len_(const Configuration& config) const;
@@ -23,6 +23,9 @@ class VisitModelIntra : public VisitModel {
   /** @name Arguments
     - intra_cut: ignore the interaction between a pair of sites when the difference
       between their indices, |i-j| <= intra_cut (integer, default: -1).
+    - VisitModel arguments.
+      If num_threads > 1, the particles are distributed among the threads to
+      compute the energy of the entire Configuration.
    */
   explicit VisitModelIntra(argtype args = argtype());
   explicit VisitModelIntra(argtype * args);
@@ -56,6 +59,11 @@ class VisitModelIntra : public VisitModel {
   //@}
  private:
   int intra_cut_;
+
+  void compute_particle_(const int sp1index, ModelTwoBody * model,
+    const ModelParams& model_params, const Select& selection,
+    const Configuration * config, VisitModelInner * inner, Position * relative,
+    Position * pbc);
 };
 
 inline std::shared_ptr<VisitModelIntra> MakeVisitModelIntra(
@@ -0,0 +1,97 @@
+#ifndef FEASST_SYSTEM_VISIT_MODEL_PACKED_H_
+#define FEASST_SYSTEM_VISIT_MODEL_PACKED_H_
+
+#include <map>
+#include <string>
+#include <memory>
+#include <vector>
+#include "system/include/visit_model.h"
+
+namespace feasst {
+
+typedef std::map<std::string, std::string> argtype;
+
+class PairBatch;
+
+/**
+  Compute two-body interactions by streaming through the contiguous
+  coordinates of the Configuration's PackedSites, instead of visiting each
+  Particle and Site through the VisitModelInner.
+  The PackedSites store is enabled in precompute, if not already.
+  The pairs of each site within the cutoff are staged in a PairBatch, and
+  their energies are computed with one call to ModelTwoBody::energy_batch.
+
+  This visitor is restricted to group index 0, and the default
+  VisitModelInner without an EnergyMap.
+  Selections of more than one particle, other group indices, or dimensions
+  other than 2 or 3 are computed with the base class VisitModel.
+  The number of pairs scales quadratically with the number of sites, so
+  VisitModelCell is faster for large systems (e.g., beyond a few thousand
+  LJ particles in the lj_BENCHMARK_LONG test).
+ */
+class VisitModelPacked : public VisitModel {
+ public:
+  //@{
+  /** @name Arguments
+    - VisitModel arguments.
+   */
+  explicit VisitModelPacked(argtype args = argtype());
+  explicit VisitModelPacked(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Same as base class, but also enable the PackedSites store.
+  void precompute(Configuration * config) override;
+
+  void compute(
+      ModelTwoBody * model,
+      const ModelParams& model_params,
+      Configuration * config,
+      const int group_index) override;
+  void compute(
+      ModelTwoBody * model,
+      const ModelParams& model_params,
+      const Select& selection,
+      Configuration * config,
+      const int group_index) override;
+
+  std::shared_ptr<VisitModel> create(std::istream& istr) const override {
+    return std::make_shared<VisitModelPacked>(istr); }
+  std::shared_ptr<VisitModel> create(argtype * args) const override {
+    return std::make_shared<VisitModelPacked>(args); }
+  void serialize(std::ostream& ostr) const override;
+  explicit VisitModelPacked(std::istream& istr);
+  virtual ~VisitModelPacked() {}
+
+  //@}
+ private:
+  bool is_packable_(const Configuration& config, const int group_index) const;
+
+  // temporary and not serialized
+  std::shared_ptr<PairBatch> pair_batch_;
+
+  // compute with positions of fixed dimension
+  template <int D>
+  void compute_(
+      ModelTwoBody * model,
+      const ModelParams& model_params,
+      const Configuration& config);
+  template <int D>
+  void compute_(
+      ModelTwoBody * model,
+      const ModelParams& model_params,
+      const Select& selection,
+      const Configuration& config);
+};
+
+inline std::shared_ptr<VisitModelPacked> MakeVisitModelPacked(
+    argtype args = argtype()) {
+  return std::make_shared<VisitModelPacked>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_SYSTEM_VISIT_MODEL_PACKED_H_
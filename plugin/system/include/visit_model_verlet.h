@@ -0,0 +1,152 @@
+#ifndef FEASST_SYSTEM_VISIT_MODEL_VERLET_H_
+#define FEASST_SYSTEM_VISIT_MODEL_VERLET_H_
+
+#include <map>
+#include <string>
+#include <memory>
+#include <vector>
+#include "math/include/position.h"
+#include "system/include/visit_model.h"
+
+namespace feasst {
+
+typedef std::map<std::string, std::string> argtype;
+
+/**
+  Compute two-body inter-particle interactions using a Verlet neighbor list.
+  Each site stores the list of sites of other particles whose reference
+  positions are within the cutoff plus a skin distance.
+
+  The reference positions are those at the time the list of a site was
+  built.
+  As long as no site has moved more than half of the skin from its reference
+  position, every pair within the cutoff is in the list.
+  Upon acceptance of a trial (e.g., TrialTranslate or TrialRotate), the
+  displacement of the moved sites is compared with half the skin.
+  If exceeded, only the lists of the moved particle are rebuilt.
+  Otherwise, the largest displacement since the last full build is tracked.
+  The selection of a trial which moved further than the skin less the
+  largest displacement is computed without the list.
+
+  The entire list is rebuilt in precompute, when the domain changes (e.g.,
+  TrialVolume) and when the computation of the entire configuration finds
+  that the list is out of date.
+  Full builds use a cell list to find the neighbors, when the domain is large
+  enough.
+
+  This visitor is restricted to group index 0.
+  Other group indices are computed with the base class VisitModel.
+  The neighbor list is not serialized, and is rebuilt upon restart.
+ */
+class VisitModelVerlet : public VisitModel {
+ public:
+  //@{
+  /** @name Arguments
+    - skin: distance beyond the cutoff within which neighbors are listed.
+      Larger values result in fewer rebuilds but more pairs in the list
+      (default: 0.3).
+    - VisitModel arguments.
+   */
+  explicit VisitModelVerlet(argtype args = argtype());
+  explicit VisitModelVerlet(argtype * args);
+
+  //@}
+  /** @name Public Functions
+   */
+  //@{
+
+  /// Return the skin distance.
+  double skin() const { return skin_; }
+
+  /// Return the number of full builds of the list.
+  int num_builds() const { return num_builds_; }
+
+  /// Return the number of builds of the list of a single particle.
+  int num_particle_builds() const { return num_particle_builds_; }
+
+  /// Return the largest displacement of an accepted trial since the last
+  /// full build.
+  double max_displacement() const { return max_displacement_; }
+
+  /// Return the number of neighbors of a site.
+  int num_neighbors(const int particle_index, const int site_index) const;
+
+  /// Same as base class, but also build the list.
+  void precompute(Configuration * config) override;
+
+  /// Rebuild the entire list.
+  void change_volume(const double delta_volume, const int dimension,
+                     Configuration * config) override;
+
+  void compute(
+      ModelTwoBody * model,
+      const ModelParams& model_params,
+      Configuration * config,
+      const int group_index) override;
+  void compute(
+      ModelTwoBody * model,
+      const ModelParams& model_params,
+      const Select& selection,
+      Configuration * config,
+      const int group_index) override;
+
+  /// Same as base class, but also update the displacements and, if needed,
+  /// the lists of the particles in the selection.
+  void finalize(const Select& select, Configuration * config) override;
+
+  void check(const Configuration& config) const override;
+
+  std::shared_ptr<VisitModel> create(std::istream& istr) const override {
+    return std::make_shared<VisitModelVerlet>(istr); }
+  std::shared_ptr<VisitModel> create(argtype * args) const override {
+    return std::make_shared<VisitModelVerlet>(args); }
+  void serialize(std::ostream& ostr) const override;
+  explicit VisitModelVerlet(std::istream& istr);
+  virtual ~VisitModelVerlet() {}
+
+  //@}
+ private:
+  double skin_;
+
+  // temporary and not serialized
+  bool is_built_ = false;
+  int num_builds_ = 0;
+  int num_particle_builds_ = 0;
+  int num_listed_ = 0;
+  double max_displacement_ = 0.;
+  std::vector<double> built_domain_;
+  std::vector<std::vector<double> > list_cutoff_sq_;
+  // reference positions, indexed by particle and site.
+  std::vector<std::vector<Position> > reference_;
+  // neighbors, indexed by particle and site, stored as consecutive
+  // particle and site indices.
+  std::vector<std::vector<std::vector<int> > > neighbors_;
+
+  std::vector<double> domain_state_(const Configuration& config) const;
+  bool is_listed_(const int particle_index) const;
+  double displacement_(const int particle_index, const int site_index,
+                       const Configuration& config);
+  bool is_current_(const Configuration& config);
+  void resize_(const int num_particles);
+  void set_reference_(const int particle_index, const Configuration& config);
+  void add_if_neighbor_(const int part1_index, const int site1_index,
+                        const int part2_index, const int site2_index,
+                        const Configuration& config);
+  void remove_particle_(const int particle_index);
+  void build_particle_(const int particle_index, const Configuration& config);
+  void build_(const Configuration& config);
+  // return true if the energy_cutoff was exceeded.
+  bool compute_site_(const int part1_index, const int site1_index,
+                     const Select& selection, const bool is_old_config,
+                     const ModelParams& model_params, ModelTwoBody * model,
+                     Configuration * config);
+};
+
+inline std::shared_ptr<VisitModelVerlet> MakeVisitModelVerlet(
+    argtype args = argtype()) {
+  return std::make_shared<VisitModelVerlet>(args);
+}
+
+}  // namespace feasst
+
+#endif  // FEASST_SYSTEM_VISIT_MODEL_VERLET_H_
@@ -86,6 +86,18 @@ void BondVisitor::compute_two(const Select& selection,
       const Site& site0 = part.site(site0_index);
       for (int site1_index : part_type.bond_neighbors(site0_index)) {
         DEBUG("site1_index " << site1_index);
+        // exclude the old bond and include the new bond, as in reptation.
+        if (selection.old_bond() && selection.new_bond() &&
+            site0_index == selection.site_indices()[0][0] &&
+            site1_index == selection.old_bond()->site_indices()[0][0]) {
+          const Bond& bond_type = part_type.bond(site0_index, site1_index);
+          const Bond& bond = unique_part.bond(bond_type.type());
+          en += bond_->deserialize_map()[bond.model()]->energy(
+            site0.position(),
+            part.site(selection.new_bond()->site_indices()[0][0]).position(),
+            bond);
+          continue;
+        }
         const Site& site1 = part.site(site1_index);
         if (site1.is_physical()) {
           if (site0_index < site1_index ||
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include "math/include/utils_math.h"
 #include "utils/include/debug.h"
@@ -38,7 +39,7 @@ void Cells::build_neighbors_3D_() {
     for (int xcell2 = xcell1 - 1; xcell2 <= xcell1 + 1; ++xcell2) {
     for (int ycell2 = ycell1 - 1; ycell2 <= ycell1 + 1; ++ycell2) {
     for (int zcell2 = zcell1 - 1; zcell2 <= zcell1 + 1; ++zcell2) {
-      neighbor_[cell].push_back(id_({xcell2, ycell2, zcell2}));
+      add_neighbor_(cell, id_({xcell2, ycell2, zcell2}));
     }}}
   }}}
 }
@@ -49,11 +50,20 @@ void Cells::build_neighbors_2D_() {
     const int cell = id_({xcell1, ycell1});
     for (int xcell2 = xcell1 - 1; xcell2 <= xcell1 + 1; ++xcell2) {
     for (int ycell2 = ycell1 - 1; ycell2 <= ycell1 + 1; ++ycell2) {
-      neighbor_[cell].push_back(id_({xcell2, ycell2}));
+      add_neighbor_(cell, id_({xcell2, ycell2}));
     }}
   }}
 }
 
+void Cells::add_neighbor_(const int cell, const int neighbor) {
+  // with two cells in a dimension, the periodic images of a neighbor coincide
+  std::vector<int> * neighbors = &neighbor_[cell];
+  if (std::find(neighbors->begin(), neighbors->end(), neighbor) ==
+      neighbors->end()) {
+    neighbors->push_back(neighbor);
+  }
+}
+
 void Cells::build_particles_() {
   particles_.resize(num_total());
 }
@@ -41,4 +41,35 @@ double HardSphere::energy(
   return 0.;
 }
 
+void HardSphere::precompute(const ModelParams& existing) {
+  ModelTwoBody::precompute(existing);
+  if (sigma_index() != -1) {
+    flatten_(existing.select(sigma_index()), &sigma_sq_);
+    for (double& sigma : sigma_sq_) {
+      sigma *= sigma;
+    }
+  }
+}
+
+void HardSphere::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  if (!is_flat_(model_params)) {
+    ModelTwoBody::energy_batch(num, squared_distance, type1, type2,
+                               model_params, energy);
+    return;
+  }
+  const double * sigma_sq = sigma_sq_.data();
+  #pragma omp simd
+  for (int pair = 0; pair < num; ++pair) {
+    const int index = flat_index_(type1[pair], type2[pair]);
+    energy[pair] = (squared_distance[pair] <= sigma_sq[index]) ?
+                   NEAR_INFINITY : 0.;
+  }
+}
+
 }  // namespace feasst
@@ -3,6 +3,7 @@
 #include "utils/include/serialize.h"
 #include "math/include/constants.h"
 #include "configuration/include/model_params.h"
+#include "system/include/pair_batch.h"
 #include "system/include/lennard_jones.h"
 
 namespace feasst {
@@ -42,6 +43,33 @@ LennardJones::LennardJones(std::istream& istr) : ModelTwoBody(istr) {
   feasst_deserialize(&hard_sphere_threshold_sq_, istr);
 }
 
+void LennardJones::precompute(const ModelParams& existing) {
+  ModelTwoBody::precompute(existing);
+  if (epsilon_index() != -1 && sigma_index() != -1) {
+    flatten_(existing.select(epsilon_index()), &epsilon_);
+    flatten_(existing.select(sigma_index()), &sigma_sq_);
+    for (double& sigma : sigma_sq_) {
+      sigma *= sigma;
+    }
+  }
+}
+
+void LennardJones::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  if (!is_flat_(model_params)) {
+    ModelTwoBody::energy_batch(num, squared_distance, type1, type2,
+                               model_params, energy);
+    return;
+  }
+  batch_lennard_jones(num, squared_distance, type1, type2, flat_num_types_,
+    epsilon_.data(), sigma_sq_.data(), hard_sphere_threshold_sq_, energy);
+}
+
 double LennardJones::hard_sphere_threshold() const {
   return std::sqrt(hard_sphere_threshold_sq_);
 }
@@ -1,3 +1,5 @@
+#include "utils/include/debug.h"
+#include "configuration/include/model_params.h"
 #include "system/include/visit_model.h"
 #include "system/include/model_two_body.h"
 
@@ -71,4 +73,35 @@ double ModelTwoBody::compute(
   return visitor->energy();
 }
 
+void ModelTwoBody::energy_batch(
+    const int num,
+    const double * squared_distance,
+    const int * type1,
+    const int * type2,
+    const ModelParams& model_params,
+    double * energy) {
+  for (int pair = 0; pair < num; ++pair) {
+    energy[pair] = this->energy(squared_distance[pair], type1[pair],
+                                type2[pair], model_params);
+  }
+}
+
+void ModelTwoBody::flatten_(const ModelParam& param,
+                            std::vector<double> * table) {
+  const std::vector<std::vector<double> >& mixed = param.mixed_values();
+  flat_num_types_ = static_cast<int>(mixed.size());
+  table->resize(flat_num_types_*flat_num_types_);
+  for (int type1 = 0; type1 < flat_num_types_; ++type1) {
+    ASSERT(static_cast<int>(mixed[type1].size()) == flat_num_types_,
+      "mixed values are not square");
+    for (int type2 = 0; type2 < flat_num_types_; ++type2) {
+      (*table)[flat_index_(type1, type2)] = mixed[type1][type2];
+    }
+  }
+}
+
+bool ModelTwoBody::is_flat_(const ModelParams& model_params) const {
+  return flat_num_types_ > 0 && flat_num_types_ == model_params.size();
+}
+
 }  // namespace feasst
@@ -0,0 +1,135 @@
+#include <cmath>
+#include "utils/include/debug.h"
+#include "math/include/constants.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/model_params.h"
+#include "system/include/model_two_body.h"
+#include "system/include/pair_batch.h"
+
+// Compile multiple versions of the kernels and select one at runtime.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+  #define FEASST_TARGET_CLONES \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+  #define FEASST_TARGET_CLONES
+#endif
+
+namespace feasst {
+
+FEASST_TARGET_CLONES
+void batch_squared_distance(const int num, const int dimension,
+    const double * xyz1, const double * const * coord, const double * side,
+    const int * periodic, double * r2) {
+  for (int site = 0; site < num; ++site) {
+    r2[site] = 0.;
+  }
+  for (int dim = 0; dim < dimension; ++dim) {
+    const double x1 = xyz1[dim];
+    const double * x2 = coord[dim];
+    const double length = side[dim];
+    if (periodic[dim] == 1) {
+      #pragma omp simd
+      for (int site = 0; site < num; ++site) {
+        double dx = x1 - x2[site];
+        dx -= length*std::rint(dx/length);
+        r2[site] += dx*dx;
+      }
+    } else {
+      #pragma omp simd
+      for (int site = 0; site < num; ++site) {
+        const double dx = x1 - x2[site];
+        r2[site] += dx*dx;
+      }
+    }
+  }
+}
+
+FEASST_TARGET_CLONES
+void batch_lennard_jones(const int num, const double * r2,
+    const int * type1, const int * type2, const int num_types,
+    const double * epsilon, const double * sigma_sq,
+    const double hard_sphere_threshold_sq, double * energy) {
+  #pragma omp simd
+  for (int pair = 0; pair < num; ++pair) {
+    const int index = type1[pair]*num_types + type2[pair];
+    const double sig_sq = sigma_sq[index];
+    const double rinv2 = sig_sq/r2[pair];
+    const double rinv6 = rinv2*rinv2*rinv2;
+    double en = 4.*epsilon[index]*rinv6*(rinv6 - 1.);
+    if (r2[pair] == 0 || r2[pair] < hard_sphere_threshold_sq*sig_sq) {
+      en = NEAR_INFINITY;
+    }
+    energy[pair] = en;
+  }
+}
+
+void PairBatch::clear(const int dimension) {
+  coord_.resize(dimension);
+  for (std::vector<double>& coord : coord_) {
+    coord.clear();
+  }
+  type_.clear();
+}
+
+void PairBatch::add(const double * coord, const int type) {
+  for (int dim = 0; dim < static_cast<int>(coord_.size()); ++dim) {
+    coord_[dim].push_back(coord[dim]);
+  }
+  type_.push_back(type);
+}
+
+void PairBatch::compute_squared_distance(const std::vector<double>& coord,
+                                         const Domain& domain) {
+  ASSERT(!domain.is_tilted(), "PairBatch assumes a cuboid domain");
+  const int dimen = static_cast<int>(coord_.size());
+  side_.resize(dimen);
+  periodic_.resize(dimen);
+  for (int dim = 0; dim < dimen; ++dim) {
+    side_[dim] = domain.side_length(dim);
+    periodic_[dim] = domain.periodic(dim);
+  }
+  const double * coords[3] = {nullptr, nullptr, nullptr};
+  ASSERT(dimen <= 3, "dimension: " << dimen);
+  for (int dim = 0; dim < dimen; ++dim) {
+    coords[dim] = coord_[dim].data();
+  }
+  r2_.resize(num());
+  batch_squared_distance(num(), dimen, coord.data(), coords, side_.data(),
+                         periodic_.data(), r2_.data());
+}
+
+double PairBatch::energy(const int type1,
+    const ModelParams& model_params,
+    const int cutoff_index,
+    ModelTwoBody * model) {
+  const std::vector<double>& cutoff =
+    model_params.select(cutoff_index).mixed_values()[type1];
+  for (int site = 0; site < num(); ++site) {
+    const int type2 = type_[site];
+    const double cut = cutoff[type2];
+    if (r2_[site] <= cut*cut) {
+      add_pair(r2_[site], type2);
+    }
+  }
+  return pair_energy(type1, model_params, model);
+}
+
+double PairBatch::pair_energy(const int type1,
+    const ModelParams& model_params,
+    ModelTwoBody * model) {
+  const int num = num_pairs();
+  pair_type1_.assign(num, type1);
+  pair_energy_.resize(num);
+  model->energy_batch(num, pair_r2_.data(), pair_type1_.data(),
+    pair_type2_.data(), model_params, pair_energy_.data());
+  double energy = 0.;
+  #pragma omp simd reduction(+:energy)
+  for (int pair = 0; pair < num; ++pair) {
+    energy += pair_energy_[pair];
+  }
+  pair_r2_.clear();
+  pair_type2_.clear();
+  return energy;
+}
+
+}  // namespace feasst
@@ -0,0 +1,261 @@
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "utils/include/debug.h"
+#include "utils/include/max_precision.h"
+#include "system/include/sorted_cells.h"
+
+namespace feasst {
+
+// Interleave the bits of the cell coordinates.
+static int64_t morton_code(const std::vector<int>& cell_coord) {
+  const int dimen = static_cast<int>(cell_coord.size());
+  int64_t code = 0;
+  for (int bit = 0; bit < 63/dimen; ++bit) {
+    for (int dim = 0; dim < dimen; ++dim) {
+      code |= static_cast<int64_t>((cell_coord[dim] >> bit) & 1) <<
+              (bit*dimen + dim);
+    }
+  }
+  return code;
+}
+
+void SortedCells::create(const double min_length,
+                         const std::vector<double>& side_lengths) {
+  ASSERT(min_length > 1e-15, "min_length(" << min_length << ") too small");
+  const int dimen = static_cast<int>(side_lengths.size());
+  ASSERT(dimen == 2 || dimen == 3, "unrecognized dimension(" << dimen << ")");
+  *this = SortedCells();
+  int num_total = 1;
+  for (double side_length : side_lengths) {
+    num_.push_back(static_cast<int>(side_length/min_length));
+    num_total *= num_.back();
+  }
+  if (num_total <= std::pow(3, dimen)) {
+    num_.clear();
+    return;
+  }
+  ASSERT(num_total < 1e8, "too many cells");
+
+  // neighbors, including self, without duplicates
+  std::vector<int> coord(dimen), coord2(dimen);
+  std::vector<std::pair<int64_t, int> > codes(num_total);
+  neighbor_begin_.push_back(0);
+  for (int cell = 0; cell < num_total; ++cell) {
+    int remain = cell;
+    for (int dim = 0; dim < dimen; ++dim) {
+      coord[dim] = remain % num_[dim];
+      remain /= num_[dim];
+    }
+    codes[cell] = std::make_pair(morton_code(coord), cell);
+    std::vector<int> neigh;
+    const int num_stencil = static_cast<int>(std::pow(3, dimen));
+    for (int stencil = 0; stencil < num_stencil; ++stencil) {
+      int remain_stencil = stencil, cell2 = 0, prod = 1;
+      for (int dim = 0; dim < dimen; ++dim) {
+        const int shift = remain_stencil % 3 - 1;
+        remain_stencil /= 3;
+        coord2[dim] = (coord[dim] + shift + num_[dim]) % num_[dim];
+        cell2 += prod*coord2[dim];
+        prod *= num_[dim];
+      }
+      neigh.push_back(cell2);
+    }
+    std::sort(neigh.begin(), neigh.end());
+    neigh.erase(std::unique(neigh.begin(), neigh.end()), neigh.end());
+    neighbor_.insert(neighbor_.end(), neigh.begin(), neigh.end());
+    neighbor_begin_.push_back(static_cast<int>(neighbor_.size()));
+  }
+  std::sort(codes.begin(), codes.end());
+  for (const std::pair<int64_t, int>& code : codes) {
+    order_.push_back(code.second);
+  }
+  begin_.resize(num_total, 0);
+  end_.resize(num_total, 0);
+  capacity_.resize(num_total, 0);
+}
+
+int SortedCells::id(const double * scaled_coord) const {
+  int cell = 0, prod = 1;
+  for (int dim = 0; dim < dimension(); ++dim) {
+    ASSERT(std::abs(scaled_coord[dim]) <= 0.5,
+      MAX_PRECISION << scaled_coord[dim] << " is not scaled coordinates");
+    cell += prod*(static_cast<int>(num_[dim]*(scaled_coord[dim] + 0.5)) %
+                  num_[dim]);
+    prod *= num_[dim];
+  }
+  return cell;
+}
+
+int SortedCells::slot_of_(const int particle_index,
+                          const int site_index) const {
+  if (particle_index < static_cast<int>(slot_.size())) {
+    const std::vector<int>& slots = slot_[particle_index];
+    if (site_index < static_cast<int>(slots.size())) {
+      return slots[site_index];
+    }
+  }
+  return -1;
+}
+
+void SortedCells::set_slot_(const int particle_index, const int site_index,
+                            const int slot) {
+  if (particle_index >= static_cast<int>(slot_.size())) {
+    slot_.resize(particle_index + 1);
+  }
+  std::vector<int>& slots = slot_[particle_index];
+  if (site_index >= static_cast<int>(slots.size())) {
+    slots.resize(site_index + 1, -1);
+  }
+  slots[site_index] = slot;
+}
+
+int SortedCells::cell(const int particle_index, const int site_index) const {
+  const int slot = slot_of_(particle_index, site_index);
+  if (slot == -1) {
+    return -1;
+  }
+  return cell_[slot];
+}
+
+void SortedCells::place_(const int slot, const int particle_index,
+    const int site_index, const int cell, const double * coord,
+    const int type) {
+  particle_[slot] = particle_index;
+  site_[slot] = site_index;
+  type_[slot] = type;
+  cell_[slot] = cell;
+  for (int dim = 0; dim < dimension(); ++dim) {
+    coord_[slot*dimension() + dim] = coord[dim];
+  }
+  set_slot_(particle_index, site_index, slot);
+}
+
+void SortedCells::remove_slot_(const int slot) {
+  const int cell = cell_[slot];
+  const int last = end_[cell] - 1;
+  set_slot_(particle_[slot], site_[slot], -1);
+  if (slot != last) {
+    place_(slot, particle_[last], site_[last], cell, coord(last), type_[last]);
+  }
+  cell_[last] = -1;
+  --end_[cell];
+}
+
+void SortedCells::update(const int particle_index, const int site_index,
+    const int cell, const double * coord, const int type) {
+  ASSERT(cell >= 0 && cell < num_total(), "cell: " << cell);
+  const int slot = slot_of_(particle_index, site_index);
+  if (slot != -1) {
+    if (cell_[slot] == cell) {
+      place_(slot, particle_index, site_index, cell, coord, type);
+      return;
+    }
+    remove_slot_(slot);
+    --num_sites_;
+    ++num_moves_;
+  }
+  if (end_[cell] < capacity_[cell] && num_moves_ < num_sites_) {
+    place_(end_[cell], particle_index, site_index, cell, coord, type);
+    ++end_[cell];
+    ++num_sites_;
+  } else {
+    add_unsorted(particle_index, site_index, cell, coord, type);
+    sort();
+  }
+}
+
+void SortedCells::add_unsorted(const int particle_index, const int site_index,
+    const int cell, const double * coord, const int type) {
+  ASSERT(slot_of_(particle_index, site_index) == -1, "site is already in a "
+    << "cell. particle: " << particle_index << " site: " << site_index);
+  ASSERT(cell >= 0 && cell < num_total(), "cell: " << cell);
+  pending_particle_.push_back(particle_index);
+  pending_site_.push_back(site_index);
+  pending_type_.push_back(type);
+  pending_cell_.push_back(cell);
+  pending_coord_.insert(pending_coord_.end(), coord, coord + dimension());
+  ++num_sites_;
+}
+
+void SortedCells::remove(const int particle_index, const int site_index) {
+  const int slot = slot_of_(particle_index, site_index);
+  if (slot != -1) {
+    remove_slot_(slot);
+    --num_sites_;
+  }
+}
+
+void SortedCells::sort() {
+  const int dimen = dimension();
+  // copy the occupied slots in the current order, followed by those pending.
+  std::vector<int> old_particle, old_site, old_type, old_cell;
+  std::vector<double> old_coord;
+  std::vector<int> count(num_total(), 0);
+  for (const int cell1 : order_) {
+    for (int slot = begin_[cell1]; slot < end_[cell1]; ++slot) {
+      old_particle.push_back(particle_[slot]);
+      old_site.push_back(site_[slot]);
+      old_type.push_back(type_[slot]);
+      old_cell.push_back(cell1);
+      old_coord.insert(old_coord.end(), &coord_[slot*dimen],
+                       &coord_[slot*dimen] + dimen);
+      ++count[cell1];
+    }
+  }
+  old_particle.insert(old_particle.end(), pending_particle_.begin(),
+                      pending_particle_.end());
+  old_site.insert(old_site.end(), pending_site_.begin(), pending_site_.end());
+  old_type.insert(old_type.end(), pending_type_.begin(), pending_type_.end());
+  old_cell.insert(old_cell.end(), pending_cell_.begin(), pending_cell_.end());
+  old_coord.insert(old_coord.end(), pending_coord_.begin(),
+                   pending_coord_.end());
+  for (const int cell1 : pending_cell_) {
+    ++count[cell1];
+  }
+  pending_particle_.clear();
+  pending_site_.clear();
+  pending_type_.clear();
+  pending_cell_.clear();
+  pending_coord_.clear();
+
+  // allocate blocks in Morton order, with room for a few more sites.
+  int offset = 0;
+  for (const int cell1 : order_) {
+    begin_[cell1] = offset;
+    end_[cell1] = offset;
+    offset += count[cell1] + 2 + count[cell1]/4;
+    capacity_[cell1] = offset;
+  }
+  particle_.assign(offset, -1);
+  site_.assign(offset, -1);
+  type_.assign(offset, -1);
+  cell_.assign(offset, -1);
+  coord_.assign(offset*dimen, 0.);
+  for (int index = 0; index < static_cast<int>(old_particle.size()); ++index) {
+    const int cell1 = old_cell[index];
+    place_(end_[cell1], old_particle[index], old_site[index], cell1,
+           &old_coord[index*dimen], old_type[index]);
+    ++end_[cell1];
+  }
+  num_moves_ = 0;
+  ++num_sorts_;
+}
+
+void SortedCells::check() const {
+  int num = 0;
+  for (int cell1 = 0; cell1 < num_total(); ++cell1) {
+    ASSERT(begin_[cell1] <= end_[cell1] && end_[cell1] <= capacity_[cell1],
+      "cell: " << cell1 << " has an invalid block");
+    for (int slot = begin_[cell1]; slot < end_[cell1]; ++slot) {
+      ASSERT(cell_[slot] == cell1, "slot: " << slot << " is not in cell: "
+        << cell1);
+      ASSERT(slot_of_(particle_[slot], site_[slot]) == slot,
+        "slot: " << slot << " is not indexed");
+      ++num;
+    }
+  }
+  ASSERT(num == num_sites_, "num: " << num << " != num_sites: " << num_sites_);
+}
+
+}  // namespace feasst
@@ -2,13 +2,14 @@
 #include "utils/include/io.h"
 #include "utils/include/arguments.h"
 #include "utils/include/debug.h"
-#include "utils/include/serialize.h"
+#include "utils/include/serialize_extra.h"
 #include "configuration/include/domain.h"
 #include "configuration/include/particle_factory.h"
 #include "configuration/include/select.h"
 #include "configuration/include/neighbor_criteria.h"
 #include "configuration/include/configuration.h"
 #include "system/include/bond_visitor.h"
+#include "system/include/potential.h"
 #include "system/include/thermo_params.h"
 #include "system/include/system.h"
 
@@ -37,6 +38,88 @@ int System::dimension(const int config) const {
   return dim;
 }
 
+System System::snapshot() const {
+  System copy(*this);
+  copy.thread_systems_.clear();
+  for (std::shared_ptr<Configuration>& config : copy.configurations_) {
+    config = std::make_shared<Configuration>(deep_copy(*config));
+  }
+  for (std::shared_ptr<BondVisitor>& bond : copy.bonds_) {
+    bond = std::make_shared<BondVisitor>(*bond);
+  }
+  for (PotentialFactory& factory : copy.unoptimized_) {
+    factory = deep_copy(factory);
+  }
+  for (PotentialFactory& factory : copy.optimized_) {
+    factory = deep_copy(factory);
+  }
+  for (std::vector<PotentialFactory>& refs : copy.references_) {
+    for (PotentialFactory& factory : refs) {
+      factory = deep_copy(factory);
+    }
+  }
+  if (thermo_params_) {
+    copy.thermo_params_ = std::make_shared<ThermoParams>(*thermo_params_);
+  }
+  return copy;
+}
+
+// Copy the stored energies if the potentials are the same.
+void update_snapshot_potentials(const PotentialFactory& factory,
+    PotentialFactory * snapshot) {
+  if (snapshot->num() == factory.num()) {
+    for (int index = 0; index < factory.num(); ++index) {
+      snapshot->get_potential(index)->set_stored_energy(
+        factory.potential(index).stored_energy());
+    }
+  } else {
+    *snapshot = deep_copy(factory);
+  }
+}
+
+void System::update_snapshot(const System& system) {
+  ASSERT(num_configurations() == system.num_configurations(), "size error");
+  for (int config = 0; config < num_configurations(); ++config) {
+    if (!configurations_[config]->copy_positions(
+        *system.configurations_[config])) {
+      configurations_[config] = std::make_shared<Configuration>(
+        deep_copy(*system.configurations_[config]));
+    }
+    *bonds_[config] = *system.bonds_[config];
+    update_snapshot_potentials(system.unoptimized_[config],
+                               &unoptimized_[config]);
+    update_snapshot_potentials(system.optimized_[config],
+                               &optimized_[config]);
+  }
+  if (references_.size() == system.references_.size()) {
+    for (int config = 0; config < static_cast<int>(references_.size());
+         ++config) {
+      const std::vector<PotentialFactory>& refs = system.references_[config];
+      references_[config].resize(refs.size());
+      for (int ref = 0; ref < static_cast<int>(refs.size()); ++ref) {
+        update_snapshot_potentials(refs[ref], &references_[config][ref]);
+      }
+    }
+  } else {
+    references_ = system.references_;
+    for (std::vector<PotentialFactory>& refs : references_) {
+      for (PotentialFactory& factory : refs) {
+        factory = deep_copy(factory);
+      }
+    }
+  }
+  if (system.thermo_params_) {
+    if (thermo_params_) {
+      *thermo_params_ = *system.thermo_params_;
+    } else {
+      thermo_params_ = std::make_shared<ThermoParams>(*system.thermo_params_);
+    }
+  }
+  is_optimized_ = system.is_optimized_;
+  ref_used_last_ = system.ref_used_last_;
+  delta_volume_previous_ = system.delta_volume_previous_;
+}
+
 void System::add_to_unoptimized(std::shared_ptr<Potential> potential,
     const int config) {
   unoptimized_[config].add(potential);
@@ -271,6 +354,13 @@ void System::finalize(const Select& select, const int config) {
     // finalize removal
     configurations_[config]->remove_particles(select);
   }
+  finalize_potentials_(select, config);
+  for (int iconf = 0; iconf < num_configurations(); ++iconf) {
+    DEBUG("number particles in conf " << iconf << ": " << configuration(iconf).num_particles());
+  }
+}
+
+void System::finalize_potentials_(const Select& select, const int config) {
   unoptimized_[config].finalize(select, configurations_[config].get());
   optimized_[config].finalize(select, configurations_[config].get());
   if (num_references(config) > 0) {
@@ -278,9 +368,6 @@ void System::finalize(const Select& select, const int config) {
       ref.finalize(select, configurations_[config].get());
     }
   }
-  for (int iconf = 0; iconf < num_configurations(); ++iconf) {
-    DEBUG("number particles in conf " << iconf << ": " << configuration(iconf).num_particles());
-  }
 }
 
 void System::revert(const Select& select, const int config) {
@@ -339,6 +426,49 @@ void System::synchronize_(const System& system, const Select& perturbed) {
   }
 }
 
+bool System::synchronize_particles_(const System& system) {
+  ASSERT(num_configurations() == system.num_configurations(), "size error");
+  for (int config = 0; config < num_configurations(); ++config) {
+    Select removed, changed;
+    if (!configurations_[config]->synchronize_particles_(
+        system.configuration(config), &removed, &changed)) {
+      return false;
+    }
+    if (removed.num_particles() > 0 || changed.num_particles() > 0) {
+      // finalize to update potentials such as cells, and then synchronize
+      // the potential data, as done with Prefetch.
+      if (removed.num_particles() > 0) {
+        removed.set_trial_state(2);
+        finalize_potentials_(removed, config);
+      }
+      if (changed.num_particles() > 0) {
+        finalize_potentials_(changed, config);
+      }
+      unoptimized_[config].synchronize_(system.unoptimized_[config], changed);
+      optimized_[config].synchronize_(system.optimized_[config], changed);
+      for (int ref = 0; ref < num_references(config); ++ref) {
+        references_[config][ref].synchronize_(
+          system.references_[config][ref], changed);
+      }
+    }
+  }
+  return true;
+}
+
+void System::resize_thread_systems_(const int num_threads) {
+  thread_systems_.resize(num_threads);
+}
+
+System * System::synchronize_thread_system_(const int thread) {
+  ASSERT(thread < static_cast<int>(thread_systems_.size()),
+    "thread: " << thread << " >= " << thread_systems_.size());
+  std::shared_ptr<System>& system = thread_systems_[thread];
+  if (!system || !system->synchronize_particles_(*this)) {
+    system = std::make_shared<System>(deep_copy(*this));
+  }
+  return system.get();
+}
+
 void System::change_volume(const double delta_volume, argtype * args) {
   const int config = integer("configuration", args, 0);
   const int dimen = integer("dimension", args, -1);
@@ -1,3 +1,6 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
 #include <cmath>
 #include <vector>
 #include "utils/include/io.h"
@@ -31,6 +34,9 @@ VisitModel::VisitModel(argtype * args) {
     ASSERT(energy_cutoff_ > 1e10, "energy_cutoff:" << energy_cutoff_ <<
       " should be > 1e10 to avoid any trial with a chance of being accepted.");
   }
+  num_threads_ = integer("num_threads", args, 1);
+  ASSERT(num_threads_ == -1 || num_threads_ >= 1,
+    "num_threads: " << num_threads_);
 }
 VisitModel::VisitModel(argtype args) : VisitModel(&args) {
   feasst_check_all_used(args);
@@ -117,6 +123,39 @@ void VisitModel::compute(
   TRACE("group index " << group_index);
   const Select& selection = config->group_select(group_index);
   TRACE("num p " << selection.num_particles());
+  const int num_threads = init_threads_(domain);
+  if (num_threads > 1) {
+    const int num_particles = selection.num_particles();
+    #pragma omp parallel num_threads(num_threads)
+    {
+      int thread = 0;
+      #ifdef _OPENMP
+      thread = omp_get_thread_num();
+      #endif // _OPENMP
+      VisitModelInner * inner = get_thread_inner_(thread);
+      Position * relative = get_thread_relative_(thread);
+      Position * pbc = get_thread_pbc_(thread);
+      #pragma omp for schedule(static, 1)
+      for (int select1_index = 0;
+           select1_index < num_particles - 1;
+           ++select1_index) {
+        const int part1_index = selection.particle_index(select1_index);
+        for (int select2_index = select1_index + 1;
+             select2_index < num_particles;
+             ++select2_index) {
+          const int part2_index = selection.particle_index(select2_index);
+          for (int site1_index : selection.site_indices(select1_index)) {
+            for (int site2_index : selection.site_indices(select2_index)) {
+              inner->compute(part1_index, site1_index, part2_index,
+                site2_index, config, model_params, model, false, relative, pbc);
+            }
+          }
+        }
+      }
+    }
+    set_energy(sum_thread_energy_());
+    return;
+  }
   for (int select1_index = 0;
        select1_index < selection.num_particles() - 1;
        ++select1_index) {
@@ -350,7 +389,7 @@ std::shared_ptr<VisitModel> VisitModel::factory(const std::string name, argtype
 }
 
 void VisitModel::serialize_visit_model_(std::ostream& ostr) const {
-  feasst_serialize_version(545, ostr);
+  feasst_serialize_version(546, ostr);
   feasst_serialize(energy_, ostr);
   feasst_serialize(epsilon_index_, ostr);
   feasst_serialize(sigma_index_, ostr);
@@ -360,12 +399,13 @@ void VisitModel::serialize_visit_model_(std::ostream& ostr) const {
   feasst_serialize_fstdr(inner_, ostr);
   feasst_serialize_fstobj(data_, ostr);
   feasst_serialize_fstobj(manual_data_, ostr);
+  feasst_serialize(num_threads_, ostr);
 }
 
 VisitModel::VisitModel(std::istream& istr) {
   istr >> class_name_;
   const int version = feasst_deserialize_version(istr);
-  ASSERT(545 == version, "mismatch: " << version);
+  ASSERT(version >= 545 && version <= 546, "mismatch: " << version);
   feasst_deserialize(&energy_, istr);
   feasst_deserialize(&epsilon_index_, istr);
   feasst_deserialize(&sigma_index_, istr);
@@ -382,6 +422,9 @@ VisitModel::VisitModel(std::istream& istr) {
   }
   feasst_deserialize_fstobj(&data_, istr);
   feasst_deserialize_fstobj(&manual_data_, istr);
+  if (version >= 546) {
+    feasst_deserialize(&num_threads_, istr);
+  }
 }
 
 void VisitModel::compute(
@@ -405,6 +448,50 @@ void VisitModel::init_relative_(const Domain& domain) {
   }
 }
 
+int VisitModel::init_threads_(const Domain& domain) {
+  int num_threads = 1;
+  #ifdef _OPENMP
+  num_threads = num_threads_;
+  if (num_threads == -1) {
+    num_threads = omp_get_max_threads();
+  }
+  #endif // _OPENMP
+  if (num_threads == 1) {
+    return 1;
+  }
+  ASSERT(inner().class_name() == "VisitModelInner" && !inner().is_energy_map(),
+    "num_threads requires the default VisitModelInner without an EnergyMap");
+  if (static_cast<int>(thread_inner_.size()) != num_threads) {
+    thread_inner_.clear();
+    thread_relative_.clear();
+    thread_pbc_.clear();
+    for (int thread = 0; thread < num_threads; ++thread) {
+      std::stringstream ss;
+      inner().serialize(ss);
+      thread_inner_.push_back(VisitModelInner().deserialize(ss));
+      thread_relative_.push_back(std::make_shared<Position>());
+      thread_pbc_.push_back(std::make_shared<Position>());
+    }
+  }
+  for (int thread = 0; thread < num_threads; ++thread) {
+    thread_inner_[thread]->set_energy(0.);
+    if (thread_relative_[thread]->dimension() != domain.dimension()) {
+      thread_relative_[thread]->set_vector(domain.side_lengths().coord());
+      thread_pbc_[thread]->set_vector(domain.side_lengths().coord());
+    }
+  }
+  return num_threads;
+}
+
+double VisitModel::sum_thread_energy_() {
+  double energy = 0.;
+  for (const std::shared_ptr<VisitModelInner>& inner : thread_inner_) {
+    energy += inner->energy();
+  }
+  get_inner_()->set_energy(energy);
+  return energy;
+}
+
 void VisitModel::compute(
     ModelOneBody * model,
     Configuration * config,
@@ -455,6 +542,7 @@ void VisitModel::synchronize_(const VisitModel& visit,
 
 void VisitModel::precompute(Configuration * config) {
   inner_->precompute(config);
+  thread_inner_.clear();
   epsilon_index_ = config->model_params().index("epsilon");
   sigma_index_ = config->model_params().index("sigma");
   cutoff_index_ = config->model_params().index("cutoff");
@@ -1,3 +1,6 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
 #include "utils/include/arguments.h"
 #include "utils/include/io.h"
 #include "utils/include/utils.h"
@@ -8,6 +11,8 @@
 #include "configuration/include/model_params.h"
 #include "configuration/include/configuration.h"
 #include "system/include/cells.h"
+#include "system/include/sorted_cells.h"
+#include "system/include/pair_batch.h"
 #include "system/include/visit_model_inner.h"
 #include "system/include/visit_model_cell.h"
 
@@ -26,6 +31,10 @@ VisitModelCell::VisitModelCell(argtype * args) : VisitModel(args) {
     group_ = str("cell_group", args, "");
   }
   ASSERT(group_index_ >= 0, "invalid group_index: " << group_index_);
+  batch_ = boolean("batch", args, false);
+  sorted_ = boolean("sorted", args, false);
+  ASSERT(num_threads() == 1 || (!batch_ && !sorted_),
+    "num_threads is not implemented with batch or sorted");
 }
 VisitModelCell::VisitModelCell(argtype args) : VisitModelCell(&args) {
   feasst_check_all_used(args);
@@ -88,11 +97,20 @@ void VisitModelCell::precompute(Configuration * config) {
     init_relative_(config->domain());
     position_tracker_(config->group_select(group_index_), config);
   }
+  if (batch_) {
+    ASSERT(inner().class_name() == "VisitModelInner",
+      "batch does not support " << inner().class_name());
+    ASSERT(!inner().is_energy_map(), "batch does not support EnergyMap");
+  }
+  if (sorted_ && !sorted_cells_) {
+    build_sorted_(config);
+  }
   check(*config);
 }
 
 void VisitModelCell::rebuild_(const Configuration& config) {
   DEBUG("rebuilding");
+  sorted_cells_.reset();
   const double min_length = min_len_(config);
   Cells cells;
   cells.create(min_length, config.domain().side_lengths().coord());
@@ -121,9 +139,34 @@ void VisitModelCell::change_volume(const double delta_volume, const int dimensio
     rebuild_(*config);
     DEBUG("position updates after change volume rebuild");
     position_tracker_(config->group_select(group_index_), config);
+    if (sorted_) {
+      build_sorted_(config);
+    }
   }
 }
 
+void VisitModelCell::build_sorted_(Configuration * config) {
+  const Domain& domain = config->domain();
+  sorted_cells_ = std::make_shared<SortedCells>();
+  sorted_cells_->create(min_len_(*config), domain.side_lengths().coord());
+  ASSERT(sorted_cells_->num_total() == cells_->num_total(),
+    "SortedCells: " << sorted_cells_->num_total() << " != Cells: " <<
+    cells_->num_total());
+  init_relative_(domain);
+  const Select& select = config->group_select(group_index_);
+  for (int spindex = 0; spindex < select.num_particles(); ++spindex) {
+    const int particle_index = select.particle_index(spindex);
+    const Particle& part = config->select_particle(particle_index);
+    for (const int site_index : select.site_indices(spindex)) {
+      const Site& site = part.site(site_index);
+      sorted_cells_->add_unsorted(particle_index, site_index,
+        cell_id_opt_(domain, site.position()), site.position().coord().data(),
+        site.type());
+    }
+  }
+  sorted_cells_->sort();
+}
+
 void VisitModelCell::compute(
     ModelTwoBody * model,
     const ModelParams& model_params,
@@ -133,6 +176,19 @@ void VisitModelCell::compute(
   const Domain& domain = config->domain();
   ASSERT(group_index == group_index_, "not equivalent");
   init_relative_(domain);
+  if (batch_) {
+    compute_batch_(model, model_params, config);
+    return;
+  }
+  if (sorted_cells_) {
+    compute_sorted_(model, model_params, config);
+    return;
+  }
+  const int num_threads = init_threads_(domain);
+  if (num_threads > 1) {
+    compute_threads_(model, model_params, config, num_threads);
+    return;
+  }
 
   /*
     Loop index nomenclature
@@ -208,6 +264,76 @@ void VisitModelCell::compute(
   set_energy(inner().energy());
 }
 
+void VisitModelCell::compute_threads_(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    Configuration * config,
+    const int num_threads) {
+  const int num_cells = cells_->num_total();
+  #pragma omp parallel num_threads(num_threads)
+  {
+    int thread = 0;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    #endif // _OPENMP
+    VisitModelInner * inner = get_thread_inner_(thread);
+    Position * relative = get_thread_relative_(thread);
+    Position * pbc = get_thread_pbc_(thread);
+    #pragma omp for schedule(static, 1)
+    for (int cell1 = 0; cell1 < num_cells; ++cell1) {
+      const Select& select1 = cells_->particles()[cell1];
+
+      // neighboring cells where cell1 < cell2 only
+      for (int cell2 : cells_->neighbor()[cell1]) {
+        if (cell1 < cell2) {
+          const Select& select2 = cells_->particles()[cell2];
+          for (int select1_index = 0;
+               select1_index < select1.num_particles();
+               ++select1_index) {
+            const int part1_index = select1.particle_index(select1_index);
+            for (int select2_index = 0;
+                 select2_index < select2.num_particles();
+                 ++select2_index) {
+              const int part2_index = select2.particle_index(select2_index);
+              if (part1_index != part2_index) {
+                for (int site1_index : select1.site_indices(select1_index)) {
+                  for (int site2_index : select2.site_indices(select2_index)) {
+                    inner->compute(part1_index, site1_index, part2_index,
+                      site2_index, config, model_params, model, false,
+                      relative, pbc);
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+
+      // the same cell only
+      for (int select1_index = 0;
+           select1_index < select1.num_particles() - 1;
+           ++select1_index) {
+        const int part1_index = select1.particle_index(select1_index);
+        for (int select2_index = select1_index + 1;
+             select2_index < select1.num_particles();
+             ++select2_index) {
+          const int part2_index = select1.particle_index(select2_index);
+          if (part1_index != part2_index) {
+            for (int site1_index : select1.site_indices(select1_index)) {
+              for (int site2_index : select1.site_indices(select2_index)) {
+                inner->compute(part1_index, site1_index, part2_index,
+                  site2_index, config, model_params, model, false,
+                  relative, pbc);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  set_energy(sum_thread_energy_());
+}
+
 void VisitModelCell::compute(
     ModelTwoBody * model,
     const ModelParams& model_params,
@@ -222,6 +348,14 @@ void VisitModelCell::compute(
 
   // If only one particle in selection, simply exclude part1==part2
   DEBUG("num particles in selection " << selection.num_particles());
+  if (batch_ && selection.num_particles() == 1) {
+    compute_batch_(model, model_params, selection, config);
+    return;
+  }
+  if (sorted_cells_) {
+    compute_sorted_(model, model_params, selection, config);
+    return;
+  }
   if (selection.num_particles() == 1) {
     for (int select1_index = 0;
          select1_index < selection.num_particles();
@@ -301,6 +435,252 @@ void VisitModelCell::compute(
   set_energy(inner().energy());
 }
 
+void VisitModelCell::batch_add_(const Select& cell_parts,
+    const int first_select_index,
+    const int part1_index,
+    const Configuration& config) {
+  for (int select2_index = first_select_index;
+       select2_index < cell_parts.num_particles();
+       ++select2_index) {
+    const int part2_index = cell_parts.particle_index(select2_index);
+    if (part1_index != part2_index) {
+      const Particle& part2 = config.select_particle(part2_index);
+      for (int site2_index : cell_parts.site_indices(select2_index)) {
+        const Site& site2 = part2.site(site2_index);
+        if (site2.is_physical()) {
+          pair_batch_->add(site2.position().coord(), site2.type());
+        }
+      }
+    }
+  }
+}
+
+void VisitModelCell::batch_add_sorted_(const int cell,
+    const int first_slot,
+    const int part1_index,
+    const Configuration& config) {
+  const SortedCells& cells = *sorted_cells_;
+  for (int slot = first_slot; slot < cells.end(cell); ++slot) {
+    const int part2_index = cells.particle(slot);
+    if (part1_index != part2_index) {
+      if (config.select_particle(part2_index).site(
+          cells.site(slot)).is_physical()) {
+        pair_batch_->add(cells.coord(slot), cells.type(slot));
+      }
+    }
+  }
+}
+
+void VisitModelCell::compute_batch_(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    Configuration * config) {
+  const Domain& domain = config->domain();
+  if (!pair_batch_) {
+    pair_batch_ = std::make_shared<PairBatch>();
+  }
+  double energy = 0.;
+  if (sorted_cells_) {
+    const SortedCells& cells = *sorted_cells_;
+    for (const int cell1 : cells.order()) {
+      for (int slot1 = cells.begin(cell1); slot1 < cells.end(cell1); ++slot1) {
+        const int part1_index = cells.particle(slot1);
+        const Site& site1 =
+          config->select_particle(part1_index).site(cells.site(slot1));
+        if (site1.is_physical()) {
+          // gather neighboring cells where cell1 < cell2, and the sites
+          // later in the same cell.
+          pair_batch_->clear(domain.dimension());
+          for (int neigh = cells.neighbor_begin(cell1);
+               neigh < cells.neighbor_end(cell1);
+               ++neigh) {
+            const int cell2 = cells.neighbor()[neigh];
+            if (cell1 < cell2) {
+              batch_add_sorted_(cell2, cells.begin(cell2), part1_index,
+                                *config);
+            } else if (cell1 == cell2) {
+              batch_add_sorted_(cell2, slot1 + 1, part1_index, *config);
+            }
+          }
+          pair_batch_->compute_squared_distance(site1.position().coord(),
+                                                domain);
+          energy += pair_batch_->energy(site1.type(), model_params,
+                                        cutoff_index(), model);
+          if ((energy_cutoff() != -1) && (energy > energy_cutoff())) {
+            set_energy(energy);
+            return;
+          }
+        }
+      }
+    }
+    set_energy(energy);
+    return;
+  }
+  for (int cell1 = 0; cell1 < cells_->num_total(); ++cell1) {
+    const Select& select1 = cells_->particles()[cell1];
+    for (int select1_index = 0;
+         select1_index < select1.num_particles();
+         ++select1_index) {
+      const int part1_index = select1.particle_index(select1_index);
+      const Particle& part1 = config->select_particle(part1_index);
+      for (int site1_index : select1.site_indices(select1_index)) {
+        const Site& site1 = part1.site(site1_index);
+        if (site1.is_physical()) {
+          // gather neighboring cells where cell1 < cell2, and the particles
+          // later in the same cell.
+          pair_batch_->clear(domain.dimension());
+          for (int cell2 : cells_->neighbor()[cell1]) {
+            if (cell1 < cell2) {
+              batch_add_(cells_->particles()[cell2], 0, part1_index, *config);
+            } else if (cell1 == cell2) {
+              batch_add_(select1, select1_index + 1, part1_index, *config);
+            }
+          }
+          pair_batch_->compute_squared_distance(site1.position().coord(),
+                                                domain);
+          energy += pair_batch_->energy(site1.type(), model_params,
+                                        cutoff_index(), model);
+          if ((energy_cutoff() != -1) && (energy > energy_cutoff())) {
+            set_energy(energy);
+            return;
+          }
+        }
+      }
+    }
+  }
+  set_energy(energy);
+}
+
+void VisitModelCell::compute_batch_(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    const Select& selection,
+    Configuration * config) {
+  const Domain& domain = config->domain();
+  if (!pair_batch_) {
+    pair_batch_ = std::make_shared<PairBatch>();
+  }
+  double energy = 0.;
+  const int part1_index = selection.particle_index(0);
+  const Particle& part1 = config->select_particle(part1_index);
+  for (int site1_index : selection.site_indices(0)) {
+    const Site& site1 = part1.site(site1_index);
+    if (site1.is_physical()) {
+      const int cell1_index = cell_id_opt_(domain, site1.position());
+      pair_batch_->clear(domain.dimension());
+      if (sorted_cells_) {
+        const SortedCells& cells = *sorted_cells_;
+        for (int neigh = cells.neighbor_begin(cell1_index);
+             neigh < cells.neighbor_end(cell1_index);
+             ++neigh) {
+          const int cell2 = cells.neighbor()[neigh];
+          batch_add_sorted_(cell2, cells.begin(cell2), part1_index, *config);
+        }
+      } else {
+        for (int cell2_index : cells_->neighbor()[cell1_index]) {
+          batch_add_(cells_->particles()[cell2_index], 0, part1_index,
+                     *config);
+        }
+      }
+      pair_batch_->compute_squared_distance(site1.position().coord(), domain);
+      energy += pair_batch_->energy(site1.type(), model_params,
+                                    cutoff_index(), model);
+      if ((energy_cutoff() != -1) && (energy > energy_cutoff())) {
+        set_energy(energy);
+        return;
+      }
+    }
+  }
+  set_energy(energy);
+}
+
+void VisitModelCell::compute_sorted_(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    Configuration * config) {
+  const SortedCells& cells = *sorted_cells_;
+  for (const int cell1 : cells.order()) {
+    for (int slot1 = cells.begin(cell1); slot1 < cells.end(cell1); ++slot1) {
+      const int part1_index = cells.particle(slot1);
+      const int site1_index = cells.site(slot1);
+      for (int neigh = cells.neighbor_begin(cell1);
+           neigh < cells.neighbor_end(cell1);
+           ++neigh) {
+        // loop through neighboring cells where cell1 < cell2, and the sites
+        // later in the same cell.
+        const int cell2 = cells.neighbor()[neigh];
+        int slot2 = cells.begin(cell2);
+        if (cell1 == cell2) {
+          slot2 = slot1 + 1;
+        } else if (cell1 > cell2) {
+          continue;
+        }
+        for (; slot2 < cells.end(cell2); ++slot2) {
+          const int part2_index = cells.particle(slot2);
+          if (part1_index != part2_index) {
+            get_inner_()->compute(part1_index, site1_index, part2_index,
+                                  cells.site(slot2), config, model_params,
+                                  model, false, relative_.get(), pbc_.get());
+            if ((energy_cutoff() != -1) &&
+                (inner().energy() > energy_cutoff())) {
+              set_energy(inner().energy());
+              return;
+            }
+          }
+        }
+      }
+    }
+  }
+  set_energy(inner().energy());
+}
+
+void VisitModelCell::compute_sorted_(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    const Select& selection,
+    Configuration * config) {
+  const Domain& domain = config->domain();
+  const SortedCells& cells = *sorted_cells_;
+  const bool is_one = selection.num_particles() == 1;
+  for (int select1_index = 0;
+       select1_index < selection.num_particles();
+       ++select1_index) {
+    const int part1_index = selection.particle_index(select1_index);
+    const Particle& part1 = config->select_particle(part1_index);
+    for (int site1_index : selection.site_indices(select1_index)) {
+      const int cell1 = cell_id_opt_(domain, part1.site(site1_index).position());
+      for (int neigh = cells.neighbor_begin(cell1);
+           neigh < cells.neighbor_end(cell1);
+           ++neigh) {
+        const int cell2 = cells.neighbor()[neigh];
+        for (int slot2 = cells.begin(cell2); slot2 < cells.end(cell2);
+             ++slot2) {
+          const int part2_index = cells.particle(slot2);
+          // If only one particle in selection, simply exclude part1==part2.
+          // Otherwise, skip those in selection.
+          if ((is_one && part1_index != part2_index) ||
+              (!is_one &&
+               !find_in_list(part2_index, selection.particle_indices()))) {
+            get_inner_()->compute(part1_index, site1_index, part2_index,
+                                  cells.site(slot2), config, model_params,
+                                  model, false, relative_.get(), pbc_.get());
+            if ((energy_cutoff() != -1) &&
+                (inner().energy() > energy_cutoff())) {
+              set_energy(inner().energy());
+              return;
+            }
+          }
+        }
+      }
+    }
+  }
+  if (!is_one) {
+    compute_between_selection(model, model_params, selection,
+      config, false, relative_.get(), pbc_.get());
+  }
+  set_energy(inner().energy());
+}
+
 void VisitModelCell::position_tracker_(const Select& select,
     Configuration * config) {
   for (int spindex = 0; spindex < select.num_particles(); ++spindex) {
@@ -356,6 +736,10 @@ void VisitModelCell::position_tracker_(const Select& select,
               << cell_new << " si " << site_index);
             cells_->add(*one_site_select_, cell_new);
           }
+          if (sorted_cells_) {
+            sorted_cells_->update(particle_index, site_index, cell_new,
+              site.position().coord().data(), site.type());
+          }
         }
       }
     }
@@ -381,6 +765,9 @@ void VisitModelCell::finalize(const Select& select, Configuration * config) {
               select.add_site(particle_index, site_index);
               cells_->remove(select, cell_old);
             }
+            if (sorted_cells_) {
+              sorted_cells_->remove(particle_index, site_index);
+            }
           }
         }
       }
@@ -408,10 +795,21 @@ void VisitModelCell::check(const Configuration& config) const {
   ASSERT(num_sites_in_cell == cells_->num_sites(),
     "num sites with cells: " << num_sites_in_cell << " != " <<
     cells_->num_sites());
+  if (sorted_cells_) {
+    sorted_cells_->check();
+    ASSERT(sorted_cells_->num_sites() == cells_->num_sites(),
+      "num sites in SortedCells: " << sorted_cells_->num_sites() << " != " <<
+      cells_->num_sites());
+  }
 }
 
 const Cells& VisitModelCell::cells() const { return *cells_; }
 
+const SortedCells& VisitModelCell::sorted_cells() const {
+  ASSERT(sorted_cells_, "sorted_cells is not used");
+  return *sorted_cells_;
+}
+
 class MapVisitModelCell {
  public:
   MapVisitModelCell() {
@@ -424,10 +822,18 @@ static MapVisitModelCell mapper_ = MapVisitModelCell();
 
 VisitModelCell::VisitModelCell(std::istream& istr) : VisitModel(istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(755 == version, version);
+  ASSERT(version >= 755 && version <= 757, "mismatch version: " << version);
   feasst_deserialize(&min_length_, istr);
   feasst_deserialize(&group_index_, istr);
   feasst_deserialize(&group_, istr);
+  batch_ = false;
+  if (version >= 756) {
+    feasst_deserialize(&batch_, istr);
+  }
+  sorted_ = false;
+  if (version >= 757) {
+    feasst_deserialize(&sorted_, istr);
+  }
 //  feasst_deserialize_fstobj(&opt_origin_, istr);
 //  feasst_deserialize_fstobj(&opt_rel_, istr);
 //  feasst_deserialize_fstobj(&opt_pbc_, istr);
@@ -445,10 +851,12 @@ VisitModelCell::VisitModelCell(std::istream& istr) : VisitModel(istr) {
 void VisitModelCell::serialize(std::ostream& ostr) const {
   ostr << class_name_ << " ";
   serialize_visit_model_(ostr);
-  feasst_serialize_version(755, ostr);
+  feasst_serialize_version(757, ostr);
   feasst_serialize(min_length_, ostr);
   feasst_serialize(group_index_, ostr);
   feasst_serialize(group_, ostr);
+  feasst_serialize(batch_, ostr);
+  feasst_serialize(sorted_, ostr);
 //  feasst_serialize_fstobj(opt_origin_, ostr);
 //  feasst_serialize_fstobj(opt_rel_, ostr);
 //  feasst_serialize_fstobj(opt_pbc_, ostr);
@@ -1,3 +1,6 @@
+#ifdef _OPENMP
+  #include <omp.h>
+#endif // _OPENMP
 #include <cmath>
 #include <vector>
 #include "utils/include/arguments.h"
@@ -35,68 +38,80 @@ void VisitModelIntra::compute(
   for (int sp1index = 0;
        sp1index < static_cast<int>(selection.particle_indices().size());
        ++sp1index) {
-    const int part1_index = selection.particle_index(sp1index);
-    TRACE("particle: " << part1_index);
-    const Particle& part1 = config->select_particle(part1_index);
-    // the first site loop is over all sites in part1 and group_index
-    // the second is all sites in selection
-    // HWH optimize this
+    compute_particle_(sp1index, model, model_params, selection, config,
+                      get_inner_(), relative_.get(), pbc_.get());
+  }
+  set_energy(inner().energy());
+}
 
-    // here we use excluded to account for chain regrowth, etc.
-    // exclude the particles which haven't been grown yet.
-    // or exclude particles which will form new bonds (reptate).
-    Select sites1;
-    sites1.add_sites(selection.particle_index(sp1index),
-                     selection.site_indices(sp1index));
-    if (selection.excluded()) {
-      sites1.remove(*(selection.excluded()));
-      TRACE("excluded " << selection.excluded()->str());
-    }
-    TRACE("sites1: " << sites1.str());
-    const std::vector<int>& site1_indices = sites1.site_indices(0);
+void VisitModelIntra::compute_particle_(
+    const int sp1index,
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    const Select& selection,
+    const Configuration * config,
+    VisitModelInner * inner,
+    Position * relative,
+    Position * pbc) {
+  const int part1_index = selection.particle_index(sp1index);
+  TRACE("particle: " << part1_index);
+  const Particle& part1 = config->select_particle(part1_index);
+  // the first site loop is over all sites in part1 and group_index
+  // the second is all sites in selection
+  // HWH optimize this
 
-    Select sites2;
-    sites2.add_particle(part1, part1_index);
-    if (selection.excluded()) {
-      sites2.remove(*(selection.excluded()));
-      TRACE("excluded " << selection.excluded()->str());
-    }
-    TRACE("sites2: " << sites2.str());
-    const std::vector<int>& site2_indices = sites2.site_indices(0);
-    for (const int site1_index : site1_indices) {
-      for (const int site2_index : site2_indices) {
-        // if sites in particle selection > 1, attempt the following check.
-        // if site2 is in selection, then require site1 < site2
-        if (!find_in_list(site2_index, site1_indices) ||
-            site1_index < site2_index) {
-          bool include = false;
-          if (selection.old_bond()) {
-            if (site2_index ==
-                selection.old_bond()->site_indices()[sp1index][0]) {
-              include = true;
-            }
+  // here we use excluded to account for chain regrowth, etc.
+  // exclude the particles which haven't been grown yet.
+  // or exclude particles which will form new bonds (reptate).
+  Select sites1;
+  sites1.add_sites(selection.particle_index(sp1index),
+                   selection.site_indices(sp1index));
+  if (selection.excluded()) {
+    sites1.remove(*(selection.excluded()));
+    TRACE("excluded " << selection.excluded()->str());
+  }
+  TRACE("sites1: " << sites1.str());
+  const std::vector<int>& site1_indices = sites1.site_indices(0);
+
+  Select sites2;
+  sites2.add_particle(part1, part1_index);
+  if (selection.excluded()) {
+    sites2.remove(*(selection.excluded()));
+    TRACE("excluded " << selection.excluded()->str());
+  }
+  TRACE("sites2: " << sites2.str());
+  const std::vector<int>& site2_indices = sites2.site_indices(0);
+  for (const int site1_index : site1_indices) {
+    for (const int site2_index : site2_indices) {
+      // if sites in particle selection > 1, attempt the following check.
+      // if site2 is in selection, then require site1 < site2
+      if (!find_in_list(site2_index, site1_indices) ||
+          site1_index < site2_index) {
+        bool include = false;
+        if (selection.old_bond()) {
+          if (site2_index ==
+              selection.old_bond()->site_indices()[sp1index][0]) {
+            include = true;
           }
-          bool exclude = false;
-          if (selection.new_bond()) {
-            if (site2_index ==
-                selection.new_bond()->site_indices()[sp1index][0]) {
-              exclude = true;
-            }
+        }
+        bool exclude = false;
+        if (selection.new_bond()) {
+          if (site2_index ==
+              selection.new_bond()->site_indices()[sp1index][0]) {
+            exclude = true;
           }
+        }
 
-          // forced exclude takes precedent over forced include
-          if ( (include || std::abs(site1_index - site2_index) > intra_cut_) &&
-               (!exclude) ) {
-            TRACE("sites: " << site1_index << " " << site2_index);
-            get_inner_()->compute(part1_index, site1_index, part1_index,
-              site2_index, config, model_params, model, false, relative_.get(),
-              pbc_.get());
-          }
+        // forced exclude takes precedent over forced include
+        if ( (include || std::abs(site1_index - site2_index) > intra_cut_) &&
+             (!exclude) ) {
+          TRACE("sites: " << site1_index << " " << site2_index);
+          inner->compute(part1_index, site1_index, part1_index,
+            site2_index, config, model_params, model, false, relative, pbc);
         }
       }
     }
   }
-  set_energy(inner().energy());
 }
 
 class MapVisitModelIntra {
@@ -127,8 +142,31 @@ void VisitModelIntra::compute(
     const ModelParams& model_params,
     Configuration * config,
     const int group_index) {
-  compute(model, model_params, config->selection_of_all(),
-          config, group_index);
+  const Select& selection = config->selection_of_all();
+  const int num_threads = init_threads_(config->domain());
+  if (num_threads == 1) {
+    compute(model, model_params, selection, config, group_index);
+    return;
+  }
+  ASSERT(group_index == 0,
+    "need to implement site1 loop filtering particles by group");
+  zero_energy();
+  const int num_particles = static_cast<int>(
+    selection.particle_indices().size());
+  #pragma omp parallel num_threads(num_threads)
+  {
+    int thread = 0;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    #endif // _OPENMP
+    #pragma omp for schedule(static, 1)
+    for (int sp1index = 0; sp1index < num_particles; ++sp1index) {
+      compute_particle_(sp1index, model, model_params, selection, config,
+        get_thread_inner_(thread), get_thread_relative_(thread),
+        get_thread_pbc_(thread));
+    }
+  }
+  set_energy(sum_thread_energy_());
 }
 
 }  // namespace feasst
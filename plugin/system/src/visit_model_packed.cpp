@@ -0,0 +1,218 @@
+#include <cmath>
+#include "utils/include/arguments.h"
+#include "utils/include/serialize.h"
+#include "math/include/fixed_position.h"
+#include "configuration/include/select.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/model_params.h"
+#include "configuration/include/packed_sites.h"
+#include "configuration/include/configuration.h"
+#include "system/include/model_two_body.h"
+#include "system/include/visit_model_inner.h"
+#include "system/include/pair_batch.h"
+#include "system/include/visit_model_packed.h"
+
+namespace feasst {
+
+VisitModelPacked::VisitModelPacked(argtype * args) : VisitModel(args) {
+  class_name_ = "VisitModelPacked";
+}
+VisitModelPacked::VisitModelPacked(argtype args) : VisitModelPacked(&args) {
+  feasst_check_all_used(args);
+}
+
+class MapVisitModelPacked {
+ public:
+  MapVisitModelPacked() {
+    auto obj = MakeVisitModelPacked();
+    obj->deserialize_map()["VisitModelPacked"] = obj;
+  }
+};
+
+static MapVisitModelPacked mapper_ = MapVisitModelPacked();
+
+void VisitModelPacked::precompute(Configuration * config) {
+  VisitModel::precompute(config);
+  ASSERT(inner().class_name() == "VisitModelInner",
+    "VisitModelPacked does not support " << inner().class_name());
+  ASSERT(!inner().is_energy_map(), "VisitModelPacked does not support EnergyMap");
+  config->init_packed_sites();
+  if (!pair_batch_) {
+    pair_batch_ = std::make_shared<PairBatch>();
+  }
+}
+
+bool VisitModelPacked::is_packable_(const Configuration& config,
+                                    const int group_index) const {
+  const int dimen = config.dimension();
+  return group_index == 0 && config.is_packed() &&
+         (dimen == 2 || dimen == 3);
+}
+
+// Load the coordinates of a site into a position of fixed dimension.
+template <int D>
+inline void packed_position(const int site,
+    const std::vector<const double *>& coord,
+    FixedPosition<D> * position) {
+  for (int dim = 0; dim < D; ++dim) {
+    position->set_coord(dim, coord[dim][site]);
+  }
+}
+
+void VisitModelPacked::compute(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    Configuration * config,
+    const int group_index) {
+  if (!is_packable_(*config, group_index)) {
+    VisitModel::compute(model, model_params, config, group_index);
+    return;
+  }
+  if (config->dimension() == 3) {
+    compute_<3>(model, model_params, *config);
+  } else {
+    compute_<2>(model, model_params, *config);
+  }
+}
+
+template <int D>
+void VisitModelPacked::compute_(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    const Configuration& config) {
+  zero_energy();
+  if (!pair_batch_) {
+    pair_batch_ = std::make_shared<PairBatch>();
+  }
+  const Domain& domain = config.domain();
+  const PackedSites& packed = config.packed_sites();
+  std::vector<const double *> coord(D);
+  for (int dim = 0; dim < D; ++dim) {
+    coord[dim] = packed.coord(dim).data();
+  }
+  const int * type = packed.type().data();
+  const int * present = packed.present().data();
+  const int * particle_index = packed.particle_index().data();
+  const std::vector<std::vector<double> >& cutoff =
+    model_params.select(cutoff_index()).mixed_values();
+  const int num_sites = packed.num_sites();
+  FixedPosition<D> pos1, pos2, rel, pbc;
+  double r2;
+  double energy = 0.;
+  for (int site1 = 0; site1 < num_sites; ++site1) {
+    if (present[site1] == 1) {
+      const int type1 = type[site1];
+      packed_position(site1, coord, &pos1);
+      const std::vector<double>& cutoff1 = cutoff[type1];
+      // sites of the same particle are contiguous, so begin with the next
+      for (int site2 = packed.start(particle_index[site1] + 1);
+           site2 < num_sites;
+           ++site2) {
+        if (present[site2] == 1) {
+          packed_position(site2, coord, &pos2);
+          domain.wrap_opt(pos1, pos2, &rel, &pbc, &r2);
+          const int type2 = type[site2];
+          const double cut = cutoff1[type2];
+          if (r2 <= cut*cut) {
+            pair_batch_->add_pair(r2, type2);
+          }
+        }
+      }
+      energy += pair_batch_->pair_energy(type1, model_params, model);
+      if ((energy_cutoff() != -1) && (energy > energy_cutoff())) {
+        set_energy(energy);
+        return;
+      }
+    }
+  }
+  set_energy(energy);
+}
+
+void VisitModelPacked::compute(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    const Select& selection,
+    Configuration * config,
+    const int group_index) {
+  if (!is_packable_(*config, group_index) ||
+      selection.num_particles() != 1) {
+    VisitModel::compute(model, model_params, selection, config, group_index);
+    return;
+  }
+  if (config->dimension() == 3) {
+    compute_<3>(model, model_params, selection, *config);
+  } else {
+    compute_<2>(model, model_params, selection, *config);
+  }
+}
+
+template <int D>
+void VisitModelPacked::compute_(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    const Select& selection,
+    const Configuration& config) {
+  zero_energy();
+  if (!pair_batch_) {
+    pair_batch_ = std::make_shared<PairBatch>();
+  }
+  const Domain& domain = config.domain();
+  const PackedSites& packed = config.packed_sites();
+  std::vector<const double *> coord(D);
+  for (int dim = 0; dim < D; ++dim) {
+    coord[dim] = packed.coord(dim).data();
+  }
+  const int * type = packed.type().data();
+  const int * present = packed.present().data();
+  const std::vector<std::vector<double> >& cutoff =
+    model_params.select(cutoff_index()).mixed_values();
+  const int num_sites = packed.num_sites();
+  const int part1_index = selection.particle_index(0);
+  const int begin1 = packed.start(part1_index);
+  const int end1 = packed.start(part1_index + 1);
+  FixedPosition<D> pos1, pos2, rel, pbc;
+  double r2;
+  double energy = 0.;
+  for (const int site1_index : selection.site_indices(0)) {
+    const int site1 = begin1 + site1_index;
+    if (present[site1] == 1) {
+      const int type1 = type[site1];
+      packed_position(site1, coord, &pos1);
+      const std::vector<double>& cutoff1 = cutoff[type1];
+      // skip the contiguous sites of the selected particle
+      for (const std::pair<int, int>& range : {std::make_pair(0, begin1),
+                                               std::make_pair(end1, num_sites)}) {
+        for (int site2 = range.first; site2 < range.second; ++site2) {
+          if (present[site2] == 1) {
+            packed_position(site2, coord, &pos2);
+            domain.wrap_opt(pos1, pos2, &rel, &pbc, &r2);
+            const int type2 = type[site2];
+            const double cut = cutoff1[type2];
+            if (r2 <= cut*cut) {
+              pair_batch_->add_pair(r2, type2);
+            }
+          }
+        }
+      }
+      energy += pair_batch_->pair_energy(type1, model_params, model);
+      if ((energy_cutoff() != -1) && (energy > energy_cutoff())) {
+        set_energy(energy);
+        return;
+      }
+    }
+  }
+  set_energy(energy);
+}
+
+VisitModelPacked::VisitModelPacked(std::istream& istr) : VisitModel(istr) {
+  const int version = feasst_deserialize_version(istr);
+  ASSERT(3641 == version, "mismatch version: " << version);
+}
+
+void VisitModelPacked::serialize(std::ostream& ostr) const {
+  ostr << class_name_ << " ";
+  serialize_visit_model_(ostr);
+  feasst_serialize_version(3641, ostr);
+}
+
+}  // namespace feasst
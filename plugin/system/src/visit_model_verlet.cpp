@@ -0,0 +1,503 @@
+#include <cmath>
+#include <algorithm>
+#include "utils/include/arguments.h"
+#include "utils/include/utils.h"
+#include "utils/include/serialize.h"
+#include "math/include/constants.h"
+#include "configuration/include/particle.h"
+#include "configuration/include/select.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/model_params.h"
+#include "configuration/include/configuration.h"
+#include "system/include/cells.h"
+#include "system/include/visit_model_inner.h"
+#include "system/include/visit_model_verlet.h"
+
+namespace feasst {
+
+VisitModelVerlet::VisitModelVerlet(argtype * args) : VisitModel(args) {
+  class_name_ = "VisitModelVerlet";
+  skin_ = dble("skin", args, 0.3);
+  ASSERT(skin_ >= 0., "skin: " << skin_ << " must be >= 0");
+}
+VisitModelVerlet::VisitModelVerlet(argtype args) : VisitModelVerlet(&args) {
+  feasst_check_all_used(args);
+}
+
+class MapVisitModelVerlet {
+ public:
+  MapVisitModelVerlet() {
+    auto obj = MakeVisitModelVerlet();
+    obj->deserialize_map()["VisitModelVerlet"] = obj;
+  }
+};
+
+static MapVisitModelVerlet mapper_ = MapVisitModelVerlet();
+
+int VisitModelVerlet::num_neighbors(const int particle_index,
+                                    const int site_index) const {
+  ASSERT(particle_index < static_cast<int>(neighbors_.size()),
+    "particle_index: " << particle_index << " is not listed");
+  return static_cast<int>(neighbors_[particle_index][site_index].size())/2;
+}
+
+void VisitModelVerlet::precompute(Configuration * config) {
+  VisitModel::precompute(config);
+  ASSERT(cutoff_index() != -1, "VisitModelVerlet requires a cutoff");
+  build_(*config);
+}
+
+void VisitModelVerlet::change_volume(const double delta_volume,
+    const int dimension, Configuration * config) {
+  build_(*config);
+}
+
+std::vector<double> VisitModelVerlet::domain_state_(
+    const Configuration& config) const {
+  const Domain& domain = config.domain();
+  std::vector<double> state = domain.side_lengths().coord();
+  if (domain.is_tilted()) {
+    state.push_back(domain.xy());
+    state.push_back(domain.xz());
+    state.push_back(domain.yz());
+  }
+  return state;
+}
+
+bool VisitModelVerlet::is_listed_(const int particle_index) const {
+  return particle_index < static_cast<int>(reference_.size()) &&
+         reference_[particle_index].size() > 0;
+}
+
+double VisitModelVerlet::displacement_(const int particle_index,
+    const int site_index,
+    const Configuration& config) {
+  double r2;
+  config.domain().wrap_opt(
+    config.select_particle(particle_index).site(site_index).position(),
+    reference_[particle_index][site_index],
+    relative_.get(), pbc_.get(), &r2);
+  return std::sqrt(r2);
+}
+
+bool VisitModelVerlet::is_current_(const Configuration& config) {
+  if (!is_built_ || domain_state_(config) != built_domain_) {
+    return false;
+  }
+  const Select& all = config.group_select(0);
+  if (all.num_particles() != num_listed_) {
+    return false;
+  }
+  for (int select_index = 0;
+       select_index < all.num_particles();
+       ++select_index) {
+    const int part_index = all.particle_index(select_index);
+    if (!is_listed_(part_index) ||
+        static_cast<int>(reference_[part_index].size()) !=
+        config.select_particle(part_index).num_sites()) {
+      return false;
+    }
+    for (const int site_index : all.site_indices(select_index)) {
+      if (displacement_(part_index, site_index, config) > 0.5*skin_) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void VisitModelVerlet::resize_(const int num_particles) {
+  if (static_cast<int>(reference_.size()) < num_particles) {
+    reference_.resize(num_particles);
+    neighbors_.resize(num_particles);
+  }
+}
+
+void VisitModelVerlet::set_reference_(const int particle_index,
+                                      const Configuration& config) {
+  const Particle& part = config.select_particle(particle_index);
+  resize_(particle_index + 1);
+  if (!is_listed_(particle_index)) {
+    ++num_listed_;
+  }
+  std::vector<Position>& reference = reference_[particle_index];
+  reference.resize(part.num_sites());
+  neighbors_[particle_index].resize(part.num_sites());
+  for (int site_index = 0; site_index < part.num_sites(); ++site_index) {
+    reference[site_index] = part.site(site_index).position();
+    neighbors_[particle_index][site_index].clear();
+  }
+}
+
+void VisitModelVerlet::add_if_neighbor_(const int part1_index,
+    const int site1_index,
+    const int part2_index,
+    const int site2_index,
+    const Configuration& config) {
+  double r2;
+  config.domain().wrap_opt(reference_[part1_index][site1_index],
+                           reference_[part2_index][site2_index],
+                           relative_.get(), pbc_.get(), &r2);
+  const int type1 = config.select_particle(part1_index).site(site1_index).type();
+  const int type2 = config.select_particle(part2_index).site(site2_index).type();
+  if (r2 <= list_cutoff_sq_[type1][type2]) {
+    std::vector<int>* neigh1 = &neighbors_[part1_index][site1_index];
+    neigh1->push_back(part2_index);
+    neigh1->push_back(site2_index);
+    std::vector<int>* neigh2 = &neighbors_[part2_index][site2_index];
+    neigh2->push_back(part1_index);
+    neigh2->push_back(site1_index);
+  }
+}
+
+void VisitModelVerlet::remove_particle_(const int particle_index) {
+  if (!is_listed_(particle_index)) {
+    return;
+  }
+  // remove the particle from the lists of its neighbors
+  std::vector<std::vector<int> >& neighbors = neighbors_[particle_index];
+  for (int site_index = 0;
+       site_index < static_cast<int>(neighbors.size());
+       ++site_index) {
+    const std::vector<int>& neigh = neighbors[site_index];
+    for (int index = 0; index < static_cast<int>(neigh.size()); index += 2) {
+      std::vector<int>* neigh2 = &neighbors_[neigh[index]][neigh[index + 1]];
+      for (int index2 = 0;
+           index2 < static_cast<int>(neigh2->size());
+           index2 += 2) {
+        if ((*neigh2)[index2] == particle_index &&
+            (*neigh2)[index2 + 1] == site_index) {
+          (*neigh2)[index2] = (*neigh2)[neigh2->size() - 2];
+          (*neigh2)[index2 + 1] = (*neigh2)[neigh2->size() - 1];
+          neigh2->resize(neigh2->size() - 2);
+          break;
+        }
+      }
+    }
+  }
+  neighbors.clear();
+  reference_[particle_index].clear();
+  --num_listed_;
+}
+
+void VisitModelVerlet::build_particle_(const int particle_index,
+                                       const Configuration& config) {
+  remove_particle_(particle_index);
+  set_reference_(particle_index, config);
+  const Select& all = config.group_select(0);
+  for (int select2_index = 0;
+       select2_index < all.num_particles();
+       ++select2_index) {
+    const int part2_index = all.particle_index(select2_index);
+    if (part2_index != particle_index && is_listed_(part2_index)) {
+      for (int site1_index = 0;
+           site1_index < static_cast<int>(reference_[particle_index].size());
+           ++site1_index) {
+        for (const int site2_index : all.site_indices(select2_index)) {
+          add_if_neighbor_(particle_index, site1_index, part2_index,
+                           site2_index, config);
+        }
+      }
+    }
+  }
+  ++num_particle_builds_;
+}
+
+void VisitModelVerlet::build_(const Configuration& config) {
+  DEBUG("building");
+  const Domain& domain = config.domain();
+  init_relative_(domain);
+  const std::vector<std::vector<double> >& cutoff =
+    config.model_params().select(cutoff_index()).mixed_values();
+  list_cutoff_sq_ = cutoff;
+  double max_cutoff = 0.;
+  for (std::vector<double>& cut : list_cutoff_sq_) {
+    for (double& value : cut) {
+      max_cutoff = std::max(max_cutoff, value);
+      value = std::pow(value + skin_, 2);
+    }
+  }
+  reference_.clear();
+  neighbors_.clear();
+  num_listed_ = 0;
+  const Select& all = config.group_select(0);
+  std::vector<int> site_part, site_site;
+  for (int select_index = 0;
+       select_index < all.num_particles();
+       ++select_index) {
+    const int part_index = all.particle_index(select_index);
+    set_reference_(part_index, config);
+    for (const int site_index : all.site_indices(select_index)) {
+      site_part.push_back(part_index);
+      site_site.push_back(site_index);
+    }
+  }
+  const int num_sites = static_cast<int>(site_part.size());
+
+  // When possible, bin the sites into cells to find neighbors.
+  // Each dimension requires at least 3 cells to avoid duplicate neighbors.
+  Cells cells;
+  bool is_binned = false;
+  if (!domain.is_tilted()) {
+    cells.create(max_cutoff + skin_, domain.side_lengths().coord());
+    is_binned = cells.num_total() > 0;
+    for (int dim = 0; is_binned && dim < domain.dimension(); ++dim) {
+      if (cells.num(dim) < 3) {
+        is_binned = false;
+      }
+    }
+  }
+  if (is_binned) {
+    std::vector<std::vector<int> > cell_sites(cells.num_total());
+    Position scaled;
+    for (int site = 0; site < num_sites; ++site) {
+      scaled = reference_[site_part[site]][site_site[site]];
+      domain.wrap(&scaled);
+      scaled.divide(domain.side_lengths());
+      cell_sites[cells.id(scaled.coord())].push_back(site);
+    }
+    for (int cell1 = 0; cell1 < cells.num_total(); ++cell1) {
+      const std::vector<int>& sites1 = cell_sites[cell1];
+      for (const int cell2 : cells.neighbor()[cell1]) {
+        if (cell1 <= cell2) {
+          const std::vector<int>& sites2 = cell_sites[cell2];
+          for (int index1 = 0;
+               index1 < static_cast<int>(sites1.size());
+               ++index1) {
+            const int site1 = sites1[index1];
+            int index2 = 0;
+            if (cell1 == cell2) {
+              index2 = index1 + 1;
+            }
+            for (; index2 < static_cast<int>(sites2.size()); ++index2) {
+              const int site2 = sites2[index2];
+              if (site_part[site1] != site_part[site2]) {
+                add_if_neighbor_(site_part[site1], site_site[site1],
+                                 site_part[site2], site_site[site2], config);
+              }
+            }
+          }
+        }
+      }
+    }
+  } else {
+    for (int site1 = 0; site1 < num_sites - 1; ++site1) {
+      for (int site2 = site1 + 1; site2 < num_sites; ++site2) {
+        if (site_part[site1] != site_part[site2]) {
+          add_if_neighbor_(site_part[site1], site_site[site1],
+                           site_part[site2], site_site[site2], config);
+        }
+      }
+    }
+  }
+  built_domain_ = domain_state_(config);
+  max_displacement_ = 0.;
+  is_built_ = true;
+  ++num_builds_;
+}
+
+void VisitModelVerlet::compute(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    Configuration * config,
+    const int group_index) {
+  if (group_index != 0) {
+    VisitModel::compute(model, model_params, config, group_index);
+    return;
+  }
+  zero_energy();
+  init_relative_(config->domain());
+  if (!is_current_(*config)) {
+    build_(*config);
+  }
+  const Select& all = config->group_select(group_index);
+  for (int select1_index = 0;
+       select1_index < all.num_particles();
+       ++select1_index) {
+    const int part1_index = all.particle_index(select1_index);
+    for (const int site1_index : all.site_indices(select1_index)) {
+      const std::vector<int>& neigh = neighbors_[part1_index][site1_index];
+      for (int index = 0; index < static_cast<int>(neigh.size()); index += 2) {
+        const int part2_index = neigh[index];
+        // each pair is listed twice
+        if (part1_index < part2_index) {
+          get_inner_()->compute(part1_index, site1_index, part2_index,
+                                neigh[index + 1], config, model_params, model,
+                                false, relative_.get(), pbc_.get());
+          if ((energy_cutoff() != -1) && (inner().energy() > energy_cutoff())) {
+            set_energy(inner().energy());
+            return;
+          }
+        }
+      }
+    }
+  }
+  set_energy(inner().energy());
+}
+
+bool VisitModelVerlet::compute_site_(const int part1_index,
+    const int site1_index,
+    const Select& selection,
+    const bool is_old_config,
+    const ModelParams& model_params,
+    ModelTwoBody * model,
+    Configuration * config) {
+  const bool is_one = selection.num_particles() == 1;
+  // The list is valid for a site which, when combined with the largest
+  // displacement of the others, moved less than the skin.
+  if (is_listed_(part1_index) &&
+      site1_index < static_cast<int>(reference_[part1_index].size()) &&
+      displacement_(part1_index, site1_index, *config) + max_displacement_ <=
+      skin_) {
+    const std::vector<int>& neigh = neighbors_[part1_index][site1_index];
+    for (int index = 0; index < static_cast<int>(neigh.size()); index += 2) {
+      const int part2_index = neigh[index];
+      if (is_one ||
+          !find_in_list(part2_index, selection.particle_indices())) {
+        get_inner_()->compute(part1_index, site1_index, part2_index,
+                              neigh[index + 1], config, model_params, model,
+                              is_old_config, relative_.get(), pbc_.get());
+        if ((energy_cutoff() != -1) && (inner().energy() > energy_cutoff())) {
+          return true;
+        }
+      }
+    }
+  } else {
+    const Select& all = config->group_select(0);
+    for (int select2_index = 0;
+         select2_index < all.num_particles();
+         ++select2_index) {
+      const int part2_index = all.particle_index(select2_index);
+      if ((is_one && part1_index != part2_index) ||
+          (!is_one &&
+           !find_in_list(part2_index, selection.particle_indices()))) {
+        for (const int site2_index : all.site_indices(select2_index)) {
+          get_inner_()->compute(part1_index, site1_index, part2_index,
+                                site2_index, config, model_params, model,
+                                is_old_config, relative_.get(), pbc_.get());
+          if ((energy_cutoff() != -1) &&
+              (inner().energy() > energy_cutoff())) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
+void VisitModelVerlet::compute(
+    ModelTwoBody * model,
+    const ModelParams& model_params,
+    const Select& selection,
+    Configuration * config,
+    const int group_index) {
+  if (group_index != 0) {
+    VisitModel::compute(model, model_params, selection, config, group_index);
+    return;
+  }
+  zero_energy();
+  init_relative_(config->domain());
+  if (!is_built_ || domain_state_(*config) != built_domain_) {
+    build_(*config);
+  }
+  bool is_old_config = false;
+  if (selection.trial_state() == 0 ||
+      selection.trial_state() == 2) {
+    is_old_config = true;
+  }
+  for (int select1_index = 0;
+       select1_index < selection.num_particles();
+       ++select1_index) {
+    const int part1_index = selection.particle_index(select1_index);
+    for (const int site1_index : selection.site_indices(select1_index)) {
+      if (compute_site_(part1_index, site1_index, selection, is_old_config,
+                        model_params, model, config)) {
+        set_energy(inner().energy());
+        return;
+      }
+    }
+  }
+  if (selection.num_particles() > 1) {
+    compute_between_selection(model, model_params, selection, config,
+      is_old_config, relative_.get(), pbc_.get());
+  }
+  set_energy(inner().energy());
+}
+
+void VisitModelVerlet::finalize(const Select& select, Configuration * config) {
+  VisitModel::finalize(select, config);
+  if (!is_built_) {
+    return;
+  }
+  init_relative_(config->domain());
+  if (select.trial_state() == 2) {
+    for (const int particle_index : select.particle_indices()) {
+      remove_particle_(particle_index);
+    }
+    return;
+  }
+  for (int select_index = 0;
+       select_index < select.num_particles();
+       ++select_index) {
+    const int particle_index = select.particle_index(select_index);
+    const int num_sites = config->select_particle(particle_index).num_sites();
+    if (!is_listed_(particle_index) ||
+        static_cast<int>(reference_[particle_index].size()) != num_sites) {
+      build_particle_(particle_index, *config);
+    } else {
+      double max_disp = 0.;
+      for (const int site_index : select.site_indices(select_index)) {
+        max_disp = std::max(max_disp,
+          displacement_(particle_index, site_index, *config));
+      }
+      if (max_disp > 0.5*skin_) {
+        build_particle_(particle_index, *config);
+      } else {
+        max_displacement_ = std::max(max_displacement_, max_disp);
+      }
+    }
+  }
+}
+
+void VisitModelVerlet::check(const Configuration& config) const {
+  VisitModel::check(config);
+  if (!is_built_ || domain_state_(config) != built_domain_) {
+    return;
+  }
+  const Select& all = config.group_select(0);
+  ASSERT(all.num_particles() == num_listed_, "num particles: " <<
+    all.num_particles() << " != num listed: " << num_listed_);
+  Position rel(config.dimension()), pbc(config.dimension());
+  double r2;
+  for (int select_index = 0;
+       select_index < all.num_particles();
+       ++select_index) {
+    const int part_index = all.particle_index(select_index);
+    ASSERT(is_listed_(part_index), "particle: " << part_index <<
+      " is not listed");
+    for (const int site_index : all.site_indices(select_index)) {
+      config.domain().wrap_opt(
+        config.select_particle(part_index).site(site_index).position(),
+        reference_[part_index][site_index], &rel, &pbc, &r2);
+      ASSERT(std::sqrt(r2) <= max_displacement_ + NEAR_ZERO,
+        "displacement: " << std::sqrt(r2) << " > max_displacement: " <<
+        max_displacement_);
+    }
+  }
+}
+
+VisitModelVerlet::VisitModelVerlet(std::istream& istr) : VisitModel(istr) {
+  const int version = feasst_deserialize_version(istr);
+  ASSERT(4721 == version, "mismatch version: " << version);
+  feasst_deserialize(&skin_, istr);
+}
+
+void VisitModelVerlet::serialize(std::ostream& ostr) const {
+  ostr << class_name_ << " ";
+  serialize_visit_model_(ostr);
+  feasst_serialize_version(4721, ostr);
+  feasst_serialize(skin_, ostr);
+}
+
+}  // namespace feasst
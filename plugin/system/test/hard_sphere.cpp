@@ -1,5 +1,6 @@
 #include <sstream>
 #include "utils/test/utils.h"
+#include "configuration/include/configuration.h"
 #include "system/include/hard_sphere.h"
 
 namespace feasst {
@@ -10,4 +11,20 @@ TEST(HardSphere, serialize) {
     test_serialize<HardSphere, Model>(model, "HardSphere 2094 -1 -1 -1 -1 607 ");
 }
 
+TEST(HardSphere, energy_batch) {
+  auto config = MakeConfiguration({{"particle_type0", "../particle/hard_sphere.fstprt"}});
+  auto model = MakeHardSphere();
+  model->precompute(config->model_params());
+  const std::vector<double> r2 = {0.5, 1., 1.5};
+  const std::vector<int> type1 = {0, 0, 0};
+  const std::vector<int> type2 = {0, 0, 0};
+  std::vector<double> energy(r2.size());
+  model->energy_batch(3, r2.data(), type1.data(), type2.data(),
+                      config->model_params(), energy.data());
+  for (int pair = 0; pair < 3; ++pair) {
+    EXPECT_NEAR(model->energy(r2[pair], type1[pair], type2[pair],
+                              config->model_params()), energy[pair], 1e-10);
+  }
+}
+
 }  // namespace feasst
@@ -22,4 +22,20 @@ TEST(LennardJones, serialize) {
     "LennardJones 2094 1 0 2 -1 763 0.089999999999999997 ");
 }
 
+TEST(LennardJones, energy_batch) {
+  auto config = MakeConfiguration({{"particle_type0", "../particle/co2_epm2.fstprt"}});
+  auto model = MakeLennardJones();
+  model->precompute(config->model_params());
+  const std::vector<double> r2 = {0.1, 9., 12., 16., 100.};
+  const std::vector<int> type1 = {0, 0, 1, 1, 0};
+  const std::vector<int> type2 = {0, 1, 0, 1, 1};
+  std::vector<double> energy(r2.size());
+  model->energy_batch(5, r2.data(), type1.data(), type2.data(),
+                      config->model_params(), energy.data());
+  for (int pair = 0; pair < 5; ++pair) {
+    EXPECT_NEAR(model->energy(r2[pair], type1[pair], type2[pair],
+                              config->model_params()), energy[pair], 1e-10);
+  }
+}
+
 }  // namespace feasst
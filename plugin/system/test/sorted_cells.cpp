@@ -0,0 +1,74 @@
+#include "utils/test/utils.h"
+#include "utils/include/debug.h"
+#include "system/include/cells.h"
+#include "system/include/sorted_cells.h"
+
+namespace feasst {
+
+TEST(SortedCells, sorted_cells) {
+  SortedCells cells;
+  EXPECT_EQ(0, cells.num_total());
+  TRY(
+    cells.create(3, {14});
+    CATCH_PHRASE("unrecognized dim");
+  );
+  cells.create(3, {9, 9, 9});
+  EXPECT_EQ(0, cells.num_total());
+
+  // same ids as Cells, but without duplicate neighbors
+  cells.create(3, {12, 12, 6});
+  Cells cells2;
+  cells2.create(3, {12, 12, 6});
+  EXPECT_EQ(cells2.num_total(), cells.num_total());
+  EXPECT_EQ(4*4*2, cells.num_total());
+  for (int cell = 0; cell < cells.num_total(); ++cell) {
+    EXPECT_EQ(3*3*2, cells.neighbor_end(cell) - cells.neighbor_begin(cell));
+  }
+  const std::vector<double> scaled = {0.3, -0.2, 0.1};
+  EXPECT_EQ(cells2.id(scaled), cells.id(scaled.data()));
+  TRY(
+    cells.id(std::vector<double>({-0.501, 0., 0.}).data());
+    CATCH_PHRASE("not scaled");
+  );
+  EXPECT_EQ(cells.num_total(), static_cast<int>(cells.order().size()));
+  EXPECT_EQ(0, cells.order()[0]);
+
+  // add sites unsorted, then sort
+  const std::vector<double> coord = {1., 2., 3.};
+  for (int part = 0; part < 10; ++part) {
+    cells.add_unsorted(part, 0, part % 3, coord.data(), 0);
+  }
+  EXPECT_EQ(-1, cells.cell(0, 0));
+  cells.sort();
+  cells.check();
+  EXPECT_EQ(10, cells.num_sites());
+  EXPECT_EQ(1, cells.num_sorts());
+  EXPECT_EQ(4, cells.end(0) - cells.begin(0));
+  EXPECT_EQ(1, cells.cell(4, 0));
+  EXPECT_EQ(2., cells.coord(cells.begin(1))[1]);
+
+  // move sites without a sort, while there is room
+  cells.update(4, 0, 5, coord.data(), 1);
+  cells.check();
+  EXPECT_EQ(5, cells.cell(4, 0));
+  EXPECT_EQ(1, cells.type(cells.begin(5)));
+  EXPECT_EQ(4, cells.particle(cells.begin(5)));
+  EXPECT_EQ(1, cells.num_sorts());
+  cells.update(5, 0, 5, coord.data(), 0);
+  cells.update(6, 0, 5, coord.data(), 0);
+  EXPECT_EQ(2, cells.num_sorts());
+  cells.check();
+  EXPECT_EQ(3, cells.end(5) - cells.begin(5));
+
+  // remove and add again
+  cells.remove(5, 0);
+  cells.check();
+  EXPECT_EQ(9, cells.num_sites());
+  EXPECT_EQ(-1, cells.cell(5, 0));
+  cells.update(5, 1, 7, coord.data(), 0);
+  cells.check();
+  EXPECT_EQ(10, cells.num_sites());
+  EXPECT_EQ(7, cells.cell(5, 1));
+}
+
+}  // namespace feasst
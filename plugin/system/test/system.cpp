@@ -1,5 +1,7 @@
 #include "utils/test/utils.h"
 #include "utils/include/cache.h"
+#include "configuration/include/select.h"
+#include "configuration/include/configuration.h"
 #include "system/include/system.h"
 #include "system/test/sys_utils.h"
 #include "system/include/lennard_jones.h"
@@ -25,6 +27,22 @@ TEST(System, cache) {
   DEBUG(system.energy());
 }
 
+TEST(System, snapshot) {
+  System system = two_particle_system();
+  const double energy = system.energy();
+  System snapshot = system.snapshot();
+  Select select(1, system.configuration().particle(1));
+  system.get_configuration()->displace_particle(select, Position({0.1, 0, 0}));
+  const double energy2 = system.energy();
+  EXPECT_NE(energy, energy2);
+  EXPECT_EQ(energy, snapshot.stored_energy());
+  EXPECT_EQ(energy, snapshot.potential(0).stored_energy());
+  EXPECT_EQ(1.25, snapshot.configuration().particle(1).site(0).position().coord(0));
+  snapshot.update_snapshot(system);
+  EXPECT_EQ(energy2, snapshot.stored_energy());
+  EXPECT_NEAR(1.35, snapshot.configuration().particle(1).site(0).position().coord(0), NEAR_ZERO);
+}
+
 // compare with https://www.nist.gov/mml/csd/chemical-informatics-group/lennard-jones-fluid-reference-calculations-non-cuboid-cell
 TEST(System, triclinic) {
   System system;
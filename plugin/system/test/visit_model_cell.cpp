@@ -1,3 +1,5 @@
+#include <cmath>
+#include <algorithm>
 #include "utils/test/utils.h"
 #include "math/include/constants.h"
 #include "math/include/random_mt19937.h"
@@ -5,13 +7,28 @@
 #include "system/test/sys_utils.h"
 #include "system/include/cells.h"
 #include "system/include/visit_model_cell.h"
+#include "system/include/visit_model_intra.h"
+#include "system/include/sorted_cells.h"
 #include "system/include/lennard_jones.h"
+#include "system/include/hard_sphere.h"
+#include "utils/include/timer.h"
+#include "configuration/test/config_utils.h"
 #include "configuration/include/file_xyz.h"
 #include "configuration/include/domain.h"
 #include "configuration/include/select.h"
+#include "configuration/include/configuration.h"
 
 namespace feasst {
 
+// The sample configurations are too small for a cell list with the cutoff of
+// the particle files, so shorten the cutoff to obtain four cells per side.
+static void shorten_cutoff_for_cells(Configuration * config) {
+  const double cutoff = config->domain().min_side_length()/4.;
+  for (int type = 0; type < config->num_site_types(); ++type) {
+    config->set_model_param("cutoff", type, cutoff);
+  }
+}
+
 TEST(VisitModelCell, cells) {
   auto config = MakeConfiguration({{"cubic_side_length", "7"},
     {"particle_type0", "../particle/spce.fstprt"},
@@ -137,4 +154,250 @@ TEST(VisitModelCell, simple_lj) {
   cell_visit->check_energy(&model, config.get());
 }
 
+TEST(VisitModelCell, batch) {
+  auto tol = [](const double energy) {
+    return 1e-12*std::max(1., std::abs(energy)); };
+  for (const std::string name : {"lj", "spce", "hard_sphere"}) {
+    Configuration config;
+    std::shared_ptr<ModelTwoBody> model;
+    if (name == "spce") {
+      config = spce_sample1();
+      model = MakeLennardJones();
+    } else {
+      config = lj_sample4();
+      if (name == "lj") {
+        model = MakeLennardJones();
+      } else {
+        model = MakeHardSphere();
+      }
+    }
+    shorten_cutoff_for_cells(&config);
+    model->precompute(config.model_params());
+    auto visit = MakeVisitModel();
+    visit->precompute(&config);
+    model->compute(&config, visit.get());
+    auto cell_visit = MakeVisitModelCell({{"min_length", "max_cutoff"}});
+    cell_visit->precompute(&config);
+    auto batch_visit = MakeVisitModelCell({{"min_length", "max_cutoff"},
+                                           {"batch", "true"}});
+    batch_visit->precompute(&config);
+    model->compute(&config, cell_visit.get());
+    model->compute(&config, batch_visit.get());
+    EXPECT_NEAR(cell_visit->energy(), batch_visit->energy(),
+                tol(cell_visit->energy()));
+    EXPECT_NEAR(visit->energy(), batch_visit->energy(), tol(visit->energy()));
+    for (int part = 0; part < config.num_particles(); ++part) {
+      Select select(part, config.select_particle(part));
+      model->compute(select, &config, cell_visit.get());
+      model->compute(select, &config, batch_visit.get());
+      EXPECT_NEAR(cell_visit->energy(), batch_visit->energy(),
+                  tol(cell_visit->energy()));
+    }
+    std::shared_ptr<VisitModel> batch_visit2 =
+      test_serialize<VisitModelCell, VisitModel>(*batch_visit);
+    model->compute(&config, cell_visit.get());
+    model->compute(&config, batch_visit2.get());
+    EXPECT_NEAR(cell_visit->energy(), batch_visit2->energy(),
+                tol(cell_visit->energy()));
+  }
+}
+
+TEST(VisitModelCell, num_threads) {
+  for (const std::string name : {"lj", "spce"}) {
+    Configuration config;
+    if (name == "spce") {
+      config = spce_sample1();
+    } else {
+      config = lj_sample4();
+    }
+    shorten_cutoff_for_cells(&config);
+    LennardJones model;
+    model.precompute(config.model_params());
+    auto visit = MakeVisitModel();
+    auto cell_visit = MakeVisitModelCell({{"min_length", "max_cutoff"}});
+    auto intra_visit = MakeVisitModelIntra({{"intra_cut", "0"}});
+    visit->precompute(&config);
+    cell_visit->precompute(&config);
+    intra_visit->precompute(&config);
+    model.compute(&config, visit.get());
+    model.compute(&config, cell_visit.get());
+    model.compute(&config, intra_visit.get());
+    const double energy = visit->energy();
+    const double cell_energy = cell_visit->energy();
+    const double intra_energy = intra_visit->energy();
+    for (const std::string num_threads : {"2", "3", "-1"}) {
+      auto visit2 = MakeVisitModel({{"num_threads", num_threads}});
+      auto cell_visit2 = MakeVisitModelCell({{"min_length", "max_cutoff"},
+                                             {"num_threads", num_threads}});
+      auto intra_visit2 = MakeVisitModelIntra({{"intra_cut", "0"},
+                                               {"num_threads", num_threads}});
+      visit2->precompute(&config);
+      cell_visit2->precompute(&config);
+      intra_visit2->precompute(&config);
+      for (int repeat = 0; repeat < 2; ++repeat) {
+        model.compute(&config, visit2.get());
+        model.compute(&config, cell_visit2.get());
+        model.compute(&config, intra_visit2.get());
+        EXPECT_NEAR(energy, visit2->energy(), 1e-11);
+        EXPECT_NEAR(cell_energy, cell_visit2->energy(), 1e-11);
+        EXPECT_NEAR(intra_energy, intra_visit2->energy(), 1e-11);
+      }
+      auto cell_visit3 = test_serialize<VisitModelCell, VisitModel>(
+        *cell_visit2);
+      EXPECT_EQ(cell_visit2->num_threads(), cell_visit3->num_threads());
+      model.compute(&config, cell_visit3.get());
+      EXPECT_EQ(cell_visit2->energy(), cell_visit3->energy());
+    }
+  }
+  TRY(
+    MakeVisitModelCell({{"min_length", "max_cutoff"}, {"batch", "true"},
+                        {"num_threads", "2"}});
+    CATCH_PHRASE("num_threads is not implemented with batch or sorted");
+  );
+}
+
+TEST(VisitModelCell, sorted) {
+  auto tol = [](const double energy) {
+    return 1e-12*std::max(1., std::abs(energy)); };
+  for (const std::string name : {"lj", "spce"}) {
+    Configuration config;
+    if (name == "lj") {
+      config = lj_sample4();
+    } else {
+      config = spce_sample1();
+    }
+    shorten_cutoff_for_cells(&config);
+    LennardJones model;
+    model.precompute(config.model_params());
+    VisitModel visit;
+    visit.precompute(&config);
+    VisitModelCell cell_visit(argtype({{"min_length", "max_cutoff"}}));
+    cell_visit.precompute(&config);
+    for (const std::string batch : {"false", "true"}) {
+      VisitModelCell sorted(argtype({{"min_length", "max_cutoff"},
+                                     {"sorted", "true"}, {"batch", batch}}));
+      sorted.precompute(&config);
+      EXPECT_EQ(sorted.cells().num_sites(), sorted.sorted_cells().num_sites());
+      model.compute(&config, &visit);
+      model.compute(&config, &cell_visit);
+      model.compute(&config, &sorted);
+      EXPECT_NEAR(cell_visit.energy(), sorted.energy(), tol(sorted.energy()));
+      EXPECT_NEAR(visit.energy(), sorted.energy(), tol(sorted.energy()));
+      for (int part = 0; part < config.num_particles(); ++part) {
+        Select select(part, config.select_particle(part));
+        model.compute(select, &config, &cell_visit);
+        model.compute(select, &config, &sorted);
+        EXPECT_NEAR(cell_visit.energy(), sorted.energy(),
+                    tol(sorted.energy()));
+      }
+      if (batch == "true") {
+        continue;
+      }
+
+      // accept random displacements, which move sites between cells
+      RandomMT19937 random(argtype({{"seed", "123"}}));
+      for (int trial = 0; trial < 50; ++trial) {
+        const int part = random.uniform(0, config.num_particles() - 1);
+        Select select(part, config.select_particle(part));
+        select.set_trial_state(1);
+        Position disp(config.dimension());
+        for (int dim = 0; dim < config.dimension(); ++dim) {
+          disp.set_coord(dim, 2.*(random.uniform() - 0.5));
+        }
+        config.displace_particle(select, disp);
+        model.compute(select, &config, &cell_visit);
+        model.compute(select, &config, &sorted);
+        EXPECT_NEAR(cell_visit.energy(), sorted.energy(),
+                    tol(cell_visit.energy()));
+        cell_visit.finalize(select, &config);
+        sorted.finalize(select, &config);
+        sorted.check(config);
+      }
+      model.compute(&config, &cell_visit);
+      model.compute(&config, &sorted);
+      EXPECT_NEAR(cell_visit.energy(), sorted.energy(),
+                  tol(cell_visit.energy()));
+      std::shared_ptr<VisitModel> sorted2 =
+        test_serialize<VisitModelCell, VisitModel>(sorted);
+      sorted2->precompute(&config);
+      model.compute(&config, sorted2.get());
+      EXPECT_NEAR(cell_visit.energy(), sorted2->energy(),
+                  tol(cell_visit.energy()));
+    }
+  }
+}
+
+// With only two cells in a dimension, the neighboring cells on either side
+// are the same, but are only visited once.
+TEST(VisitModelCell, two_cells) {
+  auto tol = [](const double energy) {
+    return 1e-12*std::max(1., std::abs(energy)); };
+  Configuration config({{"side_length0", "6.5"}, {"side_length1", "13"},
+    {"side_length2", "13"}, {"particle_type", "../particle/lj.fstprt"}});
+  const int num = 50;
+  for (int part = 0; part < num; ++part) {
+    config.add_particle_of_type(0);
+  }
+  RandomMT19937 random(argtype({{"seed", "123"}}));
+  std::vector<std::vector<double> > coords(num, std::vector<double>(3));
+  for (std::vector<double>& coord : coords) {
+    for (int dim = 0; dim < 3; ++dim) {
+      coord[dim] = config.domain().side_length(dim)*(random.uniform() - 0.5);
+    }
+  }
+  config.update_positions(coords);
+  LennardJones model;
+  model.precompute(config.model_params());
+  VisitModel visit;
+  visit.precompute(&config);
+  model.compute(&config, &visit);
+  for (const std::string sorted : {"false", "true"}) {
+    VisitModelCell cell_visit(argtype({{"min_length", "max_cutoff"},
+                                       {"sorted", sorted}}));
+    cell_visit.precompute(&config);
+    EXPECT_EQ(2, cell_visit.cells().num(0));
+    EXPECT_EQ(4, cell_visit.cells().num(1));
+    model.compute(&config, &cell_visit);
+    EXPECT_NEAR(visit.energy(), cell_visit.energy(), tol(visit.energy()));
+  }
+}
+
+// Compare the time to compute the energy of each particle in a random
+// configuration of LJ particles with and without batch and sorted.
+TEST(VisitModelCell, batch_BENCHMARK_LONG) {
+  const int num = 10000;
+  const double length = std::pow(static_cast<double>(num)/0.5, 1./3.);
+  Configuration config({{"cubic_side_length", str(length)},
+    {"particle_type", "../particle/lj.fstprt"}});
+  for (int part = 0; part < num; ++part) {
+    config.add_particle_of_type(0);
+  }
+  RandomMT19937 random(argtype({{"seed", "123"}}));
+  std::vector<std::vector<double> > coords(num, std::vector<double>(3));
+  for (std::vector<double>& coord : coords) {
+    for (double& x : coord) {
+      x = length*(random.uniform() - 0.5);
+    }
+  }
+  config.update_positions(coords);
+  LennardJones model;
+  model.precompute(config.model_params());
+  for (const std::string sorted : {"false", "true"}) {
+    for (const std::string batch : {"false", "true"}) {
+      VisitModelCell visit({{"min_length", "max_cutoff"}, {"batch", batch},
+                            {"sorted", sorted}});
+      visit.precompute(&config);
+      double energy = 0.;
+      const double time = cpu_hours();
+      for (int part = 0; part < num; ++part) {
+        Select select(part, config.select_particle(part));
+        model.compute(select, &config, &visit);
+        energy += visit.energy();
+      }
+      INFO("sorted " << sorted << " batch " << batch << " energy " << energy
+           << " time " << 3600.*(cpu_hours() - time) << "s");
+    }
+  }
+}
+
 }  // namespace feasst
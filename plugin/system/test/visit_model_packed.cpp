@@ -0,0 +1,122 @@
+#include <cmath>
+#include <algorithm>
+#include "utils/test/utils.h"
+#include "utils/include/timer.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/select.h"
+#include "configuration/include/domain.h"
+#include "configuration/include/packed_sites.h"
+#include "configuration/test/config_utils.h"
+#include "system/include/lennard_jones.h"
+#include "system/include/visit_model.h"
+#include "system/include/visit_model_packed.h"
+#include "system/include/visit_model_cell.h"
+
+namespace feasst {
+
+TEST(VisitModelPacked, reference_config) {
+  auto tol = [](const double energy) {
+    return 1e-12*std::max(1., std::abs(energy)); };
+  for (const std::string name : {"lj", "spce"}) {
+    Configuration config;
+    if (name == "lj") {
+      config = lj_sample4();
+    } else {
+      config = spce_sample1();
+    }
+    LennardJones model;
+    model.precompute(config.model_params());
+    VisitModel visit;
+    visit.precompute(&config);
+    VisitModelPacked packed;
+    packed.precompute(&config);
+    EXPECT_TRUE(config.is_packed());
+    EXPECT_EQ(config.packed_sites().num_sites(), config.num_sites());
+    model.compute(&config, &visit);
+    model.compute(&config, &packed);
+    if (name == "lj") {
+      EXPECT_NEAR(-16.790321304625856, packed.energy(), 1e-12);
+    }
+    EXPECT_NEAR(visit.energy(), packed.energy(), tol(visit.energy()));
+    packed.check_energy(&model, &config);
+
+    // displace a particle and compare the energy of the selection
+    Select select;
+    select.add_particle(config.select_particle(1), 1);
+    config.displace_particle(select, Position({0.1, -0.2, 0.3}));
+    config.check();
+    model.compute(select, &config, &visit);
+    model.compute(select, &config, &packed);
+    EXPECT_NEAR(visit.energy(), packed.energy(), tol(visit.energy()));
+
+    // remove a particle, which becomes a ghost
+    config.remove_particle(select);
+    config.check();
+    model.compute(&config, &visit);
+    model.compute(&config, &packed);
+    EXPECT_NEAR(visit.energy(), packed.energy(), tol(visit.energy()));
+
+    // revive the ghost
+    config.add_particle_of_type(config.select_particle(1).type());
+    EXPECT_EQ(1, config.newest_particle_index());
+    config.check();
+    model.compute(&config, &visit);
+    model.compute(&config, &packed);
+    EXPECT_NEAR(visit.energy(), packed.energy(), tol(visit.energy()));
+
+    // serialize
+    auto packed2 = test_serialize<VisitModelPacked, VisitModel>(packed);
+    Configuration config2 = test_serialize(config);
+    EXPECT_TRUE(config2.is_packed());
+    config2.check();
+    packed2->precompute(&config2);
+    model.compute(&config2, packed2.get());
+    EXPECT_NEAR(visit.energy(), packed2->energy(), tol(visit.energy()));
+  }
+}
+
+// Compare the time to compute the energy of a random configuration of LJ
+// particles with and without the PackedSites, and with cells, which scale
+// linearly instead of quadratically with the number of particles.
+TEST(VisitModelPacked, lj_BENCHMARK_LONG) {
+  for (const int num : {1000, 10000, 100000}) {
+    const double length = std::pow(static_cast<double>(num)/0.1, 1./3.);
+    Configuration config({{"cubic_side_length", str(length)},
+      {"particle_type", "../particle/lj.fstprt"}});
+    for (int part = 0; part < num; ++part) {
+      config.add_particle_of_type(0);
+    }
+    RandomMT19937 random(argtype({{"seed", "123"}}));
+    std::vector<std::vector<double> > coords(num, std::vector<double>(3));
+    for (std::vector<double>& coord : coords) {
+      for (double& x : coord) {
+        x = length*(random.uniform() - 0.5);
+      }
+    }
+    config.update_positions(coords);
+    LennardJones model;
+    model.precompute(config.model_params());
+    VisitModel visit;
+    visit.precompute(&config);
+    VisitModelPacked packed;
+    packed.precompute(&config);
+    double time = cpu_hours();
+    model.compute(&config, &visit);
+    const double visit_hours = cpu_hours() - time;
+    time = cpu_hours();
+    model.compute(&config, &packed);
+    const double packed_hours = cpu_hours() - time;
+    VisitModelCell cell(argtype({{"min_length", "max_cutoff"}}));
+    cell.precompute(&config);
+    time = cpu_hours();
+    model.compute(&config, &cell);
+    const double cell_hours = cpu_hours() - time;
+    EXPECT_NEAR(visit.energy(), packed.energy(), 1e-8*std::abs(visit.energy()));
+    EXPECT_NEAR(visit.energy(), cell.energy(), 1e-8*std::abs(visit.energy()));
+    INFO("num " << num << " VisitModel " << 3600.*visit_hours << "s " <<
+         "VisitModelPacked " << 3600.*packed_hours << "s " <<
+         "VisitModelCell " << 3600.*cell_hours << "s");
+  }
+}
+
+}  // namespace feasst
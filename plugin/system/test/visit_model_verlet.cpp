@@ -0,0 +1,145 @@
+#include <cmath>
+#include <algorithm>
+#include "utils/test/utils.h"
+#include "math/include/random_mt19937.h"
+#include "configuration/include/select.h"
+#include "configuration/include/domain.h"
+#include "configuration/test/config_utils.h"
+#include "system/include/lennard_jones.h"
+#include "system/include/visit_model.h"
+#include "system/include/visit_model_verlet.h"
+
+namespace feasst {
+
+TEST(VisitModelVerlet, reference_config) {
+  // displacements may result in large energies
+  auto tol = [](const double energy) {
+    return 1e-12*std::max(1., std::abs(energy)); };
+  for (const std::string name : {"lj", "spce"}) {
+    Configuration config;
+    if (name == "lj") {
+      config = lj_sample4();
+    } else {
+      config = spce_sample1();
+    }
+    LennardJones model;
+    model.precompute(config.model_params());
+    VisitModel visit;
+    visit.precompute(&config);
+    VisitModelVerlet verlet(argtype({{"skin", "0.5"}}));
+    verlet.precompute(&config);
+    EXPECT_EQ(1, verlet.num_builds());
+    model.compute(&config, &visit);
+    model.compute(&config, &verlet);
+    if (name == "lj") {
+      EXPECT_NEAR(-16.790321304625856, verlet.energy(), 1e-12);
+    }
+    EXPECT_NEAR(visit.energy(), verlet.energy(), tol(visit.energy()));
+    verlet.check_energy(&model, &config);
+
+    // accept random displacements, some of which are larger than the skin
+    RandomMT19937 random(argtype({{"seed", "123"}}));
+    for (int trial = 0; trial < 100; ++trial) {
+      const int part = random.uniform(0, config.num_particles() - 1);
+      Select select(part, config.select_particle(part));
+      select.set_trial_state(1);
+      Position disp(config.dimension());
+      const double max_disp = trial % 10 == 0 ? 2. : 0.1;
+      for (int dim = 0; dim < config.dimension(); ++dim) {
+        disp.set_coord(dim, max_disp*(random.uniform() - 0.5));
+      }
+      config.displace_particle(select, disp);
+      model.compute(select, &config, &visit);
+      model.compute(select, &config, &verlet);
+      EXPECT_NEAR(visit.energy(), verlet.energy(), tol(visit.energy()));
+      verlet.finalize(select, &config);
+      verlet.check(config);
+    }
+    EXPECT_EQ(1, verlet.num_builds());
+    EXPECT_GT(verlet.num_particle_builds(), 0);
+    EXPECT_LE(verlet.max_displacement(), 0.5*verlet.skin());
+    model.compute(&config, &visit);
+    model.compute(&config, &verlet);
+    EXPECT_NEAR(visit.energy(), verlet.energy(), tol(visit.energy()));
+    EXPECT_EQ(1, verlet.num_builds());
+
+    // remove a particle, which becomes a ghost
+    Select select(1, config.select_particle(1));
+    select.set_trial_state(2);
+    verlet.finalize(select, &config);
+    config.remove_particle(select);
+    verlet.check(config);
+    model.compute(&config, &visit);
+    model.compute(&config, &verlet);
+    EXPECT_NEAR(visit.energy(), verlet.energy(), tol(visit.energy()));
+
+    // revive the ghost
+    config.add_particle_of_type(config.select_particle(1).type());
+    EXPECT_EQ(1, config.newest_particle_index());
+    Select added(1, config.select_particle(1));
+    added.set_trial_state(3);
+    model.compute(added, &config, &visit);
+    model.compute(added, &config, &verlet);
+    EXPECT_NEAR(visit.energy(), verlet.energy(), tol(visit.energy()));
+    verlet.finalize(added, &config);
+    verlet.check(config);
+    model.compute(&config, &visit);
+    model.compute(&config, &verlet);
+    EXPECT_NEAR(visit.energy(), verlet.energy(), tol(visit.energy()));
+    EXPECT_EQ(1, verlet.num_builds());
+
+    // moving a particle without finalize is found by the entire computation
+    config.displace_particle(select, Position(std::vector<double>(
+      config.dimension(), 2.)));
+    model.compute(&config, &visit);
+    model.compute(&config, &verlet);
+    EXPECT_NEAR(visit.energy(), verlet.energy(), tol(visit.energy()));
+    EXPECT_EQ(2, verlet.num_builds());
+
+    // serialize
+    auto verlet2 = test_serialize<VisitModelVerlet, VisitModel>(verlet);
+    verlet2->precompute(&config);
+    model.compute(&config, verlet2.get());
+    EXPECT_NEAR(visit.energy(), verlet2->energy(), tol(visit.energy()));
+  }
+}
+
+// Use a domain large enough to bin the sites into cells during the build.
+TEST(VisitModelVerlet, cells) {
+  const int num = 300, num_per_side = 7;
+  Configuration config({{"cubic_side_length", "12"},
+    {"particle_type", "../particle/lj.fstprt"}});
+  for (int part = 0; part < num; ++part) {
+    config.add_particle_of_type(0);
+  }
+  RandomMT19937 random(argtype({{"seed", "123"}}));
+  // place on a lattice with a small random perturbation
+  const double spacing = 12./static_cast<double>(num_per_side);
+  std::vector<std::vector<double> > coords(num, std::vector<double>(3));
+  for (int part = 0; part < num; ++part) {
+    std::vector<int> lattice = {part % num_per_side,
+      (part/num_per_side) % num_per_side, part/num_per_side/num_per_side};
+    for (int dim = 0; dim < 3; ++dim) {
+      coords[part][dim] = -6. + spacing*(lattice[dim] + 0.5) +
+                          0.2*(random.uniform() - 0.5);
+    }
+  }
+  config.update_positions(coords);
+  LennardJones model;
+  model.precompute(config.model_params());
+  VisitModel visit;
+  visit.precompute(&config);
+  VisitModelVerlet verlet;
+  verlet.precompute(&config);
+  model.compute(&config, &visit);
+  model.compute(&config, &verlet);
+  EXPECT_NEAR(visit.energy(), verlet.energy(), 1e-8);
+  for (int part = 0; part < num; ++part) {
+    Select select(part, config.select_particle(part));
+    model.compute(select, &config, &visit);
+    model.compute(select, &config, &verlet);
+    EXPECT_NEAR(visit.energy(), verlet.energy(), 1e-8);
+  }
+}
+
+}  // namespace feasst
@@ -3,6 +3,7 @@
 #define FEASST_UTILS_INCLUDE_CHECKPOINT_H_
 
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <memory>
 #include <map>
@@ -37,6 +38,31 @@ class Checkpoint {
       If -1, only backup the previous file by appending its name with ".bak".
       Otherwise, if > 0, append each backup with an integer count beginning
       with 0.
+    - binary: if true, write arrays of doubles as raw binary blocks instead of
+      text (see feasst_set_binary), which is faster and smaller for large
+      systems (default: false).
+      Binary files are detected upon reading, and are read through a memory
+      map (see MappedFileBuffer).
+    - asynchronous: if true, serialize the object into memory and return,
+      while a background thread writes the file (default: false).
+      The file is first written with the appended name ".tmp", flushed to
+      disk, and then renamed to checkpoint_file, so that an existing
+      checkpoint is always complete.
+      One background thread is shared by all checkpoints in the process
+      (e.g., Clones), such that only one file is written at a time.
+    - asynchronous_queue: maximum number of pending asynchronous writes of
+      this checkpoint_file, before writing waits for them to complete
+      (default: 1).
+    - delta_writes: if > 0, the periodic writes in check append only the
+      changes since the previous write (e.g., positions, random numbers and
+      accumulators) to a file with the appended name ".delta", for this many
+      writes, before the full checkpoint is written again and the deltas are
+      compacted into it (default: 0).
+      The changes are found by comparing the serialized object with the
+      previous one, which is kept in memory.
+      Reading replays the deltas onto the full checkpoint.
+      Backups (see writes_per_backup) are only created with the full writes,
+      and include their deltas (e.g., checkpoint_file3.delta).
    */
   explicit Checkpoint(argtype args = argtype());
 
@@ -48,16 +74,28 @@ class Checkpoint {
   /// Return number of hours between writing file.
   double num_hours() const { return num_hours_; }
 
+  /// Return true if writing in binary.
+  bool binary() const { return binary_; }
+
+  /// Return true if writing asynchronously.
+  bool asynchronous() const { return asynchronous_; }
+
   /// Write the checkpoint to file. If the file exists, create backup.
+  /// The object is serialized directly to the file, unless asynchronous.
   template <typename T>
   void write(const T& obj, const std::string append_backup = ".bak") const {
     if (checkpoint_file_.empty() || checkpoint_file_ == " ") return;
+    if (asynchronous_ || delta_writes_ > 0) {
+      write_serialized_(serialize_(obj), append_backup, false);
+      return;
+    }
     file_backup(checkpoint_file_, append_backup);
     std::ofstream file(checkpoint_file_.c_str(),
-      std::ofstream::out | std::ofstream::trunc);
-    std::stringstream ss;
-    obj.serialize(ss);
-    file << ss.str();
+      std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+    if (binary_) {
+      begin_binary_(&file);
+    }
+    obj.serialize(file);
     file.close();
   }
 
@@ -70,12 +108,7 @@ class Checkpoint {
                               hours > first_hours_ + num_hours_terminate_;
     if (is_write) previous_hours_ = hours;
     if (is_write || is_terminate) {
-      std::string append_backup = ".bak";
-      if (writes_per_backup_ > 0) {
-        ++previous_backup_;
-        file_backup(checkpoint_file_, feasst::str(previous_backup_));
-      }
-      write(obj, append_backup);
+      write_periodic(obj);
     }
     if (is_terminate) {
       FATAL("Terminating because Checkpoint has reached the user input " <<
@@ -84,9 +117,52 @@ class Checkpoint {
     }
   }
 
+  /// Perform the write of check, regardless of the time, which may be a
+  /// delta or a backup.
+  template <typename T>
+  void write_periodic(const T& obj) {
+    const bool is_delta = is_delta_next_();
+    std::string append_backup = ".bak";
+    if (writes_per_backup_ > 0 && !is_delta) {
+      ++previous_backup_;
+      append_backup = feasst::str(previous_backup_);
+    }
+    if (delta_writes_ > 0) {
+      write_serialized_(serialize_(obj), append_backup, true);
+    } else {
+      write(obj, append_backup);
+    }
+  }
+
+  /// Offset the time of the next writes by a fraction of num_hours, so that
+  /// many checkpoints which start together (e.g., Clones) are not written at
+  /// the same time.
+  /// The offset replaces that of any previous stagger.
+  void stagger(const double fraction);
+
+  /// Return the cpu hours after which check writes next.
+  double next_hours() const { return previous_hours_ + num_hours_; }
+
+  /// Wait until the asynchronous writes of the checkpoint_file are complete.
+  void wait() const;
+
   /// Initialize object by reading from file.
+  /// First, wait for any asynchronous writes of the file.
   template <typename T>
   void read(T * obj) {
+    wait();
+    std::stringstream deltas;
+    if (replay_deltas_(&deltas)) {
+      *obj = T(deltas);
+      return;
+    }
+    if (is_binary_file_()) {
+      MappedFileBuffer buffer(checkpoint_file_);
+      std::istream istr(&buffer);
+      begin_binary_(&istr);
+      *obj = T(istr);
+      return;
+    }
     std::ifstream file(checkpoint_file_.c_str());
     ASSERT(file.good(), "cannot find " << checkpoint_file_);
     std::string line;
@@ -96,6 +172,19 @@ class Checkpoint {
   }
   template <typename T>
   void read_unique(std::unique_ptr<T>& obj) {
+    wait();
+    std::stringstream deltas;
+    if (replay_deltas_(&deltas)) {
+      obj = std::make_unique<T>(deltas);
+      return;
+    }
+    if (is_binary_file_()) {
+      MappedFileBuffer buffer(checkpoint_file_);
+      std::istream istr(&buffer);
+      begin_binary_(&istr);
+      obj = std::make_unique<T>(istr);
+      return;
+    }
     std::ifstream file(checkpoint_file_.c_str());
     ASSERT(file.good(), "cannot find " << checkpoint_file_);
     std::string line;
@@ -117,16 +206,63 @@ class Checkpoint {
   double num_hours_terminate_ = 0;
   int writes_per_backup_;
   int previous_backup_ = -1;
+  bool binary_;
+  bool asynchronous_;
+  int asynchronous_queue_;
+  int delta_writes_;
 
   // temporary, not to be checkpointed
   double first_hours_ = -1.;
   double previous_hours_ = 0.;
+  double stagger_ = 0.;
+  mutable std::string previous_;
+  mutable int num_deltas_ = 0;
+
+  // Write or read the header of a binary file, and set the stream to binary.
+  void begin_binary_(std::ostream * ostr) const;
+  void begin_binary_(std::istream * istr) const;
+
+  // Return true if the checkpoint_file begins with the binary header.
+  bool is_binary_file_() const;
+
+  template <typename T>
+  std::string serialize_(const T& obj) const {
+    std::stringstream ss;
+    if (binary_) {
+      begin_binary_(static_cast<std::ostream*>(&ss));
+    }
+    obj.serialize(ss);
+    return ss.str();
+  }
+
+  // Return true if the next write in check is a delta.
+  bool is_delta_next_() const;
+
+  // Write the serialized object, or only its delta if is_delta, either
+  // directly or by the background thread if asynchronous.
+  void write_serialized_(std::string serialized,
+    const std::string& append_backup, const bool is_delta) const;
+
+  // If there are deltas, replay them onto the checkpoint_file and return
+  // true.
+  bool replay_deltas_(std::stringstream * ss) const;
 };
 
 inline std::shared_ptr<Checkpoint> MakeCheckpoint(argtype args = argtype()) {
   return std::make_shared<Checkpoint>(args);
 }
 
+/// Return a record of the changes which construct current from previous.
+/// Both strings are split into words at each space (or at most 64
+/// characters), and the record copies the unchanged words from previous and
+/// inserts the others.
+std::string delta_encode(const std::string& previous,
+                         const std::string& current);
+
+/// Apply the next record in the delta stream to the state.
+/// Return false if there is no complete record.
+bool delta_decode(std::istream * delta, std::string * state);
+
 }  // namespace feasst
 
 #endif  // FEASST_UTILS_INCLUDE_CHECKPOINT_H_
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <fstream>
+#include <streambuf>
 
 namespace feasst {
 
@@ -22,6 +23,34 @@ bool file_exists(const std::string& file_name);
 void file_backup(const std::string& file_name,
   const std::string append = ".bak");
 
+/**
+  A read-only stream buffer over a memory-mapped file, for use with
+  std::istream.
+  Reading from the stream copies directly from the mapped pages, which are
+  loaded by the operating system as needed, instead of first reading the whole
+  file into memory.
+ */
+class MappedFileBuffer : public std::streambuf {
+ public:
+  explicit MappedFileBuffer(const std::string& file_name);
+  ~MappedFileBuffer();
+
+  /// Return the mapped contents of the file.
+  const char * data() const { return data_; }
+
+  /// Return the size of the file in bytes.
+  size_t size() const { return size_; }
+
+ protected:
+  pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+    std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+
+ private:
+  char * data_ = nullptr;
+  size_t size_ = 0;
+};
+
 }  // namespace feasst
 
 #endif  // FEASST_UTILS_FILE_H_
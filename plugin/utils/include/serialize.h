@@ -71,6 +71,22 @@ void feasst_deserialize(T * val, std::istream& istr) {
   istr >> *val;
 }
 
+/// Return true if the machine stores numbers in little-endian byte order.
+bool is_little_endian();
+
+/**
+  Set a stream to serialize arrays of doubles (see below) as raw binary
+  blocks instead of text.
+  The flag is stored in the stream, so that the same serialize functions and
+  deserialize constructors are used for both formats.
+  Binary blocks use the byte order of the machine, which is checked to be
+  little-endian.
+ */
+void feasst_set_binary(const bool binary, std::ios_base * stream);
+
+/// Return true if the stream serializes arrays of doubles in binary.
+bool feasst_is_binary(std::ios_base& stream);
+
 /// Serialize object version
 void feasst_serialize_version(const int version, std::ostream& ostr);
 
@@ -137,7 +153,7 @@ void feasst_deserialize(std::vector<T> * vector, std::istream& istr) {
   }
 }
 
-/// Serialize 1D vector of doubles
+/// Serialize 1D vector of doubles, in binary if feasst_is_binary.
 void feasst_serialize(const std::vector<double>& vector, std::ostream& ostr);
 
 /// Deserialize 1D vector of doubles.
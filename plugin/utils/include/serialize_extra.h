@@ -19,7 +19,7 @@ std::shared_ptr<T> template_deserialize(
     /// Rewind istr position to read class name again (default: false).
     bool rewind = false) {
   std::string class_name;
-  int pos = istr.tellg();  // record position before reading
+  const std::streampos pos = istr.tellg();  // record position
   istr >> class_name;      // read class name
 
   // rewind position so constructors can reread class name.
@@ -1,3 +1,13 @@
+#include <cstdint>
+#include <cstdio>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <thread>
 #include "utils/include/checkpoint.h"
 #include "utils/include/arguments.h"
 #include "utils/include/io.h"
@@ -5,6 +15,183 @@
 
 namespace feasst {
 
+namespace {
+
+// The first word of a binary checkpoint file, followed by a format version.
+const std::string binary_header = "FEASSTBinaryCheckpoint";
+
+// The appended name of the file of changes since the full checkpoint.
+const std::string delta_suffix = ".delta";
+
+// The first word of each record in the delta file, followed by a version.
+const std::string delta_header = "FEASSTDelta";
+
+// The number of consecutive words which are matched to find moved text.
+const int delta_words = 4;
+
+// FNV-1a hash.
+uint64_t fnv_hash(const char * data, const size_t size) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t index = 0; index < size; ++index) {
+    hash ^= static_cast<unsigned char>(data[index]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// The maximum size of a word, such that a binary block is split into many
+// words.
+const size_t max_word_size = 64;
+
+// Return the position of the beginning of each word, including the trailing
+// space, with the size of the string appended.
+std::vector<size_t> word_starts(const std::string& text) {
+  std::vector<size_t> starts;
+  size_t position = 0;
+  while (position < text.size()) {
+    starts.push_back(position);
+    size_t next = text.find(' ', position);
+    if (next == std::string::npos) {
+      next = text.size();
+    } else {
+      ++next;
+    }
+    position = std::min(next, position + max_word_size);
+  }
+  starts.push_back(text.size());
+  return starts;
+}
+
+// A file to be written by a checkpoint.
+struct CheckpointTask {
+  std::string file_name, contents, append_backup;
+  // true if the checkpoint_file has deltas, which are backed up with it.
+  bool is_delta_chain = false;
+  // true if contents is a delta record, which is appended to the deltas.
+  bool is_append = false;
+};
+
+// Write a file, flush it to disk, backup the previous file and rename.
+// Or, append a delta record to the delta file.
+// Return an error message, or empty if successful.
+std::string write_task(const CheckpointTask& task) {
+  const std::string delta_file = task.file_name + delta_suffix;
+  const std::string write_name = task.is_append ? delta_file :
+                                 task.file_name + ".tmp";
+  FILE * file = fopen(write_name.c_str(), task.is_append ? "ab" : "wb");
+  if (file == NULL) {
+    return "cannot open " + write_name;
+  }
+  const std::string& contents = task.contents;
+  const bool is_written =
+    fwrite(contents.data(), 1, contents.size(), file) == contents.size() &&
+    fflush(file) == 0 &&
+    fsync(fileno(file)) == 0;
+  fclose(file);
+  if (!is_written) {
+    return "cannot write " + write_name;
+  }
+  if (task.is_append) {
+    return std::string("");
+  }
+  if (task.is_delta_chain) {
+    // Move the deltas with their full checkpoint before replacing it.
+    const std::string backup = task.file_name + task.append_backup +
+                               delta_suffix;
+    remove(backup.c_str());
+    if (file_exists(delta_file)) {
+      rename(delta_file.c_str(), backup.c_str());
+    }
+  }
+  file_backup(task.file_name, task.append_backup);
+  if (rename(write_name.c_str(), task.file_name.c_str()) != 0) {
+    return "cannot rename " + write_name;
+  }
+  return std::string("");
+}
+
+// A single background thread which writes all asynchronous checkpoints in
+// order, one at a time.
+class CheckpointWriter {
+ public:
+  // Queue a task, but first wait if the file has max_pending writes.
+  void push(CheckpointTask task, const int max_pending) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::string file_name = task.file_name;
+    check_error_(file_name);
+    changed_.wait(lock, [&]() { return pending_[file_name] < max_pending; });
+    ++pending_[file_name];
+    tasks_.push_back(std::move(task));
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&CheckpointWriter::work_, this);
+    }
+    changed_.notify_all();
+  }
+
+  // Wait until there are no pending writes of the file.
+  void wait(const std::string& file_name) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [&]() { return pending_[file_name] == 0; });
+    check_error_(file_name);
+  }
+
+  // Complete all writes before exit.
+  ~CheckpointWriter() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    changed_.notify_all();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+
+ private:
+  std::deque<CheckpointTask> tasks_;
+  std::map<std::string, int> pending_;
+  std::map<std::string, std::string> errors_;
+  bool stop_ = false;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::thread worker_;
+
+  void check_error_(const std::string& file_name) {
+    if (errors_.count(file_name) > 0) {
+      const std::string error = errors_[file_name];
+      errors_.erase(file_name);
+      FATAL("asynchronous checkpoint failed: " << error);
+    }
+  }
+
+  void work_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      changed_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      CheckpointTask task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      const std::string error = write_task(task);
+      lock.lock();
+      if (!error.empty()) {
+        errors_[task.file_name] = error;
+      }
+      --pending_[task.file_name];
+      changed_.notify_all();
+    }
+  }
+};
+
+CheckpointWriter& checkpoint_writer() {
+  static CheckpointWriter writer;
+  return writer;
+}
+
+}  // namespace
+
 Checkpoint::Checkpoint(argtype args) {
   num_hours_ = dble("num_hours", &args, 1.);
   num_hours_terminate_ = dble("num_hours_terminate", &args, -1);
@@ -14,28 +201,270 @@ Checkpoint::Checkpoint(argtype args) {
     checkpoint_file_ = str("file_name", &args);
   }
   writes_per_backup_ = integer("writes_per_backup", &args, -1);
+  binary_ = boolean("binary", &args, false);
+  asynchronous_ = boolean("asynchronous", &args, false);
+  asynchronous_queue_ = integer("asynchronous_queue", &args, 1);
+  ASSERT(asynchronous_queue_ > 0,
+    "asynchronous_queue: " << asynchronous_queue_ << " must be positive.");
+  delta_writes_ = integer("delta_writes", &args, 0);
   first_hours_ = cpu_hours();
   feasst_check_all_used(args);
 }
 
 void Checkpoint::serialize(std::ostream& ostr) const {
-  feasst_serialize_version(223, ostr);
+  feasst_serialize_version(226, ostr);
   feasst_serialize(checkpoint_file_, ostr);
   feasst_serialize(num_hours_, ostr);
   feasst_serialize(num_hours_terminate_, ostr);
   feasst_serialize(writes_per_backup_, ostr);
   feasst_serialize(previous_backup_, ostr);
+  feasst_serialize(binary_, ostr);
+  feasst_serialize(asynchronous_, ostr);
+  feasst_serialize(asynchronous_queue_, ostr);
+  feasst_serialize(delta_writes_, ostr);
 }
 
 Checkpoint::Checkpoint(std::istream& istr) {
   const int version = feasst_deserialize_version(istr);
-  ASSERT(version == 223, "version mismatch: " << version);
+  ASSERT(version >= 223 && version <= 226, "version mismatch: " << version);
   feasst_deserialize(&checkpoint_file_, istr);
   feasst_deserialize(&num_hours_, istr);
   feasst_deserialize(&num_hours_terminate_, istr);
   feasst_deserialize(&writes_per_backup_, istr);
   feasst_deserialize(&previous_backup_, istr);
+  binary_ = false;
+  if (version >= 224) {
+    feasst_deserialize(&binary_, istr);
+  }
+  asynchronous_ = false;
+  asynchronous_queue_ = 1;
+  if (version >= 225) {
+    feasst_deserialize(&asynchronous_, istr);
+    feasst_deserialize(&asynchronous_queue_, istr);
+  }
+  delta_writes_ = 0;
+  if (version >= 226) {
+    feasst_deserialize(&delta_writes_, istr);
+  }
   first_hours_ = cpu_hours();
 }
 
+void Checkpoint::stagger(const double fraction) {
+  previous_hours_ += (fraction - stagger_)*num_hours_;
+  stagger_ = fraction;
+}
+
+bool Checkpoint::is_delta_next_() const {
+  return delta_writes_ > 0 && !previous_.empty() &&
+         num_deltas_ < delta_writes_;
+}
+
+void Checkpoint::write_serialized_(std::string serialized,
+    const std::string& append_backup, const bool is_delta) const {
+  if (checkpoint_file_.empty() || checkpoint_file_ == " ") return;
+  CheckpointTask task;
+  task.file_name = checkpoint_file_;
+  task.append_backup = append_backup;
+  task.is_delta_chain = delta_writes_ > 0;
+  if (is_delta && is_delta_next_()) {
+    task.contents = delta_encode(previous_, serialized);
+    task.is_append = true;
+    ++num_deltas_;
+  } else {
+    num_deltas_ = 0;
+    if (delta_writes_ > 0) {
+      task.contents = serialized;
+    }
+  }
+  if (delta_writes_ > 0) {
+    previous_ = std::move(serialized);
+  } else {
+    task.contents = std::move(serialized);
+  }
+  if (asynchronous_) {
+    checkpoint_writer().push(std::move(task), asynchronous_queue_);
+  } else {
+    const std::string error = write_task(task);
+    ASSERT(error.empty(), error);
+  }
+}
+
+bool Checkpoint::replay_deltas_(std::stringstream * ss) const {
+  const std::string delta_file = checkpoint_file_ + delta_suffix;
+  if (!file_exists(delta_file)) {
+    return false;
+  }
+  std::ifstream file(checkpoint_file_.c_str(), std::ifstream::binary);
+  ASSERT(file.good(), "cannot find " << checkpoint_file_);
+  std::stringstream full;
+  full << file.rdbuf();
+  std::string state = full.str();
+  std::ifstream deltas(delta_file.c_str(), std::ifstream::binary);
+  while (delta_decode(&deltas, &state)) {}
+  ss->str(state);
+  if (state.compare(0, binary_header.size(), binary_header) == 0) {
+    begin_binary_(static_cast<std::istream*>(ss));
+  }
+  return true;
+}
+
+void Checkpoint::wait() const {
+  checkpoint_writer().wait(checkpoint_file_);
+}
+
+void Checkpoint::begin_binary_(std::ostream * ostr) const {
+  feasst_set_binary(true, ostr);
+  *ostr << binary_header << " ";
+  feasst_serialize_version(1, *ostr);
+}
+
+void Checkpoint::begin_binary_(std::istream * istr) const {
+  feasst_set_binary(true, istr);
+  std::string header;
+  *istr >> header;
+  ASSERT(header == binary_header, "unrecognized header: " << header);
+  const int version = feasst_deserialize_version(*istr);
+  ASSERT(version == 1, "unrecognized binary version: " << version);
+}
+
+bool Checkpoint::is_binary_file_() const {
+  std::ifstream file(checkpoint_file_.c_str());
+  ASSERT(file.good(), "cannot find " << checkpoint_file_);
+  std::string header;
+  file >> header;
+  return header == binary_header;
+}
+
+std::string delta_encode(const std::string& previous,
+    const std::string& current) {
+  const std::vector<size_t> old_starts = word_starts(previous);
+  const std::vector<size_t> new_starts = word_starts(current);
+  const int num_old = static_cast<int>(old_starts.size()) - 1;
+  const int num_new = static_cast<int>(new_starts.size()) - 1;
+  auto hash_words = [](const std::string& text,
+                       const std::vector<size_t>& starts, const int word) {
+    return fnv_hash(text.data() + starts[word],
+                    starts[word + delta_words] - starts[word]);
+  };
+  // the first word of each sequence of delta_words in previous.
+  std::unordered_map<uint64_t, int> first_words;
+  for (int word = num_old - delta_words; word >= 0; --word) {
+    first_words[hash_words(previous, old_starts, word)] = word;
+  }
+  auto is_same = [&](const int old_word, const int new_word) {
+    const size_t size = old_starts[old_word + 1] - old_starts[old_word];
+    return size == new_starts[new_word + 1] - new_starts[new_word] &&
+      previous.compare(old_starts[old_word], size, current,
+                       new_starts[new_word], size) == 0;
+  };
+
+  // Copy words from previous, or insert words from current, and combine
+  // contiguous operations.
+  std::stringstream ops;
+  int num_ops = 0;
+  char op = ' ';
+  size_t op_begin = 0, op_size = 0;
+  auto flush = [&]() {
+    if (op == 'c') {
+      ops << "c " << op_begin << " " << op_size << "\n";
+      ++num_ops;
+    } else if (op == 'i') {
+      ops << "i " << op_size << "\n";
+      ops.write(current.data() + op_begin, op_size);
+      ops << "\n";
+      ++num_ops;
+    }
+  };
+  auto add = [&](const char type, const size_t begin, const size_t size) {
+    if (type != op || begin != op_begin + op_size) {
+      flush();
+      op = type;
+      op_begin = begin;
+      op_size = 0;
+    }
+    op_size += size;
+  };
+  int old_word = 0, new_word = 0;
+  while (new_word < num_new) {
+    if (old_word < num_old && is_same(old_word, new_word)) {
+      add('c', old_starts[old_word],
+          old_starts[old_word + 1] - old_starts[old_word]);
+      ++old_word;
+      ++new_word;
+      continue;
+    }
+    // Look for the words in another position of previous.
+    if (new_word + delta_words <= num_new) {
+      auto found = first_words.find(hash_words(current, new_starts, new_word));
+      if (found != first_words.end() && is_same(found->second, new_word)) {
+        old_word = found->second;
+        continue;
+      }
+    }
+    // Otherwise, assume the word was replaced.
+    add('i', new_starts[new_word],
+        new_starts[new_word + 1] - new_starts[new_word]);
+    ++new_word;
+    if (old_word < num_old) ++old_word;
+  }
+  flush();
+  std::stringstream record;
+  record << delta_header << " 1 " << previous.size() << " " << current.size()
+    << " " << fnv_hash(current.data(), current.size()) << " " << num_ops
+    << "\n" << ops.str() << "end\n";
+  return record.str();
+}
+
+bool delta_decode(std::istream * delta, std::string * state) {
+  std::string header;
+  *delta >> header;
+  if (header.empty()) {
+    return false;
+  }
+  ASSERT(header == delta_header, "unrecognized delta header: " << header);
+  int version, num_ops;
+  size_t old_size, new_size;
+  uint64_t hash;
+  *delta >> version >> old_size >> new_size >> hash >> num_ops;
+  if (delta->fail()) {
+    return false;
+  }
+  ASSERT(version == 1, "unrecognized delta version: " << version);
+  ASSERT(old_size == state->size(), "delta of size: " << old_size <<
+    " does not apply to the previous checkpoint of size: " << state->size());
+  std::string result;
+  result.reserve(new_size);
+  for (int index = 0; index < num_ops; ++index) {
+    char op = ' ';
+    size_t begin = 0, size = 0;
+    *delta >> op;
+    if (op == 'c') {
+      *delta >> begin >> size;
+      if (delta->fail()) return false;
+      ASSERT(begin + size <= state->size(), "delta copy out of range");
+      result.append(*state, begin, size);
+    } else if (op == 'i') {
+      *delta >> size;
+      delta->get();
+      if (delta->fail()) return false;
+      const size_t previous_size = result.size();
+      result.resize(previous_size + size);
+      delta->read(&result[previous_size], size);
+      if (static_cast<size_t>(delta->gcount()) != size) return false;
+    } else {
+      return false;
+    }
+  }
+  std::string end;
+  *delta >> end;
+  if (end != "end") {
+    return false;
+  }
+  ASSERT(result.size() == new_size &&
+         fnv_hash(result.data(), result.size()) == hash,
+    "delta does not reproduce the checkpoint");
+  *state = std::move(result);
+  return true;
+}
+
 }  // namespace feasst
@@ -1,4 +1,7 @@
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sstream>
 #include "utils/include/file.h"
 #include "utils/include/debug.h"
@@ -50,4 +53,47 @@ void file_backup(const std::string& file_name,
   }
 }
 
+MappedFileBuffer::MappedFileBuffer(const std::string& file_name) {
+  const int descriptor = open(file_name.c_str(), O_RDONLY);
+  ASSERT(descriptor != -1, "cannot open " << file_name);
+  struct stat status;
+  ASSERT(fstat(descriptor, &status) == 0, "cannot stat " << file_name);
+  size_ = static_cast<size_t>(status.st_size);
+  if (size_ > 0) {
+    void * map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ASSERT(map != MAP_FAILED, "cannot map " << file_name);
+    data_ = static_cast<char *>(map);
+    madvise(map, size_, MADV_SEQUENTIAL);
+  }
+  close(descriptor);
+  setg(data_, data_, data_ + size_);
+}
+
+MappedFileBuffer::~MappedFileBuffer() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+MappedFileBuffer::pos_type MappedFileBuffer::seekoff(off_type offset,
+    std::ios_base::seekdir direction,
+    std::ios_base::openmode which) {
+  off_type position = offset;
+  if (direction == std::ios_base::cur) {
+    position += gptr() - eback();
+  } else if (direction == std::ios_base::end) {
+    position += static_cast<off_type>(size_);
+  }
+  if (position < 0 || position > static_cast<off_type>(size_)) {
+    return pos_type(off_type(-1));
+  }
+  setg(eback(), eback() + position, egptr());
+  return pos_type(position);
+}
+
+MappedFileBuffer::pos_type MappedFileBuffer::seekpos(pos_type position,
+    std::ios_base::openmode which) {
+  return seekoff(off_type(position), std::ios_base::beg, which);
+}
+
 }  // namespace feasst
@@ -1,4 +1,6 @@
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include "utils/include/debug.h"
 #include "utils/include/io.h"
@@ -35,6 +37,32 @@ void feasst_deserialize(bool * val, std::istream& istr) {
   *val = tmp;
 }
 
+namespace {
+
+int binary_index() {
+  static const int index = std::ios_base::xalloc();
+  return index;
+}
+
+}  // namespace
+
+bool is_little_endian() {
+  const uint32_t value = 1;
+  unsigned char first;
+  std::memcpy(&first, &value, 1);
+  return first == 1;
+}
+
+void feasst_set_binary(const bool binary, std::ios_base * stream) {
+  ASSERT(!binary || is_little_endian(),
+    "binary serialization requires a little-endian machine.");
+  stream->iword(binary_index()) = binary;
+}
+
+bool feasst_is_binary(std::ios_base& stream) {
+  return stream.iword(binary_index()) != 0;
+}
+
 void feasst_serialize_version(const int version, std::ostream& ostr) {
   ostr << version << " ";
 }
@@ -100,6 +128,13 @@ void feasst_deserialize(long double * val, std::istream& ostr) {
 }
 
 void feasst_serialize(const std::vector<double>& vector, std::ostream& ostr) {
+  if (feasst_is_binary(ostr)) {
+    ostr << vector.size() << " b";
+    ostr.write(reinterpret_cast<const char *>(vector.data()),
+               sizeof(double)*vector.size());
+    ostr << " ";
+    return;
+  }
   ostr << MAX_PRECISION;
   ostr << vector.size() << " ";
   for (const double& element : vector) {
@@ -111,6 +146,14 @@ void feasst_deserialize(std::vector<double> * vector, std::istream& istr) {
   int num;
   istr >> num;
   vector->resize(num);
+  if (feasst_is_binary(istr)) {
+    istr >> std::ws;
+    ASSERT(istr.get() == 'b', "expected a binary block of " << num <<
+      " doubles.");
+    istr.read(reinterpret_cast<char *>(vector->data()), sizeof(double)*num);
+    ASSERT(istr.good(), "binary block of " << num << " doubles ended early.");
+    return;
+  }
   for (int index = 0; index < num; ++index) {
     feasst_deserialize(&(*vector)[index], istr);
   }
@@ -1,6 +1,7 @@
 #include <fstream>
 #include "utils/test/utils.h"
 #include "utils/include/checkpoint.h"
+#include "utils/include/serialize.h"
 
 namespace feasst {
 
@@ -25,4 +26,127 @@ TEST(Checkpoint, init) {
   EXPECT_EQ(check3.num_hours(), 1e-7);
 }
 
+TEST(Checkpoint, binary) {
+  Checkpoint check({{"checkpoint_file", "tmp/checkpoint_binary"},
+                    {"num_hours", "2"}, {"binary", "true"}});
+  EXPECT_TRUE(check.binary());
+  check.write(check);
+  Checkpoint check2;
+  MakeCheckpoint({{"checkpoint_file", "tmp/checkpoint_binary"}})->read(&check2);
+  EXPECT_EQ(check2.num_hours(), 2);
+  EXPECT_TRUE(check2.binary());
+  auto check3 = test_serialize(check2);
+  EXPECT_TRUE(check3.binary());
+}
+
+TEST(Checkpoint, asynchronous) {
+  for (const std::string binary : {"false", "true"}) {
+    const std::string file = "tmp/checkpoint_async" + binary;
+    Checkpoint check({{"checkpoint_file", file}, {"num_hours", "3"},
+      {"binary", binary}, {"asynchronous", "true"},
+      {"writes_per_backup", "1"}});
+    EXPECT_TRUE(check.asynchronous());
+    for (int write = 0; write < 5; ++write) {
+      check.write(check, str(write));
+    }
+    Checkpoint check2;
+    MakeCheckpoint({{"checkpoint_file", file}})->read(&check2);
+    EXPECT_EQ(check2.num_hours(), 3);
+    EXPECT_TRUE(check2.asynchronous());
+    EXPECT_EQ(file_exists(file + ".tmp"), false);
+    EXPECT_TRUE(file_exists(file + "3"));
+    auto check3 = test_serialize(check2);
+    EXPECT_TRUE(check3.asynchronous());
+  }
+  TRY(
+    MakeCheckpoint({{"asynchronous_queue", "0"}});
+    CATCH_PHRASE("must be positive");
+  );
+}
+
+TEST(Checkpoint, delta_encode) {
+  const std::string previous = "1 2 3 4 5 6 7 8 9 10 11 12";
+  for (const std::string& current : {previous,
+      std::string("1 2 3 4 5 x 7 8 9 10 11 12"),
+      std::string("0 1 2 3 4 5 6 7 8 9 10 11 12 13"),
+      std::string("1 2 3 7 8 9 10 11 12 yy"),
+      std::string("")}) {
+    std::stringstream delta(delta_encode(previous, current) +
+                            delta_encode(current, previous));
+    std::string state = previous;
+    EXPECT_TRUE(delta_decode(&delta, &state));
+    EXPECT_EQ(current, state);
+    EXPECT_TRUE(delta_decode(&delta, &state));
+    EXPECT_EQ(previous, state);
+    EXPECT_FALSE(delta_decode(&delta, &state));
+  }
+  // an incomplete record is ignored.
+  std::string delta = delta_encode(previous, "1 2 3");
+  std::stringstream partial(delta.substr(0, delta.size() - 3));
+  std::string state = previous;
+  EXPECT_FALSE(delta_decode(&partial, &state));
+  EXPECT_EQ(previous, state);
+}
+
+class DeltaTest {
+ public:
+  std::vector<double> data;
+  int step = 0;
+  DeltaTest() : data(100, 1.) {}
+  void serialize(std::ostream& ostr) const {
+    feasst_serialize(data, ostr);
+    feasst_serialize(step, ostr);
+  }
+  explicit DeltaTest(std::istream& istr) {
+    feasst_deserialize(&data, istr);
+    feasst_deserialize(&step, istr);
+  }
+};
+
+TEST(Checkpoint, delta) {
+  for (const std::string async : {"false", "true"}) {
+  for (const std::string binary : {"false", "true"}) {
+    const std::string file = "tmp/checkpoint_delta" + async + binary;
+    Checkpoint check({{"checkpoint_file", file},
+      {"delta_writes", "3"}, {"writes_per_backup", "1"},
+      {"asynchronous", async}, {"binary", binary}});
+    DeltaTest obj;
+    for (int step = 0; step < 8; ++step) {
+      obj.step = step;
+      obj.data[step] = 0.5 + step;
+      check.write_periodic(obj);
+      DeltaTest obj2;
+      MakeCheckpoint({{"checkpoint_file", file}})->read(&obj2);
+      EXPECT_EQ(obj2.step, obj.step);
+      EXPECT_EQ(obj2.data, obj.data);
+    }
+    EXPECT_TRUE(file_exists(file + ".delta"));
+    EXPECT_TRUE(file_exists(file + "1"));
+    EXPECT_TRUE(file_exists(file + "1.delta"));
+    DeltaTest obj3;
+    MakeCheckpoint({{"checkpoint_file", file + "1"}})->read(&obj3);
+    EXPECT_EQ(obj3.step, 3);
+
+    // a full write compacts the deltas
+    check.write(obj);
+    check.wait();
+    EXPECT_FALSE(file_exists(file + ".delta"));
+    std::unique_ptr<DeltaTest> obj4;
+    MakeCheckpoint({{"checkpoint_file", file}})->read_unique(obj4);
+    EXPECT_EQ(obj4->step, 7);
+  }
+  }
+}
+
+TEST(Checkpoint, stagger) {
+  Checkpoint check(argtype({{"num_hours", "2"}}));
+  const double next = check.next_hours();
+  check.stagger(0.5);
+  EXPECT_DOUBLE_EQ(next + 1., check.next_hours());
+  check.stagger(0.5);
+  EXPECT_DOUBLE_EQ(next + 1., check.next_hours());
+  check.stagger(0.25);
+  EXPECT_DOUBLE_EQ(next + 0.5, check.next_hours());
+}
+
 }  // namespace feasst
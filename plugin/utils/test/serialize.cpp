@@ -16,6 +16,24 @@ TEST(Serialize, serialize) {
   EXPECT_EQ(data, data2);
 }
 
+TEST(Serialize, binary) {
+  vec3 data = { { {1./3., -2e-300}, {} }, { {3e300, 4.}, {0.1} } };
+  std::stringstream ss;
+  feasst_set_binary(true, &ss);
+  EXPECT_TRUE(feasst_is_binary(ss));
+  feasst_serialize(data, ss);
+  feasst_serialize(std::string("text"), ss);
+  feasst_serialize(data, ss);
+  vec3 data2, data3;
+  std::string text;
+  feasst_deserialize(&data2, ss);
+  feasst_deserialize(&text, ss);
+  feasst_deserialize(&data3, ss);
+  EXPECT_EQ(data, data2);
+  EXPECT_EQ("text", text);
+  EXPECT_EQ(data, data3);
+}
+
 TEST(Serialize, inf) {
   const long double inf = 2*std::numeric_limits<long double>::max();
   std::stringstream ss;